@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sysexits.h>
@@ -95,14 +96,48 @@ struct line_details {
     long stride;
 };
 
+enum {
+    PATTERN_SHARED,  // N-1: all ranks write one file
+    PATTERN_NODE,    // N-M: ranks sharing a node write one file
+    PATTERN_GROUP,   // N-M: contiguous groups of ranks write one file
+    PATTERN_RANK,    // N-N: every rank writes its own file
+    MAX_PATTERNS = 8
+};
+
+enum {
+    FILL_INTEGER,         // Integers drawn by random(), differing by rank
+    FILL_RANDOM,          // Uniform deviates on [0, 1)
+    FILL_CONSTANT,        // Every value is one
+    FILL_TURBULENCE       // Random-phase modes following a model spectrum
+};
+
+/** Number of Fourier modes summed by the turbulence generator */
+#define TURBULENCE_NMODES (32)
+
+struct pattern_details {
+    int kind;
+    int ngroups;          // Requested group count for PATTERN_GROUP
+    int nfiles;           // Number of files written concurrently
+    double rate;          // Mean global transfer rate in bytes/second
+    double create, close; // Mean slowest esio_file_{create,close} seconds
+};
+
 struct details {
     int world_rank;
     int world_size;
+    MPI_Comm comm;        // Ranks writing the same file as this rank
+    int comm_rank;
+    int comm_size;
+    int file_index;       // Distinguishes the files written concurrently
+    int npatterns;
+    struct pattern_details pattern[MAX_PATTERNS];
     size_t typesize;
     esio_handle h;
     int verbose;
     int repeat;
     int nfields, nplanes, nlines;
+    int fill;
+    unsigned seed;
     char *uncommitted;
     char *dst_template;
     int   retain;
@@ -136,13 +171,37 @@ static int start(int nglobal, int nranks, int rank, int extralow);
 
 static int global_minmax(long val, long *min, long *max);
 
+static int parse_patterns(struct details *d, char *arg);
+
+static const char *pattern_name(const struct pattern_details *pat,
+                                char *buf, size_t len);
+
+static int pattern_initialize(struct details *d,
+                              struct pattern_details *pat);
+
+static int pattern_finalize(struct details *d);
+
 static int field_initialize(struct details *d, struct field_details *f);
 
 static int plane_initialize(struct details *d, struct plane_details *p);
 
 static int line_initialize( struct details *d, struct line_details  *l);
 
-static void* malloc_and_fill(struct details *d, const long bytes);
+static void* malloc_and_fill(struct details *d, const long bytes,
+                             int nproblems, int ncomponents,
+                             const int global[3],
+                             const int start[3],
+                             const int local[3]);
+
+static double uniform(void);
+
+static double spectrum(double k, double kp, double kd);
+
+static void turbulence(const int global[3],
+                       const int start[3],
+                       const int local[3],
+                       int ncomponents,
+                       double *values);
 
 static int field_finalize(struct details *d, struct field_details *f);
 
@@ -168,6 +227,24 @@ static const char doc[]               =
 "then renamed to match DESTTEMPLATE.  Timing information is collected "
 "over one or more iterations.\n"
 "\n"
+"Option --file-pattern accepts a comma-separated list drawn from 'shared', "
+"'node', 'group=G', and 'rank'.  Each pattern is benchmarked in turn by "
+"splitting MPI_COMM_WORLD into sub-communicators, each with its own ESIO "
+"handle writing its own file named by suffixing FILENAME (and "
+"DESTTEMPLATE) with '.' and the file's index.  Sizes given by "
+"--*-memory keep per-rank memory fixed across patterns while sizes given "
+"by --*-global apply to every file.  The aggregate transfer rate and "
+"the mean file creation and closing costs are then summarized side by "
+"side.\n"
+"\n"
+"Option --fill selects the data written.  By default each value is an "
+"integer drawn by random(), differing by rank, as in earlier releases.  "
+"Random data is uniform on [0, 1) and differs by rank.  Turbulence data sums random-phase Fourier modes "
+"whose amplitudes follow a model energy spectrum with a -5/3 inertial "
+"range.  It is periodic and coherent across ranks, so its entropy "
+"resembles simulation output for compression or hashing studies.  "
+"Option --seed changes any random sequence reproducibly.\n"
+"\n"
 "Options taking a 'bytes' parameter can be given common byte-related "
 "units.  For example --field-memory=5G indicates that approximately "
 "5 gigabytes of memory should be used on each rank to store field data. "
@@ -185,7 +262,10 @@ enum {
     LINE_NCOMPONENTS,
     NFIELDS,
     NPLANES,
-    NLINES
+    NLINES,
+    FILE_PATTERN,
+    FILL,
+    SEED
 };
 
 static struct argp_option options[] = {
@@ -220,11 +300,19 @@ static struct argp_option options[] = {
      "Changing the type of data written", 0 },
     {"single",      's', 0,       0, "write single-precision data", 0 },
     {"double",      'd', 0,       0, "write double-precision data", 0 },
+    {"fill",        FILL, "kind", 0,
+            "integer (default), constant, random, or turbulence data", 0 },
+    {"seed",        SEED, "value", 0,
+            "random seed offset by each rank for random data", 0 },
     {0, 0, 0, 0,
      "Controlling parallel decomposition per MPI_Dims_create semantics", 0 },
     {"field-dims", 'F', "NCxNBxNA", 0, "field parallel decomposition",   0 },
     {"plane-dims", 'P', "NBxNA",    0, "plane parallel decomposition",   0 },
     {"line-dims",  'L', "NA",       0, "line parallel decomposition",    0 },
+    {0, 0, 0, 0,
+     "Controlling how ranks share files", 0 },
+    {"file-pattern", FILE_PATTERN, "list", 0,
+            "shared, node, group=G, and/or rank (default shared)", 0 },
     { 0, 0, 0, 0,  0, 0 }
 };
 
@@ -525,6 +613,36 @@ parse_opt(int key, char *arg, struct argp_state *state)
             d->nplanes = max(d->nplanes, 1); // Set nplanes >= 1
             break;
 
+        case FILL:
+            if        (0 == strcmp(arg ? arg : "", "integer")) {
+                d->fill = FILL_INTEGER;
+            } else if (0 == strcmp(arg ? arg : "", "constant")) {
+                d->fill = FILL_CONSTANT;
+            } else if (0 == strcmp(arg ? arg : "", "random")) {
+                d->fill = FILL_RANDOM;
+            } else if (0 == strcmp(arg ? arg : "", "turbulence")) {
+                d->fill = FILL_TURBULENCE;
+            } else {
+                argp_failure(state, EX_USAGE, 0,
+                        "fill option is malformed: '%s'", arg);
+            }
+            break;
+
+        case SEED:
+            errno = 0;
+            if (1 != sscanf(arg ? arg : "", "%u %c", &d->seed, &ignore)) {
+                argp_failure(state, EX_USAGE, errno,
+                        "seed option is malformed: '%s'", arg);
+            }
+            break;
+
+        case FILE_PATTERN:
+            if (parse_patterns(d, arg)) {
+                argp_failure(state, EX_USAGE, 0,
+                        "file-pattern option is malformed: '%s'", arg);
+            }
+            break;
+
         case LINE_GLOBAL:
             if (d->l->bytes) {
                 argp_error(state, "only one of --line-{memory,global}"
@@ -569,6 +687,7 @@ int main(int argc, char *argv[])
     struct plane_details p;  memset(&p, 0, sizeof(struct plane_details));
     struct line_details  l;  memset(&l, 0, sizeof(struct line_details));
     d.typesize = sizeof(double);
+    d.comm = MPI_COMM_NULL;
     d.repeat = 1;
     d.retain = 1;
     f.ncomponents = p.ncomponents = l.ncomponents = 1;
@@ -606,13 +725,16 @@ int main(int argc, char *argv[])
     }
     fprintf(rankout, "\n");
 
-    // Initialize ESIO handle
-    d.h = esio_handle_initialize(MPI_COMM_WORLD);
+    // Benchmark all ranks writing one shared file unless told otherwise
+    if (d.npatterns == 0) {
+        d.pattern[0].kind = PATTERN_SHARED;
+        d.npatterns = 1;
+    }
 
-    // Initialize the field, plane, and line problems
-    if (d.nfields) field_initialize(&d, &f);
-    if (d.nplanes) plane_initialize(&d, &p);
-    if (d.nlines)  line_initialize( &d, &l);
+    // Problems are recomputed for each pattern from these specifications
+    const struct field_details f_spec = f;
+    const struct plane_details p_spec = p;
+    const struct line_details  l_spec = l;
 
     // Prepare scratch space to hold names for fields, planes, and lines
     char  *names   = NULL;
@@ -632,24 +754,6 @@ int main(int argc, char *argv[])
         }
     }
 
-    // Determine combined size of problem across all ranks
-    long localbytes = f.bytes + p.bytes + l.bytes;
-    long globalbytes;
-    ESIO_MPICHKQ(MPI_Allreduce(&localbytes, &globalbytes, 1,
-                               MPI_LONG, MPI_SUM, MPI_COMM_WORLD));
-    {
-        double coeff;
-        const char *units;
-        to_human_readable_byte_count(globalbytes, 0, &coeff, &units);
-        fprintf(rankout, "Global overall problem size is %.3f %s\n",
-                coeff, units);
-    }
-
-    fprintf(rankout, "Allocating and filling required memory buffers\n");
-    if (d.nfields) f.data = malloc_and_fill(&d, f.bytes);
-    if (d.nplanes) p.data = malloc_and_fill(&d, p.bytes);
-    if (d.nlines)  l.data = malloc_and_fill(&d, l.bytes);
-
     // Determine which functions to invoke below based on d.typesize
     int (*p_esio_field_writev)(const esio_handle, const char *,
                                const void *, int, int, int, int,
@@ -678,99 +782,201 @@ int main(int argc, char *argv[])
             MPI_Abort(MPI_COMM_WORLD, 1); // Sanity failure
     }
 
-    fprintf(rankout, "Beginning benchmark...\n");
-    ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
-    const double start = MPI_Wtime();
-
-    char *n;
-    GRVY_TIMER_RESET();
-    for (int i = 0; i < d.repeat; ++i) {
-        fprintf(rankout, "\tIteration %d\n", i);
-
-        GRVY_TIMER_BEGIN("esio_file_create");
-        esio_file_create(d.h, d.uncommitted, 1 /*overwrite*/);
-        GRVY_TIMER_END("esio_file_create");
+    for (int k = 0; k < d.npatterns; ++k) {
+        struct pattern_details *pat = &d.pattern[k];
+        f = f_spec;
+        p = p_spec;
+        l = l_spec;
+
+        // Split ranks by the files they write and initialize ESIO handle
+        pattern_initialize(&d, pat);
+        d.h = esio_handle_initialize(d.comm);
+
+        // Initialize the field, plane, and line problems
+        if (d.nfields) field_initialize(&d, &f);
+        if (d.nplanes) plane_initialize(&d, &p);
+        if (d.nlines)  line_initialize( &d, &l);
+
+        // Determine combined size of problem across all ranks
+        long localbytes = f.bytes + p.bytes + l.bytes;
+        long globalbytes;
+        ESIO_MPICHKQ(MPI_Allreduce(&localbytes, &globalbytes, 1,
+                                   MPI_LONG, MPI_SUM, MPI_COMM_WORLD));
+        {
+            double coeff;
+            const char *units;
+            to_human_readable_byte_count(globalbytes, 0, &coeff, &units);
+            fprintf(rankout, "Global overall problem size is %.3f %s\n",
+                    coeff, units);
+        }
 
+        fprintf(rankout, "Allocating and filling required memory buffers\n");
         if (d.nfields) {
-            GRVY_TIMER_BEGIN("esio_field_write");
-            n = names;
-            for (int j = 0; j < d.nfields; ++j) {
-                *n = 'f';
-                p_esio_field_writev(d.h, n,
-                        f.data + j * f.stride, 0, 0, 0, f.ncomponents, NULL);
-                n += namelen;
-            }
-            GRVY_TIMER_END("esio_field_write");
+            const int global[3] = { f.cglobal, f.bglobal, f.aglobal };
+            const int start[3]  = { f.cstart,  f.bstart,  f.astart  };
+            const int local[3]  = { f.clocal,  f.blocal,  f.alocal  };
+            f.data = malloc_and_fill(&d, f.bytes, d.nfields, f.ncomponents,
+                                     global, start, local);
         }
-
         if (d.nplanes) {
-            GRVY_TIMER_BEGIN("esio_plane_write");
-            n = names;
-            for (int j = 0; j < d.nplanes; ++j) {
-                *n = 'p';
-                p_esio_plane_writev(d.h, n,
-                        p.data + j * p.stride, 0, 0, p.ncomponents, NULL);
-                n += namelen;
-            }
-            GRVY_TIMER_END("esio_plane_write");
+            const int global[3] = { 1, p.bglobal, p.aglobal };
+            const int start[3]  = { 0, p.bstart,  p.astart  };
+            const int local[3]  = { 1, p.blocal,  p.alocal  };
+            p.data = malloc_and_fill(&d, p.bytes, d.nplanes, p.ncomponents,
+                                     global, start, local);
         }
-
         if (d.nlines) {
-            GRVY_TIMER_BEGIN("esio_line_write");
-            n = names;
-            for (int j = 0; j < d.nlines; ++j) {
-                *n = 'l';
-                p_esio_line_writev(d.h, n,
-                        l.data + j * l.stride, 0, l.ncomponents, NULL);
-                n += namelen;
+            const int global[3] = { 1, 1, l.aglobal };
+            const int start[3]  = { 0, 0, l.astart  };
+            const int local[3]  = { 1, 1, l.alocal  };
+            l.data = malloc_and_fill(&d, l.bytes, d.nlines, l.ncomponents,
+                                     global, start, local);
+        }
+
+        // Files written concurrently are distinguished by a suffix
+        char *uncommitted  = d.uncommitted;
+        char *dst_template = d.dst_template;
+        if (pat->kind != PATTERN_SHARED) {
+            uncommitted = malloc(strlen(d.uncommitted) + 16);
+            assert(uncommitted);
+            sprintf(uncommitted, "%s.%d", d.uncommitted, d.file_index);
+            if (d.dst_template) {
+                dst_template = malloc(strlen(d.dst_template) + 16);
+                assert(dst_template);
+                sprintf(dst_template, "%s.%d", d.dst_template, d.file_index);
             }
-            GRVY_TIMER_END("esio_line_write");
         }
 
-        GRVY_TIMER_BEGIN("esio_file_flush");
-        esio_file_flush(d.h);
-        GRVY_TIMER_END("esio_file_flush");
+        fprintf(rankout, "Beginning benchmark...\n");
+        ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+        const double start = MPI_Wtime();
+
+        char *n;
+        double t, tcreate = 0, tclose = 0;
+        GRVY_TIMER_RESET();
+        for (int i = 0; i < d.repeat; ++i) {
+            fprintf(rankout, "\tIteration %d\n", i);
+
+            GRVY_TIMER_BEGIN("esio_file_create");
+            t = MPI_Wtime();
+            esio_file_create(d.h, uncommitted, 1 /*overwrite*/);
+            tcreate += MPI_Wtime() - t;
+            GRVY_TIMER_END("esio_file_create");
+
+            if (d.nfields) {
+                GRVY_TIMER_BEGIN("esio_field_write");
+                n = names;
+                for (int j = 0; j < d.nfields; ++j) {
+                    *n = 'f';
+                    p_esio_field_writev(d.h, n, f.data + j * f.stride,
+                                        0, 0, 0, f.ncomponents, NULL);
+                    n += namelen;
+                }
+                GRVY_TIMER_END("esio_field_write");
+            }
 
-        if (d.dst_template) {
-            GRVY_TIMER_BEGIN("esio_file_close_restart");
-            esio_file_close_restart(d.h, d.dst_template, d.retain);
-            GRVY_TIMER_END("esio_file_close_restart");
-        } else {
-            GRVY_TIMER_BEGIN("esio_file_close");
-            esio_file_close(d.h);
-            GRVY_TIMER_END("esio_file_close");
+            if (d.nplanes) {
+                GRVY_TIMER_BEGIN("esio_plane_write");
+                n = names;
+                for (int j = 0; j < d.nplanes; ++j) {
+                    *n = 'p';
+                    p_esio_plane_writev(d.h, n, p.data + j * p.stride,
+                                        0, 0, p.ncomponents, NULL);
+                    n += namelen;
+                }
+                GRVY_TIMER_END("esio_plane_write");
+            }
+
+            if (d.nlines) {
+                GRVY_TIMER_BEGIN("esio_line_write");
+                n = names;
+                for (int j = 0; j < d.nlines; ++j) {
+                    *n = 'l';
+                    p_esio_line_writev(d.h, n, l.data + j * l.stride,
+                                       0, l.ncomponents, NULL);
+                    n += namelen;
+                }
+                GRVY_TIMER_END("esio_line_write");
+            }
+
+            GRVY_TIMER_BEGIN("esio_file_flush");
+            esio_file_flush(d.h);
+            GRVY_TIMER_END("esio_file_flush");
+
+            t = MPI_Wtime();
+            if (dst_template) {
+                GRVY_TIMER_BEGIN("esio_file_close_restart");
+                esio_file_close_restart(d.h, dst_template, d.retain);
+                GRVY_TIMER_END("esio_file_close_restart");
+            } else {
+                GRVY_TIMER_BEGIN("esio_file_close");
+                esio_file_close(d.h);
+                GRVY_TIMER_END("esio_file_close");
+            }
+            tclose += MPI_Wtime() - t;
+        }
+        GRVY_TIMER_FINALIZE();
+
+        const double end = MPI_Wtime();
+        ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+        fprintf(rankout, "Ending benchmark...\n");
+
+        const double elapsed = end - start;
+        const double mean = elapsed / d.repeat;
+        {
+            double coeff;
+            const char *units;
+            to_human_readable_byte_count(
+                    floor(globalbytes / mean), 0, &coeff, &units);
+            fprintf(rankout,
+                "Mean global transfer rate across %d iteration(s) was"
+                " %.4f %s/s\n", d.repeat, coeff, units);
         }
-    }
-    GRVY_TIMER_FINALIZE();
 
-    const double end = MPI_Wtime();
-    ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
-    fprintf(rankout, "Ending benchmark...\n");
+        // Metadata costs are those of the slowest rank
+        double tmeta[2] = { tcreate / d.repeat, tclose / d.repeat };
+        ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, tmeta, 2, MPI_DOUBLE,
+                                   MPI_MAX, MPI_COMM_WORLD));
+        pat->rate   = globalbytes / mean;
+        pat->create = tmeta[0];
+        pat->close  = tmeta[1];
+
+        // TODO Get timing information back from multiple ranks
+        if (d.world_rank == 0) {
+            GRVY_TIMER_SUMMARIZE();
+        }
 
-    const double elapsed = end - start;
-    const double mean = elapsed / d.repeat;
-    {
-        double coeff;
-        const char *units;
-        to_human_readable_byte_count(
-                floor(globalbytes / mean), 0, &coeff, &units);
-        fprintf(rankout,
-            "Mean global transfer rate across %d iteration(s) was %.4f %s/s\n",
-            d.repeat, coeff, units);
-    }
+        if (uncommitted  != d.uncommitted)  free(uncommitted);
+        if (dst_template != d.dst_template) free(dst_template);
 
-    // TODO Get timing information back from multiple ranks
-    if (d.world_rank == 0) {
-        GRVY_TIMER_SUMMARIZE();
+        // Finalize the field, plane, and line problems
+        if (d.nfields) field_finalize(&d, &f);
+        if (d.nplanes) plane_finalize(&d, &p);
+        if (d.nlines)  line_finalize( &d, &l);
+
+        // Finalize ESIO handle and the pattern's communicator
+        esio_handle_finalize(d.h);
+        pattern_finalize(&d);
     }
 
-    // Finalize the field, plane, and line problems
-    if (d.nfields) field_finalize(&d, &f);
-    if (d.nplanes) plane_finalize(&d, &p);
-    if (d.nlines)  line_finalize( &d, &l);
+    // Report all patterns side by side when more than one was requested
+    if (d.npatterns > 1) {
+        char buf[32];
+        fprintf(rankout, "\n%-12s %6s %16s %12s %12s\n",
+                "Pattern", "Files", "Rate", "Create (s)", "Close (s)");
+        for (int k = 0; k < d.npatterns; ++k) {
+            const struct pattern_details *pat = &d.pattern[k];
+            double coeff;
+            const char *units;
+            to_human_readable_byte_count(
+                    floor(pat->rate), 0, &coeff, &units);
+            fprintf(rankout, "%-12s %6d %10.4f %3s/s %12.6f %12.6f\n",
+                    pattern_name(pat, buf, sizeof(buf)), pat->nfiles,
+                    coeff, units, pat->create, pat->close);
+        }
+    }
 
-    // Finalize ESIO handle
-    esio_handle_finalize(d.h);
+    free(names);
 
     return 0;
 }
@@ -943,6 +1149,110 @@ static int global_minmax(long val, long *min, long *max)
 }
 
 
+// Parse a comma-separated list of file patterns into d->pattern.
+// Returns nonzero on malformed input.
+static int parse_patterns(struct details *d, char *arg)
+{
+    d->npatterns = 0;
+    for (char *tok = strtok(arg, ","); tok; tok = strtok(NULL, ",")) {
+        trim(tok);
+        if (d->npatterns == MAX_PATTERNS) return 1;
+        struct pattern_details *pat = &d->pattern[d->npatterns++];
+        memset(pat, 0, sizeof(struct pattern_details));
+        char ignore = '\0';
+        if        (0 == strcmp(tok, "shared")) {
+            pat->kind = PATTERN_SHARED;
+        } else if (0 == strcmp(tok, "node")) {
+            pat->kind = PATTERN_NODE;
+        } else if (0 == strcmp(tok, "rank")) {
+            pat->kind = PATTERN_RANK;
+        } else if (1 == sscanf(tok, "group = %d %c", &pat->ngroups, &ignore)
+                   && pat->ngroups > 0) {
+            pat->kind = PATTERN_GROUP;
+        } else {
+            return 1;
+        }
+    }
+    return d->npatterns == 0;
+}
+
+
+static const char *pattern_name(const struct pattern_details *pat,
+                                char *buf, size_t len)
+{
+    switch (pat->kind) {
+        case PATTERN_SHARED: snprintf(buf, len, "shared");   break;
+        case PATTERN_NODE:   snprintf(buf, len, "node");     break;
+        case PATTERN_RANK:   snprintf(buf, len, "rank");     break;
+        case PATTERN_GROUP:  snprintf(buf, len, "group=%d", pat->ngroups);
+                             break;
+        default:             snprintf(buf, len, "unknown");  break;
+    }
+    return buf;
+}
+
+
+// Split MPI_COMM_WORLD into the ranks writing each file under a pattern.
+// Files are numbered in order of their lowest world rank.
+static int pattern_initialize(struct details *d, struct pattern_details *pat)
+{
+    char buf[32];
+    fprintf(rankout, "Using file pattern %s\n",
+            pattern_name(pat, buf, sizeof(buf)));
+
+    switch (pat->kind) {
+        case PATTERN_SHARED:
+            ESIO_MPICHKQ(MPI_Comm_dup(MPI_COMM_WORLD, &d->comm));
+            break;
+        case PATTERN_NODE:
+            ESIO_MPICHKQ(MPI_Comm_split_type(MPI_COMM_WORLD,
+                        MPI_COMM_TYPE_SHARED, d->world_rank,
+                        MPI_INFO_NULL, &d->comm));
+            break;
+        case PATTERN_GROUP: {
+            const int ngroups = min(pat->ngroups, d->world_size);
+            const int color = (int) (((long) d->world_rank * ngroups)
+                                     / d->world_size);
+            ESIO_MPICHKQ(MPI_Comm_split(MPI_COMM_WORLD, color,
+                                        d->world_rank, &d->comm));
+            break;
+        }
+        case PATTERN_RANK:
+            ESIO_MPICHKQ(MPI_Comm_dup(MPI_COMM_SELF, &d->comm));
+            break;
+        default:
+            MPI_Abort(MPI_COMM_WORLD, 1); // Sanity failure
+    }
+    ESIO_MPICHKQ(MPI_Comm_rank(d->comm, &d->comm_rank));
+    ESIO_MPICHKQ(MPI_Comm_size(d->comm, &d->comm_size));
+
+    // Each file's lowest rank determines its index and the file count
+    int leader = (d->comm_rank == 0);
+    d->file_index = 0;
+    ESIO_MPICHKQ(MPI_Exscan(&leader, &d->file_index, 1, MPI_INT,
+                            MPI_SUM, MPI_COMM_WORLD));
+    if (d->world_rank == 0) d->file_index = 0; // Exscan leaves undefined
+    ESIO_MPICHKQ(MPI_Bcast(&d->file_index, 1, MPI_INT, 0, d->comm));
+    ESIO_MPICHKQ(MPI_Allreduce(&leader, &pat->nfiles, 1, MPI_INT,
+                               MPI_SUM, MPI_COMM_WORLD));
+
+    fprintf(rankout, "\tWriting %d file(s) concurrently\n", pat->nfiles);
+
+    return ESIO_SUCCESS;
+}
+
+
+static int pattern_finalize(struct details *d)
+{
+    if (d->comm != MPI_COMM_NULL) {
+        ESIO_MPICHKQ(MPI_Comm_free(&d->comm));
+    }
+    d->comm = MPI_COMM_NULL;
+
+    return ESIO_SUCCESS;
+}
+
+
 static int field_initialize(struct details *d, struct field_details *f)
 {
     double coeff;
@@ -951,11 +1261,11 @@ static int field_initialize(struct details *d, struct field_details *f)
     fprintf(rankout, "Initializing field problem...\n");
 
     // Use MPI (temporarily) to find topology for field problem
-    ESIO_MPICHKQ(MPI_Dims_create(d->world_size, 3, f->dims));
+    ESIO_MPICHKQ(MPI_Dims_create(d->comm_size, 3, f->dims));
     MPI_Comm tmp;
     int periods[3] = { 0, 0, 0 };
     ESIO_MPICHKQ(MPI_Cart_create(
-                MPI_COMM_WORLD, 3, f->dims, periods, 0, &tmp));
+                d->comm, 3, f->dims, periods, 0, &tmp));
     ESIO_MPICHKQ(MPI_Comm_rank(tmp, &f->rank));
     ESIO_MPICHKQ(MPI_Cart_coords(tmp, f->rank, 3, f->coords));
     ESIO_MPICHKQ(MPI_Comm_free(&tmp));
@@ -966,7 +1276,7 @@ static int field_initialize(struct details *d, struct field_details *f)
 
     // Compute global problem size, if necessary, from memory constraint
     if (f->bytes) {
-        const double nvectors = (f->bytes * d->world_size)
+        const double nvectors = (f->bytes * d->comm_size)
                               / ((double) f->ncomponents * d->typesize)
                               / ((double) d->nfields);
         f->cglobal = f->bglobal = f->aglobal = ceil(cbrt(nvectors));
@@ -1050,11 +1360,11 @@ static int plane_initialize(struct details *d, struct plane_details *p)
     fprintf(rankout, "Initializing plane problem...\n");
 
     // Use MPI (temporarily) to find topology for field problem
-    ESIO_MPICHKQ(MPI_Dims_create(d->world_size, 2, p->dims));
+    ESIO_MPICHKQ(MPI_Dims_create(d->comm_size, 2, p->dims));
     MPI_Comm tmp;
     int periods[2] = { 0, 0 };
     ESIO_MPICHKQ(MPI_Cart_create(
-                MPI_COMM_WORLD, 2, p->dims, periods, 0, &tmp));
+                d->comm, 2, p->dims, periods, 0, &tmp));
     ESIO_MPICHKQ(MPI_Comm_rank(tmp, &p->rank));
     ESIO_MPICHKQ(MPI_Cart_coords(tmp, p->rank, 2, p->coords));
     ESIO_MPICHKQ(MPI_Comm_free(&tmp));
@@ -1064,7 +1374,7 @@ static int plane_initialize(struct details *d, struct plane_details *p)
 
     // Compute global problem size, if necessary, from memory constraint
     if (p->bytes) {
-        const double nvectors = (p->bytes * d->world_size)
+        const double nvectors = (p->bytes * d->comm_size)
                               / ((double) p->ncomponents * d->typesize)
                               / ((double) d->nplanes);
         p->bglobal = p->aglobal = ceil(sqrt(nvectors));
@@ -1139,11 +1449,11 @@ static int line_initialize(struct details *d, struct line_details  *l)
     fprintf(rankout, "Initializing line problem...\n");
 
     // Use MPI (temporarily) to find topology for field problem
-    ESIO_MPICHKQ(MPI_Dims_create(d->world_size, 1, l->dims));
+    ESIO_MPICHKQ(MPI_Dims_create(d->comm_size, 1, l->dims));
     MPI_Comm tmp;
     int periods[1] = { 0 };
     ESIO_MPICHKQ(MPI_Cart_create(
-                MPI_COMM_WORLD, 1, l->dims, periods, 0, &tmp));
+                d->comm, 1, l->dims, periods, 0, &tmp));
     ESIO_MPICHKQ(MPI_Comm_rank(tmp, &l->rank));
     ESIO_MPICHKQ(MPI_Cart_coords(tmp, l->rank, 1, l->coords));
     ESIO_MPICHKQ(MPI_Comm_free(&tmp));
@@ -1153,7 +1463,7 @@ static int line_initialize(struct details *d, struct line_details  *l)
 
     // Compute global problem size, if necessary, from memory constraint
     if (l->bytes) {
-        const double nvectors = (l->bytes * d->world_size)
+        const double nvectors = (l->bytes * d->comm_size)
                               / ((double) l->ncomponents * d->typesize)
                               / ((double) d->nlines);
         l->aglobal = ceil(nvectors);
@@ -1216,7 +1526,11 @@ static int line_initialize(struct details *d, struct line_details  *l)
 }
 
 
-static void* malloc_and_fill(struct details *d, const long bytes)
+static void* malloc_and_fill(struct details *d, const long bytes,
+                             int nproblems, int ncomponents,
+                             const int global[3],
+                             const int start[3],
+                             const int local[3])
 {
     // Malloc
     void *p = malloc(bytes);
@@ -1229,24 +1543,57 @@ static void* malloc_and_fill(struct details *d, const long bytes)
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
-    // Store previous random seed and provide a new one
+    // Store previous random seed and provide a new one.
+    // Integer and uniform data differ by rank while turbulence is coherent
+    // across ranks so that every rank seeds identically.
     char state[64];
-    initstate(d->world_rank, state, sizeof(state)/sizeof(state[0]));
+    initstate(d->fill == FILL_TURBULENCE ? d->seed : d->seed + d->world_rank,
+              state, sizeof(state)/sizeof(state[0]));
     char *previous = setstate(state);
 
-    // Fill
-    const size_t count = bytes / d->typesize;
-    switch (d->typesize)
-    {
-        case sizeof(double):
-            for (size_t i = 0; i < count; ++i)
-                ((double *) p)[i] = (double) random();
-            break;
-        case sizeof(float):
-            for (size_t i = 0; i < count; ++i)
-                ((float *) p)[i] = (float) random();
-            break;
+    // Fill each problem's block of components one value at a time
+    const size_t nlocal = (size_t) local[0] * local[1] * local[2];
+    const size_t count  = nlocal * ncomponents;
+    double *values = malloc(count * sizeof(double));
+    if (!values) {
+        fprintf(stderr, "Unable to malloc fill buffer on rank %d\n",
+                d->world_rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (int j = 0; j < nproblems; ++j) {
+        switch (d->fill) {
+            case FILL_INTEGER:
+                for (size_t i = 0; i < count; ++i) {
+                    values[i] = (double) random();
+                }
+                break;
+            case FILL_CONSTANT:
+                for (size_t i = 0; i < count; ++i) values[i] = 1;
+                break;
+            case FILL_RANDOM:
+                for (size_t i = 0; i < count; ++i) values[i] = uniform();
+                break;
+            case FILL_TURBULENCE:
+                for (int m = 0; m < ncomponents; ++m) {
+                    turbulence(global, start, local, ncomponents,
+                               values + m);
+                }
+                break;
+        }
+
+        char *dst = (char *) p + j * count * d->typesize;
+        switch (d->typesize)
+        {
+            case sizeof(double):
+                memcpy(dst, values, count * sizeof(double));
+                break;
+            case sizeof(float):
+                for (size_t i = 0; i < count; ++i)
+                    ((float *) dst)[i] = (float) values[i];
+                break;
+        }
     }
+    free(values);
 
     // Restore previous random state
     setstate(previous);
@@ -1255,6 +1602,117 @@ static void* malloc_and_fill(struct details *d, const long bytes)
 }
 
 
+// Draw a uniform deviate on [0, 1) using 53 random bits
+static double uniform(void)
+{
+    const uint64_t hi = (uint64_t) random() & ((UINT64_C(1) << 31) - 1);
+    const uint64_t lo = (uint64_t) random() & ((UINT64_C(1) << 22) - 1);
+    return ldexp((double) ((hi << 22) | lo), -53);
+}
+
+
+// Model energy spectrum with an energy-containing peak near wavenumber kp,
+// a Kolmogorov -5/3 inertial range, and an exponential dissipation range
+// beyond wavenumber kd as in a well-resolved simulation.
+static double spectrum(double k, double kp, double kd)
+{
+    const double r = k / kp;
+    return pow(r, 4) / pow(1 + r*r, 17.0/6.0) * exp(-k / kd);
+}
+
+
+// Store into every ncomponents-th element of values one component of a
+// periodic, random-phase velocity-like field over the local block.  The
+// field is a sum of TURBULENCE_NMODES Fourier modes, logarithmically spaced
+// in wavenumber with random orientations and phases, whose amplitudes
+// follow spectrum().  Mode details depend only on the random state, so
+// ranks agree on the field whenever they are seeded identically.
+static void turbulence(const int global[3],
+                       const int start[3],
+                       const int local[3],
+                       int ncomponents,
+                       double *values)
+{
+    // Determine resolvable wavenumber range across nontrivial directions
+    int nmin = 0;
+    for (int x = 0; x < 3; ++x) {
+        if (global[x] > 1 && (nmin == 0 || global[x] < nmin)) nmin = global[x];
+    }
+    const double kmax = nmin > 2 ? nmin / 2 : 1;
+    const double kp   = kmax > 8 ? kmax / 8 : 1;
+    const double ratio = pow(kmax, 1.0 / TURBULENCE_NMODES);
+
+    // Tabulate each mode's phase factors along each local direction
+    const int n = local[0] + local[1] + local[2];
+    double *re = calloc((size_t) TURBULENCE_NMODES * n, sizeof(double));
+    double *im = calloc((size_t) TURBULENCE_NMODES * n, sizeof(double));
+    double amplitude[TURBULENCE_NMODES];
+    if (!re || !im) {
+        fprintf(stderr, "Unable to malloc turbulence phase tables\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    for (int m = 0; m < TURBULENCE_NMODES; ++m) {
+        // Random direction on the sphere restricted to nontrivial extents
+        double dir[3], norm = 0;
+        do {
+            norm = 0;
+            for (int x = 0; x < 3; ++x) {
+                dir[x] = global[x] > 1 ? 2 * uniform() - 1 : 0;
+                norm  += dir[x] * dir[x];
+            }
+        } while (norm > 1 || norm == 0);
+
+        // Integral wavevector ensures periodicity over the global extents
+        const double k = pow(ratio, m + uniform());
+        int kv[3];
+        double kmag = 0;
+        for (int x = 0; x < 3; ++x) {
+            kv[x] = (int) lround(k * dir[x] / sqrt(norm));
+            kmag += (double) kv[x] * kv[x];
+        }
+        kmag = sqrt(kmag);
+        const double dk = k * (ratio - 1);
+        amplitude[m] = kmag > 0
+                     ? sqrt(2 * spectrum(kmag, kp, kmax / 4) * dk)
+                     : 0;
+        const double phase = 2 * M_PI * uniform();
+
+        // Phase factors, with the random phase folded into direction zero
+        double *r = re + (size_t) m * n, *i = im + (size_t) m * n;
+        for (int x = 0; x < 3; ++x) {
+            for (int l = 0; l < local[x]; ++l) {
+                const double theta = 2 * M_PI * kv[x] * (start[x] + l)
+                                   / global[x] + (x == 0 ? phase : 0);
+                *r++ = cos(theta);
+                *i++ = sin(theta);
+            }
+        }
+    }
+
+    // Evaluate the real part of the mode sum at every local point
+    for (int c = 0; c < local[0]; ++c) {
+        for (int b = 0; b < local[1]; ++b) {
+            for (int a = 0; a < local[2]; ++a) {
+                double sum = 0;
+                for (int m = 0; m < TURBULENCE_NMODES; ++m) {
+                    const double *r = re + (size_t) m * n;
+                    const double *i = im + (size_t) m * n;
+                    const int ib = local[0] + b, ia = local[0] + local[1] + a;
+                    const double zr = r[c]*r[ib] - i[c]*i[ib];
+                    const double zi = r[c]*i[ib] + i[c]*r[ib];
+                    sum += amplitude[m] * (zr*r[ia] - zi*i[ia]);
+                }
+                *values = sum;
+                values += ncomponents;
+            }
+        }
+    }
+
+    free(im);
+    free(re);
+}
+
+
 static int field_finalize(struct details *d, struct field_details *f)
 {
     (void) d; // Unused
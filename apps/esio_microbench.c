@@ -0,0 +1,563 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+
+#include "argp.h"
+#include "mpi_argp.h"
+
+#include <hdf5.h>
+#include <mpi.h>
+#include <esio/error.h>
+#include <esio/esio.h>
+#include <esio/layout.h>
+#include <esio/metadata.h>
+#include <esio/precision.h>
+#include <esio/restart-rename.h>
+
+// Microbenchmarks for ESIO's CPU-side internals.  Every kernel runs against
+// an in-memory HDF5 file (the core driver without a backing store) so that
+// timings reflect selection building, packing, type conversion, and
+// metadata handling rather than filesystem behavior.
+
+//****************************************************************
+// DATA STRUCTURES DATA STRUCTURES DATA STRUCTURES DATA STRUCTURES
+//****************************************************************
+
+struct details {
+    double mintime;      // Minimum seconds to spend measuring each case
+    int    extent;       // Local extent in each direction for field cases
+    char  *filter;       // Only run cases whose names contain this string
+    hid_t  file_id;      // In-memory file used by all cases
+};
+
+// A benchmark case invokes kernel(state) repeatedly, each call touching
+// nelems elements.  Kernels return zero on success.
+typedef int (*kernel_t)(void *state);
+
+struct field_state {
+    int layout;
+    hid_t dset_id, type_id;
+    void *field;
+    int cglobal, cstart, clocal, cstride;
+    int bglobal, bstart, blocal, bstride;
+    int aglobal, astart, alocal, astride;
+};
+
+struct metadata_state {
+    hid_t file_id, type_id;
+    const char *name;
+};
+
+struct conversion_state {
+    size_t n;
+    float *f;
+    uint16_t *h;
+};
+
+struct nextindex_state {
+    const char *tmpl;
+    const char *name;
+};
+
+//*************************************************************
+// STATIC PROTOTYPES STATIC PROTOTYPES STATIC PROTOTYPES STATIC
+//*************************************************************
+
+static void print_version(FILE *stream, struct argp_state *state);
+
+static void trim(char *a);
+
+static void finalize(void);
+
+static int benchmark(struct details *d, int argc, char *argv[]);
+
+static void measure(const struct details *d, const char *name,
+                    size_t nelems, kernel_t kernel, void *state);
+
+static void field_cases(const struct details *d);
+
+static void metadata_cases(const struct details *d);
+
+static void conversion_cases(const struct details *d);
+
+static void nextindex_cases(const struct details *d);
+
+//*******************************************************************
+// ARGP DETAILS: http://www.gnu.org/s/libc/manual/html_node/Argp.html
+//*******************************************************************
+
+const char *argp_program_version      = "esio_microbench " PACKAGE_VERSION;
+void (*argp_program_version_hook)(FILE *stream, struct argp_state *state)
+                                      = &print_version;
+const char *argp_program_bug_address  = PACKAGE_BUGREPORT;
+static const char doc[]               =
+"Microbenchmark ESIO's internal kernels apart from filesystem noise."
+"\v"
+"Field layout selection building and packing, reduced precision "
+"conversion, metadata encoding and decoding, and restart template parsing "
+"are exercised on synthetic inputs "
+"against an in-memory HDF5 file.  Each case reports the mean cost per "
+"element and the number of kernel invocations per second.\n"
+;
+
+static struct argp_option options[] = {
+    {"min-time", 't', "seconds", 0, "minimum time spent per case", 0 },
+    {"extent",   'n', "count",   0, "local field extent per direction", 0 },
+    {"filter",   'f', "substr",  0, "run only cases containing substr", 0 },
+    { 0, 0, 0, 0,  0, 0 }
+};
+
+// Parse a single option following Argp semantics
+static error_t
+parse_opt(int key, char *arg, struct argp_state *state)
+{
+    // Get the input argument from argp_parse.
+    struct details *d = state->input;
+
+    // Trim any leading/trailing whitespace from arg
+    if (arg) trim(arg);
+
+    // Want to ensure we consume the entire argument for many options
+    // Many sscanf calls provide an extra sentinel %c dumping into &ignore
+    char ignore = '\0';
+
+    switch (key) {
+        case ARGP_KEY_ARG:
+            argp_usage(state);
+            break;
+
+        case 't':
+            errno = 0;
+            if (1 != sscanf(arg ? arg : "", "%lf %c", &d->mintime, &ignore)) {
+                argp_failure(state, EX_USAGE, errno,
+                        "min-time option is malformed: '%s'", arg);
+            }
+            if (d->mintime <= 0) {
+                argp_failure(state, EX_USAGE, 0,
+                        "min-time value %g must be strictly positive",
+                        d->mintime);
+            }
+            break;
+
+        case 'n':
+            errno = 0;
+            if (1 != sscanf(arg ? arg : "", "%d %c", &d->extent, &ignore)) {
+                argp_failure(state, EX_USAGE, errno,
+                        "extent option is malformed: '%s'", arg);
+            }
+            if (d->extent < 1) {
+                argp_failure(state, EX_USAGE, 0,
+                        "extent value %d must be strictly positive",
+                        d->extent);
+            }
+            break;
+
+        case 'f':
+            d->filter = arg;
+            break;
+
+        default:
+            return ARGP_ERR_UNKNOWN;
+    }
+    return 0;
+}
+
+static struct argp argp = { options, parse_opt, 0, doc, 0, 0, 0 };
+
+//***************************************************************
+// KERNELS KERNELS KERNELS KERNELS KERNELS KERNELS KERNELS KERNELS
+//***************************************************************
+
+static const struct {
+    esio_field_writer_t writer;
+    esio_field_reader_t reader;
+    esio_filespace_creator_t creator;
+} layouts[] = {
+    { &esio_field_layout0_field_writer, &esio_field_layout0_field_reader,
+      &esio_field_layout0_filespace_creator },
+    { &esio_field_layout1_field_writer, &esio_field_layout1_field_reader,
+      &esio_field_layout1_filespace_creator },
+    { &esio_field_layout2_field_writer, &esio_field_layout2_field_reader,
+      &esio_field_layout2_filespace_creator },
+    { &esio_field_layout3_field_writer, &esio_field_layout3_field_reader,
+      &esio_field_layout3_filespace_creator },
+};
+static const int nlayouts = sizeof(layouts)/sizeof(layouts[0]);
+
+static int field_write(void *state)
+{
+    struct field_state *s = state;
+    return layouts[s->layout].writer(H5P_DEFAULT, s->dset_id, s->field,
+            s->cglobal, s->cstart, s->clocal, s->cstride,
+            s->bglobal, s->bstart, s->blocal, s->bstride,
+            s->aglobal, s->astart, s->alocal, s->astride,
+            s->type_id);
+}
+
+static int field_read(void *state)
+{
+    struct field_state *s = state;
+    return layouts[s->layout].reader(H5P_DEFAULT, s->dset_id, s->field,
+            s->cglobal, s->cstart, s->clocal, s->cstride,
+            s->bglobal, s->bstart, s->blocal, s->bstride,
+            s->aglobal, s->astart, s->alocal, s->astride,
+            s->type_id);
+}
+
+static int field_metadata_roundtrip(void *state)
+{
+    struct metadata_state *s = state;
+    int layout_index, cglobal, bglobal, aglobal, ncomponents;
+    if (esio_field_metadata_write(s->file_id, s->name, 1, 4, 5, 6,
+                                  s->type_id)) return 1;
+    return esio_field_metadata_read(s->file_id, s->name, &layout_index,
+                                    &cglobal, &bglobal, &aglobal,
+                                    &ncomponents);
+}
+
+static int field_metadata_read(void *state)
+{
+    struct metadata_state *s = state;
+    int layout_index, cglobal, bglobal, aglobal, ncomponents;
+    return esio_field_metadata_read(s->file_id, s->name, &layout_index,
+                                    &cglobal, &bglobal, &aglobal,
+                                    &ncomponents);
+}
+
+static int plane_metadata_read(void *state)
+{
+    struct metadata_state *s = state;
+    int bglobal, aglobal, ncomponents;
+    return esio_plane_metadata_read(s->file_id, s->name,
+                                    &bglobal, &aglobal, &ncomponents);
+}
+
+static int line_metadata_read(void *state)
+{
+    struct metadata_state *s = state;
+    int aglobal, ncomponents;
+    return esio_line_metadata_read(s->file_id, s->name,
+                                   &aglobal, &ncomponents);
+}
+
+static int float_half(void *state)
+{
+    struct conversion_state *s = state;
+    esio_convert_float_half(s->f, s->h, s->n);
+    return 0;
+}
+
+static int half_float(void *state)
+{
+    struct conversion_state *s = state;
+    esio_convert_half_float(s->h, s->f, s->n);
+    return 0;
+}
+
+static int float_bfloat16(void *state)
+{
+    struct conversion_state *s = state;
+    esio_convert_float_bfloat16(s->f, s->h, s->n);
+    return 0;
+}
+
+static int bfloat16_float(void *state)
+{
+    struct conversion_state *s = state;
+    esio_convert_bfloat16_float(s->h, s->f, s->n);
+    return 0;
+}
+
+static int nextindex(void *state)
+{
+    struct nextindex_state *s = state;
+    return restart_nextindex(s->tmpl, s->name, -1) < 0;
+}
+
+//*****************************************************************
+// IMPLEMENTATION IMPLEMENTATION IMPLEMENTATION IMPLEMENTATION
+//*****************************************************************
+
+FILE *rankout = NULL;
+
+int main(int argc, char *argv[])
+{
+    // Initialize default argument storage and default values
+    struct details d;
+    memset(&d, 0, sizeof(struct details));
+    d.mintime = 0.1;
+    d.extent  = 32;
+
+    // Initialize/finalize MPI; only rank zero benchmarks.  Exits from
+    // within argp, e.g. after --help, finalize through atexit.
+    MPI_Init(&argc, &argv);
+    atexit(&finalize);
+    int world_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    rankout = world_rank == 0 ? stdout : fopen("/dev/null", "w");
+    if (!rankout) {
+        perror("Unable to open rank-dependent output streams"),
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    // Parse command line arguments using MPI-savvy argp extension
+    mpi_argp_parse(world_rank, &argp, argc, argv, 0, 0, &d);
+
+    // Every rank finalizes MPI once rank zero finishes
+    const int status = world_rank == 0 ? benchmark(&d, argc, argv)
+                                       : EXIT_SUCCESS;
+    MPI_Finalize();
+
+    return status;
+}
+
+int benchmark(struct details *d, int argc, char *argv[])
+{
+    // Create an in-memory file never written to disk
+    const hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+    if (fapl_id < 0 || H5Pset_fapl_core(fapl_id, 1 << 24, 0) < 0) {
+        fprintf(stderr, "Unable to configure HDF5 core driver\n");
+        return EXIT_FAILURE;
+    }
+    d->file_id = H5Fcreate("esio_microbench.h5", H5F_ACC_TRUNC,
+                           H5P_DEFAULT, fapl_id);
+    H5Pclose(fapl_id);
+    if (d->file_id < 0) {
+        fprintf(stderr, "Unable to create in-memory file\n");
+        return EXIT_FAILURE;
+    }
+
+    fprintf(rankout, "%s invoked as\n\t", argp_program_version);
+    for (int i = 0; i < argc; ++i) {
+        fprintf(rankout, " %s", argv[i]);
+    }
+    fprintf(rankout, "\n%-44s %12s %14s %12s\n",
+            "case", "elements", "calls/sec", "ns/element");
+
+    field_cases(d);
+    conversion_cases(d);
+    metadata_cases(d);
+    nextindex_cases(d);
+
+    H5Fclose(d->file_id);
+
+    return EXIT_SUCCESS;
+}
+
+void measure(const struct details *d, const char *name,
+             size_t nelems, kernel_t kernel, void *state)
+{
+    if (d->filter && !strstr(name, d->filter)) return;
+
+    // Warm up once then double the batch size until mintime is reached
+    if (kernel(state)) {
+        fprintf(rankout, "%-44s failed\n", name);
+        return;
+    }
+    long calls = 0, batch = 1;
+    double elapsed = 0;
+    const double begin = MPI_Wtime();
+    while (elapsed < d->mintime) {
+        for (long i = 0; i < batch; ++i) {
+            if (kernel(state)) {
+                fprintf(stderr, "%s failed after %ld calls\n",
+                        name, calls + i + 1);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        calls  += batch;
+        batch  *= 2;
+        elapsed = MPI_Wtime() - begin;
+    }
+
+    fprintf(rankout, "%-44s %12zu %14.1f %12.3f\n", name, nelems,
+            calls / elapsed, 1e9 * elapsed / ((double) calls * nelems));
+}
+
+void field_cases(const struct details *d)
+{
+    static const char *typenames[] = { "double", "float", "int" };
+    const hid_t type_ids[3] = {
+        H5T_NATIVE_DOUBLE, H5T_NATIVE_FLOAT, H5T_NATIVE_INT
+    };
+
+    // Decompositions: a cube within a larger domain, a thin slab spanning
+    // the domain in two directions, and a tiny block dominated by setup.
+    const int n = d->extent;
+    static const char *shapes[] = { "cube", "slab", "tiny" };
+    const int locals[3][3] = {
+        { n,     n,     n     },
+        { 1 + n / 8, 2 * n, 2 * n },
+        { 2,     2,     2     }
+    };
+
+    for (int t = 0; t < 3; ++t) {
+        const size_t type_size = H5Tget_size(type_ids[t]);
+        for (int s = 0; s < 3; ++s) {
+            for (int padded = 0; padded < 2; ++padded) {
+                struct field_state st;
+                memset(&st, 0, sizeof(st));
+                st.type_id = type_ids[t];
+                st.clocal  = locals[s][0];
+                st.blocal  = locals[s][1];
+                st.alocal  = locals[s][2];
+                st.cstart  = st.clocal / 2;
+                st.bstart  = st.blocal / 2;
+                st.astart  = st.alocal / 2;
+                st.cglobal = 2 * st.clocal;
+                st.bglobal = 2 * st.blocal;
+                st.aglobal = 2 * st.alocal;
+                st.astride = padded ? 2 : 1;
+                st.bstride = st.astride * st.alocal + padded;
+                st.cstride = st.bstride * st.blocal + padded;
+                const size_t nelems = (size_t) st.clocal
+                                    * st.blocal * st.alocal;
+                st.field = calloc((size_t) st.cstride * st.clocal,
+                                  type_size);
+                assert(st.field);
+
+                for (st.layout = 0; st.layout < nlayouts; ++st.layout) {
+                    const hid_t space_id = layouts[st.layout].creator(
+                            st.cglobal, st.bglobal, st.aglobal);
+                    st.dset_id = H5Dcreate2(d->file_id, "field",
+                                            st.type_id, space_id,
+                                            H5P_DEFAULT, H5P_DEFAULT,
+                                            H5P_DEFAULT);
+                    H5Sclose(space_id);
+                    assert(st.dset_id >= 0);
+
+                    char name[64];
+                    snprintf(name, sizeof(name), "layout%d %s %s%s write",
+                             st.layout, typenames[t], shapes[s],
+                             padded ? " strided" : "");
+                    measure(d, name, nelems, &field_write, &st);
+                    snprintf(name, sizeof(name), "layout%d %s %s%s read",
+                             st.layout, typenames[t], shapes[s],
+                             padded ? " strided" : "");
+                    measure(d, name, nelems, &field_read, &st);
+
+                    H5Dclose(st.dset_id);
+                    H5Ldelete(d->file_id, "field", H5P_DEFAULT);
+                }
+                free(st.field);
+            }
+        }
+    }
+}
+
+void conversion_cases(const struct details *d)
+{
+    struct conversion_state s;
+    s.n = (size_t) d->extent * d->extent * d->extent;
+    s.f = malloc(s.n * sizeof(float));
+    s.h = malloc(s.n * sizeof(uint16_t));
+    assert(s.f && s.h);
+    for (size_t i = 0; i < s.n; ++i) s.f[i] = 1.0f / (1 + i % 1021);
+
+    measure(d, "convert float to half",     s.n, &float_half,     &s);
+    measure(d, "convert half to float",     s.n, &half_float,     &s);
+    measure(d, "convert float to bfloat16", s.n, &float_bfloat16, &s);
+    measure(d, "convert bfloat16 to float", s.n, &bfloat16_float, &s);
+
+    free(s.h);
+    free(s.f);
+}
+
+void metadata_cases(const struct details *d)
+{
+    // Datasets matching field, plane, and line shapes
+    const hsize_t dims[3] = { 4, 5, 6 };
+    const char *names[3] = { "mdline", "mdplane", "mdfield" };
+    for (int rank = 1; rank <= 3; ++rank) {
+        const hid_t space_id = H5Screate_simple(rank, dims + 3 - rank, NULL);
+        const hid_t dset_id  = H5Dcreate2(d->file_id, names[rank - 1],
+                                          H5T_NATIVE_DOUBLE, space_id,
+                                          H5P_DEFAULT, H5P_DEFAULT,
+                                          H5P_DEFAULT);
+        assert(dset_id >= 0);
+        H5Dclose(dset_id);
+        H5Sclose(space_id);
+    }
+
+    struct metadata_state s = { d->file_id, H5T_NATIVE_DOUBLE, "mdfield" };
+    measure(d, "metadata field read layout0", 1, &field_metadata_read, &s);
+    measure(d, "metadata field write+read", 1, &field_metadata_roundtrip, &s);
+    measure(d, "metadata field read", 1, &field_metadata_read, &s);
+    s.name = "mdplane";
+    measure(d, "metadata plane read", 1, &plane_metadata_read, &s);
+    s.name = "mdline";
+    measure(d, "metadata line read", 1, &line_metadata_read, &s);
+}
+
+void nextindex_cases(const struct details *d)
+{
+    struct nextindex_state s = { "restart#####.h5", "restart00042.h5" };
+    measure(d, "restart_nextindex match", 1, &nextindex, &s);
+    s.name = "unrelated.h5";
+    measure(d, "restart_nextindex mismatch", 1, &nextindex, &s);
+}
+
+void print_version(FILE *stream, struct argp_state *state)
+{
+    (void) state; // Unused
+
+    fputs(argp_program_version, stream);
+    unsigned majnum, minnum, relnum;
+    if (H5get_libversion(&majnum, &minnum, &relnum) >= 0) {
+        fprintf(stream, " linked against HDF5 %u.%u.%u",
+                         majnum, minnum, relnum);
+    }
+    int version, subversion;
+    if (MPI_SUCCESS == MPI_Get_version(&version, &subversion)) {
+        fprintf(stream, " running atop MPI %d.%d", version, subversion);
+    }
+    fputc('\n', stream);
+}
+
+void finalize(void)
+{
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) MPI_Finalize();
+}
+
+void trim(char *a)
+{
+    char *b = a;
+    while (isspace(*b))   ++b;
+    while (*b)            *a++ = *b++;
+    *a = '\0';
+    while (isspace(*--a)) *a = '\0';
+}
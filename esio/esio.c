@@ -35,6 +35,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <hdf5.h>
 #include <hdf5_hl.h>
 #include <mpi.h>
@@ -42,9 +46,15 @@
 #include "chunksize.h"
 #include "error.h"
 #include "file-copy.h"
+#include "group.h"
 #include "h5utils.h"
 #include "layout.h"
+#include "linetable.h"
+#include "manifest.h"
 #include "metadata.h"
+#include "parity.h"
+#include "precision.h"
+#include "readahead.h"
 #include "restart-rename.h"
 #include "uri.h"
 #include "version.h"
@@ -65,6 +75,11 @@ hid_t esio_H5P_FILE_ACCESS_create(const esio_handle h);
 static
 int esio_CONFIGURE_METADATA_CACHING(hid_t plist_id);
 
+static
+hid_t esio_dataset_create(const esio_handle h,
+                          const char *name, hid_t type_id, hid_t space_id,
+                          hid_t lcpl_id, hid_t dcpl_id, hid_t dapl_id);
+
 static
 hid_t esio_field_create(const esio_handle h,
                         const char *name, hid_t type_id,
@@ -89,6 +104,34 @@ int esio_plane_close(hid_t dataset_id);
 static
 int esio_line_close(hid_t dataset_id);
 
+static
+int esio_line_table_flush(const esio_handle h);
+
+static
+int esio_views_write(const esio_handle h);
+
+static
+int esio_balance_schedule(const esio_handle h, int *redistribute);
+
+static
+int esio_comment_defer(const esio_handle h,
+                       const char *name,
+                       const char *comment);
+
+static
+int esio_comments_write(const esio_handle h);
+
+static
+int esio_provenance_write(const esio_handle h);
+
+static
+int esio_field_write_balanced(const esio_handle h,
+                              const char *name,
+                              const void *field,
+                              int cstride, int bstride, int astride,
+                              const char *comment,
+                              hid_t type_id);
+
 static
 int esio_field_write_internal(const esio_handle h,
                               const char *name,
@@ -105,6 +148,17 @@ int esio_field_read_internal(const esio_handle h,
                              const char *comment,
                              hid_t type_id);
 
+static
+int esio_field_read_delta(const esio_handle h,
+                          hid_t dset_id,
+                          const char *reference,
+                          void *field,
+                          int cstride, int bstride, int astride,
+                          hid_t type_id);
+
+static
+char* esio_delta_reference(hid_t dset_id);
+
 static
 int esio_plane_write_internal(const esio_handle h,
                               const char *name,
@@ -147,10 +201,27 @@ int esio_line_read_internal(const esio_handle h,
 // INTERNAL TYPES INTERNAL TYPES INTERNAL TYPES INTERNAL TYPES INTERNAL
 //*********************************************************************
 
+// Target chunk size in bytes for fields written sparsely
+#define ESIO_SPARSE_CHUNK_BYTES (256 * 1024)
+
+// Bytes of partial values packed per round of reduce-on-write
+#define ESIO_REDUCE_PACK_BYTES (4 * 1024 * 1024)
+
 // Bit flags used to control some runtime behavior.
 enum {
     FLAG_COLLECTIVE_ENABLED = 1 << 0, //< Should collective IO be used?
-    FLAG_CHUNKING_ENABLED   = 1 << 1  //< See features #1246 and #1247
+    FLAG_CHUNKING_ENABLED   = 1 << 1, //< See features #1246 and #1247
+    FLAG_FILE_WRITABLE      = 1 << 2, //< Was the active file opened writable?
+    FLAG_READAHEAD_ENABLED  = 1 << 3, //< Should page cache hints be issued?
+    FLAG_SPARSE_ENABLED     = 1 << 4, //< Should all-fill chunks be skipped?
+    FLAG_LINETABLE_ENABLED  = 1 << 5, //< Should new lines be packed in tables?
+    FLAG_FILE_STAGED        = 1 << 6, //< Is the active file written aside?
+    FLAG_SMALL_ENABLED      = 1 << 7, //< Should files be built in memory?
+    FLAG_FILE_SMALL         = 1 << 8, //< Is the active file held in memory?
+    FLAG_VIEWS_ENABLED      = 1 << 9, //< Should views be written at close?
+    FLAG_BALANCE_ENABLED    = 1 << 10, //< Should field writes be rebalanced?
+    FLAG_COMMENTS_DISABLED  = 1 << 11, //< Should comments be dropped?
+    FLAG_FILE_WRITTEN       = 1 << 12  //< Was the active file written to?
 };
 
 struct line_decomp_s {
@@ -171,15 +242,59 @@ struct field_decomp_s {
     int cchunk, bchunk, achunk;   // Cache for when FLAG_CHUNKING_ENABLED
 };
 
+struct esio_target_s {
+    hid_t    file_id;             // Subfile holding some new datasets
+    char    *path;                // Subfile's canonical path used in links
+    hsize_t  bytes;               // Bytes assigned to the subfile so far
+};
+
+struct esio_map_s {
+    void              *addr;      // Page-aligned start of the mapping
+    size_t             length;    // Mapping length in bytes
+    const void        *field;     // Field's first element within mapping
+    struct esio_map_s *next;      // Next mapping held by the same handle
+};
+
+struct esio_comment_s {
+    hid_t                  file_id; // File containing the commented object
+    char                  *name;    // Object's name relative to file_id
+    char                  *text;    // Most recently requested comment
+    struct esio_comment_s *next;    // Next comment awaiting writing
+};
+
+struct esio_comments_s {
+    struct esio_comment_s *head;    // Shared by every view of one handle
+};
+
+struct esio_balance_s {
+    int *blocks;                  // Every rank's {c,b,a}{start,local} block
+    int  dst[6];                  // This rank's block when balanced
+    int  redistribute;            // Does balancing relieve the busiest rank?
+};
+
 struct esio_handle_s {
     MPI_Comm  comm;          //< Communicator used for collective calls
     int       comm_rank;     //< Process rank within in MPI communicator
     int       comm_size;     //< Number of ranks within MPI communicator
     MPI_Info  info;          //< Info object used for collective calls
+    MPI_Comm  node_comm;     //< Ranks sharing one page cache, if needed
     hid_t     file_id;       //< Active HDF file identifier
     char     *file_path;     //< Active file's canonical path
     int       layout_index;  //< Active field layout_index within HDF5 file
+    int       precision;     //< Storage precision for new fields and planes
     int       flags;         //< Miscellaneous bit-based flags
+    double    fill;          //< Fill value when FLAG_SPARSE_ENABLED
+    struct esio_manifest *manifest; //< Active file's manifest, if any
+    struct esio_linetable *linetable; //< Active file's line tables, if any
+    int       ntargets;      //< Number of subfiles used for new datasets
+    struct esio_target_s *targets; //< Subfiles when created multi-target
+    int       ngroups;       //< Number of groups when created grouped
+    MPI_Comm  group_comm;    //< Ranks sharing this rank's group subfile
+    hid_t     group_file;    //< This rank's group subfile, if any
+    struct esio_map_s *maps; //< Read-only field mappings not yet unmapped
+    struct esio_balance_s *balance; //< Cached schedule for balanced writes
+    int       pipeline;      //< Segments per redistributed field write
+    struct esio_comments_s *comments; //< Comments awaiting esio_file_flush
     struct line_decomp_s  l; //< Active parallel decomposition for lines
     struct plane_decomp_s p; //< Active parallel decomposition for planes
     struct field_decomp_s f; //< Active parallel decomposition for fields
@@ -196,27 +311,44 @@ static const struct {
     esio_dataset_chunker_t   dataset_chunker;
     esio_field_writer_t      field_writer;
     esio_field_reader_t      field_reader;
+    int                      rowmajor;  // Stored in global row-major order?
+    esio_virtual_mapper_t    virtual_mapper; // NULL if none is worthwhile
 } esio_field_layout[] = {
     {
         0,
         &esio_field_layout0_filespace_creator,
         &esio_field_layout0_dataset_chunker,
         &esio_field_layout0_field_writer,
-        &esio_field_layout0_field_reader
+        &esio_field_layout0_field_reader,
+        1,
+        NULL
     },
     {
         1,
         &esio_field_layout1_filespace_creator,
         &esio_field_layout1_dataset_chunker,
         &esio_field_layout1_field_writer,
-        &esio_field_layout1_field_reader
+        &esio_field_layout1_field_reader,
+        1,
+        NULL
     },
     {
         2,
         &esio_field_layout2_filespace_creator,
         &esio_field_layout2_dataset_chunker,
         &esio_field_layout2_field_writer,
-        &esio_field_layout2_field_reader
+        &esio_field_layout2_field_reader,
+        1,
+        &esio_field_layout2_virtual_mapper
+    },
+    {
+        3,
+        &esio_field_layout3_filespace_creator,
+        &esio_field_layout3_dataset_chunker,
+        &esio_field_layout3_field_writer,
+        &esio_field_layout3_field_reader,
+        0,
+        NULL
     },
 };
 static const int esio_field_nlayout = sizeof(esio_field_layout)
@@ -272,7 +404,9 @@ hid_t esio_H5P_DATASET_XFER_create(const esio_handle h)
                        ESIO_ESANITY, -1);
     }
 
-    if (h->flags & FLAG_COLLECTIVE_ENABLED) {
+    // Small files reside in memory where collective operation is moot
+    if (   (h->flags & FLAG_COLLECTIVE_ENABLED)
+        && !(h->flags & FLAG_FILE_SMALL)) {
         // Set property list to perform collective operation
         if (H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE) < 0) {
             H5Pclose(plist_id);
@@ -284,6 +418,9 @@ hid_t esio_H5P_DATASET_XFER_create(const esio_handle h)
     return plist_id;
 }
 
+// Growth increment for in-memory file images used by esio_file_small_set
+static const size_t esio_small_increment = 64 * 1024;
+
 static
 hid_t esio_H5P_FILE_ACCESS_create(const esio_handle h)
 {
@@ -294,13 +431,27 @@ hid_t esio_H5P_FILE_ACCESS_create(const esio_handle h)
                        ESIO_ESANITY, -1);
     }
 
-    // Set property list collective details
-    if (H5Pset_fapl_mpio(fapl_id, h->comm, h->info)) {
+    if (h->flags & FLAG_SMALL_ENABLED) {
+        // Assemble small files in memory and write them once when closed
+        if (H5Pset_fapl_core(fapl_id, esio_small_increment, 1) < 0) {
+            H5Pclose(fapl_id);
+            ESIO_ERROR_VAL("Unable to store core driver details in fapl_id",
+                           ESIO_ESANITY, -1);
+        }
+    } else if (H5Pset_fapl_mpio(fapl_id, h->comm, h->info)) {
+        // Set property list collective details
         H5Pclose(fapl_id);
         ESIO_ERROR_VAL("Unable to store MPI details in fapl_id",
                        ESIO_ESANITY, -1);
     }
 
+    // Keep subfiles reached through external links open between accesses
+    if (H5Pset_elink_file_cache_size(fapl_id, 16) < 0) {
+        H5Pclose(fapl_id);
+        ESIO_ERROR_VAL("Unable to set external link file cache size",
+                       ESIO_ESANITY, -1);
+    }
+
     return fapl_id;
 }
 
@@ -358,15 +509,40 @@ esio_handle_initialize(MPI_Comm comm)
     h->comm_rank    = comm_rank;
     h->comm_size    = comm_size;
     h->info         = info;
+    h->node_comm    = MPI_COMM_NULL;
     h->file_id      = -1;
     h->file_path    = NULL;
+    h->manifest     = NULL;
+    h->linetable    = NULL;
+    h->ntargets     = 0;
+    h->targets      = NULL;
+    h->ngroups      = 0;
+    h->group_comm   = MPI_COMM_NULL;
+    h->group_file   = -1;
+    h->maps         = NULL;
+    h->balance      = NULL;
+    h->pipeline     = 1;
+    h->comments     = calloc(1, sizeof(struct esio_comments_s));
     h->layout_index = 0;
+    h->precision    = ESIO_PRECISION_NATIVE;
     h->flags        = FLAG_COLLECTIVE_ENABLED;
+    h->fill         = 0;
 
     if (h->comm == MPI_COMM_NULL) {
         esio_handle_finalize(h);
         ESIO_ERROR_NULL("Detected MPI_COMM_NULL in h->comm", ESIO_ESANITY);
     }
+    if (h->comments == NULL) {
+        esio_handle_finalize(h);
+        ESIO_ERROR_NULL("failed to allocate space for comments", ESIO_ENOMEM);
+    }
+
+    // Reduced precision storage converts faster with ESIO's kernels
+    if (esio_precision_initialize() != ESIO_SUCCESS) {
+        esio_handle_finalize(h);
+        ESIO_ERROR_NULL("Unable to initialize precision conversions",
+                        ESIO_EFAILED);
+    }
 
     return h;
 }
@@ -414,10 +590,26 @@ esio_handle_finalize(esio_handle h)
             ESIO_MPICHKR(MPI_Info_free(&h->info));
             h->info = MPI_INFO_NULL;
         }
+        if (h->node_comm != MPI_COMM_NULL) {
+            ESIO_MPICHKR(MPI_Comm_free(&h->node_comm));
+            h->node_comm = MPI_COMM_NULL;
+        }
         if (h->file_path) {
             free(h->file_path);
             h->file_path = NULL;
         }
+        while (h->maps) {
+            struct esio_map_s *m = h->maps;
+            h->maps = m->next;
+            munmap(m->addr, m->length);
+            free(m);
+        }
+        if (h->balance) {
+            free(h->balance->blocks);
+            free(h->balance);
+            h->balance = NULL;
+        }
+        free(h->comments);
         free(h);
     }
 
@@ -467,924 +659,4150 @@ esio_field_layout_set(esio_handle h, int layout_index)
 }
 
 int
-esio_file_create(esio_handle h, const char *file, int overwrite)
+esio_precision_get(const esio_handle h)
 {
-    // Sanity check incoming arguments
     if (h == NULL) {
-        ESIO_ERROR("h == NULL", ESIO_EFAULT);
-    }
-    if (h->file_id != -1) {
-        ESIO_ERROR("Cannot create file because previous file not closed",
-                   ESIO_EINVAL);
-    }
-    if (file == NULL) {
-        ESIO_ERROR("file == NULL", ESIO_EFAULT);
+        // As in esio_field_layout_get, return the default on NULL input
+        return ESIO_PRECISION_NATIVE;
     }
 
-    // Initialize file creation property list identifier
-    const hid_t fcpl_id = H5P_DEFAULT;
+    return h->precision;
+}
 
-    // Initialize file access list property identifier
-    const hid_t fapl_id = esio_H5P_FILE_ACCESS_create(h);
-    if (fapl_id < 0) {
-        ESIO_ERROR("Unable to create fapl_id", ESIO_ESANITY);
+int
+esio_precision_set(esio_handle h, int precision)
+{
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
     }
-
-    // Set metadata caching options on the file access list property identifier
-    if (esio_CONFIGURE_METADATA_CACHING(fapl_id) != ESIO_SUCCESS) {
-        H5Pclose(fapl_id);
-        ESIO_ERROR("Unable to configure metadata caching", ESIO_ESANITY);
+    switch (precision) {
+        case ESIO_PRECISION_NATIVE:
+        case ESIO_PRECISION_HALF:
+        case ESIO_PRECISION_BFLOAT16:
+            break;
+        default:
+            ESIO_ERROR("unknown precision", ESIO_EINVAL);
     }
 
-    // Collectively create the file
-    hid_t file_id;
-    if (overwrite) {
-        // Create new file or truncate existing file
-        file_id = H5Fcreate(file, H5F_ACC_TRUNC, fcpl_id, fapl_id);
-        if (file_id < 0) {
-            H5Pclose(fapl_id);
-            ESIO_ERROR("Unable to create file", ESIO_EFAILED);
-        }
-    } else {
-        // Avoid overwriting existing file
-        file_id = H5Fcreate(file, H5F_ACC_EXCL, fcpl_id, fapl_id);
-        if (file_id < 0) {
-            H5Pclose(fapl_id);
-            ESIO_ERROR("File already exists", ESIO_EFAILED);
-        }
-    }
+    h->precision = precision;
 
-    // Clean up temporary HDF5 resources
-    H5Pclose(fapl_id);
+    return ESIO_SUCCESS;
+}
 
-    // Duplicate the (prefix-less) canonical file name for later use
-    // Canonical chosen so that changes in working directory are irrelevant
-    h->file_path = canonicalize_file_name(file + scheme_prefix_len(file));
-    if (h->file_path == NULL) {
-        ESIO_ERROR("failed to allocate space for file_path", ESIO_ENOMEM);
+// Collectively find the ranks sharing this node whenever not already known
+static
+int esio_node_comm(esio_handle h)
+{
+    if (h->node_comm == MPI_COMM_NULL) {
+        ESIO_MPICHKQ(MPI_Comm_split_type(h->comm, MPI_COMM_TYPE_SHARED,
+                                         h->comm_rank, MPI_INFO_NULL,
+                                         &h->node_comm));
     }
+    return ESIO_SUCCESS;
+}
 
-    // File creation successful: update handle
-    h->file_id = file_id;
+int
+esio_readahead_get(const esio_handle h)
+{
+    if (h == NULL) {
+        // As in esio_field_layout_get, return the default on NULL input
+        return 0;
+    }
 
-    return ESIO_SUCCESS;
+    return (h->flags & FLAG_READAHEAD_ENABLED) ? 1 : 0;
 }
 
 int
-esio_file_open(esio_handle h, const char *file, int readwrite)
+esio_readahead_set(esio_handle h, int enable)
 {
-    // Sanity check incoming arguments
     if (h == NULL) {
         ESIO_ERROR("h == NULL", ESIO_EFAULT);
     }
-    if (h->file_id != -1) {
-        ESIO_ERROR("Cannot open new file because previous file not closed",
-                   ESIO_EINVAL);
-    }
-    if (file == NULL) {
-        ESIO_ERROR("file == NULL", ESIO_EFAULT);
-    }
 
-    // Initialize file access list property identifier
-    const hid_t fapl_id = esio_H5P_FILE_ACCESS_create(h);
-    if (fapl_id < 0) {
-        ESIO_ERROR("Unable to create fapl_id", ESIO_ESANITY);
+    // Collectively find the ranks sharing each node's page cache
+    if (enable) {
+        const int status = esio_node_comm(h);
+        if (status != ESIO_SUCCESS) return status;
     }
 
-    // Set metadata caching options on the file access list property identifier
-    if (esio_CONFIGURE_METADATA_CACHING(fapl_id) != ESIO_SUCCESS) {
-        H5Pclose(fapl_id);
-        ESIO_ERROR("Unable to configure metadata caching", ESIO_ESANITY);
+    if (enable) {
+        h->flags |=  FLAG_READAHEAD_ENABLED;
+    } else {
+        h->flags &= ~FLAG_READAHEAD_ENABLED;
     }
 
-    // Initialize access flags
-    const unsigned flags = readwrite ? H5F_ACC_RDWR : H5F_ACC_RDONLY;
+    return ESIO_SUCCESS;
+}
 
-    // Collectively open the file
-    const hid_t file_id = H5Fopen(file, flags, fapl_id);
-    if (file_id < 0) {
-        H5Pclose(fapl_id);
-        ESIO_ERROR("Unable to open existing file", ESIO_EFAILED);
+int
+esio_field_sparse_get(const esio_handle h, double *fill)
+{
+    if (h == NULL) {
+        // As in esio_field_layout_get, return the default on NULL input
+        return 0;
     }
 
-    // Clean up temporary HDF5 resources
-    H5Pclose(fapl_id);
-
-    // Duplicate the (prefix-less) canonical file name for later use
-    // Canonical chosen so that changes in working directory are irrelevant
-    //
-    // canonicalize_file_name (aka. realpath) call just below has three issues:
-    //   1) A race occurs for file creation versus the canonicalize call
-    //   2) Every rank calling canonicalize_file_name hits the file system
-    //   3) Memory usage of the returned string isn't promised to be low
-    //
-    // The messy logic below here is to rectify all three concerns.
-    // It is ugly as sin and chatty but pre-allocating everything in advance is
-    // and calling realpath(3) is buggy as described in realpath(3)'s man page.
-
-    // Collectively best-effort flush to the operating system
-    H5Fflush(file_id, H5F_SCOPE_LOCAL);
+    if (fill) *fill = h->fill;
+    return (h->flags & FLAG_SPARSE_ENABLED) ? 1 : 0;
+}
 
-    // Last rank canonicalizes the file path, strdups it, and measures length
-    // Error information saved but not reported until later.
-    const int worker = h->comm_size - 1; // Last rank does work
-    int  buf[3] = { /*length*/ -1, /*status*/ ESIO_SUCCESS, /*line*/ -1 };
-    char msg[384];
-    if (h->comm_rank == worker) {
-        static const char msgpat[] = "failed to canonicalize path '%s': %s";
-        const char * s = canonicalize_file_name(file + scheme_prefix_len(file));
-        if (s == NULL) {
-            snprintf(msg, sizeof(msg), msgpat, file, strerror(errno));
-            buf[1] = ESIO_EFAILED;
-            buf[2] = __LINE__;
-        } else if ((h->file_path = strdup(s)) == NULL) {
-            snprintf(msg, sizeof(msg), msgpat, file, strerror(ENOMEM));
-            buf[1] = ESIO_ENOMEM;
-            buf[2] = __LINE__;
-        } else if ((buf[0] = (int) strlen(s)) < 1) {
-            snprintf(msg, sizeof(msg), msgpat, file, strerror(EINVAL));
-            buf[1] = ESIO_ESANITY;
-            buf[2] = __LINE__;
-        }
-        free((void *) s);
+int
+esio_field_sparse_set(esio_handle h, int enable, double fill)
+{
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
     }
 
-    // Broadcast details from rank zero to everyone and return if necessary
-    ESIO_MPICHKQ(MPI_Bcast(buf, sizeof(buf)/sizeof(buf[0]), MPI_INT,
-                           worker, h->comm));
-    if (buf[1] != ESIO_SUCCESS) {
-        if (h->comm_rank == worker) {
-            esio_error(msg, __FILE__, buf[2], buf[1]);
-            free(h->file_path);
-        }
-        return buf[1];
+    if (enable) {
+        h->flags |=  FLAG_SPARSE_ENABLED;
+    } else {
+        h->flags &= ~FLAG_SPARSE_ENABLED;
     }
+    h->fill = fill;
 
-    // Non-zero ranks allocate space to receive canonical path
-    if (h->comm_rank < worker) h->file_path = malloc(buf[0] + 1);
-    if (h->file_path == NULL)  buf[1] = ESIO_ENOMEM;
+    return ESIO_SUCCESS;
+}
 
-    // Did everybody grab memory?  Otherwise subsequent broadcast crashes...
-    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, buf, sizeof(buf)/sizeof(buf[0]),
-                               MPI_INT, MPI_MAX, h->comm));
-    if (buf[1] != ESIO_SUCCESS) {
-        if (h->file_path == NULL) {
-            ESIO_ERROR_REPORT("failed to allocate space for canonical path",
-                              ESIO_ENOMEM);
-        }
-        free(h->file_path);
-        return buf[1];
+int
+esio_line_table_get(const esio_handle h)
+{
+    if (h == NULL) {
+        // As in esio_field_layout_get, return the default on NULL input
+        return 0;
     }
 
-    // Broadcast canonical path from rank zero to other ranks
-    ESIO_MPICHKQ(MPI_Bcast(h->file_path, buf[0] + 1, MPI_CHAR,
-                           worker, h->comm));
-
-    // File creation successful: update handle
-    h->file_id = file_id;
-
-    return ESIO_SUCCESS;
+    return (h->flags & FLAG_LINETABLE_ENABLED) ? 1 : 0;
 }
 
-int esio_file_clone(esio_handle h,
-                    const char *srcfile,
-                    const char *dstfile,
-                    int overwrite)
+int
+esio_line_table_set(esio_handle h, int enable)
 {
-    // Sanity check incoming arguments
     if (h == NULL) {
         ESIO_ERROR("h == NULL", ESIO_EFAULT);
     }
-    if (h->file_id != -1) {
-        ESIO_ERROR("Cannot create file because previous file not closed",
-                   ESIO_EINVAL);
-    }
-    if (srcfile == NULL) {
-        ESIO_ERROR("srcfile == NULL", ESIO_EFAULT);
-    }
-    if (dstfile == NULL) {
-        ESIO_ERROR("dstfile == NULL", ESIO_EFAULT);
+
+    if (enable) {
+        h->flags |=  FLAG_LINETABLE_ENABLED;
+    } else {
+        h->flags &= ~FLAG_LINETABLE_ENABLED;
     }
 
-    // One rank copies the file synchronously and "broadcasts" the result;
-    // The "broadcast" is a summing Allreduce that behaves as useful barrier.
-    const int worker = h->comm_size - 1; // Last rank does work
-    int status = 0;
-    if (h->comm_rank == worker) {
-        int prefix_len = scheme_prefix_len(srcfile);
-        status = file_copy(srcfile + prefix_len, dstfile + prefix_len,
-                           overwrite, 1 /*blockuntilsync*/);
-    }
-    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1/*count*/,
-                               MPI_INT, MPI_SUM, h->comm));
-
-    // Bail now if an error occurred
-    if (status) return status;
-
-    // All ranks then open the file in readwrite mode
-    return esio_file_open(h, dstfile, 1 /* readwrite */);
+    return ESIO_SUCCESS;
 }
 
-char* esio_file_path(const esio_handle h)
+int
+esio_file_small_get(const esio_handle h)
 {
-    // Sanity check incoming arguments
     if (h == NULL) {
-        ESIO_ERROR_NULL("h == NULL", ESIO_EFAULT);
-    }
-    if (h->file_id == -1) {
-        return NULL;
-    }
-    if (h->file_path == NULL) {
-        ESIO_ERROR_NULL("file_id != -1 but file_path == NULL", ESIO_ESANITY);
+        // As in esio_field_layout_get, return the default on NULL input
+        return 0;
     }
 
-    // h->file_path has already had any leading URI scheme removed
-    char *retval = strdup(h->file_path);
-    if (retval == NULL) {
-        ESIO_ERROR_NULL("Unable to allocate space for file_path", ESIO_ENOMEM);
-    }
-    return retval;
+    return (h->flags & FLAG_SMALL_ENABLED) ? 1 : 0;
 }
 
-int esio_file_flush(esio_handle h)
+int
+esio_file_small_set(esio_handle h, int enable)
 {
-    // Sanity check incoming arguments
-    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    }
 
-    // Flush any currently open file
-    if (h->file_id != -1) {
-        if (H5Fflush(h->file_id, H5F_SCOPE_GLOBAL) < 0) {
-            ESIO_ERROR("Unable to flush file", ESIO_EFAILED);
+    if (enable) {
+        // HDF5's core driver cannot be shared between ranks
+        if (h->comm_size != 1) {
+            ESIO_ERROR("Small files require a single-rank handle",
+                       ESIO_EINVAL);
         }
+        h->flags |=  FLAG_SMALL_ENABLED;
+    } else {
+        h->flags &= ~FLAG_SMALL_ENABLED;
     }
 
     return ESIO_SUCCESS;
 }
 
-int esio_file_close(esio_handle h)
+int
+esio_file_views_get(const esio_handle h)
 {
-    // Sanity check incoming arguments
-    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
-
-    // Close any currently open file
-    if (h->file_id != -1) {
+    if (h == NULL) {
+        // As in esio_field_layout_get, return the default on NULL input
+        return 0;
+    }
 
-        if (H5Fclose(h->file_id) < 0) {
-            ESIO_ERROR("Unable to close file", ESIO_EFAILED);
-        }
+    return (h->flags & FLAG_VIEWS_ENABLED) ? 1 : 0;
+}
 
-        if (h->file_path) {
-            free(h->file_path);
-            h->file_path = NULL;
-        }
+int
+esio_file_views_set(esio_handle h, int enable)
+{
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    }
 
-        // Close successful: update handle
-        h->file_id = -1;
+    if (enable) {
+        h->flags |=  FLAG_VIEWS_ENABLED;
+    } else {
+        h->flags &= ~FLAG_VIEWS_ENABLED;
     }
 
     return ESIO_SUCCESS;
 }
 
-int esio_file_close_restart(esio_handle h,
-                            const char *restart_template,
-                            int retain_count)
+int
+esio_field_balance_get(const esio_handle h)
 {
-    // Sanity check incoming arguments
-    // Template sanity checking is performed within restart_rename as well
     if (h == NULL) {
-        ESIO_ERROR("h == NULL", ESIO_EFAULT);
-    }
-    if (restart_template == NULL) {
-        ESIO_ERROR("restart_template == NULL", ESIO_EFAULT);
-    }
-    if (retain_count < 1) {
-        ESIO_ERROR("retain_count < 1", ESIO_EINVAL);
-    }
-    if (h->file_id == -1) {
-        ESIO_ERROR("No file currently open", ESIO_EINVAL);
+        // As in esio_field_layout_get, return the default on NULL input
+        return 0;
     }
 
-    // Copy the current file's canonical path and then close the file
-    char *src_filename = esio_file_path(h);
-    if (src_filename == NULL) {
-        ESIO_ERROR("Unable to clone file's canonical path", ESIO_EFAILED);
-    }
-    const int close_status = esio_file_close(h);
-    if (close_status != ESIO_SUCCESS) {
-        ESIO_ERROR("Unable to close current restart file", close_status);
-    }
+    return (h->flags & FLAG_BALANCE_ENABLED) ? 1 : 0;
+}
 
-    // One rank invokes restart_rename and "broadcasts" the result.
-    // The "broadcast" is a summing Allreduce that behaves as useful barrier.
-    const int worker = h->comm_size - 1; // Last rank does work
-    int status = 0;
-    if (h->comm_rank == worker) {
-        status = restart_rename(
-                src_filename, // No URI scheme prefix munging required
-                restart_template + scheme_prefix_len(restart_template),
-                retain_count);
+int
+esio_field_balance_set(esio_handle h, int enable)
+{
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
     }
-    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1/*count*/,
-                               MPI_INT, MPI_SUM, h->comm));
-
-    // Free temporary memory
-    free(src_filename);
 
-    // All ranks return the same status
-    if (status != ESIO_SUCCESS) {
-        ESIO_ERROR("Failure in esio_file_close_restart", status);
+    if (enable) {
+        h->flags |=  FLAG_BALANCE_ENABLED;
+    } else {
+        h->flags &= ~FLAG_BALANCE_ENABLED;
     }
+
     return ESIO_SUCCESS;
 }
 
-static
-hid_t esio_field_create(const esio_handle h,
-                        const char *name, hid_t type_id,
-                        hid_t lcpl_id, hid_t dcpl_id, hid_t dapl_id)
+int
+esio_field_pipeline_get(const esio_handle h)
 {
-    // Sanity check that the handle's layout_index matches our internal table
-    if (esio_field_layout[h->layout_index].index != h->layout_index) {
-        ESIO_ERROR_VAL("SEVERE: Consistency error in esio_field_layout",
-                ESIO_ESANITY, -1);
+    if (h == NULL) {
+        // As in esio_field_layout_get, return the default on NULL input
+        return 1;
     }
 
-    // Create the filespace using current layout within handle
-    const hid_t filespace
-        = (esio_field_layout[h->layout_index].filespace_creator)(h->f.cglobal,
-                                                                 h->f.bglobal,
-                                                                 h->f.aglobal);
-    if (filespace < 0) {
-        ESIO_ERROR_VAL("Unable to create filespace", ESIO_ESANITY, -1);
-    }
+    return h->pipeline;
+}
 
-    // Create the dataspace
-    const hid_t dset_id = H5Dcreate2(h->file_id, name, type_id, filespace,
-                                     lcpl_id, dcpl_id, dapl_id);
-    if (dset_id < 0) {
-        H5Sclose(filespace);
-        ESIO_ERROR_VAL("Unable to create dataspace", ESIO_ESANITY, -1);
+int
+esio_field_pipeline_set(esio_handle h, int nsegments)
+{
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
     }
-
-    // Stash field's metadata
-    if (ESIO_SUCCESS != esio_field_metadata_write(
-                h->file_id, name, h->layout_index,
-                h->f.cglobal, h->f.bglobal, h->f.aglobal, type_id)) {
-        H5Sclose(filespace);
-        H5Sclose(dset_id);
-        ESIO_ERROR_VAL("Unable to save field metadata", ESIO_EFAILED, -1);
+    if (nsegments < 1) {
+        ESIO_ERROR("nsegments < 1", ESIO_EINVAL);
     }
 
-    // Clean up temporary resources
-    H5Sclose(filespace);
+    h->pipeline = nsegments;
 
-    return dset_id;
+    return ESIO_SUCCESS;
 }
 
-static
-hid_t esio_plane_create(const esio_handle h,
-                        const char *name, hid_t type_id,
-                        hid_t lcpl_id, hid_t dcpl_id, hid_t dapl_id)
+int
+esio_field_comments_get(const esio_handle h)
 {
-    // Create the filespace
-    const hsize_t dims[2] = { h->p.bglobal, h->p.aglobal };
-    const hid_t filespace = H5Screate_simple(2, dims, NULL);
-    if (filespace < 0) {
-        ESIO_ERROR_VAL("Unable to create filespace", ESIO_ESANITY, -1);
+    if (h == NULL) {
+        // As in esio_field_layout_get, return the default on NULL input
+        return 1;
     }
 
-    // Create the dataspace
-    const hid_t dset_id = H5Dcreate2(h->file_id, name, type_id, filespace,
-                                     lcpl_id, dcpl_id, dapl_id);
-    if (dset_id < 0) {
-        H5Sclose(filespace);
-        ESIO_ERROR_VAL("Unable to create dataspace", ESIO_ESANITY, -1);
+    return (h->flags & FLAG_COMMENTS_DISABLED) ? 0 : 1;
+}
+
+int
+esio_field_comments_set(esio_handle h, int enable)
+{
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
     }
 
-    // Stash plane's metadata
-    if (ESIO_SUCCESS != esio_plane_metadata_write(h->file_id, name,
-                                                  h->p.bglobal, h->p.aglobal,
-                                                  type_id)) {
-        H5Sclose(filespace);
-        H5Dclose(dset_id);
-        ESIO_ERROR_VAL("Unable to save plane metadata", ESIO_EFAILED, -1);
+    if (enable) {
+        h->flags &= ~FLAG_COMMENTS_DISABLED;
+    } else {
+        h->flags |=  FLAG_COMMENTS_DISABLED;
     }
 
-    // Clean up temporary resources
-    H5Sclose(filespace);
+    return ESIO_SUCCESS;
+}
 
-    return dset_id;
+// Convert the handle's fill value to type_id storing the result in fill.
+// Returns nonzero when new fields of type_id should be written sparsely.
+static
+int esio_field_sparse_fill(const esio_handle h, hid_t type_id,
+                           void *fill, size_t fillsize)
+{
+    if (!(h->flags & FLAG_SPARSE_ENABLED)) return 0;
+    if (h->layout_index != 0)              return 0;
+
+    // Only scalar fields have a single-value fill representation
+    const H5T_class_t cls = H5Tget_class(type_id);
+    if (cls != H5T_INTEGER && cls != H5T_FLOAT) return 0;
+    const size_t size = H5Tget_size(type_id);
+    if (size > fillsize || sizeof(double) > fillsize) return 0;
+
+    memcpy(fill, &h->fill, sizeof(double));
+    return H5Tconvert(H5T_NATIVE_DOUBLE, type_id, 1, fill,
+                      NULL, H5P_DEFAULT) >= 0;
 }
 
+// Halve the largest of the given chunk extents until one chunk of
+// elements of the given size fits within ESIO_SPARSE_CHUNK_BYTES.
+// Smaller chunks let sparse writes skip constant regions more finely.
 static
-hid_t esio_line_create(const esio_handle h,
-                       const char *name, hid_t type_id,
-                       hid_t lcpl_id, hid_t dcpl_id, hid_t dapl_id)
+void esio_field_sparse_chunks(size_t size, int *cchunk, int *bchunk,
+                              int *achunk)
 {
-    // Create the filespace
-    const hsize_t dims[1] = { h->l.aglobal };
-    const hid_t filespace = H5Screate_simple(1, dims, NULL);
-    if (filespace < 0) {
-        ESIO_ERROR_VAL("Unable to create filespace", ESIO_ESANITY, -1);
+    while (   (size_t) *cchunk * *bchunk * *achunk * size
+                > ESIO_SPARSE_CHUNK_BYTES
+           && *cchunk * *bchunk * *achunk > 1) {
+        int *const x = (*cchunk >= *bchunk && *cchunk >= *achunk) ? cchunk
+                     : (*bchunk >= *achunk)                       ? bchunk
+                                                                  : achunk;
+        *x = (*x + 1) / 2;
     }
+}
 
-    // Create the dataspace
-    const hid_t dset_id = H5Dcreate2(h->file_id, name, type_id, filespace,
-                                     lcpl_id, dcpl_id, dapl_id);
-    if (dset_id < 0) {
-        H5Sclose(filespace);
-        ESIO_ERROR_VAL("Unable to create dataspace", ESIO_ESANITY, -1);
+// Form this rank's parity group, failing with ESIO_EINVAL wherever the group
+// could not survive losing a node.  Members of a group never share a node, so
+// its size is the number of nodes it spans.  Failures are not reported.
+static
+int esio_parity_split(const esio_handle h, int k, MPI_Comm *group)
+{
+    int status = esio_node_comm(h);
+    if (status == ESIO_SUCCESS) {
+        status = esio_parity_group(h->comm, h->node_comm, k, group);
     }
-
-    // Stash line's metadata
-    if (ESIO_SUCCESS != esio_line_metadata_write(h->file_id, name,
-                                                 h->l.aglobal, type_id)) {
-        H5Sclose(filespace);
-        H5Dclose(dset_id);
-        ESIO_ERROR_VAL("Unable to save line metadata", ESIO_EFAILED, -1);
+    if (status == ESIO_SUCCESS) {
+        int g = 0;
+        if (MPI_Comm_size(*group, &g)) {
+            status = ESIO_EFAILED;
+        } else if (g < 2 || g < k) {
+            status = ESIO_EINVAL;
+        }
+        if (status != ESIO_SUCCESS) MPI_Comm_free(group);
     }
-
-    // Clean up temporary resources
-    H5Sclose(filespace);
-
-    return dset_id;
+    return status;
 }
 
-static
-int esio_field_close(hid_t dataset_id)
+int
+esio_parity_encode(const esio_handle h,
+                   const char *file,
+                   const char *parity,
+                   int k)
 {
-    if (H5Dclose(dataset_id) < 0) {
-        ESIO_ERROR("Error closing field", ESIO_EFAILED);
+    if (h == NULL)      ESIO_ERROR("h == NULL",      ESIO_EFAULT);
+    if (file == NULL)   ESIO_ERROR("file == NULL",   ESIO_EFAULT);
+    if (parity == NULL) ESIO_ERROR("parity == NULL", ESIO_EFAULT);
+    if (k < 2)          ESIO_ERROR("k < 2",          ESIO_EINVAL);
+
+    MPI_Comm group;
+    int status = esio_parity_split(h, k, &group);
+    if (status == ESIO_SUCCESS) {
+        status = esio_parity_encode_group(group, file, parity);
+        MPI_Comm_free(&group);
     }
 
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status == ESIO_EINVAL) {
+        ESIO_ERROR("Parity group spans fewer than max(2, k) nodes", status);
+    } else if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to compute parity", status);
+    }
     return ESIO_SUCCESS;
 }
 
-static
-int esio_plane_close(hid_t dataset_id)
+int
+esio_parity_rebuild(const esio_handle h,
+                    const char *file,
+                    const char *parity,
+                    int k)
 {
-    if (H5Dclose(dataset_id) < 0) {
-        ESIO_ERROR("Error closing plane", ESIO_EFAILED);
+    if (h == NULL)      ESIO_ERROR("h == NULL",      ESIO_EFAULT);
+    if (file == NULL)   ESIO_ERROR("file == NULL",   ESIO_EFAULT);
+    if (parity == NULL) ESIO_ERROR("parity == NULL", ESIO_EFAULT);
+    if (k < 2)          ESIO_ERROR("k < 2",          ESIO_EINVAL);
+
+    MPI_Comm group;
+    int status = esio_parity_split(h, k, &group);
+    if (status == ESIO_SUCCESS) {
+        // Groups which recreated a file restore its lost parity block
+        int rebuilt = 0;
+        status = esio_parity_rebuild_group(group, file, parity, &rebuilt);
+        if (status == ESIO_SUCCESS && MPI_Allreduce(MPI_IN_PLACE, &rebuilt,
+                                                    1, MPI_INT, MPI_MAX,
+                                                    group)) {
+            status = ESIO_EFAILED;
+        }
+        if (status == ESIO_SUCCESS && rebuilt) {
+            status = esio_parity_encode_group(group, file, parity);
+        }
+        MPI_Comm_free(&group);
     }
 
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status == ESIO_EINVAL) {
+        ESIO_ERROR("Parity group spans fewer than max(2, k) nodes", status);
+    } else if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to rebuild from parity", status);
+    }
     return ESIO_SUCCESS;
 }
 
+// Suffix marking a staged file which has not yet been closed
+static const char esio_stage_suffix[] = ".partial";
+
+// Wait up to ESIO_STAGE_WAIT seconds for a staged file to be published.
+// One rank polls and broadcasts so the staging directory sees little load.
 static
-int esio_line_close(hid_t dataset_id)
+void esio_stage_wait(const esio_handle h, const char *path)
 {
-    if (H5Dclose(dataset_id) < 0) {
-        ESIO_ERROR("Error closing line", ESIO_EFAILED);
+    const char *s = getenv("ESIO_STAGE_WAIT");
+    const double wait = s ? atof(s) : 0;
+    if (!(wait > 0)) return;
+
+    const int worker = h->comm_size - 1; // Last rank does work
+    if (h->comm_rank == worker) {
+        const struct timespec nap = { 0, 10000000 }; // 10 milliseconds
+        const double until = MPI_Wtime() + wait;
+        while (access(path, R_OK) != 0 && MPI_Wtime() < until) {
+            nanosleep(&nap, NULL);
+        }
     }
+    MPI_Barrier(h->comm);
+}
 
+// Staging directories like /dev/shm are node-local, so ranks on different
+// nodes would each write their own partial file.  Collectively require that
+// every rank of the handle shares one node.
+static
+int esio_stage_check(esio_handle h)
+{
+    const int nstat = esio_node_comm(h);
+    if (nstat != ESIO_SUCCESS) return nstat;
+    int node_size;
+    ESIO_MPICHKQ(MPI_Comm_size(h->node_comm, &node_size));
+    int spread = (node_size != h->comm_size);
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &spread, 1, MPI_INT,
+                               MPI_LOR, h->comm));
+    if (spread) {
+        ESIO_ERROR("stage: files require every rank on one node",
+                   ESIO_EINVAL);
+    }
     return ESIO_SUCCESS;
 }
 
-// *********************************************************************
-// PARALLEL DECOMPOSITION DETAILS PARALLEL DECOMPOSITION DETAILS
-// *********************************************************************
+// Publish a closed staged file under its final name in one atomic step.
+static
+int esio_stage_publish(const esio_handle h)
+{
+    int status = ESIO_SUCCESS;
+    const int worker = h->comm_size - 1; // Last rank does work
+    if (h->comm_rank == worker) {
+        const size_t len = strlen(h->file_path) + sizeof(esio_stage_suffix);
+        char *partial = malloc(len);
+        if (partial == NULL) {
+            status = ESIO_ENOMEM;
+        } else {
+            snprintf(partial, len, "%s%s", h->file_path, esio_stage_suffix);
+            if (rename(partial, h->file_path)) status = ESIO_EFAILED;
+            free(partial);
+        }
+    }
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to publish staged file", status);
+    }
+    return ESIO_SUCCESS;
+}
 
 int
-esio_line_establish(esio_handle h,
-                    int aglobal, int astart, int alocal)
+esio_file_create(esio_handle h, const char *file, int overwrite)
 {
     // Sanity check incoming arguments
-    if (h == NULL)   ESIO_ERROR("h == NULL",   ESIO_EFAULT);
-    if (aglobal < 1) ESIO_ERROR("aglobal < 1", ESIO_EINVAL);
-    if (astart  < 0) ESIO_ERROR("astart < 0",  ESIO_EINVAL);
-    if (alocal  < 0) ESIO_ERROR("alocal < 0",  ESIO_EINVAL);
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    }
+    if (h->file_id != -1) {
+        ESIO_ERROR("Cannot create file because previous file not closed",
+                   ESIO_EINVAL);
+    }
+    if (file == NULL) {
+        ESIO_ERROR("file == NULL", ESIO_EFAULT);
+    }
 
-    // Save parallel decomposition in handle
-    h->l.aglobal = aglobal;
-    h->l.astart  = astart;
-    h->l.alocal  = alocal;
+    // Files using the stage: scheme are written aside and only renamed into
+    // place by esio_file_close so consumers never observe partial contents
+    char *staged = NULL;
+    if (stage_scheme(file)) {
+        if (!stage_name_valid(file)) {
+            ESIO_ERROR("stage: names may not contain '/' or '..'",
+                       ESIO_EINVAL);
+        }
+        const int cstat = esio_stage_check(h);
+        if (cstat != ESIO_SUCCESS) return cstat;
+        if (!overwrite) {
+            char *final = stage_resolve(file, NULL);
+            if (final == NULL) {
+                ESIO_ERROR("Unable to resolve staged path", ESIO_ENOMEM);
+            }
+            const int exists = (access(final, F_OK) == 0);
+            free(final);
+            if (exists) {
+                ESIO_ERROR("File already exists", ESIO_EFAILED);
+            }
+        }
+        staged = stage_resolve(file, esio_stage_suffix);
+        if (staged == NULL) {
+            ESIO_ERROR("Unable to resolve staged path", ESIO_ENOMEM);
+        }
+        file = staged;
+    }
+
+    // Initialize file creation property list identifier
+    const hid_t fcpl_id = H5P_DEFAULT;
+
+    // Initialize file access list property identifier
+    const hid_t fapl_id = esio_H5P_FILE_ACCESS_create(h);
+    if (fapl_id < 0) {
+        free(staged);
+        ESIO_ERROR("Unable to create fapl_id", ESIO_ESANITY);
+    }
+
+    // Set metadata caching options on the file access list property identifier
+    if (esio_CONFIGURE_METADATA_CACHING(fapl_id) != ESIO_SUCCESS) {
+        H5Pclose(fapl_id);
+        free(staged);
+        ESIO_ERROR("Unable to configure metadata caching", ESIO_ESANITY);
+    }
+
+    // Collectively create the file
+    hid_t file_id;
+    if (overwrite) {
+        // Create new file or truncate existing file
+        file_id = H5Fcreate(file, H5F_ACC_TRUNC, fcpl_id, fapl_id);
+        if (file_id < 0) {
+            H5Pclose(fapl_id);
+            free(staged);
+            ESIO_ERROR("Unable to create file", ESIO_EFAILED);
+        }
+    } else {
+        // Avoid overwriting existing file
+        file_id = H5Fcreate(file, H5F_ACC_EXCL, fcpl_id, fapl_id);
+        if (file_id < 0) {
+            H5Pclose(fapl_id);
+            free(staged);
+            ESIO_ERROR("File already exists", ESIO_EFAILED);
+        }
+    }
+
+    // Clean up temporary HDF5 resources
+    H5Pclose(fapl_id);
+
+    // Duplicate the (prefix-less) canonical file name for later use
+    // Canonical chosen so that changes in working directory are irrelevant
+    h->file_path = canonicalize_file_name(
+            staged ? staged : file + scheme_prefix_len(file));
+    if (h->file_path == NULL) {
+        H5Fclose(file_id);
+        free(staged);
+        ESIO_ERROR("failed to allocate space for file_path", ESIO_ENOMEM);
+    }
+
+    // Staged files report their final name which esio_file_close provides
+    if (staged) {
+        h->file_path[strlen(h->file_path)
+                     - (sizeof(esio_stage_suffix) - 1)] = '\0';
+        h->flags |= FLAG_FILE_STAGED;
+        free(staged);
+    }
+
+    // File creation successful: update handle
+    h->file_id = file_id;
+    h->flags  |= FLAG_FILE_WRITABLE;
+    if (h->flags & FLAG_SMALL_ENABLED) h->flags |= FLAG_FILE_SMALL;
 
     return ESIO_SUCCESS;
 }
 
+// Close any subfiles created by esio_file_create_multi, optionally advising
+// each node's page cache to drop their freshly written pages.
+static
+int esio_targets_close(esio_handle h, int evict)
+{
+    int status = ESIO_SUCCESS;
+    for (int k = 0; k < h->ntargets; ++k) {
+        const hid_t file_id = h->targets[k].file_id;
+        if (file_id >= 0 && H5Fclose(file_id) < 0) status = ESIO_EFAILED;
+        if (evict && h->targets[k].path) {
+            esio_readahead_evict(h->targets[k].path);
+        }
+        free(h->targets[k].path);
+    }
+    free(h->targets);
+    h->targets  = NULL;
+    h->ntargets = 0;
+    return status;
+}
+
 int
-esio_line_established(esio_handle h,
-                      int *aglobal, int *astart, int *alocal)
+esio_file_create_multi(esio_handle h,
+                       const char *file,
+                       int overwrite,
+                       int ntargets,
+                       const char * const *targets)
 {
     // Sanity check incoming arguments
-    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    }
+    if (file == NULL) {
+        ESIO_ERROR("file == NULL", ESIO_EFAULT);
+    }
+    if (ntargets < 0) {
+        ESIO_ERROR("ntargets < 0", ESIO_EINVAL);
+    }
+    if (ntargets > 0 && targets == NULL) {
+        ESIO_ERROR("targets == NULL", ESIO_EFAULT);
+    }
+    for (int k = 0; k < ntargets; ++k) {
+        if (targets[k] == NULL) {
+            ESIO_ERROR("targets[k] == NULL", ESIO_EFAULT);
+        }
+    }
 
-    // Retrieve parallel decomposition from handle
-    if (aglobal) *aglobal = h->l.aglobal;
-    if (astart ) *astart  = h->l.astart;
-    if (alocal ) *alocal  = h->l.alocal;
+    // Create the file holding attributes and links to subfiles
+    const int cstat = esio_file_create(h, file, overwrite);
+    if (cstat != ESIO_SUCCESS) return cstat;
+    if (ntargets == 0) return ESIO_SUCCESS;
+
+    h->targets = calloc(ntargets, sizeof(struct esio_target_s));
+    if (h->targets == NULL) {
+        esio_file_close(h);
+        ESIO_ERROR("failed to allocate space for targets", ESIO_ENOMEM);
+    }
+    for (int k = 0; k < ntargets; ++k) h->targets[k].file_id = -1;
+    h->ntargets = ntargets;
+
+    // Subfiles are named after the file's final path component
+    const char *base = strrchr(h->file_path, '/');
+    base = base ? base + 1 : h->file_path;
+
+    const hid_t fapl_id = esio_H5P_FILE_ACCESS_create(h);
+    if (fapl_id < 0) {
+        esio_targets_close(h, 0);
+        esio_file_close(h);
+        ESIO_ERROR("Unable to create fapl_id", ESIO_ESANITY);
+    }
+    if (esio_CONFIGURE_METADATA_CACHING(fapl_id) != ESIO_SUCCESS) {
+        H5Pclose(fapl_id);
+        esio_targets_close(h, 0);
+        esio_file_close(h);
+        ESIO_ERROR("Unable to configure metadata caching", ESIO_ESANITY);
+    }
+
+    // Collectively create each subfile and record its canonical path
+    for (int k = 0; k < ntargets; ++k) {
+        const size_t len = strlen(targets[k]) + strlen(base) + 16;
+        char *sub = malloc(len);
+        if (sub == NULL) {
+            H5Pclose(fapl_id);
+            esio_targets_close(h, 0);
+            esio_file_close(h);
+            ESIO_ERROR("failed to allocate space for subfile", ESIO_ENOMEM);
+        }
+        snprintf(sub, len, "%s/%s.%d", targets[k], base, k);
+
+        h->targets[k].file_id = H5Fcreate(
+                sub, overwrite ? H5F_ACC_TRUNC : H5F_ACC_EXCL,
+                H5P_DEFAULT, fapl_id);
+        if (h->targets[k].file_id >= 0) {
+            h->targets[k].path = canonicalize_file_name(
+                    sub + scheme_prefix_len(sub));
+        }
+        free(sub);
+        if (h->targets[k].path == NULL) {
+            H5Pclose(fapl_id);
+            esio_targets_close(h, 0);
+            esio_file_close(h);
+            ESIO_ERROR("Unable to create subfile", ESIO_EFAILED);
+        }
+    }
+    H5Pclose(fapl_id);
 
     return ESIO_SUCCESS;
 }
 
-int
-esio_plane_establish(esio_handle h,
-                     int bglobal, int bstart, int blocal,
-                     int aglobal, int astart, int alocal)
+// Populate *sub as a view of h restricted to this rank's group and subfile.
+// Page cache hints are suppressed as they are collective across groups.
+// Balancing and pipelining are suppressed as groups already write evenly
+// sized blocks.
+static
+int esio_group_view(const esio_handle h, struct esio_handle_s *sub)
 {
-    // Sanity check incoming arguments
-    if (h == NULL)   ESIO_ERROR("h == NULL",   ESIO_EFAULT);
-    if (bglobal < 1) ESIO_ERROR("bglobal < 1", ESIO_EINVAL);
-    if (bstart  < 0) ESIO_ERROR("bstart < 0",  ESIO_EINVAL);
-    if (blocal  < 0) ESIO_ERROR("blocal < 0",  ESIO_EINVAL);
-    if (aglobal < 1) ESIO_ERROR("aglobal < 1", ESIO_EINVAL);
-    if (astart  < 0) ESIO_ERROR("astart < 0",  ESIO_EINVAL);
-    if (alocal  < 0) ESIO_ERROR("alocal < 0",  ESIO_EINVAL);
+    *sub = *h;
+    ESIO_MPICHKQ(MPI_Comm_rank(h->group_comm, &sub->comm_rank));
+    ESIO_MPICHKQ(MPI_Comm_size(h->group_comm, &sub->comm_size));
+    sub->comm       = h->group_comm;
+    sub->node_comm  = MPI_COMM_NULL;
+    sub->file_id    = h->group_file;
+    sub->flags     &= ~(FLAG_READAHEAD_ENABLED | FLAG_BALANCE_ENABLED);
+    sub->balance    = NULL;
+    sub->pipeline   = 1;
+    sub->manifest   = NULL;
+    sub->linetable  = NULL;
+    sub->ntargets   = 0;
+    sub->targets    = NULL;
+    sub->ngroups    = 0;
+    sub->group_comm = MPI_COMM_NULL;
+    sub->group_file = -1;
+    return ESIO_SUCCESS;
+}
 
-    // Save parallel decomposition in handle
-    h->p.bglobal = bglobal;
-    h->p.bstart  = bstart;
-    h->p.blocal  = blocal;
-    h->p.aglobal = aglobal;
-    h->p.astart  = astart;
-    h->p.alocal  = alocal;
+// Collectively create or reopen every group's subfile within its group.
+// Subfiles are open only while esio_field_write_batch_internal writes them.
+// At all other times they are reached solely through external links from the
+// active file, which HDF5 follows using h->comm.  Opening a subfile both ways
+// at once would give one file two MPI-IO communicators.  Failures are not
+// reported.
+static
+int esio_groups_open(esio_handle h, int create, int overwrite)
+{
+    struct esio_handle_s sub;
+    int status = esio_group_view(h, &sub);
+    int group, first, count;
+    esio_group_members(h->comm_size, h->ngroups, h->comm_rank,
+                       &group, &first, &count);
+    char *path = esio_group_path(h->file_path, group);
+    if (status == ESIO_SUCCESS && path == NULL) status = ESIO_ENOMEM;
+    if (status == ESIO_SUCCESS) {
+        const hid_t fapl_id = esio_H5P_FILE_ACCESS_create(&sub);
+        if (   fapl_id < 0
+            || esio_CONFIGURE_METADATA_CACHING(fapl_id) != ESIO_SUCCESS) {
+            status = ESIO_ESANITY;
+        } else {
+            h->group_file = !create
+                ? H5Fopen(path, H5F_ACC_RDWR, fapl_id)
+                : H5Fcreate(path, overwrite ? H5F_ACC_TRUNC : H5F_ACC_EXCL,
+                            H5P_DEFAULT, fapl_id);
+            if (h->group_file < 0) status = ESIO_EFAILED;
+        }
+        if (fapl_id >= 0) H5Pclose(fapl_id);
+    }
+    free(path);
+    return status;
+}
 
-    return ESIO_SUCCESS;
+// Release any group subfile and communicator from esio_file_create_grouped,
+// optionally advising this node's page cache to drop every group's written
+// pages.
+static
+int esio_groups_close(esio_handle h, int evict)
+{
+    int status = ESIO_SUCCESS;
+    if (h->group_file >= 0 && H5Fclose(h->group_file) < 0) {
+        status = ESIO_EFAILED;
+    }
+    for (int g = 0; evict && g < h->ngroups; ++g) {
+        char *path = esio_group_path(h->file_path, g);
+        if (path) esio_readahead_evict(path);
+        free(path);
+    }
+    if (h->group_comm != MPI_COMM_NULL && MPI_Comm_free(&h->group_comm)) {
+        status = ESIO_EFAILED;
+    }
+    h->group_comm = MPI_COMM_NULL;
+    h->group_file = -1;
+    h->ngroups    = 0;
+    return status;
 }
 
 int
-esio_plane_established(esio_handle h,
-                       int *bglobal, int *bstart, int *blocal,
-                       int *aglobal, int *astart, int *alocal)
+esio_file_create_grouped(esio_handle h,
+                         const char *file,
+                         int overwrite,
+                         int ngroups)
 {
     // Sanity check incoming arguments
-    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    }
+    if (file == NULL) {
+        ESIO_ERROR("file == NULL", ESIO_EFAULT);
+    }
+    if (ngroups < 1) {
+        ESIO_ERROR("ngroups < 1", ESIO_EINVAL);
+    }
+    if (ngroups > h->comm_size) {
+        ESIO_ERROR("ngroups exceeds the communicator size", ESIO_EINVAL);
+    }
 
-    // Retrieve parallel decomposition from handle
-    if (bglobal) *bglobal = h->p.bglobal;
-    if (bstart ) *bstart  = h->p.bstart;
-    if (blocal ) *blocal  = h->p.blocal;
-    if (aglobal) *aglobal = h->p.aglobal;
-    if (astart ) *astart  = h->p.astart;
-    if (alocal ) *alocal  = h->p.alocal;
+    // Create the file holding attributes and links to subfiles
+    const int cstat = esio_file_create(h, file, overwrite);
+    if (cstat != ESIO_SUCCESS) return cstat;
+
+    // Split the communicator into contiguous groups of ranks
+    if (esio_group_split(h->comm, ngroups, &h->group_comm) != ESIO_SUCCESS) {
+        esio_file_close(h);
+        ESIO_ERROR("Unable to split communicator into groups", ESIO_EFAILED);
+    }
+    h->ngroups = ngroups;
+
+    // Each group collectively creates its own subfile, which then stays
+    // closed until the next batched write
+    int status = esio_groups_open(h, 1, overwrite);
+    if (h->group_file >= 0 && H5Fclose(h->group_file) < 0) {
+        status = ESIO_EFAILED;
+    }
+    h->group_file = -1;
+
+    // Proceed only when every group obtained its subfile
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status != ESIO_SUCCESS) {
+        esio_file_close(h);
+        ESIO_ERROR("Unable to create group subfile", status);
+    }
 
     return ESIO_SUCCESS;
 }
 
 int
-esio_field_establish(esio_handle h,
-                     int cglobal, int cstart, int clocal,
-                     int bglobal, int bstart, int blocal,
-                     int aglobal, int astart, int alocal)
+esio_file_open(esio_handle h, const char *file, int readwrite)
 {
     // Sanity check incoming arguments
-    if (h == NULL)   ESIO_ERROR("h == NULL",   ESIO_EFAULT);
-    if (cglobal < 1) ESIO_ERROR("cglobal < 1", ESIO_EINVAL);
-    if (cstart  < 0) ESIO_ERROR("cstart < 0",  ESIO_EINVAL);
-    if (clocal  < 0) ESIO_ERROR("clocal < 0",  ESIO_EINVAL);
-    if (bglobal < 1) ESIO_ERROR("bglobal < 1", ESIO_EINVAL);
-    if (bstart  < 0) ESIO_ERROR("bstart < 0",  ESIO_EINVAL);
-    if (blocal  < 0) ESIO_ERROR("blocal < 0",  ESIO_EINVAL);
-    if (aglobal < 1) ESIO_ERROR("aglobal < 1", ESIO_EINVAL);
-    if (astart  < 0) ESIO_ERROR("astart < 0",  ESIO_EINVAL);
-    if (alocal  < 0) ESIO_ERROR("alocal < 0",  ESIO_EINVAL);
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    }
+    if (h->file_id != -1) {
+        ESIO_ERROR("Cannot open new file because previous file not closed",
+                   ESIO_EINVAL);
+    }
+    if (file == NULL) {
+        ESIO_ERROR("file == NULL", ESIO_EFAULT);
+    }
 
-    // Save parallel decomposition in handle
-    h->f.cglobal = cglobal;
-    h->f.cstart  = cstart;
-    h->f.clocal  = clocal;
-    h->f.bglobal = bglobal;
-    h->f.bstart  = bstart;
-    h->f.blocal  = blocal;
-    h->f.aglobal = aglobal;
-    h->f.astart  = astart;
-    h->f.alocal  = alocal;
+    // Files using the stage: scheme are found within the staging directory
+    // once their producer has published them
+    char *staged = NULL;
+    if (stage_scheme(file)) {
+        if (!stage_name_valid(file)) {
+            ESIO_ERROR("stage: names may not contain '/' or '..'",
+                       ESIO_EINVAL);
+        }
+        staged = stage_resolve(file, NULL);
+        if (staged == NULL) {
+            ESIO_ERROR("Unable to resolve staged path", ESIO_ENOMEM);
+        }
+        esio_stage_wait(h, staged);
+        file = staged;
+    }
 
-    return ESIO_SUCCESS;
-}
+    // Initialize file access list property identifier
+    const hid_t fapl_id = esio_H5P_FILE_ACCESS_create(h);
+    if (fapl_id < 0) {
+        free(staged);
+        ESIO_ERROR("Unable to create fapl_id", ESIO_ESANITY);
+    }
+
+    // Set metadata caching options on the file access list property identifier
+    if (esio_CONFIGURE_METADATA_CACHING(fapl_id) != ESIO_SUCCESS) {
+        H5Pclose(fapl_id);
+        free(staged);
+        ESIO_ERROR("Unable to configure metadata caching", ESIO_ESANITY);
+    }
+
+    // Initialize access flags
+    const unsigned flags = readwrite ? H5F_ACC_RDWR : H5F_ACC_RDONLY;
+
+    // Collectively open the file
+    const hid_t file_id = H5Fopen(file, flags, fapl_id);
+    if (file_id < 0) {
+        H5Pclose(fapl_id);
+        free(staged);
+        ESIO_ERROR("Unable to open existing file", ESIO_EFAILED);
+    }
+
+    // Clean up temporary HDF5 resources
+    H5Pclose(fapl_id);
+
+    // Duplicate the (prefix-less) canonical file name for later use
+    // Canonical chosen so that changes in working directory are irrelevant
+    //
+    // canonicalize_file_name (aka. realpath) call just below has three issues:
+    //   1) A race occurs for file creation versus the canonicalize call
+    //   2) Every rank calling canonicalize_file_name hits the file system
+    //   3) Memory usage of the returned string isn't promised to be low
+    //
+    // The messy logic below here is to rectify all three concerns.
+    // It is ugly as sin and chatty but pre-allocating everything in advance is
+    // and calling realpath(3) is buggy as described in realpath(3)'s man page.
+
+    // Collectively best-effort flush to the operating system
+    H5Fflush(file_id, H5F_SCOPE_LOCAL);
+
+    // Last rank canonicalizes the file path, strdups it, and measures length
+    // Error information saved but not reported until later.
+    const int worker = h->comm_size - 1; // Last rank does work
+    int  buf[3] = { /*length*/ -1, /*status*/ ESIO_SUCCESS, /*line*/ -1 };
+    char msg[384];
+    if (h->comm_rank == worker) {
+        static const char msgpat[] = "failed to canonicalize path '%s': %s";
+        const char * s = canonicalize_file_name(file + scheme_prefix_len(file));
+        if (s == NULL) {
+            snprintf(msg, sizeof(msg), msgpat, file, strerror(errno));
+            buf[1] = ESIO_EFAILED;
+            buf[2] = __LINE__;
+        } else if ((h->file_path = strdup(s)) == NULL) {
+            snprintf(msg, sizeof(msg), msgpat, file, strerror(ENOMEM));
+            buf[1] = ESIO_ENOMEM;
+            buf[2] = __LINE__;
+        } else if ((buf[0] = (int) strlen(s)) < 1) {
+            snprintf(msg, sizeof(msg), msgpat, file, strerror(EINVAL));
+            buf[1] = ESIO_ESANITY;
+            buf[2] = __LINE__;
+        }
+        free((void *) s);
+    }
+    free(staged);
+
+    // Broadcast details from rank zero to everyone and return if necessary
+    ESIO_MPICHKQ(MPI_Bcast(buf, sizeof(buf)/sizeof(buf[0]), MPI_INT,
+                           worker, h->comm));
+    if (buf[1] != ESIO_SUCCESS) {
+        if (h->comm_rank == worker) {
+            esio_error(msg, __FILE__, buf[2], buf[1]);
+            free(h->file_path);
+        }
+        return buf[1];
+    }
+
+    // Non-zero ranks allocate space to receive canonical path
+    if (h->comm_rank < worker) h->file_path = malloc(buf[0] + 1);
+    if (h->file_path == NULL)  buf[1] = ESIO_ENOMEM;
+
+    // Did everybody grab memory?  Otherwise subsequent broadcast crashes...
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, buf, sizeof(buf)/sizeof(buf[0]),
+                               MPI_INT, MPI_MAX, h->comm));
+    if (buf[1] != ESIO_SUCCESS) {
+        if (h->file_path == NULL) {
+            ESIO_ERROR_REPORT("failed to allocate space for canonical path",
+                              ESIO_ENOMEM);
+        }
+        free(h->file_path);
+        return buf[1];
+    }
+
+    // Broadcast canonical path from rank zero to other ranks
+    ESIO_MPICHKQ(MPI_Bcast(h->file_path, buf[0] + 1, MPI_CHAR,
+                           worker, h->comm));
+
+    // Load any manifest so metadata lookups need not touch each object
+    const int mstat = esio_manifest_read(file_id, h->comm, &h->manifest);
+    if (mstat != ESIO_SUCCESS) {
+        H5Fclose(file_id);
+        free(h->file_path);
+        h->file_path = NULL;
+        return mstat;
+    }
+
+    // File creation successful: update handle
+    h->file_id = file_id;
+    if (h->flags & FLAG_SMALL_ENABLED) h->flags |= FLAG_FILE_SMALL;
+    if (readwrite) {
+        h->flags |=  FLAG_FILE_WRITABLE;
+    } else {
+        h->flags &= ~FLAG_FILE_WRITABLE;
+    }
+
+    return ESIO_SUCCESS;
+}
+
+int esio_file_clone(esio_handle h,
+                    const char *srcfile,
+                    const char *dstfile,
+                    int overwrite)
+{
+    // Sanity check incoming arguments
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    }
+    if (h->file_id != -1) {
+        ESIO_ERROR("Cannot create file because previous file not closed",
+                   ESIO_EINVAL);
+    }
+    if (srcfile == NULL) {
+        ESIO_ERROR("srcfile == NULL", ESIO_EFAULT);
+    }
+    if (dstfile == NULL) {
+        ESIO_ERROR("dstfile == NULL", ESIO_EFAULT);
+    }
+
+    // One rank copies the file synchronously and "broadcasts" the result;
+    // The "broadcast" is a summing Allreduce that behaves as useful barrier.
+    const int worker = h->comm_size - 1; // Last rank does work
+    int status = 0;
+    if (h->comm_rank == worker) {
+        int prefix_len = scheme_prefix_len(srcfile);
+        status = file_copy(srcfile + prefix_len, dstfile + prefix_len,
+                           overwrite, 1 /*blockuntilsync*/);
+    }
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1/*count*/,
+                               MPI_INT, MPI_SUM, h->comm));
+
+    // Bail now if an error occurred
+    if (status) return status;
+
+    // All ranks then open the file in readwrite mode
+    return esio_file_open(h, dstfile, 1 /* readwrite */);
+}
+
+char* esio_file_path(const esio_handle h)
+{
+    // Sanity check incoming arguments
+    if (h == NULL) {
+        ESIO_ERROR_NULL("h == NULL", ESIO_EFAULT);
+    }
+    if (h->file_id == -1) {
+        return NULL;
+    }
+    if (h->file_path == NULL) {
+        ESIO_ERROR_NULL("file_id != -1 but file_path == NULL", ESIO_ESANITY);
+    }
+
+    // h->file_path has already had any leading URI scheme removed
+    char *retval = strdup(h->file_path);
+    if (retval == NULL) {
+        ESIO_ERROR_NULL("Unable to allocate space for file_path", ESIO_ENOMEM);
+    }
+    return retval;
+}
+
+int esio_file_flush(esio_handle h)
+{
+    // Sanity check incoming arguments
+    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+
+    // Flush any currently open file
+    if (h->file_id != -1) {
+        const int cstat = esio_comments_write(h);
+        if (cstat != ESIO_SUCCESS) return cstat;
+        const int tstat = esio_line_table_flush(h);
+        if (tstat != ESIO_SUCCESS) return tstat;
+        if (H5Fflush(h->file_id, H5F_SCOPE_GLOBAL) < 0) {
+            ESIO_ERROR("Unable to flush file", ESIO_EFAILED);
+        }
+        for (int k = 0; k < h->ntargets; ++k) {
+            if (H5Fflush(h->targets[k].file_id, H5F_SCOPE_GLOBAL) < 0) {
+                ESIO_ERROR("Unable to flush subfile", ESIO_EFAILED);
+            }
+        }
+    }
+
+    return ESIO_SUCCESS;
+}
+
+int esio_file_close(esio_handle h)
+{
+    // Sanity check incoming arguments
+    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+
+    // Close any currently open file
+    int status = ESIO_SUCCESS;
+    if (h->file_id != -1) {
+
+        // Write any deferred comments and staged lines and then record the
+        // provenance and contents of any possibly modified file.  Provenance
+        // changes only when something was written.  Failure is reported but
+        // does not prevent closing.
+        if (h->flags & FLAG_FILE_WRITABLE) {
+            status = esio_comments_write(h);
+            const int tstat = esio_line_table_flush(h);
+            if (status == ESIO_SUCCESS) status = tstat;
+            if (h->flags & FLAG_FILE_WRITTEN) {
+                const int pstat = esio_provenance_write(h);
+                if (status == ESIO_SUCCESS) status = pstat;
+            }
+            const int mstat = esio_manifest_write(h->file_id, h->comm);
+            if (status == ESIO_SUCCESS) status = mstat;
+            if (h->flags & FLAG_VIEWS_ENABLED) {
+                const int vstat = esio_views_write(h);
+                if (status == ESIO_SUCCESS) status = vstat;
+            }
+        }
+        esio_manifest_free(h->manifest);
+        h->manifest = NULL;
+        esio_linetable_free(h->linetable);
+        h->linetable = NULL;
+
+        if (H5Fclose(h->file_id) < 0) {
+            ESIO_ERROR("Unable to close file", ESIO_EFAILED);
+        }
+
+        // Keep freshly written data from evicting the application's pages.
+        // Advice is only a hint so failures are silently ignored.
+        int evict = 0;
+        if (   (h->flags & FLAG_READAHEAD_ENABLED)
+            && (h->flags & FLAG_FILE_WRITABLE)) {
+            int node_rank;
+            ESIO_MPICHKQ(MPI_Comm_rank(h->node_comm, &node_rank));
+            evict = (node_rank == 0);
+        }
+
+        // Close any subfiles only after links to them are no longer needed
+        if (esio_targets_close(h, evict) != ESIO_SUCCESS) {
+            ESIO_ERROR("Unable to close subfile", ESIO_EFAILED);
+        }
+        if (esio_groups_close(h, evict) != ESIO_SUCCESS) {
+            ESIO_ERROR("Unable to close group subfile", ESIO_EFAILED);
+        }
+
+        // Publish staged files only once every subfile is complete and
+        // only if every earlier step succeeded.  Otherwise the partial file
+        // remains for inspection and consumers never see it.
+        if (h->flags & FLAG_FILE_STAGED) {
+            if (MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                              MPI_MAX, h->comm)) {
+                status = ESIO_EFAILED;
+            }
+            if (status == ESIO_SUCCESS) status = esio_stage_publish(h);
+        }
+        if (evict) esio_readahead_evict(h->file_path);
+
+        if (h->file_path) {
+            free(h->file_path);
+            h->file_path = NULL;
+        }
+
+        // Close successful: update handle
+        h->file_id = -1;
+        h->flags  &= ~(FLAG_FILE_WRITABLE | FLAG_FILE_STAGED
+                       | FLAG_FILE_SMALL | FLAG_FILE_WRITTEN);
+    }
+
+    return status;
+}
+
+int esio_file_close_restart(esio_handle h,
+                            const char *restart_template,
+                            int retain_count)
+{
+    // Sanity check incoming arguments
+    // Template sanity checking is performed within restart_rename as well
+    if (h == NULL) {
+        ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    }
+    if (restart_template == NULL) {
+        ESIO_ERROR("restart_template == NULL", ESIO_EFAULT);
+    }
+    if (retain_count < 1) {
+        ESIO_ERROR("retain_count < 1", ESIO_EINVAL);
+    }
+    if (h->file_id == -1) {
+        ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    }
+    if (h->ntargets > 0) {
+        ESIO_ERROR("Cannot rename a file created by esio_file_create_multi",
+                   ESIO_EINVAL);
+    }
+    if (h->ngroups > 0) {
+        ESIO_ERROR("Cannot rename a file created by esio_file_create_grouped",
+                   ESIO_EINVAL);
+    }
+
+    // Copy the current file's canonical path and then close the file
+    char *src_filename = esio_file_path(h);
+    if (src_filename == NULL) {
+        ESIO_ERROR("Unable to clone file's canonical path", ESIO_EFAILED);
+    }
+    const int close_status = esio_file_close(h);
+    if (close_status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to close current restart file", close_status);
+    }
+
+    // One rank invokes restart_rename and "broadcasts" the result.
+    // The "broadcast" is a summing Allreduce that behaves as useful barrier.
+    const int worker = h->comm_size - 1; // Last rank does work
+    int status = 0;
+    if (h->comm_rank == worker) {
+        status = restart_rename(
+                src_filename, // No URI scheme prefix munging required
+                restart_template + scheme_prefix_len(restart_template),
+                retain_count);
+    }
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1/*count*/,
+                               MPI_INT, MPI_SUM, h->comm));
+
+    // Free temporary memory
+    free(src_filename);
+
+    // All ranks return the same status
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Failure in esio_file_close_restart", status);
+    }
+    return ESIO_SUCCESS;
+}
+
+// Create a dataset within the active file or, for files created by
+// esio_file_create_multi, within the subfile assigned the fewest bytes
+// so far.  The latter is reached through an external link named name.
+static
+hid_t esio_dataset_create(const esio_handle h,
+                          const char *name, hid_t type_id, hid_t space_id,
+                          hid_t lcpl_id, hid_t dcpl_id, hid_t dapl_id)
+{
+    if (h->ntargets == 0) {
+        return H5Dcreate2(h->file_id, name, type_id, space_id,
+                          lcpl_id, dcpl_id, dapl_id);
+    }
+
+    // Every rank makes the same choice as all inputs are collective
+    int k = 0;
+    for (int j = 1; j < h->ntargets; ++j) {
+        if (h->targets[j].bytes < h->targets[k].bytes) k = j;
+    }
+
+    const hid_t dset_id = H5Dcreate2(h->targets[k].file_id, name, type_id,
+                                     space_id, lcpl_id, dcpl_id, dapl_id);
+    if (dset_id < 0) {
+        ESIO_ERROR_VAL("Unable to create dataset in subfile",
+                       ESIO_EFAILED, -1);
+    }
+    if (H5Lcreate_external(h->targets[k].path, name, h->file_id, name,
+                           H5P_DEFAULT, H5P_DEFAULT) < 0) {
+        H5Dclose(dset_id);
+        ESIO_ERROR_VAL("Unable to link dataset in subfile",
+                       ESIO_EFAILED, -1);
+    }
+
+    const hssize_t npoints = H5Sget_simple_extent_npoints(space_id);
+    h->targets[k].bytes += (npoints > 0 ? npoints : 0) * H5Tget_size(type_id);
+
+    return dset_id;
+}
+
+static
+hid_t esio_field_create(const esio_handle h,
+                        const char *name, hid_t type_id,
+                        hid_t lcpl_id, hid_t dcpl_id, hid_t dapl_id)
+{
+    // Sanity check that the handle's layout_index matches our internal table
+    if (esio_field_layout[h->layout_index].index != h->layout_index) {
+        ESIO_ERROR_VAL("SEVERE: Consistency error in esio_field_layout",
+                ESIO_ESANITY, -1);
+    }
+
+    // Create the filespace using current layout within handle
+    const hid_t filespace
+        = (esio_field_layout[h->layout_index].filespace_creator)(h->f.cglobal,
+                                                                 h->f.bglobal,
+                                                                 h->f.aglobal);
+    if (filespace < 0) {
+        ESIO_ERROR_VAL("Unable to create filespace", ESIO_ESANITY, -1);
+    }
+
+    // Determine the on-disk type per the handle's storage precision
+    const hid_t storage_id = esio_type_storage(type_id, h->precision);
+    if (storage_id < 0) {
+        H5Sclose(filespace);
+        ESIO_ERROR_VAL("Unable to create storage type", ESIO_EFAILED, -1);
+    }
+
+    // Create the dataspace
+    const hid_t dset_id = esio_dataset_create(h, name, storage_id, filespace,
+                                              lcpl_id, dcpl_id, dapl_id);
+    H5Tclose(storage_id);
+    if (dset_id < 0) {
+        H5Sclose(filespace);
+        ESIO_ERROR_VAL("Unable to create dataspace", ESIO_ESANITY, -1);
+    }
+
+    // Stash field's metadata
+    if (ESIO_SUCCESS != esio_field_metadata_write(
+                h->file_id, name, h->layout_index,
+                h->f.cglobal, h->f.bglobal, h->f.aglobal, type_id)) {
+        H5Sclose(filespace);
+        H5Sclose(dset_id);
+        ESIO_ERROR_VAL("Unable to save field metadata", ESIO_EFAILED, -1);
+    }
+
+    // Clean up temporary resources
+    H5Sclose(filespace);
+
+    return dset_id;
+}
+
+static
+hid_t esio_plane_create(const esio_handle h,
+                        const char *name, hid_t type_id,
+                        hid_t lcpl_id, hid_t dcpl_id, hid_t dapl_id)
+{
+    // Create the filespace
+    const hsize_t dims[2] = { h->p.bglobal, h->p.aglobal };
+    const hid_t filespace = H5Screate_simple(2, dims, NULL);
+    if (filespace < 0) {
+        ESIO_ERROR_VAL("Unable to create filespace", ESIO_ESANITY, -1);
+    }
+
+    // Determine the on-disk type per the handle's storage precision
+    const hid_t storage_id = esio_type_storage(type_id, h->precision);
+    if (storage_id < 0) {
+        H5Sclose(filespace);
+        ESIO_ERROR_VAL("Unable to create storage type", ESIO_EFAILED, -1);
+    }
+
+    // Create the dataspace
+    const hid_t dset_id = esio_dataset_create(h, name, storage_id, filespace,
+                                              lcpl_id, dcpl_id, dapl_id);
+    H5Tclose(storage_id);
+    if (dset_id < 0) {
+        H5Sclose(filespace);
+        ESIO_ERROR_VAL("Unable to create dataspace", ESIO_ESANITY, -1);
+    }
+
+    // Stash plane's metadata
+    if (ESIO_SUCCESS != esio_plane_metadata_write(h->file_id, name,
+                                                  h->p.bglobal, h->p.aglobal,
+                                                  type_id)) {
+        H5Sclose(filespace);
+        H5Dclose(dset_id);
+        ESIO_ERROR_VAL("Unable to save plane metadata", ESIO_EFAILED, -1);
+    }
+
+    // Clean up temporary resources
+    H5Sclose(filespace);
+
+    return dset_id;
+}
+
+static
+hid_t esio_line_create(const esio_handle h,
+                       const char *name, hid_t type_id,
+                       hid_t lcpl_id, hid_t dcpl_id, hid_t dapl_id)
+{
+    // Create the filespace
+    const hsize_t dims[1] = { h->l.aglobal };
+    const hid_t filespace = H5Screate_simple(1, dims, NULL);
+    if (filespace < 0) {
+        ESIO_ERROR_VAL("Unable to create filespace", ESIO_ESANITY, -1);
+    }
+
+    // Lines are stored at native precision though compounds are packed
+    const hid_t storage_id = esio_type_storage(type_id,
+                                               ESIO_PRECISION_NATIVE);
+    if (storage_id < 0) {
+        H5Sclose(filespace);
+        ESIO_ERROR_VAL("Unable to create storage type", ESIO_EFAILED, -1);
+    }
+
+    // Create the dataspace
+    const hid_t dset_id = esio_dataset_create(h, name, storage_id, filespace,
+                                              lcpl_id, dcpl_id, dapl_id);
+    H5Tclose(storage_id);
+    if (dset_id < 0) {
+        H5Sclose(filespace);
+        ESIO_ERROR_VAL("Unable to create dataspace", ESIO_ESANITY, -1);
+    }
+
+    // Stash line's metadata
+    if (ESIO_SUCCESS != esio_line_metadata_write(h->file_id, name,
+                                                 h->l.aglobal, type_id)) {
+        H5Sclose(filespace);
+        H5Dclose(dset_id);
+        ESIO_ERROR_VAL("Unable to save line metadata", ESIO_EFAILED, -1);
+    }
+
+    // Clean up temporary resources
+    H5Sclose(filespace);
+
+    return dset_id;
+}
+
+static
+int esio_field_close(hid_t dataset_id)
+{
+    if (H5Dclose(dataset_id) < 0) {
+        ESIO_ERROR("Error closing field", ESIO_EFAILED);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+static
+int esio_plane_close(hid_t dataset_id)
+{
+    if (H5Dclose(dataset_id) < 0) {
+        ESIO_ERROR("Error closing plane", ESIO_EFAILED);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+static
+int esio_line_close(hid_t dataset_id)
+{
+    if (H5Dclose(dataset_id) < 0) {
+        ESIO_ERROR("Error closing line", ESIO_EFAILED);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+// *********************************************************************
+// PARALLEL DECOMPOSITION DETAILS PARALLEL DECOMPOSITION DETAILS
+// *********************************************************************
+
+int
+esio_line_establish(esio_handle h,
+                    int aglobal, int astart, int alocal)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)   ESIO_ERROR("h == NULL",   ESIO_EFAULT);
+    if (aglobal < 1) ESIO_ERROR("aglobal < 1", ESIO_EINVAL);
+    if (astart  < 0) ESIO_ERROR("astart < 0",  ESIO_EINVAL);
+    if (alocal  < 0) ESIO_ERROR("alocal < 0",  ESIO_EINVAL);
+
+    // Staged lines are grouped by decomposition so they must be written
+    // before any rank's decomposition changes
+    const int fstat = esio_line_table_flush(h);
+    if (fstat != ESIO_SUCCESS) return fstat;
+
+    // Save parallel decomposition in handle
+    h->l.aglobal = aglobal;
+    h->l.astart  = astart;
+    h->l.alocal  = alocal;
+
+    return ESIO_SUCCESS;
+}
+
+int
+esio_line_established(esio_handle h,
+                      int *aglobal, int *astart, int *alocal)
+{
+    // Sanity check incoming arguments
+    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+
+    // Retrieve parallel decomposition from handle
+    if (aglobal) *aglobal = h->l.aglobal;
+    if (astart ) *astart  = h->l.astart;
+    if (alocal ) *alocal  = h->l.alocal;
+
+    return ESIO_SUCCESS;
+}
+
+int
+esio_plane_establish(esio_handle h,
+                     int bglobal, int bstart, int blocal,
+                     int aglobal, int astart, int alocal)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)   ESIO_ERROR("h == NULL",   ESIO_EFAULT);
+    if (bglobal < 1) ESIO_ERROR("bglobal < 1", ESIO_EINVAL);
+    if (bstart  < 0) ESIO_ERROR("bstart < 0",  ESIO_EINVAL);
+    if (blocal  < 0) ESIO_ERROR("blocal < 0",  ESIO_EINVAL);
+    if (aglobal < 1) ESIO_ERROR("aglobal < 1", ESIO_EINVAL);
+    if (astart  < 0) ESIO_ERROR("astart < 0",  ESIO_EINVAL);
+    if (alocal  < 0) ESIO_ERROR("alocal < 0",  ESIO_EINVAL);
+
+    // Save parallel decomposition in handle
+    h->p.bglobal = bglobal;
+    h->p.bstart  = bstart;
+    h->p.blocal  = blocal;
+    h->p.aglobal = aglobal;
+    h->p.astart  = astart;
+    h->p.alocal  = alocal;
+
+    return ESIO_SUCCESS;
+}
+
+int
+esio_plane_established(esio_handle h,
+                       int *bglobal, int *bstart, int *blocal,
+                       int *aglobal, int *astart, int *alocal)
+{
+    // Sanity check incoming arguments
+    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+
+    // Retrieve parallel decomposition from handle
+    if (bglobal) *bglobal = h->p.bglobal;
+    if (bstart ) *bstart  = h->p.bstart;
+    if (blocal ) *blocal  = h->p.blocal;
+    if (aglobal) *aglobal = h->p.aglobal;
+    if (astart ) *astart  = h->p.astart;
+    if (alocal ) *alocal  = h->p.alocal;
+
+    return ESIO_SUCCESS;
+}
+
+int
+esio_field_establish(esio_handle h,
+                     int cglobal, int cstart, int clocal,
+                     int bglobal, int bstart, int blocal,
+                     int aglobal, int astart, int alocal)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)   ESIO_ERROR("h == NULL",   ESIO_EFAULT);
+    if (cglobal < 1) ESIO_ERROR("cglobal < 1", ESIO_EINVAL);
+    if (cstart  < 0) ESIO_ERROR("cstart < 0",  ESIO_EINVAL);
+    if (clocal  < 0) ESIO_ERROR("clocal < 0",  ESIO_EINVAL);
+    if (bglobal < 1) ESIO_ERROR("bglobal < 1", ESIO_EINVAL);
+    if (bstart  < 0) ESIO_ERROR("bstart < 0",  ESIO_EINVAL);
+    if (blocal  < 0) ESIO_ERROR("blocal < 0",  ESIO_EINVAL);
+    if (aglobal < 1) ESIO_ERROR("aglobal < 1", ESIO_EINVAL);
+    if (astart  < 0) ESIO_ERROR("astart < 0",  ESIO_EINVAL);
+    if (alocal  < 0) ESIO_ERROR("alocal < 0",  ESIO_EINVAL);
+
+    // Save parallel decomposition in handle
+    h->f.cglobal = cglobal;
+    h->f.cstart  = cstart;
+    h->f.clocal  = clocal;
+    h->f.bglobal = bglobal;
+    h->f.bstart  = bstart;
+    h->f.blocal  = blocal;
+    h->f.aglobal = aglobal;
+    h->f.astart  = astart;
+    h->f.alocal  = alocal;
+
+    // Any balanced write schedule belonged to the previous decomposition
+    if (h->balance) {
+        free(h->balance->blocks);
+        free(h->balance);
+        h->balance = NULL;
+    }
+
+    return ESIO_SUCCESS;
+}
+
+int
+esio_field_established(esio_handle h,
+                       int *cglobal, int *cstart, int *clocal,
+                       int *bglobal, int *bstart, int *blocal,
+                       int *aglobal, int *astart, int *alocal)
+{
+    // Sanity check incoming arguments
+    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+
+    // Retrieve parallel decomposition from handle
+    if (cglobal) *cglobal = h->f.cglobal;
+    if (cstart ) *cstart  = h->f.cstart;
+    if (clocal ) *clocal  = h->f.clocal;
+    if (bglobal) *bglobal = h->f.bglobal;
+    if (bstart ) *bstart  = h->f.bstart;
+    if (blocal ) *blocal  = h->f.blocal;
+    if (aglobal) *aglobal = h->f.aglobal;
+    if (astart ) *astart  = h->f.astart;
+    if (alocal ) *alocal  = h->f.alocal;
+
+    return ESIO_SUCCESS;
+}
+
+// *********************************************************************
+// SIZE SIZEV SIZE SIZEV SIZE SIZEV SIZE SIZEV SIZE SIZEV SIZE SIZEV
+// *********************************************************************
+
+// The esio_XXX_metadata_lookup functions consult any manifest loaded by
+// esio_file_open before falling back to esio_XXX_metadata_read.  Names absent
+// from the manifest, e.g. those written since opening, or recorded with a
+// different kind take the per-object path so that behavior is unchanged.
+
+static
+int esio_field_metadata_lookup(const esio_handle h, const char *name,
+                               int *layout_index,
+                               int *cglobal, int *bglobal, int *aglobal,
+                               int *ncomponents)
+{
+    const struct esio_manifest_entry *e = esio_manifest_find(h->manifest, name);
+    if (e == NULL || e->kind != ESIO_MANIFEST_FIELD) {
+        return esio_field_metadata_read(h->file_id, name, layout_index,
+                                        cglobal, bglobal, aglobal,
+                                        ncomponents);
+    }
+    if (layout_index) *layout_index = e->layout_index;
+    if (cglobal)      *cglobal      = e->cglobal;
+    if (bglobal)      *bglobal      = e->bglobal;
+    if (aglobal)      *aglobal      = e->aglobal;
+    if (ncomponents)  *ncomponents  = e->ncomponents;
+    return ESIO_SUCCESS;
+}
+
+static
+int esio_plane_metadata_lookup(const esio_handle h, const char *name,
+                               int *bglobal, int *aglobal,
+                               int *ncomponents)
+{
+    const struct esio_manifest_entry *e = esio_manifest_find(h->manifest, name);
+    if (e == NULL || e->kind != ESIO_MANIFEST_PLANE) {
+        return esio_plane_metadata_read(h->file_id, name,
+                                        bglobal, aglobal, ncomponents);
+    }
+    if (bglobal)     *bglobal     = e->bglobal;
+    if (aglobal)     *aglobal     = e->aglobal;
+    if (ncomponents) *ncomponents = e->ncomponents;
+    return ESIO_SUCCESS;
+}
+
+static
+int esio_line_metadata_lookup(const esio_handle h, const char *name,
+                              int *aglobal,
+                              int *ncomponents)
+{
+    const struct esio_manifest_entry *e = esio_manifest_find(h->manifest, name);
+    if (e == NULL || e->kind != ESIO_MANIFEST_LINE) {
+        const int status = esio_line_metadata_read(h->file_id, name,
+                                                   aglobal, ncomponents);
+        if (status == ESIO_SUCCESS) return status;
+
+        // Lines packed into tables are found within the tables' indices
+        const int tstat = esio_linetable_find(&h->linetable, h->file_id, name,
+                                              aglobal, ncomponents,
+                                              NULL, NULL);
+        return (tstat == ESIO_NOTFOUND) ? status : tstat;
+    }
+    if (aglobal)     *aglobal     = e->aglobal;
+    if (ncomponents) *ncomponents = e->ncomponents;
+    return ESIO_SUCCESS;
+}
+
+int esio_field_size(const esio_handle h,
+                    const char *name,
+                    int *cglobal, int *bglobal, int *aglobal)
+{
+    int ncomponents;
+    const int status
+        = esio_field_sizev(h, name, cglobal, bglobal, aglobal, &ncomponents);
+    if (status == ESIO_SUCCESS && ncomponents != 1) {
+        ESIO_ERROR("Must retrieve location size using esio_field_sizev",
+                   ESIO_EINVAL);
+    }
+    return status;
+}
+
+int esio_field_sizev(const esio_handle h,
+                     const char *name,
+                     int *cglobal, int *bglobal, int *aglobal,
+                     int *ncomponents)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
+    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+
+    const int status = esio_field_metadata_lookup(
+            h, name, NULL, cglobal, bglobal, aglobal, ncomponents);
+    switch (status) {
+        case ESIO_SUCCESS:
+        case ESIO_NOTFOUND:  // ESIO_ERROR not called to allow existence query
+            return status;
+        default:
+            ESIO_ERROR("Unable to retrieve field metadata", status);
+    }
+}
+
+int esio_plane_size(const esio_handle h,
+                    const char *name,
+                    int *bglobal, int *aglobal)
+{
+    int ncomponents;
+    const int status
+        = esio_plane_sizev(h, name, bglobal, aglobal, &ncomponents);
+    if (status == ESIO_SUCCESS && ncomponents != 1) {
+        ESIO_ERROR("Must retrieve location size using esio_plane_sizev",
+                   ESIO_EINVAL);
+    }
+    return status;
+}
+
+int esio_plane_sizev(const esio_handle h,
+                     const char *name,
+                     int *bglobal, int *aglobal,
+                     int *ncomponents)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
+    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+
+    const int status = esio_plane_metadata_lookup(
+            h, name, bglobal, aglobal, ncomponents);
+    switch (status) {
+        case ESIO_SUCCESS:
+        case ESIO_NOTFOUND:  // ESIO_ERROR not called to allow existence query
+            return status;
+        default:
+            ESIO_ERROR("Unable to retrieve plane metadata", status);
+    }
+}
+
+int esio_line_size(const esio_handle h,
+                   const char *name,
+                   int *aglobal)
+{
+    int ncomponents;
+    const int status = esio_line_sizev(h, name, aglobal, &ncomponents);
+    if (status == ESIO_SUCCESS && ncomponents != 1) {
+        ESIO_ERROR("Must retrieve location size using esio_line_sizev",
+                   ESIO_EINVAL);
+    }
+    return status;
+}
+
+int esio_line_sizev(const esio_handle h,
+                    const char *name,
+                    int *aglobal,
+                    int *ncomponents)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
+    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+
+    const int status = esio_line_metadata_lookup(
+            h, name, aglobal, ncomponents);
+    switch (status) {
+        case ESIO_SUCCESS:
+        case ESIO_NOTFOUND:  // ESIO_ERROR not called to allow existence query
+            return status;
+        default:
+            ESIO_ERROR("Unable to retrieve line metadata", status);
+    }
+}
+
+// *******************************************************************
+// PAGE CACHE HINTS PAGE CACHE HINTS PAGE CACHE HINTS PAGE CACHE HINTS
+// *******************************************************************
+
+// Name of the file actually holding dset_id or NULL on failure.  Datasets
+// reached through external links reside within subfiles.  The name may have
+// a URI scheme prefix.  The caller must free the result.
+static
+char* esio_dataset_file_name(hid_t dset_id)
+{
+    const ssize_t len = H5Fget_name(dset_id, NULL, 0);
+    char *path = (len > 0) ? malloc(len + 1) : NULL;
+    if (path && H5Fget_name(dset_id, path, len + 1) < 0) {
+        free(path);
+        path = NULL;
+    }
+    return path;
+}
+
+// Collectively advise each node's page cache about the local block of a
+// dataset when FLAG_READAHEAD_ENABLED.  Only datasets storing elements in
+// row-major order at a known offset contribute ranges; all ranks must call.
+// Advice is only a hint so failures are silently ignored.
+static
+void esio_dataset_advise(const esio_handle h, hid_t dset_id, int rowmajor,
+                         int cglobal, int cstart, int clocal,
+                         int bglobal, int bstart, int blocal,
+                         int aglobal, int astart, int alocal,
+                         int advice)
+{
+    if (!(h->flags & FLAG_READAHEAD_ENABLED)) return;
+
+    uint64_t *ranges = NULL;
+    size_t nranges = 0;
+    const haddr_t base = rowmajor ? H5Dget_offset(dset_id) : HADDR_UNDEF;
+    if (base != HADDR_UNDEF) {
+        const hid_t type_id = H5Dget_type(dset_id);
+        const size_t size   = (type_id < 0) ? 0 : H5Tget_size(type_id);
+        if (type_id >= 0) H5Tclose(type_id);
+        ranges = malloc(2 * (clocal > 1 ? clocal : 1) * sizeof(uint64_t));
+        if (ranges && size) {
+            nranges = esio_readahead_ranges(base, size,
+                                            cglobal, cstart, clocal,
+                                            bglobal, bstart, blocal,
+                                            aglobal, astart, alocal,
+                                            ranges);
+        }
+    }
+
+    char *path = esio_dataset_file_name(dset_id);
+    esio_readahead_advise(h->node_comm,
+                          path ? path + scheme_prefix_len(path) : h->file_path,
+                          ranges, nranges, advice);
+    free(path);
+    free(ranges);
+}
+
+// *******************************************************************
+// FIELD READ WRITE FIELD READ WRITE FIELD READ WRITE FIELD READ WRITE
+// *******************************************************************
+
+// Pack elements [lo, hi) of the row-major linearization of a local block
+// with extents local[3] from strided field into contiguous staging.
+static
+void esio_field_pack_range(void *staging, const void *field,
+                           const int *local, const int *strides,
+                           size_t size, size_t lo, size_t hi)
+{
+    const size_t ba = (size_t) local[1] * local[2];
+    char *dst = staging;
+    for (size_t i = lo; i < hi;) {
+        const size_t c = i / ba, b = (i % ba) / local[2], a = i % local[2];
+        size_t run = local[2] - a;
+        if (run > hi - i) run = hi - i;
+        const char *src = (const char *) field
+                        + (c * strides[0] + b * strides[1] + a * strides[2])
+                        * size;
+        if (strides[2] == 1) {
+            memcpy(dst, src, run * size);
+        } else {
+            for (size_t j = 0; j < run; ++j) {
+                memcpy(dst + j * size, src + j * strides[2] * size, size);
+            }
+        }
+        dst += run * size;
+        i   += run;
+    }
+}
+
+// Start collectively writing count elements from staging at offset elements
+// into the current file view.  Without MPI-3.1 nonblocking collective I/O
+// the write completes before returning.
+static
+int esio_field_iwrite_start(MPI_File fh, MPI_Offset offset,
+                            const void *staging, int count,
+                            MPI_Datatype elem, MPI_Request *request)
+{
+#if MPI_VERSION > 3 || (MPI_VERSION == 3 && MPI_SUBVERSION >= 1)
+    return MPI_File_iwrite_at_all(fh, offset, (void *) staging, count, elem,
+                                  request);
+#else
+    *request = MPI_REQUEST_NULL;
+    return MPI_File_write_at_all(fh, offset, (void *) staging, count, elem,
+                                 MPI_STATUS_IGNORE);
+#endif
+}
+
+// Collectively set a view of fh exposing this rank's block, of extents
+// local at start within global, as one contiguous run of elements of the
+// given size.  The dataset's raw data must begin at byte offset.  On
+// success *elem and *block must later be released by esio_field_view_reset.
+static
+int esio_field_view_set(MPI_Comm comm, MPI_File fh, MPI_Offset offset,
+                        const int *global, const int *start, const int *local,
+                        size_t size, MPI_Datatype *elem, MPI_Datatype *block)
+{
+    const int empty = (local[0] == 0 || local[1] == 0 || local[2] == 0);
+    int status = ESIO_SUCCESS;
+    *elem  = MPI_DATATYPE_NULL;
+    *block = MPI_DATATYPE_NULL;
+    if (   MPI_Type_contiguous((int) size, MPI_BYTE, elem)
+        || MPI_Type_commit(elem)) {
+        status = ESIO_EFAILED;
+    }
+    if (status == ESIO_SUCCESS && !empty) {
+        if (   MPI_Type_create_subarray(3, (int *) global, (int *) local,
+                                        (int *) start, MPI_ORDER_C,
+                                        *elem, block)
+            || MPI_Type_commit(block)) {
+            status = ESIO_EFAILED;
+        }
+    }
+    if (MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm)) {
+        status = ESIO_EFAILED;
+    }
+    if (status == ESIO_SUCCESS && MPI_File_set_view(fh, offset, *elem,
+                empty ? *elem : *block, "native", MPI_INFO_NULL)) {
+        status = ESIO_EFAILED;
+    }
+    return status;
+}
+
+// Collectively restore the default view expected by HDF5's MPI-IO driver
+// and release the types created by esio_field_view_set
+static
+int esio_field_view_reset(MPI_File fh, MPI_Datatype *elem,
+                          MPI_Datatype *block)
+{
+    int status = ESIO_SUCCESS;
+    if (MPI_File_set_view(fh, 0, MPI_BYTE, MPI_BYTE, "native",
+                          MPI_INFO_NULL)) {
+        status = ESIO_EFAILED;
+    }
+    if (*block != MPI_DATATYPE_NULL) MPI_Type_free(block);
+    if (*elem  != MPI_DATATYPE_NULL) MPI_Type_free(elem);
+    return status;
+}
+
+// Collectively write this rank's block of a contiguous, row-major dataset
+// whose raw data begins at byte offset within fh.  The block's linearization
+// is split into nsegments ranges.  Each range is packed from the strided
+// field into one staging buffer and written with nonblocking collective
+// MPI-IO while the next range is packed into the other buffer.  Every rank
+// issues the same number of writes, some possibly empty.
+static
+int esio_field_write_overlapped(MPI_Comm comm, MPI_File fh, MPI_Offset offset,
+                                const int *global, const int *start,
+                                const int *local, const int *strides,
+                                const void *field, size_t size,
+                                int nsegments)
+{
+    const size_t n = (size_t) local[0] * local[1] * local[2];
+    const size_t most = (n + nsegments - 1) / nsegments;
+
+    void        *staging[2]  = { NULL, NULL };
+    MPI_Request  requests[2] = { MPI_REQUEST_NULL, MPI_REQUEST_NULL };
+    MPI_Datatype elem, block;
+    for (int j = 0; j < 2; ++j) staging[j] = malloc(most ? most * size : 1);
+    int status = esio_field_view_set(comm, fh, offset, global, start, local,
+                                     size, &elem, &block);
+    int agree = (staging[0] && staging[1]) ? status : ESIO_ENOMEM;
+    if (MPI_Allreduce(MPI_IN_PLACE, &agree, 1, MPI_INT, MPI_MAX, comm)) {
+        agree = ESIO_EFAILED;
+    }
+
+    for (int k = 0; k < nsegments && agree == ESIO_SUCCESS; ++k) {
+        const int j = k % 2;
+        if (MPI_Wait(&requests[j], MPI_STATUS_IGNORE)) agree = ESIO_EFAILED;
+        const size_t lo = ( (size_t) k      * n) / nsegments;
+        const size_t hi = (((size_t) k + 1) * n) / nsegments;
+        esio_field_pack_range(staging[j], field, local, strides, size, lo, hi);
+        if (esio_field_iwrite_start(fh, (MPI_Offset) lo, staging[j],
+                                    (int) (hi - lo), elem, &requests[j])) {
+            agree = ESIO_EFAILED;
+        }
+    }
+    for (int j = 0; j < 2; ++j) {
+        if (MPI_Wait(&requests[j], MPI_STATUS_IGNORE)) agree = ESIO_EFAILED;
+    }
+
+    const int rstat = esio_field_view_reset(fh, &elem, &block);
+    free(staging[1]);
+    free(staging[0]);
+    return agree != ESIO_SUCCESS ? agree : rstat;
+}
+
+// Collectively open or create a field for writing directly through MPI-IO.
+// Only layout 0 fields stored contiguously without conversion in a file
+// opened with the MPI-IO driver qualify, and no rank may transfer more than
+// nmax elements at once.  Whenever the field does not qualify *dset_id is
+// negative and nothing was changed so that the caller writes it as usual.
+// Otherwise the caller must close *dset_id.
+static
+int esio_field_direct_open(const esio_handle h, const char *name,
+                           hid_t type_id, size_t nmax, hid_t *dset_id,
+                           MPI_File *fh, MPI_Offset *offset)
+{
+    *dset_id = -1;
+
+    // Qualification depends only on collective inputs and file contents
+    int layout_index = h->layout_index;
+    int c, b, a, ncomponents;
+    const int exists = (ESIO_SUCCESS == esio_field_metadata_lookup(
+                h, name, &layout_index, &c, &b, &a, &ncomponents));
+    int ok = (h->ntargets == 0)
+          && layout_index == 0
+          && !(h->flags & (FLAG_CHUNKING_ENABLED | FLAG_SPARSE_ENABLED))
+          && (!exists || (   c == h->f.cglobal && b == h->f.bglobal
+                          && a == h->f.aglobal));
+    if (ok) {
+        const hid_t fapl_id = H5Fget_access_plist(h->file_id);
+        ok = (fapl_id >= 0) && (H5Pget_driver(fapl_id) == H5FD_MPIO);
+        if (fapl_id >= 0) H5Pclose(fapl_id);
+    }
+    if (ok && !exists) {
+        const hid_t storage_id = esio_type_storage(type_id, h->precision);
+        ok = (storage_id >= 0) && (H5Tequal(storage_id, type_id) > 0);
+        if (storage_id >= 0) H5Tclose(storage_id);
+    }
+    ok = ok && nmax <= INT_MAX;
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT,
+                               MPI_LAND, h->comm));
+    if (!ok) return ESIO_SUCCESS;
+
+    // Open or create the contiguous dataset with its space allocated early
+    hid_t id = -1;
+    if (exists) {
+        id = H5Dopen2(h->file_id, name, H5P_DEFAULT);
+    } else {
+        const hid_t dcpl_id = H5Pcreate(H5P_DATASET_CREATE);
+        if (   dcpl_id >= 0
+            && H5Pset_layout(dcpl_id, H5D_CONTIGUOUS) >= 0
+            && H5Pset_alloc_time(dcpl_id, H5D_ALLOC_TIME_EARLY) >= 0
+            && H5Pset_fill_time(dcpl_id, H5D_FILL_TIME_NEVER) >= 0) {
+            id = esio_field_create(h, name, type_id,
+                                   H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
+        }
+        if (dcpl_id >= 0) H5Pclose(dcpl_id);
+    }
+    if (id < 0) ESIO_ERROR("Unable to open or create field", ESIO_EFAILED);
+
+    // Existing datasets must match the memory type and be contiguous
+    const hid_t dcpl_id = H5Dget_create_plist(id);
+    const hid_t dtype   = H5Dget_type(id);
+    const haddr_t addr  = H5Dget_offset(id);
+    ok = dcpl_id >= 0 && dtype >= 0
+      && H5Pget_layout(dcpl_id) == H5D_CONTIGUOUS
+      && H5Tequal(dtype, type_id) > 0
+      && addr != HADDR_UNDEF;
+    if (dtype   >= 0) H5Tclose(dtype);
+    if (dcpl_id >= 0) H5Pclose(dcpl_id);
+    MPI_File *handle = NULL;
+    if (ok && (H5Fget_vfd_handle(h->file_id, H5P_DEFAULT,
+                                 (void **) &handle) < 0 || handle == NULL)) {
+        ok = 0;
+    }
+    if (!ok) {
+        esio_field_close(id);
+        if (exists) return ESIO_SUCCESS; // Written as usual by the caller
+        ESIO_ERROR("New field unexpectedly unsuitable for direct writes",
+                   ESIO_ESANITY);
+    }
+
+    *dset_id = id;
+    *fh      = *handle;
+    *offset  = (MPI_Offset) addr;
+    return ESIO_SUCCESS;
+}
+
+// Pipeline an evenly decomposed field write by packing one segment while the
+// previous one is written directly through MPI-IO.  Sets *done to zero, and
+// writes nothing, whenever esio_field_direct_open finds the field unsuitable
+// so that the caller writes it as usual.
+static
+int esio_field_write_pipelined(const esio_handle h,
+                               const char *name,
+                               const void *field,
+                               int cstride, int bstride, int astride,
+                               const char *comment,
+                               hid_t type_id,
+                               int *done)
+{
+    const size_t n = (size_t) h->f.clocal * h->f.blocal * h->f.alocal;
+    hid_t dset_id;
+    MPI_File fh;
+    MPI_Offset offset;
+    const int ostat = esio_field_direct_open(
+            h, name, type_id, (n + h->pipeline - 1) / h->pipeline,
+            &dset_id, &fh, &offset);
+    *done = (ostat != ESIO_SUCCESS || dset_id >= 0);
+    if (!*done || ostat != ESIO_SUCCESS) return ostat;
+
+    const int global[3]  = { h->f.cglobal, h->f.bglobal, h->f.aglobal };
+    const int start[3]   = { h->f.cstart,  h->f.bstart,  h->f.astart  };
+    const int local[3]   = { h->f.clocal,  h->f.blocal,  h->f.alocal  };
+    const int strides[3] = { cstride, bstride, astride };
+    const int wstat = esio_field_write_overlapped(
+            h->comm, fh, offset, global, start, local, strides,
+            field, H5Tget_size(type_id), h->pipeline);
+
+    // Written data need not remain cached
+    if (wstat == ESIO_SUCCESS) {
+        esio_dataset_advise(h, dset_id, 1,
+                h->f.cglobal, h->f.cstart, h->f.clocal,
+                h->f.bglobal, h->f.bstart, h->f.blocal,
+                h->f.aglobal, h->f.astart, h->f.alocal,
+                ESIO_READAHEAD_DONTNEED);
+    }
+    esio_field_close(dset_id);
+    if (wstat != ESIO_SUCCESS) {
+        ESIO_ERROR("Error writing pipelined field", wstat);
+    }
+
+    return esio_comment_defer(h, name, comment);
+}
+
+static
+int esio_field_write_internal(const esio_handle h,
+                              const char *name,
+                              const void *field,
+                              int cstride, int bstride, int astride,
+                              const char *comment,
+                              hid_t type_id)
+{
+    // Sanity check incoming arguments
+    // Strides must be nonnegative because hsize_t is unsigned
+    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
+    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+    if (field == NULL && h->f.clocal && h->f.blocal && h->f.alocal) {
+                          ESIO_ERROR("field == NULL",           ESIO_EFAULT);
+    }
+    if (cstride < 0)      ESIO_ERROR("cstride < 0",            ESIO_EINVAL);
+    if (bstride < 0)      ESIO_ERROR("bstride < 0",            ESIO_EINVAL);
+    if (astride < 0)      ESIO_ERROR("astride < 0",            ESIO_EINVAL);
+    // (comment == NULL) is valid input
+    if (type_id < 0)      ESIO_ERROR("type_id < 0",            ESIO_EINVAL);
+    if (h->f.aglobal == 0)
+        ESIO_ERROR("esio_field_establish() never called", ESIO_EINVAL);
+    h->flags |= FLAG_FILE_WRITTEN; // Provenance is updated at close
+
+    // Provide contiguous defaults whenever the user supplied zero strides.
+    // Strides are given in units of type_id; hence astride = 1 is contiguous.
+    if (astride == 0) astride = 1;
+    if (bstride == 0) bstride = astride * h->f.alocal;
+    if (cstride == 0) cstride = bstride * h->f.blocal;
+
+    // Uneven decompositions are first redistributed onto balanced blocks,
+    // pipelining the exchange with the write whenever requested
+    if ((h->flags & FLAG_BALANCE_ENABLED) || h->pipeline > 1) {
+        int redistribute;
+        const int bstat = esio_balance_schedule(h, &redistribute);
+        if (bstat != ESIO_SUCCESS) return bstat;
+        if (redistribute) {
+            return esio_field_write_balanced(h, name, field,
+                                             cstride, bstride, astride,
+                                             comment, type_id);
+        }
+    }
+
+    // Evenly decomposed writes overlap packing with nonblocking MPI-IO
+    if (h->pipeline > 1) {
+        int done;
+        const int pstat = esio_field_write_pipelined(h, name, field,
+                                                     cstride, bstride, astride,
+                                                     comment, type_id, &done);
+        if (done) return pstat;
+    }
+
+    // Attempt to read metadata for the field (which may or may not exist)
+    int layout_index;
+    int field_cglobal, field_bglobal, field_aglobal;
+    int field_ncomponents;
+    const int mstat = esio_field_metadata_lookup(h, name,
+                                                 &layout_index,
+                                                 &field_cglobal,
+                                                 &field_bglobal,
+                                                 &field_aglobal,
+                                                 &field_ncomponents);
+
+    if (mstat != ESIO_SUCCESS) {
+        // Presume field did not exist
+
+        // Sparse writes of new fields always require chunking
+        double fill[4];
+        const int sparse = esio_field_sparse_fill(h, type_id,
+                                                  fill, sizeof(fill));
+        const int chunked = sparse || (h->flags & FLAG_CHUNKING_ENABLED);
+
+        // Determine the chunking parameters to use for dataset creation
+        // if they've not already been computed.  Note values are cached!
+        if (chunked && h->f.achunk == 0) {
+            const int status = chunksize_field(h->comm, // Expensive
+                    h->f.cglobal, h->f.cstart, h->f.clocal, &h->f.cchunk,
+                    h->f.bglobal, h->f.bstart, h->f.blocal, &h->f.bchunk,
+                    h->f.aglobal, h->f.astart, h->f.alocal, &h->f.achunk);
+            if (status != ESIO_SUCCESS) {
+                ESIO_ERROR("Error determining chunk size for decomposition",
+                        status);
+            }
+        }
+
+        // Sparse fields subdivide the cached chunks for finer skipping
+        int cchunk = h->f.cchunk, bchunk = h->f.bchunk, achunk = h->f.achunk;
+        if (sparse) {
+            esio_field_sparse_chunks(H5Tget_size(type_id),
+                                     &cchunk, &bchunk, &achunk);
+        }
+
+        // Create a dataset creation property list with chunk parameters
+        hid_t dcpl_id = H5Pcreate(H5P_DATASET_CREATE);
+        if (dcpl_id < 0) {
+            ESIO_ERROR("Error creating dataset creation property list",
+                       ESIO_EFAILED);
+        }
+        if (chunked) {
+            if ((esio_field_layout[h->layout_index].dataset_chunker)(
+                        dcpl_id, cchunk, bchunk, achunk) < 0) {
+                H5Pclose(dcpl_id);
+                ESIO_ERROR("Error setting chunk size information",
+                        ESIO_ESANITY);
+            }
+        }
+
+        // Sparse fields allocate chunks only when written and read back
+        // the fill value wherever they were not
+        if (sparse) {
+            if (   H5Pset_fill_value(dcpl_id, type_id, fill) < 0
+                || H5Pset_fill_time(dcpl_id, H5D_FILL_TIME_IFSET) < 0
+                || H5Pset_alloc_time(dcpl_id, H5D_ALLOC_TIME_INCR) < 0) {
+                H5Pclose(dcpl_id);
+                ESIO_ERROR("Error setting fill value information",
+                        ESIO_EFAILED);
+            }
+        }
+
+        // Create dataset and write it with the active field layout
+        const hid_t dset_id = esio_field_create(
+                h, name, type_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
+        if (dset_id < 0) {
+            ESIO_ERROR("Error creating new field", ESIO_EFAILED);
+        }
+
+        // Close creation property list
+        H5Pclose(dcpl_id);
+
+        // Obtain appropriate dataset transfer properties
+        const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
+        if (plist_id < 0) {
+            ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
+        }
+
+        // Write the field using the appropriate layout logic
+        const int wstat = sparse
+            ? esio_field_layout0_sparse_writer(
+                plist_id, dset_id, field,
+                h->f.cglobal, h->f.cstart, h->f.clocal, cstride,
+                h->f.bglobal, h->f.bstart, h->f.blocal, bstride,
+                h->f.aglobal, h->f.astart, h->f.alocal, astride,
+                cchunk, bchunk, achunk,
+                type_id, fill)
+            : (esio_field_layout[h->layout_index].field_writer)(
+                plist_id, dset_id, field,
+                h->f.cglobal, h->f.cstart, h->f.clocal, cstride,
+                h->f.bglobal, h->f.bstart, h->f.blocal, bstride,
+                h->f.aglobal, h->f.astart, h->f.alocal, astride,
+                type_id);
+        if (wstat != ESIO_SUCCESS) {
+            esio_field_close(dset_id);
+            H5Pclose(plist_id);
+            ESIO_ERROR_VAL("Error writing new field", ESIO_EFAILED, wstat);
+        }
+        H5Pclose(plist_id);
+
+        // Written data need not remain cached
+        esio_dataset_advise(h, dset_id,
+                esio_field_layout[h->layout_index].rowmajor,
+                h->f.cglobal, h->f.cstart, h->f.clocal,
+                h->f.bglobal, h->f.bstart, h->f.blocal,
+                h->f.aglobal, h->f.astart, h->f.alocal,
+                ESIO_READAHEAD_DONTNEED);
+
+        esio_field_close(dset_id);
+
+        // Optionally record a comment about the new field
+        const int cstat = esio_comment_defer(h, name, comment);
+        if (cstat != ESIO_SUCCESS) return cstat;
+
+    } else {
+        // Field already existed
+
+        // Ensure caller gave correct size information
+        if (h->f.cglobal != field_cglobal) {
+            ESIO_ERROR("request cglobal mismatch with existing field",
+                       ESIO_EINVAL);
+        }
+        if (h->f.bglobal != field_bglobal) {
+            ESIO_ERROR("request bglobal mismatch with existing field",
+                       ESIO_EINVAL);
+        }
+        if (h->f.aglobal != field_aglobal) {
+            ESIO_ERROR("request aglobal mismatch with existing field",
+                       ESIO_EINVAL);
+        }
+
+        // Ensure caller gave type with correct component count
+        if (esio_type_ncomponents(type_id) != field_ncomponents) {
+            ESIO_ERROR("request ncomponents mismatch with existing field",
+                       ESIO_EINVAL);
+        }
+
+        // Open the existing field's dataset
+        const hid_t dset_id = H5Dopen1(h->file_id, name);
+        if (dset_id < 0) {
+            ESIO_ERROR("Unable to open dataset", ESIO_EFAILED);
+        }
+
+        // Delta-encoded fields hold XOR differences which plain values
+        // would silently replace while the reference attribute remained
+        char *reference = esio_delta_reference(dset_id);
+        if (reference) {
+            free(reference);
+            H5Dclose(dset_id);
+            ESIO_ERROR("existing field is delta-encoded; "
+                       "use esio_field_write_delta_double or similar",
+                       ESIO_EINVAL);
+        }
+
+        // Check if supplied type can be converted to the field's type
+        const hid_t field_type_id = H5Dget_type(dset_id);
+        H5T_cdata_t *pcdata;
+        const H5T_conv_t converter = H5Tfind(type_id, field_type_id, &pcdata);
+        if (converter == NULL) {
+            H5Tclose(field_type_id);
+            H5Dclose(dset_id);
+            ESIO_ERROR("request type not convertible to existing field type",
+                       ESIO_EINVAL);
+        }
+        H5Tclose(field_type_id);
+
+        // Obtain appropriate dataset transfer properties
+        const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
+        if (plist_id < 0) {
+            ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
+        }
+
+        // Overwrite existing data using layout routines per metadata
+        const int wstat = (esio_field_layout[layout_index].field_writer)(
+                plist_id, dset_id, field,
+                h->f.cglobal, h->f.cstart, h->f.clocal, cstride,
+                h->f.bglobal, h->f.bstart, h->f.blocal, bstride,
+                h->f.aglobal, h->f.astart, h->f.alocal, astride,
+                type_id);
+        if (wstat != ESIO_SUCCESS) {
+            esio_field_close(dset_id);
+            H5Pclose(plist_id);
+            ESIO_ERROR_VAL("Error overwriting field", ESIO_EFAILED, wstat);
+        }
+        H5Pclose(plist_id);
+
+        // Written data need not remain cached
+        esio_dataset_advise(h, dset_id,
+                esio_field_layout[layout_index].rowmajor,
+                h->f.cglobal, h->f.cstart, h->f.clocal,
+                h->f.bglobal, h->f.bstart, h->f.blocal,
+                h->f.aglobal, h->f.astart, h->f.alocal,
+                ESIO_READAHEAD_DONTNEED);
+
+        esio_field_close(dset_id);
+
+        // Optionally record a comment about the field
+        const int cstat = esio_comment_defer(h, name, comment);
+        if (cstat != ESIO_SUCCESS) return cstat;
+
+    }
+
+    return ESIO_SUCCESS;
+}
+
+static
+int esio_field_read_internal(const esio_handle h,
+                             const char *name,
+                             void *field,
+                             int cstride, int bstride, int astride,
+                             const char *comment,
+                             hid_t type_id)
+{
+    char msg[256]; // message buffer for error handling
+    (void) comment; // Present for consistency with esio_field_write_internal
+    assert(comment == 0);
+
+    // Sanity check incoming arguments
+    // Strides must be nonnegative because hsize_t is unsigned
+    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
+    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+    if (field == NULL && h->f.clocal && h->f.blocal && h->f.alocal) {
+                          ESIO_ERROR("field == NULL",           ESIO_EFAULT);
+    }
+    if (cstride < 0)      ESIO_ERROR("cstride < 0",            ESIO_EINVAL);
+    if (bstride < 0)      ESIO_ERROR("bstride < 0",            ESIO_EINVAL);
+    if (astride < 0)      ESIO_ERROR("astride < 0",            ESIO_EINVAL);
+    if (type_id < 0)      ESIO_ERROR("type_id < 0",            ESIO_EINVAL);
+    if (h->f.aglobal == 0)
+        ESIO_ERROR("esio_field_establish() never called", ESIO_EINVAL);
+
+    // Provide contiguous defaults whenever the user supplied zero strides.
+    // Strides are given in units of type_id; hence astride = 1 is contiguous.
+    if (astride == 0) astride = 1;
+    if (bstride == 0) bstride = astride * h->f.alocal;
+    if (cstride == 0) cstride = bstride * h->f.blocal;
+
+    // Read metadata for the field
+    int layout_index;
+    int field_cglobal, field_bglobal, field_aglobal;
+    int field_ncomponents;
+    const int status = esio_field_metadata_lookup(h, name,
+                                                  &layout_index,
+                                                  &field_cglobal,
+                                                  &field_bglobal,
+                                                  &field_aglobal,
+                                                  &field_ncomponents);
+    switch (status) {
+        case ESIO_SUCCESS:
+            break;
+        case ESIO_NOTFOUND:
+	    snprintf(msg, sizeof(msg), "Field '%s' not found in file", name);
+            ESIO_ERROR(msg, status);
+        default:
+            ESIO_ERROR("Unable to read field's ESIO metadata", status);
+    }
+
+    // Ensure caller gave correct size information
+    if (h->f.cglobal != field_cglobal) {
+        ESIO_ERROR("field read request has incorrect cglobal", ESIO_EINVAL);
+    }
+    if (h->f.bglobal != field_bglobal) {
+        ESIO_ERROR("field read request has incorrect bglobal", ESIO_EINVAL);
+    }
+    if (h->f.aglobal != field_aglobal) {
+        ESIO_ERROR("field read request has incorrect aglobal", ESIO_EINVAL);
+    }
+
+    // Ensure caller gave type with correct component count
+    if (esio_type_ncomponents(type_id) != field_ncomponents) {
+        ESIO_ERROR("request ncomponents mismatch with existing field",
+                    ESIO_EINVAL);
+    }
+
+    // Open existing dataset
+    const hid_t dapl_id = H5P_DEFAULT;
+    const hid_t dset_id = H5Dopen2(h->file_id, name, dapl_id);
+    if (dset_id < 0) {
+        ESIO_ERROR("Unable to open dataset", ESIO_EFAILED);
+    }
+
+    // Delta-encoded fields are reconstructed starting from their reference
+    char *reference = esio_delta_reference(dset_id);
+    if (reference) {
+        const int dstat = esio_field_read_delta(h, dset_id, reference, field,
+                                                cstride, bstride, astride,
+                                                type_id);
+        free(reference);
+        esio_field_close(dset_id);
+        return dstat;
+    }
+
+    // Check if supplied type can be converted to the field's type
+    const hid_t field_type_id = H5Dget_type(dset_id);
+    H5T_cdata_t *pcdata;
+    const H5T_conv_t converter = H5Tfind(type_id, field_type_id, &pcdata);
+    if (converter == NULL) {
+        H5Dclose(dset_id);
+        H5Tclose(field_type_id);
+        ESIO_ERROR("request type not convertible to existing field type",
+                    ESIO_EINVAL);
+    }
+    H5Tclose(field_type_id);
+
+    // Obtain appropriate dataset transfer properties
+    const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
+    if (plist_id < 0) {
+        H5Dclose(dset_id);
+        H5Tclose(field_type_id);
+        ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
+    }
+
+    // Have each node prefetch what its ranks are about to read
+    esio_dataset_advise(h, dset_id, esio_field_layout[layout_index].rowmajor,
+            h->f.cglobal, h->f.cstart, h->f.clocal,
+            h->f.bglobal, h->f.bstart, h->f.blocal,
+            h->f.aglobal, h->f.astart, h->f.alocal,
+            ESIO_READAHEAD_WILLNEED);
+
+    // Read the field based on the metadata's layout_index
+    // Note that this means we can read any layout ESIO understands
+    // Note that reading does not change the chosen field write layout_index
+    (esio_field_layout[layout_index].field_reader)(
+            plist_id, dset_id, field,
+            h->f.cglobal, h->f.cstart, h->f.clocal, cstride,
+            h->f.bglobal, h->f.bstart, h->f.blocal, bstride,
+            h->f.aglobal, h->f.astart, h->f.alocal, astride,
+            type_id);
+
+    H5Pclose(plist_id);
+
+    // Close dataset
+    esio_field_close(dset_id);
+
+    return ESIO_SUCCESS;
+}
+
+#define GEN_FIELD_OP(OP,QUAL,TYPE,H5TYPE,CMTPAR,CMTARG)              \
+int esio_field_ ## OP ## _ ## TYPE (                                 \
+        const esio_handle h,                                         \
+        const char *name,                                            \
+        QUAL TYPE *field,                                            \
+        int cstride, int bstride, int astride                        \
+        CMTPAR)                                                      \
+{                                                                    \
+    return esio_field_ ## OP ## _internal(h, name, field,            \
+                                          cstride, bstride, astride  \
+                                          CMTARG,                    \
+                                          H5TYPE);                   \
+}
+
+GEN_FIELD_OP(write, const,       double, H5T_NATIVE_DOUBLE, WCMTPAR, WCMTARG)
+GEN_FIELD_OP(read,  /*mutable*/, double, H5T_NATIVE_DOUBLE, RCMTPAR, RCMTARG)
+
+GEN_FIELD_OP(write, const,       float, H5T_NATIVE_FLOAT, WCMTPAR, WCMTARG)
+GEN_FIELD_OP(read,  /*mutable*/, float, H5T_NATIVE_FLOAT, RCMTPAR, RCMTARG)
+
+GEN_FIELD_OP(write, const,       int, H5T_NATIVE_INT, WCMTPAR, WCMTARG)
+GEN_FIELD_OP(read,  /*mutable*/, int, H5T_NATIVE_INT, RCMTPAR, RCMTARG)
+
+
+#define GEN_FIELD_OPV(OP,QUAL,TYPE,H5TYPE,CMTPAR,CMTARG)                  \
+int esio_field_ ## OP ## v_ ## TYPE(                                      \
+        const esio_handle h,                                              \
+        const char *name,                                                 \
+        QUAL TYPE *field,                                                 \
+        int cstride, int bstride, int astride,                            \
+        int ncomponents                                                   \
+        CMTPAR)                                                           \
+{                                                                         \
+    const hid_t array_type_id = esio_type_arrayify(H5TYPE, ncomponents);  \
+                                                                          \
+    /* Input strides are in units of sizeof(TYPE). HDF5 requires slab */  \
+    /* selection using sizeof(array_type_id) and cannot use "partial" */  \
+    /* offsets in this selection process.  Check strides conform.     */  \
+    if (cstride % ncomponents) {                                          \
+        H5Tclose(array_type_id);                                          \
+        ESIO_ERROR("cstride must be an integer multiple of ncomponents",  \
+                   ESIO_EINVAL);                                          \
+    }                                                                     \
+    if (bstride % ncomponents) {                                          \
+        H5Tclose(array_type_id);                                          \
+        ESIO_ERROR("bstride must be an integer multiple of ncomponents",  \
+                   ESIO_EINVAL);                                          \
+    }                                                                     \
+    if (astride % ncomponents) {                                          \
+        H5Tclose(array_type_id);                                          \
+        ESIO_ERROR("astride must be an integer multiple of ncomponents",  \
+                   ESIO_EINVAL);                                          \
+    }                                                                     \
+    const int retval = esio_field_ ## OP ## _internal(                    \
+            h, name, field,                                               \
+            (cstride / ncomponents),                                      \
+            (bstride / ncomponents),                                      \
+            (astride / ncomponents)                                       \
+            CMTARG,                                                       \
+            array_type_id);                                               \
+    H5Tclose(array_type_id);                                              \
+    return retval;                                                        \
+}
+
+GEN_FIELD_OPV(write, const,       double, H5T_NATIVE_DOUBLE, WCMTPAR, WCMTARG)
+GEN_FIELD_OPV(read,  /*mutable*/, double, H5T_NATIVE_DOUBLE, RCMTPAR, RCMTARG)
+
+GEN_FIELD_OPV(write, const,       float, H5T_NATIVE_FLOAT, WCMTPAR, WCMTARG)
+GEN_FIELD_OPV(read,  /*mutable*/, float, H5T_NATIVE_FLOAT, RCMTPAR, RCMTARG)
+
+GEN_FIELD_OPV(write, const,       int, H5T_NATIVE_INT, WCMTPAR, WCMTARG)
+GEN_FIELD_OPV(read,  /*mutable*/, int, H5T_NATIVE_INT, RCMTPAR, RCMTARG)
+
+// *******************************************************************
+// FIELD STREAMING FIELD STREAMING FIELD STREAMING FIELD STREAMING FIELD
+// *******************************************************************
+
+// Find the planes of this rank's block in C moved by slab k of at most
+// cslab planes.  Exhausted blocks yield an empty slab at their end.
+static
+void esio_field_stream_slab(const struct field_decomp_s *whole, int cslab,
+                            int k, int *cstart, int *clocal)
+{
+    const int offset = (k * cslab < whole->clocal) ? k * cslab
+                                                   : whole->clocal;
+    *clocal = (whole->clocal - offset < cslab) ? whole->clocal - offset
+                                               : cslab;
+    *cstart = whole->cstart + offset;
+}
+
+// Collectively stream a field write directly through MPI-IO using two
+// staging buffers of at most cslab planes of C each.  The callback fills
+// one slab while the previous slab is written by nonblocking collective
+// MPI-IO.  Sets *done to zero, and writes nothing, whenever
+// esio_field_direct_open finds the field unsuitable so that the caller
+// streams it as usual.
+static
+int esio_field_write_stream_direct(const esio_handle h,
+                                   const char *name,
+                                   int cslab,
+                                   esio_field_stream_callback callback,
+                                   void *user_data,
+                                   const char *comment,
+                                   hid_t type_id,
+                                   int *done)
+{
+    const struct field_decomp_s *f = &h->f;
+    const size_t size   = H5Tget_size(type_id);
+    const int    ncslab = f->clocal < cslab ? f->clocal : cslab;
+    const size_t plane  = (size_t) f->blocal * f->alocal;
+    hid_t dset_id;
+    MPI_File fh;
+    MPI_Offset offset;
+    const int ostat = esio_field_direct_open(h, name, type_id,
+                                             ncslab * plane,
+                                             &dset_id, &fh, &offset);
+    *done = (ostat != ESIO_SUCCESS || dset_id >= 0);
+    if (!*done || ostat != ESIO_SUCCESS) return ostat;
+
+    // Every rank participates in as many writes as the busiest rank.
+    // Allocation failures are agreed within the same reduction.
+    void        *slab[2]     = { NULL, NULL };
+    MPI_Request  requests[2] = { MPI_REQUEST_NULL, MPI_REQUEST_NULL };
+    MPI_Datatype elem, block;
+    const size_t nbytes = ncslab * plane * size;
+    for (int j = 0; j < 2; ++j) slab[j] = malloc(nbytes ? nbytes : 1);
+    const int global[3] = { f->cglobal, f->bglobal, f->aglobal };
+    const int start[3]  = { f->cstart,  f->bstart,  f->astart  };
+    const int local[3]  = { f->clocal,  f->blocal,  f->alocal  };
+    const int vstat = esio_field_view_set(h->comm, fh, offset, global, start,
+                                          local, size, &elem, &block);
+    int agree[2] = { (f->clocal + cslab - 1) / cslab,
+                     (slab[0] && slab[1]) ? vstat : ESIO_ENOMEM };
+    if (MPI_Allreduce(MPI_IN_PLACE, agree, 2, MPI_INT, MPI_MAX, h->comm)) {
+        agree[1] = ESIO_EFAILED;
+    }
+    const int nslabs = agree[0];
+    int status = agree[1];
+
+    // Callback failures skip that rank's later callbacks but not its
+    // writes, so one agreement after the final slab suffices.
+    int cbstat = 0;
+    for (int k = 0; k < nslabs && status == ESIO_SUCCESS; ++k) {
+        const int j = k % 2;
+        int cstart, clocal;
+        esio_field_stream_slab(f, cslab, k, &cstart, &clocal);
+        if (MPI_Wait(&requests[j], MPI_STATUS_IGNORE)) status = ESIO_EFAILED;
+        if (clocal > 0 && !cbstat) {
+            cbstat = callback(slab[j], cstart, clocal, user_data);
+        }
+        if (esio_field_iwrite_start(fh,
+                    (MPI_Offset) (cstart - f->cstart) * plane, slab[j],
+                    (int) (clocal * plane), elem, &requests[j])) {
+            status = ESIO_EFAILED;
+        }
+    }
+    for (int j = 0; j < 2; ++j) {
+        if (MPI_Wait(&requests[j], MPI_STATUS_IGNORE)) status = ESIO_EFAILED;
+    }
+    const int rstat = esio_field_view_reset(fh, &elem, &block);
+    if (status == ESIO_SUCCESS) status = rstat;
+    free(slab[1]);
+    free(slab[0]);
+
+    // Written data need not remain cached
+    if (status == ESIO_SUCCESS) {
+        esio_dataset_advise(h, dset_id, 1,
+                f->cglobal, f->cstart, f->clocal,
+                f->bglobal, f->bstart, f->blocal,
+                f->aglobal, f->astart, f->alocal,
+                ESIO_READAHEAD_DONTNEED);
+    }
+    esio_field_close(dset_id);
+
+    if (cbstat && status == ESIO_SUCCESS) status = ESIO_EFAILED;
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Error streaming field", status);
+    }
+    return esio_comment_defer(h, name, comment);
+}
+
+// Collectively move this rank's field block through a staging buffer
+// holding at most cslab planes of C.  Each slab is transferred by
+// temporarily narrowing the established decomposition in C and invoking
+// the usual write or read path.  All ranks perform the same number of
+// transfers so that collective IO remains matched.
+static
+int esio_field_stream_internal(const esio_handle h,
+                               const char *name,
+                               int cslab,
+                               esio_field_stream_callback callback,
+                               void *user_data,
+                               const char *comment,
+                               hid_t type_id,
+                               int writing)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
+    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+    if (callback == NULL) ESIO_ERROR("callback == NULL",       ESIO_EFAULT);
+    if (cslab < 1)        ESIO_ERROR("cslab < 1",              ESIO_EINVAL);
+    if (h->f.aglobal == 0)
+        ESIO_ERROR("esio_field_establish() never called", ESIO_EINVAL);
+    if (writing) h->flags |= FLAG_FILE_WRITTEN;
+
+    // Only layout 0 stores a sub-block of C exactly as a whole block would
+    int layout_index, c, b, a, n;
+    const int mstat = esio_field_metadata_lookup(h, name, &layout_index,
+                                                 &c, &b, &a, &n);
+    if (mstat != ESIO_SUCCESS) {
+        if (!writing) ESIO_ERROR("Unable to read field's ESIO metadata", mstat);
+        layout_index = h->layout_index;
+    }
+    if (layout_index != 0) {
+        ESIO_ERROR("Streaming requires field layout 0", ESIO_EINVAL);
+    }
+
+    // Compute and cache chunking for the full decomposition before
+    // narrowing it.  Otherwise slab extents would determine chunk sizes.
+    if (writing && h->flags & FLAG_CHUNKING_ENABLED && h->f.achunk == 0) {
+        const int status = chunksize_field(h->comm, // Expensive
+                h->f.cglobal, h->f.cstart, h->f.clocal, &h->f.cchunk,
+                h->f.bglobal, h->f.bstart, h->f.blocal, &h->f.bchunk,
+                h->f.aglobal, h->f.astart, h->f.alocal, &h->f.achunk);
+        if (status != ESIO_SUCCESS) {
+            ESIO_ERROR("Error determining chunk size for decomposition",
+                       status);
+        }
+    }
+
+    // Writers overlap producing one slab with writing the previous one
+    // whenever the field may be written directly
+    if (writing) {
+        int done;
+        const int dstat = esio_field_write_stream_direct(h, name, cslab,
+                                                         callback, user_data,
+                                                         comment, type_id,
+                                                         &done);
+        if (done) return dstat;
+    }
+
+    // Every rank participates in as many transfers as the busiest rank.
+    // Allocation failures are agreed within the same reduction.
+    const struct field_decomp_s whole = h->f;
+    const int ncslab = whole.clocal < cslab ? whole.clocal : cslab;
+    const size_t nbytes = (size_t) ncslab * whole.blocal * whole.alocal
+                        * H5Tget_size(type_id);
+    void *slab = malloc(nbytes ? nbytes : 1);
+    int agree[2] = { (whole.clocal + cslab - 1) / cslab,
+                     slab ? ESIO_SUCCESS : ESIO_ENOMEM };
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, agree, 2, MPI_INT,
+                               MPI_MAX, h->comm));
+    const int nslabs = agree[0];
+    int status = agree[1];
+    if (status != ESIO_SUCCESS) {
+        free(slab);
+        ESIO_ERROR("Unable to allocate staging buffer", status);
+    }
+
+    // Readers hinting the page cache keep the dataset open to prefetch
+    const hid_t dset_id = (!writing && (h->flags & FLAG_READAHEAD_ENABLED))
+                        ? H5Dopen2(h->file_id, name, H5P_DEFAULT) : -1;
+
+    // Callback failures skip that rank's later callbacks but not its
+    // transfers, so one agreement after the final slab suffices.
+    const int flags = h->flags;
+    int cbstat = 0;
+    for (int k = 0; k < nslabs && status == ESIO_SUCCESS; ++k) {
+        int cstart, clocal;
+        esio_field_stream_slab(&whole, cslab, k, &cstart, &clocal);
+
+        // Writers obtain the slab before it is stored
+        if (writing && clocal > 0 && !cbstat) {
+            cbstat = callback(slab, cstart, clocal, user_data);
+        }
+
+        h->f.cstart = cstart;
+        h->f.clocal = clocal;
+        if (!writing && k > 0) {
+            h->flags &= ~FLAG_READAHEAD_ENABLED; // Prefetched below
+        }
+        status = writing
+               ? esio_field_write_internal(h, name, slab, 0, 0, 0,
+                                           k ? NULL : comment, type_id)
+               : esio_field_read_internal(h, name, slab, 0, 0, 0,
+                                          NULL, type_id);
+        h->f     = whole;
+        h->flags = flags;
+        if (writing || status != ESIO_SUCCESS) continue;
+
+        // Hint the next slab so it is fetched while this one is consumed
+        if (k + 1 < nslabs) {
+            int nstart, nlocal;
+            esio_field_stream_slab(&whole, cslab, k + 1, &nstart, &nlocal);
+            esio_dataset_advise(h, dset_id,
+                    esio_field_layout[layout_index].rowmajor,
+                    whole.cglobal, nstart, nlocal,
+                    whole.bglobal, whole.bstart, whole.blocal,
+                    whole.aglobal, whole.astart, whole.alocal,
+                    ESIO_READAHEAD_WILLNEED);
+        }
+
+        // Readers consume the slab after it is loaded
+        if (clocal > 0 && !cbstat) {
+            cbstat = callback(slab, cstart, clocal, user_data);
+        }
+    }
+    if (dset_id >= 0) H5Dclose(dset_id);
+    free(slab);
+
+    if (cbstat && status == ESIO_SUCCESS) status = ESIO_EFAILED;
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Error streaming field", status);
+    }
+    return ESIO_SUCCESS;
+}
+
+#define GEN_FIELD_OP_STREAM(TYPE,H5TYPE)                                  \
+int esio_field_write_stream_ ## TYPE(                                     \
+        const esio_handle h,                                              \
+        const char *name,                                                 \
+        int cslab,                                                        \
+        esio_field_stream_callback callback,                              \
+        void *user_data,                                                  \
+        const char *comment)                                              \
+{                                                                         \
+    return esio_field_stream_internal(h, name, cslab, callback,           \
+                                      user_data, comment, H5TYPE, 1);     \
+}                                                                         \
+                                                                          \
+int esio_field_read_stream_ ## TYPE(                                      \
+        const esio_handle h,                                              \
+        const char *name,                                                 \
+        int cslab,                                                        \
+        esio_field_stream_callback callback,                              \
+        void *user_data)                                                  \
+{                                                                         \
+    return esio_field_stream_internal(h, name, cslab, callback,           \
+                                      user_data, NULL, H5TYPE, 0);        \
+}
+
+GEN_FIELD_OP_STREAM(double, H5T_NATIVE_DOUBLE)
+GEN_FIELD_OP_STREAM(float,  H5T_NATIVE_FLOAT)
+GEN_FIELD_OP_STREAM(int,    H5T_NATIVE_INT)
+
+// *******************************************************************
+// BATCHED FIELD WRITES BATCHED FIELD WRITES BATCHED FIELD WRITES BATCH
+// *******************************************************************
+
+// Create a committed datatype selecting the overlap of blocks x and y from
+// a contiguous buffer holding block x.  Blocks are {c,b,a}{start,local}.
+// Returns zero without creating any type whenever the overlap is empty.
+static
+int esio_block_overlap(const int *x, const int *y,
+                       MPI_Datatype elem, MPI_Datatype *type)
+{
+    int sizes[3], subsizes[3], starts[3];
+    for (int d = 0; d < 3; ++d) {
+        const int lo = x[2*d] > y[2*d] ? x[2*d] : y[2*d];
+        const int xe = x[2*d] + x[2*d+1], ye = y[2*d] + y[2*d+1];
+        const int hi = xe < ye ? xe : ye;
+        if (hi <= lo) return 0;
+        sizes[d]    = x[2*d+1];
+        subsizes[d] = hi - lo;
+        starts[d]   = lo - x[2*d];
+    }
+    if (   MPI_Type_create_subarray(3, sizes, subsizes, starts,
+                                    MPI_ORDER_C, elem, type)
+        || MPI_Type_commit(type)) {
+        return -1;
+    }
+    return 1;
+}
+
+// Collectively write several scalar-valued fields.  Fields which already
+// exist, and all fields when the active file is not grouped, are written
+// one after another.  Otherwise, new fields are dealt round-robin to the
+// groups.  During each round, one MPI_Alltoallw moves every rank's share of
+// up to ngroups fields to the groups owning them, each group writes its field
+// to its own subfile concurrently, and all ranks link the results into the
+// active file.  Every rank stages only its share of one field at a time.
+// Group subfiles are open only between the first and last round so that
+// fields reached through links never find them already open.
+static
+int esio_field_write_batch_internal(const esio_handle h,
+                                    int nfields,
+                                    const char * const *names,
+                                    const void * const *fields,
+                                    const char * const *comments,
+                                    hid_t type_id)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
+    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    if (nfields < 0)      ESIO_ERROR("nfields < 0",            ESIO_EINVAL);
+    if (nfields > 0 && names == NULL)
+                          ESIO_ERROR("names == NULL",          ESIO_EFAULT);
+    if (nfields > 0 && fields == NULL)
+                          ESIO_ERROR("fields == NULL",         ESIO_EFAULT);
+    // (comments == NULL) is valid input
+    if (h->f.aglobal == 0)
+        ESIO_ERROR("esio_field_establish() never called", ESIO_EINVAL);
+    for (int j = 0; j < nfields; ++j) {
+        if (names[j] == NULL) ESIO_ERROR("names[j] == NULL", ESIO_EFAULT);
+    }
+    h->flags |= FLAG_FILE_WRITTEN;
+
+    // Write without redistribution whenever grouping cannot help
+    int *pending = malloc((nfields ? nfields : 1) * sizeof(int));
+    if (pending == NULL) {
+        ESIO_ERROR("Unable to allocate batch information", ESIO_ENOMEM);
+    }
+    int npending = 0;
+    for (int j = 0; j < nfields; ++j) {
+        int layout_index, c, b, a, ncomponents;
+        if (   h->ngroups > 0
+            && esio_field_metadata_lookup(h, names[j], &layout_index,
+                                          &c, &b, &a, &ncomponents)
+               != ESIO_SUCCESS) {
+            pending[npending++] = j;
+            continue;
+        }
+        const int wstat = esio_field_write_internal(
+                h, names[j], fields[j], 0, 0, 0,
+                comments ? comments[j] : NULL, type_id);
+        if (wstat != ESIO_SUCCESS) {
+            free(pending);
+            return wstat;
+        }
+    }
+    if (npending == 0) {
+        free(pending);
+        return ESIO_SUCCESS;
+    }
+
+    // Learn every rank's block within the established decomposition
+    const int mine[6] = { h->f.cstart, h->f.clocal,
+                          h->f.bstart, h->f.blocal,
+                          h->f.astart, h->f.alocal };
+    const int n = h->comm_size;
+    int *blocks  = malloc(6 * n * sizeof(int));
+    int *scounts = malloc(4 * n * sizeof(int));
+    MPI_Datatype *stypes = malloc(2 * n * sizeof(MPI_Datatype));
+    int status = (blocks && scounts && stypes) ? ESIO_SUCCESS : ESIO_ENOMEM;
+    if (scounts) memset(scounts, 0, 4 * n * sizeof(int));
+    if (   status == ESIO_SUCCESS
+        && MPI_Allgather((void *) mine, 6, MPI_INT,
+                         blocks, 6, MPI_INT, h->comm)) {
+        status = ESIO_EFAILED;
+    }
+    int *rcounts = scounts + n, *sdispls = scounts + 2*n,
+        *rdispls = scounts + 3*n;
+    MPI_Datatype *rtypes = stypes ? stypes + n : NULL;
+
+    // Determine this rank's block when writing within its group
+    struct esio_handle_s sub;
+    if (status == ESIO_SUCCESS) status = esio_groups_open(h, 0, 0);
+    if (status == ESIO_SUCCESS) status = esio_group_view(h, &sub);
+    int group, dst[6];
+    esio_group_block(h->comm_size, h->ngroups, h->comm_rank,
+                     h->f.cglobal, h->f.bglobal, h->f.aglobal, &group, dst);
+    sub.f.cstart = dst[0]; sub.f.clocal = dst[1];
+    sub.f.bstart = dst[2]; sub.f.blocal = dst[3];
+    sub.f.astart = dst[4]; sub.f.alocal = dst[5];
+    sub.f.cchunk = sub.f.bchunk = sub.f.achunk = 0;
+
+    const size_t size = H5Tget_size(type_id);
+    const size_t nbytes = (size_t) dst[1] * dst[3] * dst[5] * size;
+    void *staging = malloc(nbytes ? nbytes : 1);
+    if (staging == NULL) status = ESIO_ENOMEM;
+
+    MPI_Datatype elem = MPI_DATATYPE_NULL;
+    if (   status == ESIO_SUCCESS
+        && MPI_Type_contiguous((int) size, MPI_BYTE, &elem)) {
+        status = ESIO_EFAILED;
+    }
+    if (MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, h->comm)) {
+        status = ESIO_EFAILED;
+    }
+
+    const int nrounds = (npending + h->ngroups - 1) / h->ngroups;
+    for (int k = 0; k < nrounds && status == ESIO_SUCCESS; ++k) {
+
+        // Describe what moves between each pair of ranks this round.
+        // Sends address user buffers absolutely relative to MPI_BOTTOM.
+        const int i = esio_group_field(h->ngroups, k, group);
+        for (int r = 0; r < n && status == ESIO_SUCCESS; ++r) {
+            int g, blk[6];
+            esio_group_block(h->comm_size, h->ngroups, r, h->f.cglobal,
+                             h->f.bglobal, h->f.aglobal, &g, blk);
+            const int l = esio_group_field(h->ngroups, k, g);
+
+            MPI_Datatype overlap;
+            int ostat = (l < npending)
+                      ? esio_block_overlap(mine, blk, elem, &overlap) : 0;
+            scounts[r] = 0; sdispls[r] = 0; stypes[r] = MPI_BYTE;
+            if (ostat > 0) {
+                MPI_Aint addr;
+                int one = 1;
+                if (   MPI_Get_address((void *) fields[pending[l]], &addr)
+                    || MPI_Type_create_struct(1, &one, &addr, &overlap,
+                                              &stypes[r])
+                    || MPI_Type_commit(&stypes[r])) {
+                    ostat = -1;
+                } else {
+                    scounts[r] = 1;
+                }
+                MPI_Type_free(&overlap);
+            }
+
+            rcounts[r] = 0; rdispls[r] = 0; rtypes[r] = MPI_BYTE;
+            if (ostat >= 0 && i < npending) {
+                ostat = esio_block_overlap(dst, blocks + 6*r, elem,
+                                           &rtypes[r]);
+                if (ostat > 0) rcounts[r] = 1;
+            }
+            if (ostat < 0) status = ESIO_EFAILED;
+        }
+        if (MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                          MPI_MAX, h->comm)) {
+            status = ESIO_EFAILED;
+        }
+        if (status == ESIO_SUCCESS && MPI_Alltoallw(
+                    MPI_BOTTOM, scounts, sdispls, stypes,
+                    staging,    rcounts, rdispls, rtypes, h->comm)) {
+            status = ESIO_EFAILED;
+        }
+        for (int r = 0; r < n; ++r) {
+            if (scounts[r]) MPI_Type_free(&stypes[r]);
+            if (rcounts[r]) MPI_Type_free(&rtypes[r]);
+            scounts[r] = rcounts[r] = 0;
+        }
+
+        // Groups write their fields concurrently
+        if (status == ESIO_SUCCESS && i < npending) {
+            status = esio_field_write_internal(
+                    &sub, names[pending[i]], staging, 0, 0, 0,
+                    NULL, type_id);
+        }
+        if (MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                          MPI_MAX, h->comm)) {
+            status = ESIO_EFAILED;
+        }
+
+        // Collectively link this round's fields into the active file.
+        // Comments are deferred through the links, as every rank sees them.
+        for (int g = 0; g < h->ngroups && status == ESIO_SUCCESS; ++g) {
+            const int l = esio_group_field(h->ngroups, k, g);
+            if (l >= npending) break;
+            const int j = pending[l];
+            char *path = esio_group_path(h->file_path, g);
+            if (path == NULL) {
+                status = ESIO_ENOMEM;
+            } else if (H5Lcreate_external(path, names[j], h->file_id,
+                                          names[j],
+                                          H5P_DEFAULT, H5P_DEFAULT) < 0) {
+                status = ESIO_EFAILED;
+            } else {
+                status = esio_comment_defer(h, names[j],
+                                            comments ? comments[j] : NULL);
+            }
+            free(path);
+        }
+    }
+
+    // Close subfiles before anything may reach them through links
+    if (h->group_file >= 0 && H5Fclose(h->group_file) < 0) {
+        status = ESIO_EFAILED;
+    }
+    h->group_file = -1;
+
+    if (elem != MPI_DATATYPE_NULL) MPI_Type_free(&elem);
+    free(staging);
+    free(stypes);
+    free(scounts);
+    free(blocks);
+    free(pending);
+
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Error writing batch of fields", status);
+    }
+    return ESIO_SUCCESS;
+}
+
+#define GEN_FIELD_OP_BATCH(TYPE,H5TYPE)                                   \
+int esio_field_write_batch_ ## TYPE(                                      \
+        const esio_handle h,                                              \
+        int nfields,                                                      \
+        const char * const *names,                                        \
+        const TYPE * const *fields,                                       \
+        const char * const *comments)                                     \
+{                                                                         \
+    return esio_field_write_batch_internal(h, nfields, names,             \
+                                           (const void * const *) fields, \
+                                           comments, H5TYPE);             \
+}
+
+GEN_FIELD_OP_BATCH(double, H5T_NATIVE_DOUBLE)
+GEN_FIELD_OP_BATCH(float,  H5T_NATIVE_FLOAT)
+GEN_FIELD_OP_BATCH(int,    H5T_NATIVE_INT)
+
+// *******************************************************************
+// DEFERRED COMMENTS DEFERRED COMMENTS DEFERRED COMMENTS DEFERRED COMMEN
+// *******************************************************************
+
+// Remember comment for the object name within h->file_id so that it may be
+// written by esio_comments_write.  Only the latest comment for each object
+// is retained.  Empty comments and all comments on handles with comments
+// disabled are discarded.
+static
+int esio_comment_defer(const esio_handle h,
+                       const char *name,
+                       const char *comment)
+{
+    if (comment == NULL || *comment == '\0') return ESIO_SUCCESS;
+    if (h->flags & FLAG_COMMENTS_DISABLED)   return ESIO_SUCCESS;
+
+    struct esio_comment_s *c = h->comments->head;
+    while (c && (c->file_id != h->file_id || strcmp(c->name, name))) {
+        c = c->next;
+    }
+    if (c) {
+        if (strcmp(c->text, comment) == 0) return ESIO_SUCCESS;
+        char *text = strdup(comment);
+        if (text == NULL) {
+            ESIO_ERROR("Unable to allocate space for comment", ESIO_ENOMEM);
+        }
+        free(c->text);
+        c->text = text;
+        return ESIO_SUCCESS;
+    }
+
+    c = malloc(sizeof(struct esio_comment_s));
+    char *copy = strdup(name);
+    char *text = strdup(comment);
+    if (c == NULL || copy == NULL || text == NULL) {
+        free(c);
+        free(copy);
+        free(text);
+        ESIO_ERROR("Unable to allocate space for comment", ESIO_ENOMEM);
+    }
+    c->file_id = h->file_id;
+    c->name    = copy;
+    c->text    = text;
+    c->next    = h->comments->head;
+    h->comments->head = c;
+
+    return ESIO_SUCCESS;
+}
+
+// Collectively write every deferred comment in one pass, leaving any object
+// already carrying the requested comment untouched.  Every rank sharing a
+// file defers the same comments in the same order and so makes identical
+// metadata modifications.  Deferred comments are discarded even on failure.
+static
+int esio_comments_write(const esio_handle h)
+{
+    int status = ESIO_SUCCESS;
+    char *existing = NULL;
+    size_t capacity = 0;
+
+    while (h->comments->head) {
+        struct esio_comment_s *c = h->comments->head;
+        h->comments->head = c->next;
+
+        const hid_t obj_id = (status == ESIO_SUCCESS)
+                           ? H5Oopen(c->file_id, c->name, H5P_DEFAULT) : -1;
+        if (obj_id < 0) {
+            status = ESIO_EFAILED;
+        } else {
+            const size_t len = strlen(c->text);
+            const ssize_t old = H5Oget_comment(obj_id, NULL, 0);
+            int same = 0;
+            if (old >= 0 && (size_t) old == len) {
+                if (capacity <= len) {
+                    free(existing);
+                    capacity = len + 1;
+                    existing = malloc(capacity);
+                }
+                same = existing
+                    && H5Oget_comment(obj_id, existing, capacity) >= 0
+                    && strcmp(existing, c->text) == 0;
+            }
+            if (!same && H5Oset_comment(obj_id, c->text) < 0) {
+                status = ESIO_EFAILED;
+            }
+            H5Oclose(obj_id);
+        }
+
+        free(c->name);
+        free(c->text);
+        free(c);
+    }
+    free(existing);
+
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Error setting deferred comments", status);
+    }
+    return ESIO_SUCCESS;
+}
+
+// Root attribute describing the most recent writer of a file
+#define ESIO_PROVENANCE_ATTRIBUTE "esio_provenance"
+
+// Collectively record which ESIO version wrote the file, using how many
+// ranks, which field decomposition, and when.  The decomposition is the
+// global field extents plus a hash of every rank's block so that restarts
+// can detect a changed decomposition.  Rank zero's clock is used so all
+// ranks agree.
+static
+int esio_provenance_write(const esio_handle h)
+{
+    const int mine[6] = { h->f.cstart, h->f.clocal,
+                          h->f.bstart, h->f.blocal,
+                          h->f.astart, h->f.alocal };
+    int *blocks = NULL;
+    if (h->comm_rank == 0) {
+        blocks = malloc(6 * h->comm_size * sizeof(int));
+        if (blocks == NULL) {
+            ESIO_ERROR("Unable to allocate provenance blocks", ESIO_ENOMEM);
+        }
+    }
+    const int gstat = MPI_Gather((void *) mine, 6, MPI_INT,
+                                 blocks, 6, MPI_INT, 0, h->comm);
+    if (gstat != MPI_SUCCESS) {
+        free(blocks);
+        ESIO_MPICHKQ(gstat);
+    }
+
+    char text[160] = "";
+    if (h->comm_rank == 0) {
+        // FNV-1a over the gathered blocks in rank order
+        unsigned long long hash = 14695981039346656037ULL;
+        const unsigned char *p = (const unsigned char *) blocks;
+        for (size_t i = 0; i < 6 * h->comm_size * sizeof(int); ++i) {
+            hash ^= p[i];
+            hash *= 1099511628211ULL;
+        }
+        free(blocks);
+
+        const time_t now = time(NULL);
+        struct tm utc;
+        char when[32] = "unknown";
+        if (gmtime_r(&now, &utc)) {
+            strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        }
+        snprintf(text, sizeof(text),
+                 "ESIO %d.%d.%d; ranks %d; field %dx%dx%d blocks %016llx;"
+                 " written %s",
+                 ESIO_MAJOR_VERSION, ESIO_MINOR_VERSION, ESIO_POINT_VERSION,
+                 h->comm_size, h->f.cglobal, h->f.bglobal, h->f.aglobal,
+                 hash, when);
+    }
+    ESIO_MPICHKQ(MPI_Bcast(text, sizeof(text), MPI_CHAR, 0, h->comm));
+
+    if (H5LTset_attribute_string(h->file_id, "/",
+                                 ESIO_PROVENANCE_ATTRIBUTE, text) < 0) {
+        ESIO_ERROR("Unable to record file provenance", ESIO_EFAILED);
+    }
+    return ESIO_SUCCESS;
+}
+
+// *******************************************************************
+// BALANCED FIELD WRITES BALANCED FIELD WRITES BALANCED FIELD WRITES BAL
+// *******************************************************************
+
+// Balancing is worthwhile only when the busiest rank holds this many times
+// the data it would hold after redistribution
+static const double esio_balance_skew = 1.25;
+
+// Find the outermost direction with at least one plane per rank
+static
+int esio_balance_direction(const esio_handle h)
+{
+    const int global[3] = { h->f.cglobal, h->f.bglobal, h->f.aglobal };
+    int d = 0;
+    while (d < 2 && global[d] < h->comm_size) ++d;
+    return d;
+}
+
+// Find the given rank's balanced {c,b,a}{start,local} block.  The direction
+// from esio_balance_direction is split evenly so that every block is
+// rectangular and, in row-major layouts, contiguous on disk.
+static
+void esio_balance_block(const esio_handle h, int rank, int *blk)
+{
+    const int global[3] = { h->f.cglobal, h->f.bglobal, h->f.aglobal };
+    const int d = esio_balance_direction(h);
+    for (int e = 0; e < 3; ++e) {
+        blk[2*e] = 0; blk[2*e+1] = global[e];
+    }
+    const long lo = ((long) rank       * global[d]) / h->comm_size;
+    const long hi = ((long) (rank + 1) * global[d]) / h->comm_size;
+    blk[2*d] = (int) lo; blk[2*d+1] = (int) (hi - lo);
+}
+
+// Collectively obtain the cached balanced write schedule for the current
+// field decomposition, computing it whenever any rank's block has changed.
+static
+int esio_balance_schedule(const esio_handle h, int *redistribute)
+{
+    const int mine[6] = { h->f.cstart, h->f.clocal,
+                          h->f.bstart, h->f.blocal,
+                          h->f.astart, h->f.alocal };
+
+    // Streaming writes adjust blocks directly so confirm the cache is current
+    int stale = (h->balance == NULL)
+             || memcmp(h->balance->blocks + 6*h->comm_rank, mine, sizeof(mine));
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &stale, 1, MPI_INT,
+                               MPI_LOR, h->comm));
+    if (!stale) {
+        *redistribute = h->balance->redistribute;
+        return ESIO_SUCCESS;
+    }
+
+    if (h->balance) {
+        free(h->balance->blocks);
+        free(h->balance);
+    }
+    struct esio_balance_s *b = malloc(sizeof(struct esio_balance_s));
+    int *blocks = malloc(6 * h->comm_size * sizeof(int));
+    int status = (b && blocks) ? ESIO_SUCCESS : ESIO_ENOMEM;
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status != ESIO_SUCCESS) {
+        free(blocks);
+        free(b);
+        h->balance = NULL;
+        ESIO_ERROR("Unable to allocate balanced write schedule", status);
+    }
+    ESIO_MPICHKQ(MPI_Allgather((void *) mine, 6, MPI_INT,
+                               blocks, 6, MPI_INT, h->comm));
+
+    // Compare the busiest rank before and after balancing
+    double before = 0, after = 0;
+    for (int r = 0; r < h->comm_size; ++r) {
+        int blk[6];
+        esio_balance_block(h, r, blk);
+        const double x = (double) blocks[6*r+1] * blocks[6*r+3]
+                                                * blocks[6*r+5];
+        const double y = (double) blk[1] * blk[3] * blk[5];
+        if (x > before) before = x;
+        if (y > after)  after  = y;
+    }
+    b->blocks       = blocks;
+    b->redistribute = before > esio_balance_skew * after;
+    esio_balance_block(h, h->comm_rank, b->dst);
+    h->balance = b;
+
+    *redistribute = b->redistribute;
+    return ESIO_SUCCESS;
+}
+
+// Create a committed datatype selecting the overlap of blocks x and y from
+// field, which holds block x using strides measured in units of elem.  The
+// type addresses memory absolutely so it must be used with MPI_BOTTOM.
+// Returns zero without creating any type whenever the overlap is empty.
+static
+int esio_block_overlap_strided(const int *x, const int *y,
+                               const void *field, const int *strides,
+                               MPI_Datatype elem, MPI_Aint size,
+                               MPI_Datatype *type)
+{
+    int count[3];
+    MPI_Aint offset = 0;
+    for (int d = 0; d < 3; ++d) {
+        const int lo = x[2*d] > y[2*d] ? x[2*d] : y[2*d];
+        const int xe = x[2*d] + x[2*d+1], ye = y[2*d] + y[2*d+1];
+        const int hi = xe < ye ? xe : ye;
+        if (hi <= lo) return 0;
+        count[d] = hi - lo;
+        offset  += (MPI_Aint) (lo - x[2*d]) * strides[d] * size;
+    }
+
+    MPI_Datatype t[4] = { elem, MPI_DATATYPE_NULL,
+                          MPI_DATATYPE_NULL, MPI_DATATYPE_NULL };
+    int failed = 0;
+    for (int d = 2; d >= 0 && !failed; --d) {
+        failed = MPI_Type_create_hvector(count[d], 1,
+                                         (MPI_Aint) strides[d] * size,
+                                         t[2 - d], &t[3 - d]);
+    }
+    MPI_Aint addr;
+    int one = 1;
+    if (   !failed
+        && !MPI_Get_address((void *) ((const char *) field + offset), &addr)
+        && !MPI_Type_create_struct(1, &one, &addr, &t[3], type)) {
+        failed = MPI_Type_commit(type);
+    } else {
+        failed = 1;
+    }
+    for (int k = 1; k < 4; ++k) {
+        if (t[k] != MPI_DATATYPE_NULL) MPI_Type_free(&t[k]);
+    }
+    return failed ? -1 : 1;
+}
+
+// Narrow the given rank's balanced block to the k-th of nsegments pieces
+// along the split direction so that every rank writes during every segment.
+static
+void esio_balance_segment(const esio_handle h, int rank,
+                          int k, int nsegments, int *blk)
+{
+    esio_balance_block(h, rank, blk);
+    const int d = esio_balance_direction(h);
+    const long lo = ((long) k       * blk[2*d+1]) / nsegments;
+    const long hi = ((long) (k + 1) * blk[2*d+1]) / nsegments;
+    blk[2*d]  += (int) lo;
+    blk[2*d+1] = (int) (hi - lo);
+}
+
+// How many segments should each redistributed field write use?
+// No more are used than the longest balanced block has planes.
+static
+int esio_balance_nsegments(const esio_handle h)
+{
+    const int global[3] = { h->f.cglobal, h->f.bglobal, h->f.aglobal };
+    const int d = esio_balance_direction(h);
+    const int longest = (global[d] + h->comm_size - 1) / h->comm_size;
+    if (h->pipeline < longest) return h->pipeline;
+    return longest > 1 ? longest : 1;
+}
+
+// Describe what moves between each pair of ranks during segment k.  Fills
+// counts with send counts, receive counts, send displacements, and receive
+// displacements for each of n ranks and types with n send then n receive
+// types.  Types are only created where the corresponding count is one.
+static
+int esio_balance_exchange(const esio_handle h, int k, int nsegments,
+                          const void *field, const int *strides,
+                          MPI_Datatype elem, size_t size,
+                          int *counts, MPI_Datatype *types)
+{
+    const struct esio_balance_s *b = h->balance;
+    const int *mine = b->blocks + 6*h->comm_rank;
+    const int n = h->comm_size;
+    int dst[6];
+    esio_balance_segment(h, h->comm_rank, k, nsegments, dst);
+
+    memset(counts, 0, 4 * n * sizeof(int));
+    for (int r = 0; r < n; ++r) {
+        int blk[6];
+        esio_balance_segment(h, r, k, nsegments, blk);
+        types[r] = types[n + r] = MPI_BYTE;
+        int ostat = esio_block_overlap_strided(mine, blk, field, strides,
+                                               elem, (MPI_Aint) size,
+                                               &types[r]);
+        if (ostat > 0) counts[r] = 1;
+        if (ostat >= 0) {
+            ostat = esio_block_overlap(dst, b->blocks + 6*r, elem,
+                                       &types[n + r]);
+            if (ostat > 0) counts[n + r] = 1;
+        }
+        if (ostat < 0) return ESIO_EFAILED;
+    }
+    return ESIO_SUCCESS;
+}
+
+// Free any types created by esio_balance_exchange and reset their counts
+static
+void esio_balance_exchange_free(int n, int *counts, MPI_Datatype *types)
+{
+    for (int r = 0; r < 2*n; ++r) {
+        if (counts[r]) MPI_Type_free(&types[r]);
+        counts[r] = 0;
+    }
+}
+
+// Start one segment's exchange into staging.  Without MPI-3 nonblocking
+// collectives the exchange completes before returning.
+static
+int esio_balance_exchange_start(const esio_handle h, void *staging,
+                                const int *counts, MPI_Datatype *types,
+                                MPI_Request *request)
+{
+    const int n = h->comm_size;
+#if MPI_VERSION >= 3
+    return MPI_Ialltoallw(MPI_BOTTOM, counts,     counts + 2*n, types,
+                          staging,    counts + n, counts + 3*n, types + n,
+                          h->comm, request);
+#else
+    *request = MPI_REQUEST_NULL;
+    return MPI_Alltoallw(MPI_BOTTOM, (int *) counts, (int *) counts + 2*n,
+                         types, staging, (int *) counts + n,
+                         (int *) counts + 3*n, types + n, h->comm);
+#endif
+}
+
+// Collectively write a field after moving every rank's block onto the
+// balanced blocks given by the cached schedule.  MPI_Alltoallw reads
+// directly from the strided user buffer into contiguous staging.  When
+// pipelining, each balanced block is split into segments and one segment's
+// exchange proceeds while the previous segment is written.
+static
+int esio_field_write_balanced(const esio_handle h,
+                              const char *name,
+                              const void *field,
+                              int cstride, int bstride, int astride,
+                              const char *comment,
+                              hid_t type_id)
+{
+    const int strides[3] = { cstride, bstride, astride };
+    const int n = h->comm_size;
+    const size_t size = H5Tget_size(type_id);
+    const int nsegments = esio_balance_nsegments(h);
+    const int nstages = (nsegments > 1) ? 2 : 1;
+    int status = ESIO_SUCCESS;
+
+    // Compute and cache chunking for the full decomposition before
+    // narrowing it.  Otherwise balanced segments would determine chunk sizes.
+    if (   (h->flags & (FLAG_CHUNKING_ENABLED | FLAG_SPARSE_ENABLED))
+        && h->f.achunk == 0) {
+        status = chunksize_field(h->comm, // Expensive
+                h->f.cglobal, h->f.cstart, h->f.clocal, &h->f.cchunk,
+                h->f.bglobal, h->f.bstart, h->f.blocal, &h->f.bchunk,
+                h->f.aglobal, h->f.astart, h->f.alocal, &h->f.achunk);
+    }
+
+    // Size staging for the largest segment this rank receives
+    size_t nbytes = 0;
+    for (int k = 0; k < nsegments; ++k) {
+        int dst[6];
+        esio_balance_segment(h, h->comm_rank, k, nsegments, dst);
+        const size_t x = (size_t) dst[1] * dst[3] * dst[5] * size;
+        if (x > nbytes) nbytes = x;
+    }
+
+    void         *staging[2]  = { NULL, NULL };
+    int          *counts[2]   = { NULL, NULL };
+    MPI_Datatype *types[2]    = { NULL, NULL };
+    MPI_Request   requests[2] = { MPI_REQUEST_NULL, MPI_REQUEST_NULL };
+    MPI_Datatype  elem        = MPI_DATATYPE_NULL;
+    for (int j = 0; j < nstages; ++j) {
+        staging[j] = malloc(nbytes ? nbytes : 1);
+        counts[j]  = calloc(4 * n, sizeof(int));
+        types[j]   = malloc(2 * n * sizeof(MPI_Datatype));
+        if (!staging[j] || !counts[j] || !types[j]) status = ESIO_ENOMEM;
+    }
+    if (   status == ESIO_SUCCESS
+        && MPI_Type_contiguous((int) size, MPI_BYTE, &elem)) {
+        status = ESIO_EFAILED;
+    }
+
+    // Start exchanging the first segment
+    if (status == ESIO_SUCCESS) {
+        status = esio_balance_exchange(h, 0, nsegments, field, strides,
+                                       elem, size, counts[0], types[0]);
+    }
+    if (MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, h->comm)) {
+        status = ESIO_EFAILED;
+    }
+    if (status == ESIO_SUCCESS && esio_balance_exchange_start(
+                h, staging[0], counts[0], types[0], &requests[0])) {
+        status = ESIO_EFAILED;
+    }
 
-int
-esio_field_established(esio_handle h,
-                       int *cglobal, int *cstart, int *clocal,
-                       int *bglobal, int *bstart, int *blocal,
-                       int *aglobal, int *astart, int *alocal)
-{
-    // Sanity check incoming arguments
-    if (h == NULL) ESIO_ERROR("h == NULL", ESIO_EFAULT);
+    // Write the balanced segments through a view of the handle.  Each
+    // segment's agreement includes the previous write so all ranks stop
+    // together after any failure.
+    struct esio_handle_s sub = *h;
+    sub.flags   &= ~FLAG_BALANCE_ENABLED;
+    sub.balance  = NULL;
+    sub.pipeline = 1;
+    int wstat = ESIO_SUCCESS;
+    for (int k = 0; k < nsegments && status == ESIO_SUCCESS; ++k) {
+        const int j = k % nstages;
+        if (MPI_Wait(&requests[j], MPI_STATUS_IGNORE)) status = ESIO_EFAILED;
+        esio_balance_exchange_free(n, counts[j], types[j]);
+
+        // Begin the next segment's exchange before writing this one
+        const int next = (k + 1 < nsegments);
+        if (next && status == ESIO_SUCCESS) {
+            status = esio_balance_exchange(h, k + 1, nsegments, field,
+                                           strides, elem, size,
+                                           counts[1 - j], types[1 - j]);
+        }
+        int agree[2] = { status, wstat };
+        if (MPI_Allreduce(MPI_IN_PLACE, agree, 2, MPI_INT, MPI_MAX, h->comm)) {
+            agree[0] = ESIO_EFAILED;
+        }
+        status = agree[0];
+        wstat  = agree[1];
+        if (next && status == ESIO_SUCCESS && wstat == ESIO_SUCCESS
+                && esio_balance_exchange_start(h, staging[1 - j],
+                                               counts[1 - j], types[1 - j],
+                                               &requests[1 - j])) {
+            status = ESIO_EFAILED;
+        }
+        if (status != ESIO_SUCCESS || wstat != ESIO_SUCCESS) break;
+
+        int dst[6];
+        esio_balance_segment(h, h->comm_rank, k, nsegments, dst);
+        sub.f.cstart = dst[0]; sub.f.clocal = dst[1];
+        sub.f.bstart = dst[2]; sub.f.blocal = dst[3];
+        sub.f.astart = dst[4]; sub.f.alocal = dst[5];
+        wstat = esio_field_write_internal(&sub, name, staging[j], 0, 0, 0,
+                                          k ? NULL : comment, type_id);
+    }
 
-    // Retrieve parallel decomposition from handle
-    if (cglobal) *cglobal = h->f.cglobal;
-    if (cstart ) *cstart  = h->f.cstart;
-    if (clocal ) *clocal  = h->f.clocal;
-    if (bglobal) *bglobal = h->f.bglobal;
-    if (bstart ) *bstart  = h->f.bstart;
-    if (blocal ) *blocal  = h->f.blocal;
-    if (aglobal) *aglobal = h->f.aglobal;
-    if (astart ) *astart  = h->f.astart;
-    if (alocal ) *alocal  = h->f.alocal;
+    // Complete any exchange abandoned after a failure
+    for (int j = 0; j < nstages; ++j) {
+        MPI_Wait(&requests[j], MPI_STATUS_IGNORE);
+        if (counts[j] && types[j]) {
+            esio_balance_exchange_free(n, counts[j], types[j]);
+        }
+        free(types[j]);
+        free(counts[j]);
+        free(staging[j]);
+    }
+    if (elem != MPI_DATATYPE_NULL) MPI_Type_free(&elem);
 
-    return ESIO_SUCCESS;
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to redistribute field onto balanced blocks",
+                   status);
+    }
+    return wstat;
 }
 
-// *********************************************************************
-// SIZE SIZEV SIZE SIZEV SIZE SIZEV SIZE SIZEV SIZE SIZEV SIZE SIZEV
-// *********************************************************************
+// *******************************************************************
+// VISUALIZATION VIEWS VISUALIZATION VIEWS VISUALIZATION VIEWS VISUAL
+// *******************************************************************
 
-int esio_field_size(const esio_handle h,
-                    const char *name,
-                    int *cglobal, int *bglobal, int *aglobal)
+// Group holding one plain 3-D view per field not already stored as one
+#define ESIO_VIEWS_GROUP "esio_views"
+
+// Where a field's plain 3-D presentation may be found, if anywhere
+enum esio_view_kind {
+    ESIO_VIEW_NONE   = 0,  //< Field cannot be viewed
+    ESIO_VIEW_DIRECT = 1,  //< Field's own dataset is already plain
+    ESIO_VIEW_GROUP  = 2   //< Dataset within ESIO_VIEWS_GROUP
+};
+
+// Collectively copy field dset_id, stored using a layout which no virtual
+// mapping presents cheaply, into a contiguous 3-D dataset view_id.  Ranks
+// split the field evenly in C irrespective of any established
+// decomposition.  Each rank temporarily holds its share of the field.
+static
+int esio_view_copy(const esio_handle h, hid_t dset_id, hid_t view_id,
+                   const struct esio_manifest_entry *e, hid_t type_id)
 {
-    int ncomponents;
-    const int status
-        = esio_field_sizev(h, name, cglobal, bglobal, aglobal, &ncomponents);
-    if (status == ESIO_SUCCESS && ncomponents != 1) {
-        ESIO_ERROR("Must retrieve location size using esio_field_sizev",
-                   ESIO_EINVAL);
+    const int cstart = (int) (( (int64_t) h->comm_rank      * e->cglobal)
+                              / h->comm_size);
+    const int clocal = (int) ((((int64_t) h->comm_rank + 1) * e->cglobal)
+                              / h->comm_size) - cstart;
+    const size_t n = (size_t) clocal * e->bglobal * e->aglobal;
+    void *buf = malloc(n ? n * H5Tget_size(type_id) : 1);
+    int status = buf ? ESIO_SUCCESS : ESIO_ENOMEM;
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status != ESIO_SUCCESS) {
+        free(buf);
+        return status;
     }
+
+    const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
+    if (plist_id < 0) status = ESIO_EFAILED;
+    if (status == ESIO_SUCCESS) {
+        status = (esio_field_layout[e->layout_index].field_reader)(
+                plist_id, dset_id, buf,
+                e->cglobal, cstart, clocal, e->bglobal * e->aglobal,
+                e->bglobal, 0, e->bglobal, e->aglobal,
+                e->aglobal, 0, e->aglobal, 1,
+                type_id);
+    }
+
+    // Every rank writes, possibly nothing, so the transfer stays collective
+    const hsize_t start[3] = { cstart, 0, 0 };
+    const hsize_t count[3] = { clocal, e->bglobal, e->aglobal };
+    const hid_t memspace  = H5Screate_simple(3, count, NULL);
+    const hid_t filespace = H5Dget_space(view_id);
+    if (memspace < 0 || filespace < 0) {
+        status = ESIO_EFAILED;
+    } else if (n == 0) {
+        H5Sselect_none(memspace);
+        H5Sselect_none(filespace);
+    } else if (H5Sselect_hyperslab(filespace, H5S_SELECT_SET,
+                                   start, NULL, count, NULL) < 0) {
+        status = ESIO_EFAILED;
+    }
+    if (   plist_id >= 0 && memspace >= 0 && filespace >= 0
+        && H5Dwrite(view_id, type_id, memspace, filespace,
+                    plist_id, buf) < 0) {
+        status = ESIO_EFAILED;
+    }
+    if (filespace >= 0) H5Sclose(filespace);
+    if (memspace  >= 0) H5Sclose(memspace);
+    if (plist_id  >= 0) H5Pclose(plist_id);
+    free(buf);
+
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
     return status;
 }
 
-int esio_field_sizev(const esio_handle h,
-                     const char *name,
-                     int *cglobal, int *bglobal, int *aglobal,
-                     int *ncomponents)
+// Collectively present field e as a plain 3-D array, storing where it may be
+// found in *kind.  Layouts stored as plain arrays need nothing.  Layouts
+// whose stored order matches a plain array become one virtual mapping.
+// Others are copied into a contiguous dataset refreshed whenever the file
+// has been written.  Any stale view is replaced.
+static
+int esio_view_create(const esio_handle h, hid_t group_id,
+                     const struct esio_manifest_entry *e, int *kind)
 {
-    // Sanity check incoming arguments
-    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
-    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
-    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+    *kind = ESIO_VIEW_NONE;
+    const hid_t dset_id = H5Dopen2(h->file_id, e->name, H5P_DEFAULT);
+    if (dset_id < 0) return ESIO_EFAILED;
+
+    // Delta-encoded fields hold XOR differences which are useless to view
+    char *reference = esio_delta_reference(dset_id);
+    if (reference) {
+        free(reference);
+        H5Dclose(dset_id);
+        return ESIO_SUCCESS;
+    }
 
-    const int status = esio_field_metadata_read(
-            h->file_id, name, NULL, cglobal, bglobal, aglobal, ncomponents);
-    switch (status) {
-        case ESIO_SUCCESS:
-        case ESIO_NOTFOUND:  // ESIO_ERROR not called to allow existence query
-            return status;
-        default:
-            ESIO_ERROR("Unable to retrieve field metadata", status);
+    // Fields already stored as plain arrays are referenced directly
+    const esio_virtual_mapper_t mapper
+        = esio_field_layout[e->layout_index].virtual_mapper;
+    const int exists = H5Lexists(group_id, e->name, H5P_DEFAULT) > 0;
+    if (mapper == NULL && esio_field_layout[e->layout_index].rowmajor) {
+        H5Dclose(dset_id);
+        if (exists) H5Ldelete(group_id, e->name, H5P_DEFAULT);
+        *kind = ESIO_VIEW_DIRECT;
+        return ESIO_SUCCESS;
     }
-}
 
-int esio_plane_size(const esio_handle h,
-                    const char *name,
-                    int *bglobal, int *aglobal)
-{
-    int ncomponents;
-    const int status
-        = esio_plane_sizev(h, name, bglobal, aglobal, &ncomponents);
-    if (status == ESIO_SUCCESS && ncomponents != 1) {
-        ESIO_ERROR("Must retrieve location size using esio_plane_sizev",
-                   ESIO_EINVAL);
+    // Copies are refreshed only after writing or when an older kind of
+    // view, e.g. a virtual dataset, is found
+    if (mapper == NULL && exists && !(h->flags & FLAG_FILE_WRITTEN)) {
+        const hid_t view_id = H5Dopen2(group_id, e->name, H5P_DEFAULT);
+        const hid_t dcpl_id = (view_id < 0) ? -1
+                            : H5Dget_create_plist(view_id);
+        const int current = dcpl_id >= 0
+                         && H5Pget_layout(dcpl_id) == H5D_CONTIGUOUS;
+        if (dcpl_id >= 0) H5Pclose(dcpl_id);
+        if (view_id >= 0) H5Dclose(view_id);
+        if (current) {
+            H5Dclose(dset_id);
+            *kind = ESIO_VIEW_GROUP;
+            return ESIO_SUCCESS;
+        }
+    }
+
+    const hid_t type_id = H5Dget_type(dset_id);
+    const hsize_t dims[3] = { e->cglobal, e->bglobal, e->aglobal };
+    const hid_t vspace_id = H5Screate_simple(3, dims, NULL);
+    const hid_t dcpl_id   = H5Pcreate(H5P_DATASET_CREATE);
+    int status = ESIO_EFAILED;
+    if (   type_id >= 0 && vspace_id >= 0 && dcpl_id >= 0
+        && (mapper == NULL || (mapper)(dcpl_id, vspace_id, e->name,
+                                       e->cglobal, e->bglobal,
+                                       e->aglobal) >= 0)) {
+        if (exists) H5Ldelete(group_id, e->name, H5P_DEFAULT);
+        const hid_t view_id = H5Dcreate2(group_id, e->name, type_id,
+                                         vspace_id, H5P_DEFAULT,
+                                         dcpl_id, H5P_DEFAULT);
+        if (view_id >= 0) {
+            status = mapper ? ESIO_SUCCESS
+                            : esio_view_copy(h, dset_id, view_id, e, type_id);
+            H5Dclose(view_id);
+        }
     }
+    if (dcpl_id   >= 0) H5Pclose(dcpl_id);
+    if (vspace_id >= 0) H5Sclose(vspace_id);
+    if (type_id   >= 0) H5Tclose(type_id);
+    H5Dclose(dset_id);
+    if (status == ESIO_SUCCESS) *kind = ESIO_VIEW_GROUP;
     return status;
 }
 
-int esio_plane_sizev(const esio_handle h,
-                     const char *name,
-                     int *bglobal, int *aglobal,
-                     int *ncomponents)
+// Write str to stream escaping XML's special characters
+static
+void esio_xml_escape(FILE *stream, const char *str)
 {
-    // Sanity check incoming arguments
-    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
-    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
-    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
-
-    const int status = esio_plane_metadata_read(
-            h->file_id, name, bglobal, aglobal, ncomponents);
-    switch (status) {
-        case ESIO_SUCCESS:
-        case ESIO_NOTFOUND:  // ESIO_ERROR not called to allow existence query
-            return status;
-        default:
-            ESIO_ERROR("Unable to retrieve plane metadata", status);
+    for (; *str; ++str) {
+        switch (*str) {
+            case '&':  fputs("&amp;",  stream); break;
+            case '<':  fputs("&lt;",   stream); break;
+            case '>':  fputs("&gt;",   stream); break;
+            case '"':  fputs("&quot;", stream); break;
+            default:   fputc(*str, stream);     break;
+        }
     }
 }
 
-int esio_line_size(const esio_handle h,
-                   const char *name,
-                   int *aglobal)
+// Write an XDMF descriptor named path referencing each field's view within
+// the HDF5 file named file.  Fields sharing an extent share a grid.  Each
+// entry's ::esio_view_kind is given by kinds.
+static
+int esio_xdmf_write(const char *path, const char *file,
+                    const struct esio_manifest *m, const int *kinds)
 {
-    int ncomponents;
-    const int status = esio_line_sizev(h, name, aglobal, &ncomponents);
-    if (status == ESIO_SUCCESS && ncomponents != 1) {
-        ESIO_ERROR("Must retrieve location size using esio_line_sizev",
-                   ESIO_EINVAL);
+    static const char * const attribute_types[] = {
+        "Matrix", "Scalar", "Matrix", "Vector", "Matrix", "Matrix", "Tensor6",
+        "Matrix", "Matrix", "Tensor"
+    };
+
+    FILE *stream = fopen(path, "w");
+    if (stream == NULL) return ESIO_EFAILED;
+
+    const char *base = strrchr(file, '/');
+    base = base ? base + 1 : file;
+
+    fputs("<?xml version=\"1.0\" ?>\n"
+          "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n"
+          "<Xdmf Version=\"2.0\">\n"
+          "  <Domain>\n", stream);
+    for (size_t i = 0; i < m->n; ++i) {
+        const struct esio_manifest_entry *g = &m->entries[i];
+        if (g->kind != ESIO_MANIFEST_FIELD) continue;
+
+        // Emit each distinct extent once upon its first appearance
+        int seen = 0;
+        for (size_t j = 0; j < i && !seen; ++j) {
+            const struct esio_manifest_entry *e = &m->entries[j];
+            seen =    e->kind    == ESIO_MANIFEST_FIELD
+                   && e->cglobal == g->cglobal
+                   && e->bglobal == g->bglobal
+                   && e->aglobal == g->aglobal;
+        }
+        if (seen) continue;
+
+        fprintf(stream,
+                "    <Grid Name=\"%dx%dx%d\" GridType=\"Uniform\">\n"
+                "      <Topology TopologyType=\"3DCoRectMesh\""
+                " Dimensions=\"%d %d %d\"/>\n"
+                "      <Geometry GeometryType=\"ORIGIN_DXDYDZ\">\n"
+                "        <DataItem Dimensions=\"3\" Format=\"XML\">"
+                "0 0 0</DataItem>\n"
+                "        <DataItem Dimensions=\"3\" Format=\"XML\">"
+                "1 1 1</DataItem>\n"
+                "      </Geometry>\n",
+                g->cglobal, g->bglobal, g->aglobal,
+                g->cglobal, g->bglobal, g->aglobal);
+
+        for (size_t j = i; j < m->n; ++j) {
+            const struct esio_manifest_entry *e = &m->entries[j];
+            if (   e->kind    != ESIO_MANIFEST_FIELD
+                || kinds[j]   == ESIO_VIEW_NONE
+                || e->cglobal != g->cglobal
+                || e->bglobal != g->bglobal
+                || e->aglobal != g->aglobal) continue;
+
+            // Only types XDMF understands are described
+            const char *number;
+            if (e->type_class == H5T_FLOAT
+                    && (e->type_size == 4 || e->type_size == 8)) {
+                number = "Float";
+            } else if (e->type_class == H5T_INTEGER) {
+                number = "Int";
+            } else {
+                continue;
+            }
+            const int n = e->ncomponents;
+            const int atype = n < (int) (sizeof(attribute_types)
+                                         / sizeof(attribute_types[0]))
+                            ? n : 0;
+
+            fputs("      <Attribute Name=\"", stream);
+            esio_xml_escape(stream, e->name);
+            fprintf(stream, "\" AttributeType=\"%s\" Center=\"Node\">\n"
+                    "        <DataItem Dimensions=\"%d %d %d",
+                    attribute_types[atype],
+                    e->cglobal, e->bglobal, e->aglobal);
+            if (n > 1) fprintf(stream, " %d", n);
+            fprintf(stream, "\" NumberType=\"%s\" Precision=\"%d\""
+                    " Format=\"HDF\">", number, e->type_size);
+            esio_xml_escape(stream, base);
+            fputs(kinds[j] == ESIO_VIEW_DIRECT ? ":/"
+                                               : ":/" ESIO_VIEWS_GROUP "/",
+                  stream);
+            esio_xml_escape(stream, e->name);
+            fputs("</DataItem>\n"
+                  "      </Attribute>\n", stream);
+        }
+        fputs("    </Grid>\n", stream);
     }
-    return status;
+    fputs("  </Domain>\n"
+          "</Xdmf>\n", stream);
+
+    return (ferror(stream) | fclose(stream)) ? ESIO_EFAILED : ESIO_SUCCESS;
 }
 
-int esio_line_sizev(const esio_handle h,
-                    const char *name,
-                    int *aglobal,
-                    int *ncomponents)
+// Collectively write a virtual dataset for every field named in the freshly
+// written manifest and have one rank write an XDMF descriptor beside the
+// file.  Together these let standard tools read fields in place.
+static
+int esio_views_write(const esio_handle h)
 {
-    // Sanity check incoming arguments
-    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
-    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
-    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+    struct esio_manifest *m = NULL;
+    const int mstat = esio_manifest_read(h->file_id, h->comm, &m);
+    if (mstat != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to enumerate fields for views", mstat);
+    }
+    if (m == NULL) return ESIO_SUCCESS;
+
+    int *kinds = calloc(m->n ? m->n : 1, sizeof(int));
+    int status = kinds ? ESIO_SUCCESS : ESIO_ENOMEM;
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    const hid_t group_id = (status != ESIO_SUCCESS) ? -1
+        : H5Lexists(h->file_id, ESIO_VIEWS_GROUP, H5P_DEFAULT) > 0
+        ? H5Gopen2(h->file_id, ESIO_VIEWS_GROUP, H5P_DEFAULT)
+        : H5Gcreate2(h->file_id, ESIO_VIEWS_GROUP,
+                     H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (group_id < 0) status = ESIO_EFAILED;
+    for (size_t i = 0; i < m->n && status == ESIO_SUCCESS; ++i) {
+        if (m->entries[i].kind == ESIO_MANIFEST_FIELD) {
+            status = esio_view_create(h, group_id, &m->entries[i], &kinds[i]);
+        }
+    }
+    if (group_id >= 0) H5Gclose(group_id);
 
-    const int status = esio_line_metadata_read(
-            h->file_id, name, aglobal, ncomponents);
-    switch (status) {
-        case ESIO_SUCCESS:
-        case ESIO_NOTFOUND:  // ESIO_ERROR not called to allow existence query
-            return status;
-        default:
-            ESIO_ERROR("Unable to retrieve line metadata", status);
+    // One rank writes the descriptor and "broadcasts" the result
+    const int worker = h->comm_size - 1; // Last rank does work
+    if (status == ESIO_SUCCESS && h->comm_rank == worker) {
+        const size_t len = strlen(h->file_path) + sizeof(".xmf");
+        char *path = malloc(len);
+        if (path) {
+            snprintf(path, len, "%s.xmf", h->file_path);
+            status = esio_xdmf_write(path, h->file_path, m, kinds);
+            free(path);
+        } else {
+            status = ESIO_ENOMEM;
+        }
+    }
+    free(kinds);
+    esio_manifest_free(m);
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                               MPI_MAX, h->comm));
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to write visualization views", status);
     }
+    return ESIO_SUCCESS;
 }
 
 // *******************************************************************
-// FIELD READ WRITE FIELD READ WRITE FIELD READ WRITE FIELD READ WRITE
+// FIELD MAPS FIELD MAPS FIELD MAPS FIELD MAPS FIELD MAPS FIELD MAPS
 // *******************************************************************
 
 static
-int esio_field_write_internal(const esio_handle h,
-                              const char *name,
-                              const void *field,
-                              int cstride, int bstride, int astride,
-                              const char *comment,
-                              hid_t type_id)
+int esio_field_map_readonly_internal(const esio_handle h,
+                                     const char *name,
+                                     const void **field,
+                                     int *cstride, int *bstride, int *astride,
+                                     hid_t type_id)
 {
+    char msg[256]; // message buffer for error handling
+
     // Sanity check incoming arguments
-    // Strides must be nonnegative because hsize_t is unsigned
     if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
     if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
     if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
-    if (field == NULL && h->f.clocal && h->f.blocal && h->f.alocal) {
-                          ESIO_ERROR("field == NULL",           ESIO_EFAULT);
-    }
-    if (cstride < 0)      ESIO_ERROR("cstride < 0",            ESIO_EINVAL);
-    if (bstride < 0)      ESIO_ERROR("bstride < 0",            ESIO_EINVAL);
-    if (astride < 0)      ESIO_ERROR("astride < 0",            ESIO_EINVAL);
-    // (comment == NULL) is valid input
-    if (type_id < 0)      ESIO_ERROR("type_id < 0",            ESIO_EINVAL);
-    if (h->f.aglobal == 0)
-        ESIO_ERROR("esio_field_establish() never called", ESIO_EINVAL);
-
-    // Provide contiguous defaults whenever the user supplied zero strides.
-    // Strides are given in units of type_id; hence astride = 1 is contiguous.
-    if (astride == 0) astride = 1;
-    if (bstride == 0) bstride = astride * h->f.alocal;
-    if (cstride == 0) cstride = bstride * h->f.blocal;
+    if (field == NULL)    ESIO_ERROR("field == NULL",          ESIO_EFAULT);
 
-    // Attempt to read metadata for the field (which may or may not exist)
+    // Read metadata for the field
     int layout_index;
-    int field_cglobal, field_bglobal, field_aglobal;
-    int field_ncomponents;
-    const int mstat = esio_field_metadata_read(h->file_id, name,
-                                               &layout_index,
-                                               &field_cglobal,
-                                               &field_bglobal,
-                                               &field_aglobal,
-                                               &field_ncomponents);
-
-    if (mstat != ESIO_SUCCESS) {
-        // Presume field did not exist
-
-        // Determine the chunking parameters to use for dataset creation
-        // if they've not already been computed.  Note values are cached!
-        if (h->flags & FLAG_CHUNKING_ENABLED && h->f.achunk == 0) {
-            const int status = chunksize_field(h->comm, // Expensive
-                    h->f.cglobal, h->f.cstart, h->f.clocal, &h->f.cchunk,
-                    h->f.bglobal, h->f.bstart, h->f.blocal, &h->f.bchunk,
-                    h->f.aglobal, h->f.astart, h->f.alocal, &h->f.achunk);
-            if (status != ESIO_SUCCESS) {
-                ESIO_ERROR("Error determining chunk size for decomposition",
-                        status);
-            }
-        }
-
-        // Create a dataset creation property list with chunk parameters
-        hid_t dcpl_id = H5Pcreate(H5P_DATASET_CREATE);
-        if (dcpl_id < 0) {
-            ESIO_ERROR("Error creating dataset creation property list",
-                       ESIO_EFAILED);
-        }
-        if (h->flags & FLAG_CHUNKING_ENABLED) {
-            if ((esio_field_layout[h->layout_index].dataset_chunker)(
-                        dcpl_id, h->f.cchunk, h->f.bchunk, h->f.achunk) < 0) {
-                H5Pclose(dcpl_id);
-                ESIO_ERROR("Error setting chunk size information",
-                        ESIO_ESANITY);
-            }
-        }
+    int cglobal, bglobal, aglobal, ncomponents;
+    const int status = esio_field_metadata_lookup(h, name, &layout_index,
+                                                  &cglobal, &bglobal, &aglobal,
+                                                  &ncomponents);
+    switch (status) {
+        case ESIO_SUCCESS:
+            break;
+        case ESIO_NOTFOUND:
+            snprintf(msg, sizeof(msg), "Field '%s' not found in file", name);
+            ESIO_ERROR(msg, status);
+        default:
+            ESIO_ERROR("Unable to read field's ESIO metadata", status);
+    }
+    if (!esio_field_layout[layout_index].rowmajor) {
+        ESIO_ERROR("Field layout is not stored in row-major order",
+                   ESIO_EINVAL);
+    }
 
-        // Create dataset and write it with the active field layout
-        const hid_t dset_id = esio_field_create(
-                h, name, type_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
-        if (dset_id < 0) {
-            ESIO_ERROR("Error creating new field", ESIO_EFAILED);
-        }
+    // Open existing dataset
+    const hid_t dset_id = H5Dopen2(h->file_id, name, H5P_DEFAULT);
+    if (dset_id < 0) {
+        ESIO_ERROR("Unable to open dataset", ESIO_EFAILED);
+    }
 
-        // Close creation property list
-        H5Pclose(dcpl_id);
+    // Only values stored verbatim may be handed out directly
+    char *reference = esio_delta_reference(dset_id);
+    if (reference) {
+        free(reference);
+        H5Dclose(dset_id);
+        ESIO_ERROR("Delta-encoded fields cannot be mapped", ESIO_EINVAL);
+    }
+    const hid_t field_type_id = H5Dget_type(dset_id);
+    const hid_t base_type_id  = (H5Tget_class(field_type_id) == H5T_ARRAY)
+                              ? H5Tget_super(field_type_id)
+                              : H5Tcopy(field_type_id);
+    const htri_t same = H5Tequal(base_type_id, type_id);
+    H5Tclose(base_type_id);
+    H5Tclose(field_type_id);
+    if (same <= 0) {
+        H5Dclose(dset_id);
+        ESIO_ERROR("Field's stored type differs from the requested type",
+                   ESIO_EINVAL);
+    }
 
-        // Obtain appropriate dataset transfer properties
-        const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
-        if (plist_id < 0) {
-            ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
-        }
+    // Chunked, compressed, or unwritten fields have no single offset
+    const haddr_t offset = H5Dget_offset(dset_id);
+    char *path = esio_dataset_file_name(dset_id);
+    H5Dclose(dset_id);
+    if (offset == HADDR_UNDEF) {
+        free(path);
+        ESIO_ERROR("Field is not stored contiguously", ESIO_EINVAL);
+    }
+    if (path == NULL) {
+        ESIO_ERROR("Unable to determine field's file name", ESIO_EFAILED);
+    }
 
-        // Write the field using the appropriate layout logic
-        const int wstat = (esio_field_layout[h->layout_index].field_writer)(
-                plist_id, dset_id, field,
-                h->f.cglobal, h->f.cstart, h->f.clocal, cstride,
-                h->f.bglobal, h->f.bstart, h->f.blocal, bstride,
-                h->f.aglobal, h->f.astart, h->f.alocal, astride,
-                type_id);
-        if (wstat != ESIO_SUCCESS) {
-            esio_field_close(dset_id);
-            H5Pclose(plist_id);
-            ESIO_ERROR_VAL("Error writing new field", ESIO_EFAILED, wstat);
-        }
-        H5Pclose(plist_id);
+    // Map whole pages spanning the field
+    const size_t size   = (size_t) cglobal * bglobal * aglobal
+                        * ncomponents * H5Tget_size(type_id);
+    const long   page   = sysconf(_SC_PAGESIZE);
+    const off_t  start  = (off_t) (offset - offset % (haddr_t) page);
+    const size_t length = size + (size_t) (offset - (haddr_t) start);
+    struct esio_map_s *m = malloc(sizeof(struct esio_map_s));
+    const int fd = open(path + scheme_prefix_len(path), O_RDONLY);
+    free(path);
+    if (m == NULL) {
+        if (fd >= 0) close(fd);
+        ESIO_ERROR("Unable to allocate mapping details", ESIO_ENOMEM);
+    }
+    if (fd < 0) {
+        free(m);
+        ESIO_ERROR("Unable to open field's file for mapping", ESIO_EFAILED);
+    }
+    m->addr = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, start);
+    close(fd); // Mapping remains valid after closing descriptor
+    if (m->addr == MAP_FAILED) {
+        free(m);
+        ESIO_ERROR("Unable to map field", ESIO_EFAILED);
+    }
+    m->length = length;
+    m->field  = (const char *) m->addr + (offset - (haddr_t) start);
+    m->next   = h->maps;
+    h->maps   = m;
 
-        // Optionally write a comment about the new field
-        if (comment && *comment) {
-            if (H5Oset_comment(dset_id, comment) < 0) {
-                esio_field_close(dset_id);
-                ESIO_ERROR("Error setting comment on new field", ESIO_EFAILED);
-            }
-        }
-        esio_field_close(dset_id);
+    // Strides are given in units of type_id with components adjacent
+    *field = m->field;
+    if (astride) *astride = ncomponents;
+    if (bstride) *bstride = ncomponents * aglobal;
+    if (cstride) *cstride = ncomponents * aglobal * bglobal;
 
-    } else {
-        // Field already existed
+    return ESIO_SUCCESS;
+}
 
-        // Ensure caller gave correct size information
-        if (h->f.cglobal != field_cglobal) {
-            ESIO_ERROR("request cglobal mismatch with existing field",
-                       ESIO_EINVAL);
-        }
-        if (h->f.bglobal != field_bglobal) {
-            ESIO_ERROR("request bglobal mismatch with existing field",
-                       ESIO_EINVAL);
-        }
-        if (h->f.aglobal != field_aglobal) {
-            ESIO_ERROR("request aglobal mismatch with existing field",
-                       ESIO_EINVAL);
-        }
+#define GEN_FIELD_MAP(TYPE,H5TYPE)                                      \
+int esio_field_map_readonly_ ## TYPE(                                   \
+        const esio_handle h,                                            \
+        const char *name,                                               \
+        const TYPE **field,                                             \
+        int *cstride, int *bstride, int *astride)                       \
+{                                                                       \
+    return esio_field_map_readonly_internal(h, name,                    \
+                                            (const void **) field,      \
+                                            cstride, bstride, astride,  \
+                                            H5TYPE);                    \
+}
 
-        // Ensure caller gave type with correct component count
-        if (esio_type_ncomponents(type_id) != field_ncomponents) {
-            ESIO_ERROR("request ncomponents mismatch with existing field",
-                       ESIO_EINVAL);
-        }
+GEN_FIELD_MAP(double, H5T_NATIVE_DOUBLE)
+GEN_FIELD_MAP(float,  H5T_NATIVE_FLOAT)
+GEN_FIELD_MAP(int,    H5T_NATIVE_INT)
 
-        // Open the existing field's dataset
-        const hid_t dset_id = H5Dopen1(h->file_id, name);
-        if (dset_id < 0) {
-            ESIO_ERROR("Unable to open dataset", ESIO_EFAILED);
-        }
+int esio_field_unmap(const esio_handle h, const void *field)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)     ESIO_ERROR("h == NULL",     ESIO_EFAULT);
+    if (field == NULL) ESIO_ERROR("field == NULL", ESIO_EFAULT);
+
+    for (struct esio_map_s **p = &h->maps; *p; p = &(*p)->next) {
+        if ((*p)->field != field) continue;
+        struct esio_map_s *m = *p;
+        *p = m->next;
+        const int failed = munmap(m->addr, m->length);
+        free(m);
+        if (failed) ESIO_ERROR("Unable to unmap field", ESIO_EFAILED);
+        return ESIO_SUCCESS;
+    }
 
-        // Check if supplied type can be converted to the field's type
-        const hid_t field_type_id = H5Dget_type(dset_id);
-        H5T_cdata_t *pcdata;
-        const H5T_conv_t converter = H5Tfind(type_id, field_type_id, &pcdata);
-        if (converter == NULL) {
-            H5Tclose(field_type_id);
-            H5Dclose(dset_id);
-            ESIO_ERROR("request type not convertible to existing field type",
-                       ESIO_EINVAL);
-        }
-        H5Tclose(field_type_id);
+    ESIO_ERROR("field was not mapped by this handle", ESIO_EINVAL);
+}
 
-        // Obtain appropriate dataset transfer properties
-        const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
-        if (plist_id < 0) {
-            ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
-        }
+// *******************************************************************
+// DELTA SNAPSHOTS DELTA SNAPSHOTS DELTA SNAPSHOTS DELTA SNAPSHOTS DELTA
+// *******************************************************************
 
-        // Overwrite existing data using layout routines per metadata
-        const int wstat = (esio_field_layout[layout_index].field_writer)(
-                plist_id, dset_id, field,
-                h->f.cglobal, h->f.cstart, h->f.clocal, cstride,
-                h->f.bglobal, h->f.bstart, h->f.blocal, bstride,
-                h->f.aglobal, h->f.astart, h->f.alocal, astride,
-                type_id);
-        if (wstat != ESIO_SUCCESS) {
-            esio_field_close(dset_id);
-            H5Pclose(plist_id);
-            ESIO_ERROR_VAL("Error overwriting field", ESIO_EFAILED, wstat);
-        }
-        H5Pclose(plist_id);
+// Attribute naming the dataset against which a delta-encoded field is stored
+#define ESIO_DELTA_ATTRIBUTE "esio_delta_reference"
 
-        // Optionally write a comment about the field
-        if (comment && *comment) {
-            if (H5Oset_comment(dset_id, comment) < 0) {
-                esio_field_close(dset_id);
-                ESIO_ERROR("Error setting comment on existing field",
-                        ESIO_EFAILED);
-            }
-        }
-        esio_field_close(dset_id);
+// Unsigned type holding the XOR of two values of type_id or -1 if unsupported
+static
+hid_t esio_delta_type(hid_t type_id)
+{
+    if (H5Tequal(type_id, H5T_NATIVE_DOUBLE) > 0) return H5T_NATIVE_UINT64;
+    if (H5Tequal(type_id, H5T_NATIVE_FLOAT ) > 0) return H5T_NATIVE_UINT32;
+    return -1;
+}
 
+// Name of the reference for a delta-encoded field or NULL if dset_id is not
+// delta-encoded.  The caller must free the result.
+static
+char* esio_delta_reference(hid_t dset_id)
+{
+    if (H5Aexists(dset_id, ESIO_DELTA_ATTRIBUTE) <= 0) return NULL;
+
+    const hid_t attr_id = H5Aopen(dset_id, ESIO_DELTA_ATTRIBUTE, H5P_DEFAULT);
+    if (attr_id < 0) return NULL;
+    const hid_t type_id = H5Aget_type(attr_id);
+    const size_t size   = (type_id < 0) ? 0 : H5Tget_size(type_id);
+    char *retval = size ? calloc(size + 1, 1) : NULL;
+    if (retval && H5Aread(attr_id, type_id, retval) < 0) {
+        free(retval);
+        retval = NULL;
     }
+    if (type_id >= 0) H5Tclose(type_id);
+    H5Aclose(attr_id);
 
-    return ESIO_SUCCESS;
+    return retval;
 }
 
+// Does following references starting from reference ever reach name?
 static
-int esio_field_read_internal(const esio_handle h,
-                             const char *name,
-                             void *field,
-                             int cstride, int bstride, int astride,
-                             const char *comment,
-                             hid_t type_id)
+int esio_delta_reaches(const esio_handle h,
+                       const char *reference,
+                       const char *name)
+{
+    int found = 0;
+    char *curr = strdup(reference);
+    while (curr && !(found = !strcmp(curr, name))) {
+        DISABLE_HDF5_ERROR_HANDLER(one)
+        const hid_t dset_id = H5Dopen2(h->file_id, curr, H5P_DEFAULT);
+        ENABLE_HDF5_ERROR_HANDLER(one)
+        char *next = (dset_id < 0) ? NULL : esio_delta_reference(dset_id);
+        if (dset_id >= 0) H5Dclose(dset_id);
+        free(curr);
+        curr = next;
+    }
+    free(curr);
+    return found;
+}
+
+// Form delta[i] = bits(x[i]) ^ bits(y[i]) for possibly strided x and y
+// or, when x is NULL, apply y[i] = bits(y[i]) ^ delta[i] in place.
+// Strides are in units of size, which must be either 4 or 8 bytes.
+static
+void esio_delta_xor(void *delta, const void *x, void *y, size_t size,
+                    int clocal, int blocal, int alocal,
+                    int xcstride, int xbstride, int xastride,
+                    int ycstride, int ybstride, int yastride)
+{
+    size_t i = 0;
+    for (int c = 0; c < clocal; ++c) {
+        for (int b = 0; b < blocal; ++b) {
+            for (int a = 0; a < alocal; ++a, ++i) {
+                const size_t xi = (size_t) c*xcstride + b*xbstride + a*xastride;
+                const size_t yi = (size_t) c*ycstride + b*ybstride + a*yastride;
+                if (size == sizeof(uint64_t)) {
+                    uint64_t *d = delta, *v = (uint64_t *) y + yi, u;
+                    if (x) {
+                        memcpy(&u, (const uint64_t *) x + xi, sizeof(u));
+                        d[i] = u ^ *v;
+                    } else {
+                        *v ^= d[i];
+                    }
+                } else {
+                    uint32_t *d = delta, *v = (uint32_t *) y + yi, u;
+                    if (x) {
+                        memcpy(&u, (const uint32_t *) x + xi, sizeof(u));
+                        d[i] = u ^ *v;
+                    } else {
+                        *v ^= d[i];
+                    }
+                }
+            }
+        }
+    }
+}
+
+static
+int esio_field_write_delta_internal(const esio_handle h,
+                                    const char *name,
+                                    const void *field,
+                                    int cstride, int bstride, int astride,
+                                    const char *reference,
+                                    const void *previous,
+                                    const char *comment,
+                                    hid_t type_id)
 {
     char msg[256]; // message buffer for error handling
-    (void) comment; // Present for consistency with esio_field_write_internal
-    assert(comment == 0);
 
     // Sanity check incoming arguments
     // Strides must be nonnegative because hsize_t is unsigned
@@ -1397,9 +4815,16 @@ int esio_field_read_internal(const esio_handle h,
     if (cstride < 0)      ESIO_ERROR("cstride < 0",            ESIO_EINVAL);
     if (bstride < 0)      ESIO_ERROR("bstride < 0",            ESIO_EINVAL);
     if (astride < 0)      ESIO_ERROR("astride < 0",            ESIO_EINVAL);
-    if (type_id < 0)      ESIO_ERROR("type_id < 0",            ESIO_EINVAL);
+    if (reference == NULL) ESIO_ERROR("reference == NULL",     ESIO_EFAULT);
+    // (previous == NULL) is valid input
+    // (comment == NULL) is valid input
     if (h->f.aglobal == 0)
         ESIO_ERROR("esio_field_establish() never called", ESIO_EINVAL);
+    h->flags |= FLAG_FILE_WRITTEN;
+    const hid_t delta_type_id = esio_delta_type(type_id);
+    if (delta_type_id < 0) {
+        ESIO_ERROR("delta encoding requires float or double", ESIO_EINVAL);
+    }
 
     // Provide contiguous defaults whenever the user supplied zero strides.
     // Strides are given in units of type_id; hence astride = 1 is contiguous.
@@ -1407,160 +4832,265 @@ int esio_field_read_internal(const esio_handle h,
     if (bstride == 0) bstride = astride * h->f.alocal;
     if (cstride == 0) cstride = bstride * h->f.blocal;
 
-    // Read metadata for the field
-    int layout_index;
-    int field_cglobal, field_bglobal, field_aglobal;
-    int field_ncomponents;
-    const int status = esio_field_metadata_read(h->file_id, name,
-                                                &layout_index,
-                                                &field_cglobal,
-                                                &field_bglobal,
-                                                &field_aglobal,
-                                                &field_ncomponents);
-    switch (status) {
-        case ESIO_SUCCESS:
-            break;
-        case ESIO_NOTFOUND:
-	    snprintf(msg, sizeof(msg), "Field '%s' not found in file", name);
-            ESIO_ERROR(msg, status);
-        default:
-            ESIO_ERROR("Unable to read field's ESIO metadata", status);
-    }
-
-    // Ensure caller gave correct size information
-    if (h->f.cglobal != field_cglobal) {
-        ESIO_ERROR("field read request has incorrect cglobal", ESIO_EINVAL);
+    // The reference must be an existing scalar field of matching size
+    int ref_cglobal, ref_bglobal, ref_aglobal, ref_ncomponents;
+    const int rstat = esio_field_metadata_lookup(h, reference, NULL,
+                                                 &ref_cglobal,
+                                                 &ref_bglobal,
+                                                 &ref_aglobal,
+                                                 &ref_ncomponents);
+    if (rstat != ESIO_SUCCESS) {
+        snprintf(msg, sizeof(msg), "Reference '%s' not found", reference);
+        ESIO_ERROR(msg, ESIO_EINVAL);
     }
-    if (h->f.bglobal != field_bglobal) {
-        ESIO_ERROR("field read request has incorrect bglobal", ESIO_EINVAL);
+    if (   h->f.cglobal != ref_cglobal
+        || h->f.bglobal != ref_bglobal
+        || h->f.aglobal != ref_aglobal
+        || ref_ncomponents != 1) {
+        ESIO_ERROR("reference size mismatch with request", ESIO_EINVAL);
     }
-    if (h->f.aglobal != field_aglobal) {
-        ESIO_ERROR("field read request has incorrect aglobal", ESIO_EINVAL);
+    if (esio_delta_reaches(h, reference, name)) {
+        ESIO_ERROR("reference would depend on the field being written",
+                   ESIO_EINVAL);
     }
 
-    // Ensure caller gave type with correct component count
-    if (esio_type_ncomponents(type_id) != field_ncomponents) {
-        ESIO_ERROR("request ncomponents mismatch with existing field",
-                    ESIO_EINVAL);
+    // Readers reconstruct from the reference as stored, so previous values
+    // are only trusted when the reference is stored at full width.  Any
+    // reduced precision reference is read back to obtain the same basis.
+    const size_t size  = H5Tget_size(type_id);
+    if (previous) {
+        const hid_t ref_id   = H5Dopen2(h->file_id, reference, H5P_DEFAULT);
+        const hid_t rtype_id = (ref_id < 0) ? -1 : H5Dget_type(ref_id);
+        if (rtype_id < 0) {
+            if (ref_id >= 0) H5Dclose(ref_id);
+            ESIO_ERROR("Unable to determine reference type", ESIO_EFAILED);
+        }
+        if (H5Tget_size(rtype_id) != size) previous = NULL;
+        H5Tclose(rtype_id);
+        H5Dclose(ref_id);
     }
 
-    // Open existing dataset
-    const hid_t dapl_id = H5P_DEFAULT;
-    const hid_t dset_id = H5Dopen2(h->file_id, name, dapl_id);
-    if (dset_id < 0) {
-        ESIO_ERROR("Unable to open dataset", ESIO_EFAILED);
+    // Compute the local delta, reading previous values when not supplied
+    const size_t nelem = (size_t) h->f.clocal * h->f.blocal * h->f.alocal;
+    void *delta = malloc(nelem ? nelem * size : 1);
+    void *tmp   = previous ? NULL : malloc(nelem ? nelem * size : 1);
+    if (delta == NULL || (previous == NULL && tmp == NULL)) {
+        free(delta);
+        free(tmp);
+        ESIO_ERROR("Unable to allocate delta buffer", ESIO_ENOMEM);
+    }
+    if (tmp) {
+        const int pstat = esio_field_read_internal(h, reference, tmp,
+                                                   0, 0, 0, 0, type_id);
+        if (pstat != ESIO_SUCCESS) {
+            free(delta);
+            free(tmp);
+            ESIO_ERROR("Unable to read reference values", pstat);
+        }
+        esio_delta_xor(delta, field, tmp, size,
+                       h->f.clocal, h->f.blocal, h->f.alocal,
+                       cstride, bstride, astride,
+                       h->f.blocal * h->f.alocal, h->f.alocal, 1);
+        free(tmp);
+    } else {
+        esio_delta_xor(delta, field, (void *) previous, size,
+                       h->f.clocal, h->f.blocal, h->f.alocal,
+                       cstride, bstride, astride,
+                       cstride, bstride, astride);
     }
 
-    // Check if supplied type can be converted to the field's type
-    const hid_t field_type_id = H5Dget_type(dset_id);
-    H5T_cdata_t *pcdata;
-    const H5T_conv_t converter = H5Tfind(type_id, field_type_id, &pcdata);
-    if (converter == NULL) {
-        H5Dclose(dset_id);
+    // Attempt to read metadata for the field (which may or may not exist)
+    int field_cglobal, field_bglobal, field_aglobal, field_ncomponents;
+    const int mstat = esio_field_metadata_lookup(h, name, NULL,
+                                                 &field_cglobal,
+                                                 &field_bglobal,
+                                                 &field_aglobal,
+                                                 &field_ncomponents);
+
+    hid_t dset_id;
+    if (mstat != ESIO_SUCCESS) {
+        // Presume field did not exist so create a chunked, layout 0 dataset.
+        // Planes of bytes within nearby values are mostly zero after XOR
+        // which byte shuffling followed by deflate compresses cheaply.
+        const hid_t dcpl_id = H5Pcreate(H5P_DATASET_CREATE);
+        const size_t maxchunk = 1 << 22;
+        hsize_t chunk[3] = { 1, h->f.bglobal, h->f.aglobal };
+        if (chunk[2] * size > maxchunk) chunk[2] = maxchunk / size;
+        if (chunk[1] * chunk[2] * size > maxchunk) {
+            chunk[1] = maxchunk / (chunk[2] * size);
+        }
+#if H5_VERSION_GE(1,10,2)
+        const int filters = H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0;
+#else
+        // Parallel writes of filtered datasets require HDF5 1.10.2
+        const int filters = H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0
+                         && h->comm_size == 1;
+#endif
+        if (   dcpl_id < 0
+            || H5Pset_chunk(dcpl_id, 3, chunk) < 0
+            || (filters && H5Pset_shuffle(dcpl_id) < 0)
+            || (filters && H5Pset_deflate(dcpl_id, 1) < 0)) {
+            if (dcpl_id >= 0) H5Pclose(dcpl_id);
+            free(delta);
+            ESIO_ERROR("Error creating delta creation property list",
+                       ESIO_EFAILED);
+        }
+
+        const hid_t space_id = esio_field_layout0_filespace_creator(
+                h->f.cglobal, h->f.bglobal, h->f.aglobal);
+        dset_id = (space_id < 0) ? -1 : esio_dataset_create(h, name,
+                delta_type_id, space_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
+        if (space_id >= 0) H5Sclose(space_id);
+        H5Pclose(dcpl_id);
+        if (dset_id < 0) {
+            free(delta);
+            ESIO_ERROR("Error creating new delta field", ESIO_EFAILED);
+        }
+
+    } else {
+        // Field already existed and must be a delta of the same width
+        if (   h->f.cglobal != field_cglobal
+            || h->f.bglobal != field_bglobal
+            || h->f.aglobal != field_aglobal
+            || field_ncomponents != 1) {
+            free(delta);
+            ESIO_ERROR("request size mismatch with existing field",
+                       ESIO_EINVAL);
+        }
+        dset_id = H5Dopen2(h->file_id, name, H5P_DEFAULT);
+        if (dset_id < 0) {
+            free(delta);
+            ESIO_ERROR("Unable to open dataset", ESIO_EFAILED);
+        }
+        char *existing = esio_delta_reference(dset_id);
+        const hid_t field_type_id = H5Dget_type(dset_id);
+        const int compatible = existing
+                && H5Tget_size(field_type_id) == H5Tget_size(delta_type_id);
         H5Tclose(field_type_id);
-        ESIO_ERROR("request type not convertible to existing field type",
-                    ESIO_EINVAL);
+        free(existing);
+        if (!compatible) {
+            esio_field_close(dset_id);
+            free(delta);
+            ESIO_ERROR("existing field is not a delta of the same type",
+                       ESIO_EINVAL);
+        }
+    }
+
+    // Record the reference, replacing any previous one
+    if (H5LTset_attribute_string(h->file_id, name,
+                                 ESIO_DELTA_ATTRIBUTE, reference) < 0) {
+        esio_field_close(dset_id);
+        free(delta);
+        ESIO_ERROR("Error recording delta reference", ESIO_EFAILED);
     }
-    H5Tclose(field_type_id);
 
     // Obtain appropriate dataset transfer properties
     const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
     if (plist_id < 0) {
-        H5Dclose(dset_id);
-        H5Tclose(field_type_id);
+        esio_field_close(dset_id);
+        free(delta);
         ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
     }
 
-    // Read the field based on the metadata's layout_index
-    // Note that this means we can read any layout ESIO understands
-    // Note that reading does not change the chosen field write layout_index
-    (esio_field_layout[layout_index].field_reader)(
-            plist_id, dset_id, field,
-            h->f.cglobal, h->f.cstart, h->f.clocal, cstride,
-            h->f.bglobal, h->f.bstart, h->f.blocal, bstride,
-            h->f.aglobal, h->f.astart, h->f.alocal, astride,
-            type_id);
-
+    // Write the contiguous delta
+    const int wstat = esio_field_layout0_field_writer(
+            plist_id, dset_id, delta,
+            h->f.cglobal, h->f.cstart, h->f.clocal, h->f.blocal*h->f.alocal,
+            h->f.bglobal, h->f.bstart, h->f.blocal, h->f.alocal,
+            h->f.aglobal, h->f.astart, h->f.alocal, 1,
+            delta_type_id);
     H5Pclose(plist_id);
+    free(delta);
+    if (wstat != ESIO_SUCCESS) {
+        esio_field_close(dset_id);
+        ESIO_ERROR_VAL("Error writing delta field", ESIO_EFAILED, wstat);
+    }
 
-    // Close dataset
     esio_field_close(dset_id);
-
-    return ESIO_SUCCESS;
-}
-
-#define GEN_FIELD_OP(OP,QUAL,TYPE,H5TYPE,CMTPAR,CMTARG)              \
-int esio_field_ ## OP ## _ ## TYPE (                                 \
-        const esio_handle h,                                         \
-        const char *name,                                            \
-        QUAL TYPE *field,                                            \
-        int cstride, int bstride, int astride                        \
-        CMTPAR)                                                      \
-{                                                                    \
-    return esio_field_ ## OP ## _internal(h, name, field,            \
-                                          cstride, bstride, astride  \
-                                          CMTARG,                    \
-                                          H5TYPE);                   \
-}
-
-GEN_FIELD_OP(write, const,       double, H5T_NATIVE_DOUBLE, WCMTPAR, WCMTARG)
-GEN_FIELD_OP(read,  /*mutable*/, double, H5T_NATIVE_DOUBLE, RCMTPAR, RCMTARG)
-
-GEN_FIELD_OP(write, const,       float, H5T_NATIVE_FLOAT, WCMTPAR, WCMTARG)
-GEN_FIELD_OP(read,  /*mutable*/, float, H5T_NATIVE_FLOAT, RCMTPAR, RCMTARG)
-
-GEN_FIELD_OP(write, const,       int, H5T_NATIVE_INT, WCMTPAR, WCMTARG)
-GEN_FIELD_OP(read,  /*mutable*/, int, H5T_NATIVE_INT, RCMTPAR, RCMTARG)
-
-
-#define GEN_FIELD_OPV(OP,QUAL,TYPE,H5TYPE,CMTPAR,CMTARG)                  \
-int esio_field_ ## OP ## v_ ## TYPE(                                      \
-        const esio_handle h,                                              \
-        const char *name,                                                 \
-        QUAL TYPE *field,                                                 \
-        int cstride, int bstride, int astride,                            \
-        int ncomponents                                                   \
-        CMTPAR)                                                           \
-{                                                                         \
-    const hid_t array_type_id = esio_type_arrayify(H5TYPE, ncomponents);  \
-                                                                          \
-    /* Input strides are in units of sizeof(TYPE). HDF5 requires slab */  \
-    /* selection using sizeof(array_type_id) and cannot use "partial" */  \
-    /* offsets in this selection process.  Check strides conform.     */  \
-    if (cstride % ncomponents) {                                          \
-        H5Tclose(array_type_id);                                          \
-        ESIO_ERROR("cstride must be an integer multiple of ncomponents",  \
-                   ESIO_EINVAL);                                          \
-    }                                                                     \
-    if (bstride % ncomponents) {                                          \
-        H5Tclose(array_type_id);                                          \
-        ESIO_ERROR("bstride must be an integer multiple of ncomponents",  \
-                   ESIO_EINVAL);                                          \
-    }                                                                     \
-    if (astride % ncomponents) {                                          \
-        H5Tclose(array_type_id);                                          \
-        ESIO_ERROR("astride must be an integer multiple of ncomponents",  \
-                   ESIO_EINVAL);                                          \
-    }                                                                     \
-    const int retval = esio_field_ ## OP ## _internal(                    \
-            h, name, field,                                               \
-            (cstride / ncomponents),                                      \
-            (bstride / ncomponents),                                      \
-            (astride / ncomponents)                                       \
-            CMTARG,                                                       \
-            array_type_id);                                               \
-    H5Tclose(array_type_id);                                              \
-    return retval;                                                        \
+
+    // Optionally record a comment about the field
+    return esio_comment_defer(h, name, comment);
 }
 
-GEN_FIELD_OPV(write, const,       double, H5T_NATIVE_DOUBLE, WCMTPAR, WCMTARG)
-GEN_FIELD_OPV(read,  /*mutable*/, double, H5T_NATIVE_DOUBLE, RCMTPAR, RCMTARG)
+static
+int esio_field_read_delta(const esio_handle h,
+                          hid_t dset_id,
+                          const char *reference,
+                          void *field,
+                          int cstride, int bstride, int astride,
+                          hid_t type_id)
+{
+    // Deltas must be read using the type they were written with
+    const hid_t delta_type_id = esio_delta_type(type_id);
+    const hid_t field_type_id = H5Dget_type(dset_id);
+    const int compatible = delta_type_id >= 0
+            && H5Tget_size(field_type_id) == H5Tget_size(delta_type_id);
+    H5Tclose(field_type_id);
+    if (!compatible) {
+        ESIO_ERROR("delta fields must be read using their written type",
+                   ESIO_EINVAL);
+    }
 
-GEN_FIELD_OPV(write, const,       float, H5T_NATIVE_FLOAT, WCMTPAR, WCMTARG)
-GEN_FIELD_OPV(read,  /*mutable*/, float, H5T_NATIVE_FLOAT, RCMTPAR, RCMTARG)
+    // Reconstruct the reference directly into the caller's buffer
+    const int rstat = esio_field_read_internal(h, reference, field,
+                                               cstride, bstride, astride,
+                                               0, type_id);
+    if (rstat != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to reconstruct delta reference", rstat);
+    }
 
-GEN_FIELD_OPV(write, const,       int, H5T_NATIVE_INT, WCMTPAR, WCMTARG)
-GEN_FIELD_OPV(read,  /*mutable*/, int, H5T_NATIVE_INT, RCMTPAR, RCMTARG)
+    // Read the contiguous delta
+    const size_t size  = H5Tget_size(type_id);
+    const size_t nelem = (size_t) h->f.clocal * h->f.blocal * h->f.alocal;
+    void *delta = malloc(nelem ? nelem * size : 1);
+    if (delta == NULL) {
+        ESIO_ERROR("Unable to allocate delta buffer", ESIO_ENOMEM);
+    }
+    const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
+    if (plist_id < 0) {
+        free(delta);
+        ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
+    }
+    const int dstat = esio_field_layout0_field_reader(
+            plist_id, dset_id, delta,
+            h->f.cglobal, h->f.cstart, h->f.clocal, h->f.blocal*h->f.alocal,
+            h->f.bglobal, h->f.bstart, h->f.blocal, h->f.alocal,
+            h->f.aglobal, h->f.astart, h->f.alocal, 1,
+            delta_type_id);
+    H5Pclose(plist_id);
+    if (dstat != ESIO_SUCCESS) {
+        free(delta);
+        ESIO_ERROR_VAL("Error reading delta field", ESIO_EFAILED, dstat);
+    }
+
+    // Apply the delta to the reconstructed reference
+    esio_delta_xor(delta, NULL, field, size,
+                   h->f.clocal, h->f.blocal, h->f.alocal,
+                   0, 0, 0,
+                   cstride, bstride, astride);
+    free(delta);
+
+    return ESIO_SUCCESS;
+}
+
+#define GEN_FIELD_OP_DELTA(TYPE,H5TYPE)                                   \
+int esio_field_write_delta_ ## TYPE(                                      \
+        const esio_handle h,                                              \
+        const char *name,                                                 \
+        const TYPE *field,                                                \
+        int cstride, int bstride, int astride,                            \
+        const char *reference,                                            \
+        const TYPE *previous,                                             \
+        const char *comment)                                              \
+{                                                                         \
+    return esio_field_write_delta_internal(h, name, field,                \
+                                           cstride, bstride, astride,     \
+                                           reference, previous, comment,  \
+                                           H5TYPE);                       \
+}
+
+GEN_FIELD_OP_DELTA(double, H5T_NATIVE_DOUBLE)
+GEN_FIELD_OP_DELTA(float,  H5T_NATIVE_FLOAT)
 
 // *******************************************************************
 // PLANE READ WRITE PLANE READ WRITE PLANE READ WRITE PLANE READ WRITE
@@ -1588,6 +5118,7 @@ int esio_plane_write_internal(const esio_handle h,
     if (type_id < 0)      ESIO_ERROR("type_id < 0",            ESIO_EINVAL);
     if (h->p.aglobal == 0)
         ESIO_ERROR("esio_plane_establish() never called", ESIO_EINVAL);
+    h->flags |= FLAG_FILE_WRITTEN;
 
     // Provide contiguous defaults whenever the user supplied zero strides.
     // Strides are given in units of type_id; hence astride = 1 is contiguous.
@@ -1597,10 +5128,10 @@ int esio_plane_write_internal(const esio_handle h,
     // Attempt to read metadata for the plane (which may or may not exist)
     int plane_bglobal, plane_aglobal;
     int plane_ncomponents;
-    const int mstat = esio_plane_metadata_read(h->file_id, name,
-                                               &plane_bglobal,
-                                               &plane_aglobal,
-                                               &plane_ncomponents);
+    const int mstat = esio_plane_metadata_lookup(h, name,
+                                                 &plane_bglobal,
+                                                 &plane_aglobal,
+                                                 &plane_ncomponents);
 
     hid_t dset_id;
     if (mstat != ESIO_SUCCESS) {
@@ -1701,16 +5232,16 @@ int esio_plane_write_internal(const esio_handle h,
     }
     H5Pclose(plist_id);
 
-    // Optionally write a comment about the plane
-    if (comment && *comment) {
-        if (H5Oset_comment(dset_id, comment) < 0) {
-            esio_plane_close(dset_id);
-            ESIO_ERROR("Error setting comment on plane", ESIO_EFAILED);
-        }
-    }
+    // Written data need not remain cached
+    esio_dataset_advise(h, dset_id, 1, 1, 0, 1,
+            h->p.bglobal, h->p.bstart, h->p.blocal,
+            h->p.aglobal, h->p.astart, h->p.alocal,
+            ESIO_READAHEAD_DONTNEED);
+
     esio_plane_close(dset_id);
 
-    return ESIO_SUCCESS;
+    // Optionally record a comment about the plane
+    return esio_comment_defer(h, name, comment);
 }
 
 static
@@ -1747,10 +5278,10 @@ int esio_plane_read_internal(const esio_handle h,
     // Read metadata for the plane
     int plane_bglobal, plane_aglobal;
     int plane_ncomponents;
-    const int status = esio_plane_metadata_read(h->file_id, name,
-                                                &plane_bglobal,
-                                                &plane_aglobal,
-                                                &plane_ncomponents);
+    const int status = esio_plane_metadata_lookup(h, name,
+                                                  &plane_bglobal,
+                                                  &plane_aglobal,
+                                                  &plane_ncomponents);
     switch (status) {
         case ESIO_SUCCESS:
             break;
@@ -1801,6 +5332,12 @@ int esio_plane_read_internal(const esio_handle h,
     }
     H5Tclose(plane_type_id);
 
+    // Have each node prefetch what its ranks are about to read
+    esio_dataset_advise(h, dset_id, 1, 1, 0, 1,
+            h->p.bglobal, h->p.bstart, h->p.blocal,
+            h->p.aglobal, h->p.astart, h->p.alocal,
+            ESIO_READAHEAD_WILLNEED);
+
     // Read plane
     const int rstat = esio_plane_reader(
             plist_id, dset_id, plane,
@@ -1888,6 +5425,26 @@ GEN_PLANE_OPV(read,  /*mutable*/, int, H5T_NATIVE_INT, RCMTPAR, RCMTARG)
 // LINE READ WRITE LINE READ WRITE LINE READ WRITE LINE READ WRITE
 // *******************************************************************
 
+// Collectively write any lines staged while FLAG_LINETABLE_ENABLED.
+// Each group of lines sharing a decomposition and type becomes one table.
+static
+int esio_line_table_flush(const esio_handle h)
+{
+    if (h->linetable == NULL || h->linetable->npending == 0) {
+        return ESIO_SUCCESS;
+    }
+
+    const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
+    if (plist_id < 0) {
+        ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
+    }
+    const int status = esio_linetable_flush(h->linetable, h->file_id,
+                                            plist_id, h->comm_rank);
+    H5Pclose(plist_id);
+
+    return status;
+}
+
 static
 int esio_line_write_internal(const esio_handle h,
                              const char *name,
@@ -1908,6 +5465,7 @@ int esio_line_write_internal(const esio_handle h,
     if (type_id < 0)      ESIO_ERROR("type_id < 0",            ESIO_EINVAL);
     if (h->l.aglobal == 0)
         ESIO_ERROR("esio_line_establish() never called", ESIO_EINVAL);
+    h->flags |= FLAG_FILE_WRITTEN;
 
     // Provide contiguous defaults whenever the user supplied zero strides.
     // Strides are given in units of type_id; hence astride = 1 is contiguous.
@@ -1915,9 +5473,52 @@ int esio_line_write_internal(const esio_handle h,
 
     // Attempt to read metadata for the line (which may or may not exist)
     int line_aglobal, line_ncomponents;
-    const int mstat = esio_line_metadata_read(h->file_id, name,
-                                              &line_aglobal,
-                                              &line_ncomponents);
+    const int mstat = esio_line_metadata_lookup(h, name,
+                                                &line_aglobal,
+                                                &line_ncomponents);
+
+    // Lines stored within or staged for a line table carry no dataset
+    int table = -1, row = -1;
+    const int tstat = (mstat != ESIO_SUCCESS) ? ESIO_NOTFOUND
+        : esio_linetable_find(&h->linetable, h->file_id, name,
+                              NULL, NULL, &table, &row);
+
+    // New lines may be staged for a later, coalesced table write
+    if (    (mstat != ESIO_SUCCESS && (h->flags & FLAG_LINETABLE_ENABLED))
+         || (tstat == ESIO_SUCCESS && table < 0)) {
+        if (tstat == ESIO_SUCCESS && h->l.aglobal != line_aglobal) {
+            ESIO_ERROR("request aglobal mismatch with existing line",
+                       ESIO_EINVAL);
+        }
+        return esio_linetable_stage(&h->linetable, name, comment,
+                                    h->l.aglobal, h->l.astart, h->l.alocal,
+                                    line, astride, type_id);
+    }
+
+    if (tstat == ESIO_SUCCESS) {
+        // Line occupies a table row which is overwritten in place.
+        // Table comments are only recorded when rows are first written.
+        if (h->l.aglobal != line_aglobal) {
+            ESIO_ERROR("request aglobal mismatch with existing line",
+                       ESIO_EINVAL);
+        }
+        if (esio_type_ncomponents(type_id) != line_ncomponents) {
+            ESIO_ERROR("request ncomponents mismatch with existing line",
+                       ESIO_EINVAL);
+        }
+        const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
+        if (plist_id < 0) {
+            ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
+        }
+        const int wstat = esio_linetable_write_row(
+                h->file_id, table, row, plist_id, line,
+                h->l.aglobal, h->l.astart, h->l.alocal, astride, type_id);
+        H5Pclose(plist_id);
+        if (wstat != ESIO_SUCCESS) {
+            ESIO_ERROR_VAL("Error writing line table row", ESIO_EFAILED, wstat);
+        }
+        return ESIO_SUCCESS;
+    }
 
     hid_t dset_id;
     if (mstat != ESIO_SUCCESS) {
@@ -2010,16 +5611,15 @@ int esio_line_write_internal(const esio_handle h,
     }
     H5Pclose(plist_id);
 
-    // Optionally write a comment about the line
-    if (comment && *comment) {
-        if (H5Oset_comment(dset_id, comment) < 0) {
-            esio_line_close(dset_id);
-            ESIO_ERROR("Error setting comment on line", ESIO_EFAILED);
-        }
-    }
+    // Written data need not remain cached
+    esio_dataset_advise(h, dset_id, 1, 1, 0, 1, 1, 0, 1,
+            h->l.aglobal, h->l.astart, h->l.alocal,
+            ESIO_READAHEAD_DONTNEED);
+
     esio_line_close(dset_id);
 
-    return ESIO_SUCCESS;
+    // Optionally record a comment about the line
+    return esio_comment_defer(h, name, comment);
 }
 
 static
@@ -2052,11 +5652,15 @@ int esio_line_read_internal(const esio_handle h,
     // Strides are given in units of type_id; hence astride = 1 is contiguous.
     if (astride == 0) astride = 1;
 
+    // Staged lines are written before any line is read back
+    const int fstat = esio_line_table_flush(h);
+    if (fstat != ESIO_SUCCESS) return fstat;
+
     // Read metadata for the line
     int line_aglobal, line_ncomponents;
-    const int status = esio_line_metadata_read(h->file_id, name,
-                                               &line_aglobal,
-                                               &line_ncomponents);
+    const int status = esio_line_metadata_lookup(h, name,
+                                                 &line_aglobal,
+                                                 &line_ncomponents);
     switch (status) {
         case ESIO_SUCCESS:
             break;
@@ -2078,6 +5682,24 @@ int esio_line_read_internal(const esio_handle h,
                     ESIO_EINVAL);
     }
 
+    // Lines stored within a table are read from their row
+    int table, row;
+    if (ESIO_SUCCESS == esio_linetable_find(&h->linetable, h->file_id, name,
+                                            NULL, NULL, &table, &row)) {
+        const hid_t plist_id = esio_H5P_DATASET_XFER_create(h);
+        if (plist_id < 0) {
+            ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
+        }
+        const int rstat = esio_linetable_read_row(
+                h->file_id, table, row, plist_id, line,
+                h->l.aglobal, h->l.astart, h->l.alocal, astride, type_id);
+        H5Pclose(plist_id);
+        if (rstat != ESIO_SUCCESS) {
+            ESIO_ERROR_VAL("Error reading line table row", ESIO_EFAILED, rstat);
+        }
+        return ESIO_SUCCESS;
+    }
+
     // Open existing dataset
     const hid_t dapl_id = H5P_DEFAULT;
     const hid_t dset_id = H5Dopen2(h->file_id, name, dapl_id);
@@ -2103,6 +5725,11 @@ int esio_line_read_internal(const esio_handle h,
         ESIO_ERROR("Error setting IO transfer properties", ESIO_EFAILED);
     }
 
+    // Have each node prefetch what its ranks are about to read
+    esio_dataset_advise(h, dset_id, 1, 1, 0, 1, 1, 0, 1,
+            h->l.aglobal, h->l.astart, h->l.alocal,
+            ESIO_READAHEAD_WILLNEED);
+
     // Read line
     const int rstat = esio_line_reader(
             plist_id, dset_id, line,
@@ -2178,6 +5805,517 @@ GEN_LINE_OPV(read,  /*mutable*/, float, H5T_NATIVE_FLOAT, RCMTPAR, RCMTARG)
 GEN_LINE_OPV(write, const,       int, H5T_NATIVE_INT, WCMTPAR, WCMTARG)
 GEN_LINE_OPV(read,  /*mutable*/, int, H5T_NATIVE_INT, RCMTPAR, RCMTARG)
 
+// *********************************************************************
+// COMPOUND RECORDS COMPOUND RECORDS COMPOUND RECORDS COMPOUND RECORDS
+// *********************************************************************
+
+struct esio_compound_s {
+    hid_t type_id;  // In-memory H5T_COMPOUND type describing one record
+};
+
+esio_compound
+esio_compound_create(size_t size)
+{
+    if (size == 0) {
+        ESIO_ERROR_NULL("size == 0", ESIO_EINVAL);
+    }
+
+    esio_compound c = malloc(sizeof(struct esio_compound_s));
+    if (c == NULL) {
+        ESIO_ERROR_NULL("failed to allocate space for compound", ESIO_ENOMEM);
+    }
+    c->type_id = H5Tcreate(H5T_COMPOUND, size);
+    if (c->type_id < 0) {
+        free(c);
+        ESIO_ERROR_NULL("Unable to create compound type", ESIO_EFAILED);
+    }
+
+    return c;
+}
+
+int
+esio_compound_free(esio_compound c)
+{
+    if (c) {
+        H5Tclose(c->type_id);
+        free(c);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+static
+int esio_compound_insert_internal(esio_compound c,
+                                  const char *name,
+                                  size_t offset,
+                                  int ncomponents,
+                                  hid_t type_id)
+{
+    if (c == NULL)       ESIO_ERROR("c == NULL",       ESIO_EFAULT);
+    if (name == NULL)    ESIO_ERROR("name == NULL",    ESIO_EFAULT);
+    if (ncomponents < 1) ESIO_ERROR("ncomponents < 1", ESIO_EINVAL);
+
+    const hid_t member_id = esio_type_arrayify(type_id, ncomponents);
+    if (member_id < 0) {
+        ESIO_ERROR("Unable to create member type", ESIO_EFAILED);
+    }
+    if (offset + H5Tget_size(member_id) > H5Tget_size(c->type_id)) {
+        H5Tclose(member_id);
+        ESIO_ERROR("member extends past the end of the record", ESIO_EINVAL);
+    }
+
+    // HDF5 rejects duplicate names and overlapping members
+    DISABLE_HDF5_ERROR_HANDLER(insert)
+    const herr_t err = H5Tinsert(c->type_id, name, offset, member_id);
+    ENABLE_HDF5_ERROR_HANDLER(insert)
+    H5Tclose(member_id);
+    if (err < 0) {
+        ESIO_ERROR("member name duplicates or member overlaps another",
+                   ESIO_EINVAL);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+#define GEN_COMPOUND_INSERT(TYPE,H5TYPE)                             \
+int esio_compound_insert_ ## TYPE (                                  \
+        esio_compound c,                                             \
+        const char *name,                                            \
+        size_t offset,                                               \
+        int ncomponents)                                             \
+{                                                                    \
+    return esio_compound_insert_internal(c, name, offset,            \
+                                         ncomponents, H5TYPE);       \
+}
+
+GEN_COMPOUND_INSERT(double, H5T_NATIVE_DOUBLE)
+GEN_COMPOUND_INSERT(float,  H5T_NATIVE_FLOAT)
+GEN_COMPOUND_INSERT(int,    H5T_NATIVE_INT)
+
+// Check that c describes at least one member before it is used for I/O
+static
+int esio_compound_check(const esio_compound c)
+{
+    if (c == NULL) ESIO_ERROR("c == NULL", ESIO_EFAULT);
+    if (H5Tget_nmembers(c->type_id) < 1) {
+        ESIO_ERROR("compound has no members", ESIO_EINVAL);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+int
+esio_field_write_compound(const esio_handle h,
+                          const char *name,
+                          const void *field,
+                          int cstride, int bstride, int astride,
+                          const esio_compound c,
+                          const char *comment)
+{
+    const int status = esio_compound_check(c);
+    if (status != ESIO_SUCCESS) return status;
+
+    return esio_field_write_internal(h, name, field,
+                                     cstride, bstride, astride,
+                                     comment, c->type_id);
+}
+
+int
+esio_field_read_compound(const esio_handle h,
+                         const char *name,
+                         void *field,
+                         int cstride, int bstride, int astride,
+                         const esio_compound c)
+{
+    const int status = esio_compound_check(c);
+    if (status != ESIO_SUCCESS) return status;
+
+    return esio_field_read_internal(h, name, field,
+                                    cstride, bstride, astride,
+                                    0, c->type_id);
+}
+
+int
+esio_plane_write_compound(const esio_handle h,
+                          const char *name,
+                          const void *plane,
+                          int bstride, int astride,
+                          const esio_compound c,
+                          const char *comment)
+{
+    const int status = esio_compound_check(c);
+    if (status != ESIO_SUCCESS) return status;
+
+    return esio_plane_write_internal(h, name, plane, bstride, astride,
+                                     comment, c->type_id);
+}
+
+int
+esio_plane_read_compound(const esio_handle h,
+                         const char *name,
+                         void *plane,
+                         int bstride, int astride,
+                         const esio_compound c)
+{
+    const int status = esio_compound_check(c);
+    if (status != ESIO_SUCCESS) return status;
+
+    return esio_plane_read_internal(h, name, plane, bstride, astride,
+                                    0, c->type_id);
+}
+
+int
+esio_line_write_compound(const esio_handle h,
+                         const char *name,
+                         const void *line,
+                         int astride,
+                         const esio_compound c,
+                         const char *comment)
+{
+    const int status = esio_compound_check(c);
+    if (status != ESIO_SUCCESS) return status;
+
+    return esio_line_write_internal(h, name, line, astride,
+                                    comment, c->type_id);
+}
+
+int
+esio_line_read_compound(const esio_handle h,
+                        const char *name,
+                        void *line,
+                        int astride,
+                        const esio_compound c)
+{
+    const int status = esio_compound_check(c);
+    if (status != ESIO_SUCCESS) return status;
+
+    return esio_line_read_internal(h, name, line, astride,
+                                   0, c->type_id);
+}
+
+// *********************************************************************
+// REDUCE ON WRITE REDUCE ON WRITE REDUCE ON WRITE REDUCE ON WRITE REDUCE
+// *********************************************************************
+
+// Map an esio_reduction value onto the matching MPI_Op or MPI_OP_NULL
+static
+MPI_Op esio_reduce_op(int op)
+{
+    switch (op) {
+        case ESIO_REDUCE_SUM: return MPI_SUM;
+        case ESIO_REDUCE_MAX: return MPI_MAX;
+        case ESIO_REDUCE_MIN: return MPI_MIN;
+        default:              return MPI_OP_NULL;
+    }
+}
+
+// Reduce full-size, per-rank partials so that each rank receives the
+// combined values for exactly the block it owns in the file.  Partials are
+// handed to MPI_Reduce_scatter, which avoids materializing the full result
+// anywhere, as rank-ordered segments.  The partial is used directly when it
+// already consists of such segments.  Otherwise, segments are packed for
+// consecutive ranks at a time into a buffer of about ESIO_REDUCE_PACK_BYTES
+// with one MPI_Reduce_scatter per round delivering only to those ranks.
+// On success *result must be freed by the caller.
+static
+int esio_reduce_internal(const esio_handle h,
+                         const void *partial,
+                         int bglobal, int bstart, int blocal, int bstride,
+                         int aglobal, int astart, int alocal, int astride,
+                         size_t size,
+                         MPI_Datatype mpi_type,
+                         int op,
+                         void **result)
+{
+    const MPI_Op mpi_op = esio_reduce_op(op);
+    if (mpi_op == MPI_OP_NULL)
+        ESIO_ERROR("op must be one of esio_reduction", ESIO_EINVAL);
+    if (partial == NULL && bglobal && aglobal)
+        ESIO_ERROR("partial == NULL", ESIO_EFAULT);
+
+    // Learn every rank's block within the global extents
+    int mine[4] = { bstart, blocal, astart, alocal };
+    int *blocks = malloc(4 * h->comm_size * sizeof(int));
+    int *counts = malloc(2 * h->comm_size * sizeof(int));
+    if (blocks == NULL || counts == NULL) {
+        free(blocks);
+        free(counts);
+        ESIO_ERROR("Unable to allocate block information", ESIO_ENOMEM);
+    }
+    if (MPI_Allgather(mine, 4, MPI_INT, blocks, 4, MPI_INT, h->comm)) {
+        free(blocks);
+        free(counts);
+        ESIO_ERROR("Error gathering block information", ESIO_EFAILED);
+    }
+
+    // Determine segment sizes and whether partial is usable in place
+    int inplace = (astride == 1 && (bglobal == 1 || bstride == aglobal));
+    size_t total = 0, largest = 0;
+    for (int r = 0; r < h->comm_size; ++r) {
+        const int *blk = blocks + 4*r;
+        counts[r] = blk[1] * blk[3];
+        if (counts[r] && (size_t) blk[0]*aglobal + blk[2] != total) {
+            inplace = 0;
+        }
+        if (blk[1] > 1 && blk[3] != aglobal) inplace = 0;
+        total += counts[r];
+        if ((size_t) counts[r] > largest) largest = counts[r];
+    }
+
+    // Rounds pack at least one rank's segment and otherwise stay in budget
+    size_t budget = ESIO_REDUCE_PACK_BYTES / size;
+    if (budget < largest) budget = largest;
+    if (budget > total)   budget = total;
+    char *packed = NULL;
+    if (!inplace) {
+        packed = malloc(budget ? budget * size : 1);
+        if (packed == NULL) {
+            free(blocks);
+            free(counts);
+            ESIO_ERROR("Unable to allocate packing buffer", ESIO_ENOMEM);
+        }
+    }
+
+    *result = malloc(counts[h->comm_rank] ? counts[h->comm_rank] * size : 1);
+    if (*result == NULL) {
+        free(packed);
+        free(blocks);
+        free(counts);
+        ESIO_ERROR("Unable to allocate reduction buffer", ESIO_ENOMEM);
+    }
+
+    // Every rank computes identical rounds from the gathered blocks
+    int *rcounts = counts + h->comm_size;
+    int rstat = 0;
+    for (int r0 = 0, r1 = 0; r0 < h->comm_size && !rstat; r0 = r1) {
+        const char *sendbuf = partial;
+        if (inplace) {
+            r1 = h->comm_size;
+        } else {
+            char *dst = packed;
+            for (size_t n = 0; r1 < h->comm_size
+                               && n + counts[r1] <= budget; ++r1) {
+                const int *blk = blocks + 4*r1;
+                for (int j = 0; j < blk[1]; ++j) {
+                    const char *src = (const char *) partial
+                                    + ((size_t) (blk[0] + j) * bstride
+                                    +  (size_t)  blk[2]      * astride) * size;
+                    for (int i = 0; i < blk[3]; ++i) {
+                        memcpy(dst, src, size);
+                        dst += size;
+                        src += astride * size;
+                    }
+                }
+                n += counts[r1];
+            }
+            sendbuf = packed;
+        }
+        for (int r = 0; r < h->comm_size; ++r) {
+            rcounts[r] = (r0 <= r && r < r1) ? counts[r] : 0;
+        }
+        rstat = MPI_Reduce_scatter((void *) sendbuf, *result, rcounts,
+                                   mpi_type, mpi_op, h->comm);
+    }
+    free(packed);
+    free(blocks);
+    free(counts);
+    if (rstat) {
+        free(*result);
+        *result = NULL;
+        ESIO_ERROR("Error reducing partial values", ESIO_EFAILED);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+#define GEN_LINE_OP_REDUCE(TYPE,H5TYPE,MPITYPE)                           \
+int esio_line_write_reduce_ ## TYPE(                                      \
+        const esio_handle h,                                              \
+        const char *name,                                                 \
+        const TYPE *line,                                                 \
+        int astride,                                                      \
+        int op,                                                           \
+        const char *comment)                                              \
+{                                                                         \
+    if (h == NULL)     ESIO_ERROR("h == NULL",     ESIO_EFAULT);          \
+    if (astride < 0)   ESIO_ERROR("astride < 0",   ESIO_EINVAL);          \
+    if (h->l.aglobal == 0)                                                \
+        ESIO_ERROR("esio_line_establish() never called", ESIO_EINVAL);    \
+    if (astride == 0) astride = 1;                                        \
+                                                                          \
+    void *reduced;                                                        \
+    const int status = esio_reduce_internal(                              \
+            h, line,                                                      \
+            1, 0, 1, 0,                                                   \
+            h->l.aglobal, h->l.astart, h->l.alocal, astride,              \
+            sizeof(TYPE), MPITYPE, op, &reduced);                         \
+    if (status != ESIO_SUCCESS) return status;                            \
+                                                                          \
+    const int retval = esio_line_write_internal(                          \
+            h, name, reduced, 1, comment, H5TYPE);                        \
+    free(reduced);                                                        \
+    return retval;                                                        \
+}
+
+GEN_LINE_OP_REDUCE(double, H5T_NATIVE_DOUBLE, MPI_DOUBLE)
+GEN_LINE_OP_REDUCE(float,  H5T_NATIVE_FLOAT,  MPI_FLOAT)
+GEN_LINE_OP_REDUCE(int,    H5T_NATIVE_INT,    MPI_INT)
+
+#define GEN_PLANE_OP_REDUCE(TYPE,H5TYPE,MPITYPE)                          \
+int esio_plane_write_reduce_ ## TYPE(                                     \
+        const esio_handle h,                                              \
+        const char *name,                                                 \
+        const TYPE *plane,                                                \
+        int bstride, int astride,                                         \
+        int op,                                                           \
+        const char *comment)                                              \
+{                                                                         \
+    if (h == NULL)     ESIO_ERROR("h == NULL",     ESIO_EFAULT);          \
+    if (bstride < 0)   ESIO_ERROR("bstride < 0",   ESIO_EINVAL);          \
+    if (astride < 0)   ESIO_ERROR("astride < 0",   ESIO_EINVAL);          \
+    if (h->p.aglobal == 0)                                                \
+        ESIO_ERROR("esio_plane_establish() never called", ESIO_EINVAL);   \
+    if (astride == 0) astride = 1;                                        \
+    if (bstride == 0) bstride = astride * h->p.aglobal;                   \
+                                                                          \
+    void *reduced;                                                        \
+    const int status = esio_reduce_internal(                              \
+            h, plane,                                                     \
+            h->p.bglobal, h->p.bstart, h->p.blocal, bstride,              \
+            h->p.aglobal, h->p.astart, h->p.alocal, astride,              \
+            sizeof(TYPE), MPITYPE, op, &reduced);                         \
+    if (status != ESIO_SUCCESS) return status;                            \
+                                                                          \
+    const int retval = esio_plane_write_internal(                         \
+            h, name, reduced, 0, 1, comment, H5TYPE);                     \
+    free(reduced);                                                        \
+    return retval;                                                        \
+}
+
+GEN_PLANE_OP_REDUCE(double, H5T_NATIVE_DOUBLE, MPI_DOUBLE)
+GEN_PLANE_OP_REDUCE(float,  H5T_NATIVE_FLOAT,  MPI_FLOAT)
+GEN_PLANE_OP_REDUCE(int,    H5T_NATIVE_INT,    MPI_INT)
+
+// *********************************************************************
+// NODE-SHARED READS NODE-SHARED READS NODE-SHARED READS NODE-SHARED READ
+// *********************************************************************
+
+// Read an entire line (when plane is zero) or plane into a window shared by
+// all ranks on each node.  Only the lowest rank on each node reads and
+// stores data.  The others take part in the collective read with empty
+// selections and then map the same memory.
+static
+int esio_shared_read_internal(const esio_handle h,
+                              const char *name,
+                              int plane,
+                              const void **data,
+                              MPI_Win *win,
+                              hid_t type_id)
+{
+    // Sanity check incoming arguments
+    if (h == NULL)        ESIO_ERROR("h == NULL",              ESIO_EFAULT);
+    if (h->file_id == -1) ESIO_ERROR("No file currently open", ESIO_EINVAL);
+    if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
+    if (data == NULL)     ESIO_ERROR("data == NULL",           ESIO_EFAULT);
+    if (win == NULL)      ESIO_ERROR("win == NULL",            ESIO_EFAULT);
+
+    // Every rank sees the same metadata so failures here are consistent
+    int bglobal = 1, aglobal, ncomponents;
+    const int mstat = plane
+        ? esio_plane_metadata_lookup(h, name, &bglobal, &aglobal, &ncomponents)
+        : esio_line_metadata_lookup(h, name, &aglobal, &ncomponents);
+    if (mstat != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to read ESIO metadata", mstat);
+    }
+    if (esio_type_ncomponents(type_id) != ncomponents) {
+        ESIO_ERROR("request ncomponents mismatch with existing data",
+                   ESIO_EINVAL);
+    }
+
+    // Collectively find the ranks sharing each node's memory
+    const int nstat = esio_node_comm(h);
+    if (nstat != ESIO_SUCCESS) return nstat;
+    int node_rank;
+    ESIO_MPICHKQ(MPI_Comm_rank(h->node_comm, &node_rank));
+
+    // Only the reader on each node contributes memory to the window
+    const size_t size = H5Tget_size(type_id);
+    const MPI_Aint bytes = node_rank ? 0 : (MPI_Aint) bglobal*aglobal*size;
+    void *base = NULL;
+    ESIO_MPICHKQ(MPI_Win_allocate_shared(bytes, (int) size, MPI_INFO_NULL,
+                                         h->node_comm, &base, win));
+
+    // From here on failures are collected so that the window is freed
+    int status = ESIO_SUCCESS;
+    if (node_rank) {
+        MPI_Aint qbytes;
+        int qdisp;
+        if (MPI_Win_shared_query(*win, 0, &qbytes, &qdisp, &base)) {
+            status = ESIO_EFAILED;
+        }
+    }
+
+    // Narrow the decomposition so that only node readers select data
+    int rstat;
+    if (plane) {
+        const struct plane_decomp_s saved = h->p;
+        h->p.bglobal = bglobal; h->p.bstart = 0;
+        h->p.aglobal = aglobal; h->p.astart = 0;
+        h->p.blocal  = node_rank ? 0 : bglobal;
+        h->p.alocal  = node_rank ? 0 : aglobal;
+        rstat = esio_plane_read_internal(h, name, base, 0, 0, NULL, type_id);
+        h->p = saved;
+    } else {
+        const struct line_decomp_s saved = h->l;
+        h->l.aglobal = aglobal; h->l.astart = 0;
+        h->l.alocal  = node_rank ? 0 : aglobal;
+        rstat = esio_line_read_internal(h, name, base, 0, NULL, type_id);
+        h->l = saved;
+    }
+    if (status == ESIO_SUCCESS) status = rstat;
+
+    // Agree on success and make the reader's stores visible node-wide
+    if (MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT,
+                      MPI_MAX, h->comm)) {
+        status = ESIO_EFAILED;
+    }
+    if (status == ESIO_SUCCESS && MPI_Win_fence(0, *win)) {
+        status = ESIO_EFAILED;
+    }
+    if (status != ESIO_SUCCESS) {
+        MPI_Win_free(win);
+        ESIO_ERROR("Error reading into node-shared window", status);
+    }
+
+    *data = base;
+    return ESIO_SUCCESS;
+}
+
+#define GEN_SHARED_OP(TYPE,H5TYPE)                                        \
+int esio_line_read_shared_ ## TYPE(                                       \
+        const esio_handle h,                                              \
+        const char *name,                                                 \
+        const TYPE **line,                                                \
+        MPI_Win *win)                                                     \
+{                                                                         \
+    return esio_shared_read_internal(h, name, 0, (const void **) line,    \
+                                     win, H5TYPE);                        \
+}                                                                         \
+                                                                          \
+int esio_plane_read_shared_ ## TYPE(                                      \
+        const esio_handle h,                                              \
+        const char *name,                                                 \
+        const TYPE **plane,                                               \
+        MPI_Win *win)                                                     \
+{                                                                         \
+    return esio_shared_read_internal(h, name, 1, (const void **) plane,   \
+                                     win, H5TYPE);                        \
+}
+
+GEN_SHARED_OP(double, H5T_NATIVE_DOUBLE)
+GEN_SHARED_OP(float,  H5T_NATIVE_FLOAT)
+GEN_SHARED_OP(int,    H5T_NATIVE_INT)
+
 // *********************************************************************
 // ATTRIBUTE ATTRIBUTE ATTRIBUTE ATTRIBUTE ATTRIBUTE ATTRIBUTE ATTRIBUTE
 // *********************************************************************
@@ -2240,6 +6378,7 @@ int esio_attribute_writev_##TYPE(const esio_handle h,                         \
     if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);  \
     if (value == NULL)    ESIO_ERROR("value == NULL",          ESIO_EFAULT);  \
     if (ncomponents < 1)  ESIO_ERROR("ncomponents < 1",        ESIO_EINVAL);  \
+    h->flags |= FLAG_FILE_WRITTEN;                                            \
                                                                               \
     const herr_t err = H5LTset_attribute_##TYPE(                              \
             h->file_id, location, name, value, ncomponents);                  \
@@ -2351,6 +6490,7 @@ int esio_string_set(const esio_handle h,
     if (location == NULL) ESIO_ERROR("location == NULL",       ESIO_EFAULT);
     if (name == NULL)     ESIO_ERROR("name == NULL",           ESIO_EFAULT);
     if (value == NULL)    ESIO_ERROR("value == NULL",          ESIO_EFAULT);
+    h->flags |= FLAG_FILE_WRITTEN;
 
     const herr_t err = H5LTset_attribute_string(
             h->file_id, location, name, value);
@@ -27,6 +27,7 @@
 #ifndef ESIO_ESIO_H
 #define ESIO_ESIO_H
 
+#include <stddef.h>
 #include <mpi.h>
 #include <esio/visibility.h>
 
@@ -43,6 +44,9 @@ extern "C" {
 /** An opaque type following ESIO's \ref conceptshandles "handle concept". */
 typedef struct esio_handle_s *esio_handle;
 
+/** An opaque description of one \ref conceptscompound "compound record". */
+typedef struct esio_compound_s *esio_compound;
+
 /**
  * \name Initializing and finalizing a state handle
  * See \ref conceptshandles "handles" for the associated semantics.
@@ -119,11 +123,15 @@ int esio_handle_finalize(esio_handle h) ESIO_API;
 
 /**
  * Create a new file or overwrite an existing one.
+ * Files named using the <tt>stage:</tt> scheme are written within the
+ * staging directory and only appear under their final name once closed.
+ * Creating them requires that every rank of the handle share one node.
+ * See \ref conceptsstaging "staging concepts" for more details.
  *
  * \param h Handle to use.
  * \param file Name of the file to open.
  *             It may contain a leading URI scheme or host name
- *             (e.g. "ufs:", "machine.univ.edu:").
+ *             (e.g. "ufs:", "machine.univ.edu:", "stage:").
  * \param overwrite If zero, fail if an existing file is detected.
  *                  If nonzero, clobber any existing file.
  *
@@ -132,15 +140,79 @@ int esio_handle_finalize(esio_handle h) ESIO_API;
 int esio_file_create(esio_handle h, const char *file, int overwrite) ESIO_API;
 
 /**
- * Open an existing file.
+ * Create a new file whose distributed datasets are spread across several
+ * target directories so that their combined capacity may be used.
+ * One subfile named after \c file is created within each target.  Each new
+ * line, plane, or field is stored within whichever subfile has so far been
+ * assigned the fewest bytes.  The file \c file itself holds only attributes
+ * and external links to the subfiles.  Such files are read using
+ * esio_file_open() exactly like any other file.
+ * Datasets are written one after another, each to a single subfile, so
+ * this offers no more bandwidth than esio_file_create().  Use
+ * esio_file_create_grouped() to write several fields concurrently.
+ * See \ref conceptsmultitarget "multi-target concepts" for more details.
+ *
+ * \param h Handle to use.
+ * \param file Name of the file to open.
+ *             It may contain a leading URI scheme or host name
+ *             (e.g. "ufs:", "machine.univ.edu:").
+ * \param overwrite If zero, fail if an existing file or subfile is detected.
+ *                  If nonzero, clobber any existing files.
+ * \param ntargets Number of directories in \c targets.  Supplying zero
+ *                 is equivalent to calling esio_file_create().
+ * \param targets Existing directories to hold subfiles.  Each may contain a
+ *                leading URI scheme (e.g. "ufs:").
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_file_create_multi(esio_handle h,
+                           const char *file,
+                           int overwrite,
+                           int ntargets,
+                           const char * const *targets) ESIO_API;
+
+/**
+ * Create a new file whose fields may be written concurrently by
+ * \c ngroups groups of ranks.  The handle's communicator is split into
+ * contiguous, nearly equal groups and each group creates a subfile named
+ * after \c file.  Fields written by esio_field_write_batch_double() and
+ * friends are dealt to the groups and each group writes its fields into its
+ * own subfile while the other groups do the same.  All other data is written
+ * to \c file, which also holds external links to every grouped field.
+ * Subfiles are open only during batched writes, so every other access,
+ * including reads before the file is closed, goes through those links.  Such
+ * files are read using esio_file_open() exactly like any other file.
+ * See \ref conceptsgrouped "grouped file concepts" for more details.
  *
  * \param h Handle to use.
  * \param file Name of the file to open.
  *             It may contain a leading URI scheme or host name
  *             (e.g. "ufs:", "machine.univ.edu:").
+ * \param overwrite If zero, fail if an existing file or subfile is detected.
+ *                  If nonzero, clobber any existing files.
+ * \param ngroups Number of groups, which must be between one and the
+ *                number of ranks in the handle's communicator.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_file_create_grouped(esio_handle h,
+                             const char *file,
+                             int overwrite,
+                             int ngroups) ESIO_API;
+
+/**
+ * Open an existing file.
+ *
+ * \param h Handle to use.
+ * \param file Name of the file to open.
+ *             It may contain a leading URI scheme or host name
+ *             (e.g. "ufs:", "machine.univ.edu:", "stage:").
  * \param readwrite If zero, open the file in read-only mode.
  *                  If nonzero, open the file in read-write mode.
  *
+ * Any \ref conceptsmanifest "manifest" present in the file is read once
+ * and used to answer subsequent metadata queries.
+ *
  * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
  */
 int esio_file_open(esio_handle h, const char *file, int readwrite) ESIO_API;
@@ -184,6 +256,7 @@ char* esio_file_path(const esio_handle h) ESIO_API;
 
 /**
  * Flush buffers associated with any currently open file.
+ * Any \ref conceptscomments "comments" not yet written are written first.
  *
  * \param h Handle to use.
  *
@@ -194,6 +267,9 @@ int esio_file_flush(esio_handle h) ESIO_API;
 /**
  * Close any currently open file.
  * Closing a file automatically flushes all unwritten data.
+ * Files opened for writing have their \ref conceptsmanifest "manifest"
+ * rewritten just before closing, as is their
+ * \ref conceptscomments "provenance" when anything was written.
  *
  * \param h Handle to use.
  *
@@ -218,6 +294,9 @@ int esio_file_close(esio_handle h) ESIO_API;
  * \warning The currently open file path must not match \c restart_template,
  *          otherwise this method will fail with mysterious renaming errors.
  *
+ * \warning Files created by esio_file_create_multi() cannot be renamed
+ *          because their subfiles would not be renamed alongside them.
+ *
  * \param h                Handle to use.
  * \param restart_template The restart template to use.  See the information
  *                         above for what constitutes a valid value.
@@ -233,6 +312,64 @@ int esio_file_close(esio_handle h) ESIO_API;
 int esio_file_close_restart(esio_handle h,
                             const char *restart_template,
                             int retain_count) ESIO_API;
+
+/**
+ * Are files created or opened by this handle built in memory?
+ * See esio_file_small_set() for more details.
+ *
+ * \param h Handle to use.
+ *
+ * \return Nonzero if small files are enabled.  Zero otherwise.
+ */
+int esio_file_small_get(const esio_handle h) ESIO_API;
+
+/**
+ * Enable or disable building small files in memory.  When enabled,
+ * subsequent esio_file_create() or esio_file_open() calls use HDF5's core
+ * driver.  The file is kept as an image in memory, so attribute, metadata,
+ * and data operations cause no filesystem traffic.  The image is written
+ * sequentially when the file is flushed or closed.  Opening reads the entire
+ * file at once.  This suits template files, run logs, and small statistics
+ * files written using an <tt>MPI_COMM_SELF</tt> handle.  It is unsuitable
+ * for files larger than available memory.  Changing this setting does not
+ * affect any file that is already open.
+ *
+ * \param h      Handle to use.  Its communicator must contain exactly one
+ *               rank when \c enable is nonzero.
+ * \param enable If nonzero, build subsequent files in memory.
+ *               If zero, use MPI-IO as usual.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_file_small_set(esio_handle h, int enable) ESIO_API;
+
+/**
+ * Are visualization views written when files are closed?
+ * See esio_file_views_set() for more details.
+ *
+ * \param h Handle to use.
+ *
+ * \return Nonzero if views are enabled.  Zero otherwise.
+ */
+int esio_file_views_get(const esio_handle h) ESIO_API;
+
+/**
+ * Enable or disable writing visualization views when files are closed.
+ * When enabled, esio_file_close() presents every field in a writable file as
+ * a plain three-dimensional HDF5 dataset, regardless of the field's layout.
+ * Layouts 0 and 1 need nothing, layout 2 gains a virtual dataset in the group
+ * <tt>esio_views</tt>, and layout 3 gains a contiguous copy there.  It also
+ * writes an XDMF descriptor named after the file with an added
+ * <tt>.xmf</tt> suffix referencing each field's plain dataset.
+ * See \ref conceptsviews "view concepts" for more details.
+ *
+ * \param h      Handle to use.
+ * \param enable If nonzero, write views when closing files.
+ *               If zero, write no views.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_file_views_set(esio_handle h, int enable) ESIO_API;
 /*\@}*/
 
 
@@ -596,6 +733,8 @@ esio_attribute_sizev(const esio_handle h,
 
 /**
  * Establish the parallel decomposition to use for subsequent line operations.
+ * Any lines staged per esio_line_table_set() are first written collectively,
+ * so while lines are staged every rank must call this together.
  *
  * \param h       Handle to use.
  * \param aglobal Global number of values within the line.
@@ -1760,42 +1899,1301 @@ esio_field_sizev(const esio_handle h,
 /** \endcond */
 
 /**
- * \name Querying and controlling field layout
- * See \ref conceptslayouts "layout concepts" for more details.
+ * \name Manipulating distributed compound-valued data
+ * Compound records hold several named members of possibly different types,
+ * such as a C \c struct, so that all members are written or read using one
+ * collective operation.  See \ref conceptscompound "compound concepts" for
+ * more details.
  */
 /*\@{*/
 
 /**
- * Query the number of layouts available within ESIO.
- * This is the maximum <code>layout_index + 1</code>.
+ * Begin describing a compound record occupying \c size bytes in memory,
+ * e.g. <tt>sizeof(struct point)</tt>.  Members are then added using
+ * esio_compound_insert_double() and its siblings.  Descriptions do not
+ * depend on any handle and may be reused for any number of operations.
  *
- * @return The number of layouts available within ESIO.
+ * \param size Number of bytes between consecutive records in memory.
+ *
+ * \return A new description on success which must be released using
+ *         esio_compound_free().  \c NULL on failure.
  */
-int esio_field_layout_count(void) ESIO_API;
+esio_compound esio_compound_create(size_t size) ESIO_API;
 
 /**
- * Get the default layout associated with the given handle.
- * This layout will be used when writing any new fields.
+ * Describe a <code>double</code>-valued member of a compound record.
+ * Members are matched by name when reading, so reading using a description
+ * holding only some members of a stored record reads only those members.
  *
- * @param h Handle to use.
+ * \param c           Description to modify.
+ * \param name        Null-terminated member name unique within \c c.
+ * \param offset      Member's offset within the record in bytes,
+ *                    e.g. <tt>offsetof(struct point, u)</tt>.
+ * \param ncomponents Number of adjacent scalars in the member, which is one
+ *                    for a plain scalar member.
  *
- * \return A \c layout_index value suitable for use with
- *         esio_field_layout_set().  On error, zero is
- *         returned.
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         Members overlapping another member or the end of the record are
+ *         rejected with ::ESIO_EINVAL.
  */
-int esio_field_layout_get(const esio_handle h) ESIO_API;
+int esio_compound_insert_double(esio_compound c,
+                                const char *name,
+                                size_t offset,
+                                int ncomponents) ESIO_API;
 
 /**
- * Set the default layout associated with the given handle.
- * The supplied layout will be used when writing any new fields.
+ * Describe a <code>float</code>-valued member of a compound record.
+ * \copydetails esio_compound_insert_double
+ */
+int esio_compound_insert_float(esio_compound c,
+                               const char *name,
+                               size_t offset,
+                               int ncomponents) ESIO_API;
+
+/**
+ * Describe an <code>int</code>-valued member of a compound record.
+ * \copydetails esio_compound_insert_double
+ */
+int esio_compound_insert_int(esio_compound c,
+                             const char *name,
+                             size_t offset,
+                             int ncomponents) ESIO_API;
+
+/**
+ * Release a description obtained from esio_compound_create().
+ * Providing \c NULL is permitted and has no effect.
  *
- * @param h Handle to use.
- * @param layout_index Layout index to set in the range
- *                     <tt>[0, </tt>esio_field_layout_count()<tt>)</tt>.
+ * \param c Description to release.
  *
  * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
  */
-int esio_field_layout_set(esio_handle h, int layout_index) ESIO_API;
+int esio_compound_free(esio_compound c) ESIO_API;
+
+/**
+ * Write a compound-valued field.
+ *
+ * The parallel decomposition must have been set by a previous call to
+ * esio_field_establish().  All strides are measured in records, that is in
+ * units of the \c size given to esio_compound_create().  Supplying zero for
+ * a stride indicates that direction is contiguous in memory.  Records are
+ * stored without padding and at native precision regardless of
+ * esio_precision_set().
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated field name.
+ * \param field Buffer containing the records to write.
+ * \param cstride Stride between adjacent records in "C" within \c field.
+ * \param bstride Stride between adjacent records in "B" within \c field.
+ * \param astride Stride between adjacent records in "A" within \c field.
+ * \param c Description of each record.
+ * \param comment Comment to associate with the field.  Providing NULL or the
+ *                empty string indicates that no comment should be written.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_field_write_compound(const esio_handle h,
+                              const char *name,
+                              const void *field,
+                              int cstride, int bstride, int astride,
+                              const esio_compound c,
+                              const char *comment) ESIO_API;
+
+/**
+ * Read a compound-valued field.
+ *
+ * The parallel decomposition must have been set by a previous call to
+ * esio_field_establish().  All strides are measured in records.  Only the
+ * members named in \c c are read and other bytes within each record of
+ * \c field are left untouched.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated field name.
+ * \param field Buffer to contain the records read.
+ * \param cstride Stride between adjacent records in "C" within \c field.
+ * \param bstride Stride between adjacent records in "B" within \c field.
+ * \param astride Stride between adjacent records in "A" within \c field.
+ * \param c Description of each record, possibly naming only some of the
+ *          stored members.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_field_read_compound(const esio_handle h,
+                             const char *name,
+                             void *field,
+                             int cstride, int bstride, int astride,
+                             const esio_compound c) ESIO_API;
+
+/**
+ * Write a compound-valued plane.
+ * The parallel decomposition must have been set by a previous call to
+ * esio_plane_establish().  Strides are measured in records.
+ * \see esio_field_write_compound() for further details.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated plane name.
+ * \param plane Buffer containing the records to write.
+ * \param bstride Stride between adjacent records in "B" within \c plane.
+ * \param astride Stride between adjacent records in "A" within \c plane.
+ * \param c Description of each record.
+ * \param comment Comment to associate with the plane.  Providing NULL or the
+ *                empty string indicates that no comment should be written.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_plane_write_compound(const esio_handle h,
+                              const char *name,
+                              const void *plane,
+                              int bstride, int astride,
+                              const esio_compound c,
+                              const char *comment) ESIO_API;
+
+/**
+ * Read a compound-valued plane.
+ * The parallel decomposition must have been set by a previous call to
+ * esio_plane_establish().  Strides are measured in records.
+ * \see esio_field_read_compound() for further details.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated plane name.
+ * \param plane Buffer to contain the records read.
+ * \param bstride Stride between adjacent records in "B" within \c plane.
+ * \param astride Stride between adjacent records in "A" within \c plane.
+ * \param c Description of each record, possibly naming only some of the
+ *          stored members.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_plane_read_compound(const esio_handle h,
+                             const char *name,
+                             void *plane,
+                             int bstride, int astride,
+                             const esio_compound c) ESIO_API;
+
+/**
+ * Write a compound-valued line.
+ * The parallel decomposition must have been set by a previous call to
+ * esio_line_establish().  Strides are measured in records.
+ * \see esio_field_write_compound() for further details.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated line name.
+ * \param line Buffer containing the records to write.
+ * \param astride Stride between adjacent records within \c line.
+ * \param c Description of each record.
+ * \param comment Comment to associate with the line.  Providing NULL or the
+ *                empty string indicates that no comment should be written.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_line_write_compound(const esio_handle h,
+                             const char *name,
+                             const void *line,
+                             int astride,
+                             const esio_compound c,
+                             const char *comment) ESIO_API;
+
+/**
+ * Read a compound-valued line.
+ * The parallel decomposition must have been set by a previous call to
+ * esio_line_establish().  Strides are measured in records.
+ * \see esio_field_read_compound() for further details.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated line name.
+ * \param line Buffer to contain the records read.
+ * \param astride Stride between adjacent records within \c line.
+ * \param c Description of each record, possibly naming only some of the
+ *          stored members.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_line_read_compound(const esio_handle h,
+                            const char *name,
+                            void *line,
+                            int astride,
+                            const esio_compound c) ESIO_API;
+/*\@}*/
+
+/** \cond INTERNAL */
+#define ESIO_FIELD_WRITE_DELTA_GEN(TYPE)                             \
+int                                                                  \
+esio_field_write_delta_##TYPE(const esio_handle h,                   \
+                              const char *name,                      \
+                              const TYPE *field,                     \
+                              int cstride, int bstride, int astride, \
+                              const char *reference,                 \
+                              const TYPE *previous,                  \
+                              const char *comment)                   \
+                              ESIO_API;
+
+#ifdef __cplusplus
+#define ESIO_FIELD_WRITE_DELTA_GEN_CXX(TYPE)                              \
+extern "C++" inline int                                                   \
+esio_field_write_delta(const esio_handle h,                               \
+                       const char *name,                                  \
+                       const TYPE *field,                                 \
+                       int cstride, int bstride, int astride,             \
+                       const char *reference,                             \
+                       const TYPE *previous = 0,                          \
+                       const char *comment = 0)                           \
+{ return esio_field_write_delta_##TYPE(h,name,field,cstride,bstride,      \
+                                       astride,reference,previous,        \
+                                       comment);                        }
+#endif
+/** \endcond */
+
+/**
+ * \name Storing time series of fields as deltas
+ * See \ref conceptsdeltas "delta concepts" for more details.
+ * Additionally, the C++-only function <tt>esio_field_write_delta()</tt>
+ * provides an overloaded, type-safe version of these methods.
+ * Delta-encoded fields are read using esio_field_read_double() or
+ * esio_field_read_float() matching the type used to write them.  They may
+ * only be overwritten by another delta write.
+ */
+/*\@{*/
+
+/**
+ * Write a scalar-valued <code>double</code> field as the bitwise difference
+ * from an existing field named \c reference.  The reference may itself be
+ * a delta-encoded field but must have the same global size.
+ *
+ * The parallel decomposition must have been set by a previous call to
+ * esio_field_establish().  All strides are measured in
+ * <tt>sizeof(</tt><i>scalar</i><tt>)</tt>.  Supplying zero for a stride
+ * indicates that direction is contiguous in memory.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated field name.
+ * \param field Buffer containing the scalars to write.
+ * \param cstride Stride between adjacent scalars in "C"
+ *                within buffers \c field and \c previous.
+ * \param bstride Stride between adjacent scalars in "B"
+ *                within buffers \c field and \c previous.
+ * \param astride Stride between adjacent scalars in "A"
+ *                within buffers \c field and \c previous.
+ * \param reference Null-terminated name of an existing field.
+ * \param previous Buffer containing exactly the values that reading
+ *                 \c reference would produce.  Providing NULL causes
+ *                 ESIO to read \c reference itself, as it also does
+ *                 whenever \c reference is stored at another precision.
+ * \param comment Comment to associate with the field.  Providing NULL or the
+ *                empty string indicates that no comment should be written.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_FIELD_WRITE_DELTA_GEN(double)
+
+#ifdef __cplusplus
+/** \copydoc esio_field_write_delta_double */
+ESIO_FIELD_WRITE_DELTA_GEN_CXX(double)
+#endif
+
+/**
+ * Write a scalar-valued <code>float</code> field as a delta.
+ * \copydetails esio_field_write_delta_double
+ */
+ESIO_FIELD_WRITE_DELTA_GEN(float)
+
+#ifdef __cplusplus
+/** \copydoc esio_field_write_delta_float */
+ESIO_FIELD_WRITE_DELTA_GEN_CXX(float)
+#endif
+/*\@}*/
+
+/** \cond INTERNAL */
+#undef ESIO_FIELD_WRITE_DELTA_GEN
+#ifdef __cplusplus
+#undef ESIO_FIELD_WRITE_DELTA_GEN_CXX
+#endif
+/** \endcond */
+
+/**
+ * Callback invoked by the streaming field routines once per slab.
+ * The slab holds \c clocal contiguous planes of this rank's field block
+ * beginning at global "C" index \c cstart.  Each plane is stored contiguously
+ * with "A" varying fastest, exactly as for esio_field_write_double() with
+ * all strides zero.
+ *
+ * \param slab Staging buffer to fill when writing or to consume when reading.
+ * \param cstart Global starting index in "C" of the slab.
+ * \param clocal Number of "C" planes within the slab.
+ * \param user_data Opaque pointer supplied by the caller.
+ *
+ * \return Zero on success.  Any nonzero value on any rank causes the
+ *         collective stream to return ::ESIO_EFAILED on every rank once
+ *         all slabs have been transferred.  The callback is not invoked
+ *         again on the rank that failed.
+ */
+typedef int (*esio_field_stream_callback)(void *slab,
+                                          int cstart,
+                                          int clocal,
+                                          void *user_data);
+
+/** \cond INTERNAL */
+#define ESIO_FIELD_WRITE_STREAM_GEN(TYPE)                               \
+int                                                                     \
+esio_field_write_stream_##TYPE(const esio_handle h,                     \
+                               const char *name,                        \
+                               int cslab,                               \
+                               esio_field_stream_callback callback,     \
+                               void *user_data,                         \
+                               const char *comment)                     \
+                               ESIO_API;
+
+#define ESIO_FIELD_READ_STREAM_GEN(TYPE)                                \
+int                                                                     \
+esio_field_read_stream_##TYPE(const esio_handle h,                      \
+                              const char *name,                         \
+                              int cslab,                                \
+                              esio_field_stream_callback callback,      \
+                              void *user_data)                          \
+                              ESIO_API;
+/** \endcond */
+
+/**
+ * \name Streaming fields through bounded buffers
+ * See \ref conceptsstream "streaming concepts" for more details.
+ * No C++ overloads are provided as ::esio_field_stream_callback is untyped.
+ */
+/*\@{*/
+
+/**
+ * Collectively write a scalar-valued <code>double</code> field whose
+ * contents are produced slab-by-slab by \c callback.  At most two slabs of
+ * \c cslab planes in "C" of this rank's block are held in memory at any one
+ * time so that, when the field can be written directly through MPI-IO, one
+ * slab is produced while the previous one is written.  The field must use
+ * layout zero, i.e. esio_field_layout_get() must return zero when the field
+ * is first written.
+ *
+ * The parallel decomposition must have been set by a previous call to
+ * esio_field_establish().
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated field name.
+ * \param cslab Maximum number of "C" planes per slab.
+ * \param callback Invoked to fill each slab before it is written.
+ * \param user_data Passed unchanged to \c callback.
+ * \param comment Comment to associate with the field.  Providing NULL or the
+ *                empty string indicates that no comment should be written.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_FIELD_WRITE_STREAM_GEN(double)
+
+/**
+ * Collectively write a scalar-valued <code>float</code> field slab-by-slab.
+ * \copydetails esio_field_write_stream_double
+ */
+ESIO_FIELD_WRITE_STREAM_GEN(float)
+
+/**
+ * Collectively write a scalar-valued <code>int</code> field slab-by-slab.
+ * \copydetails esio_field_write_stream_double
+ */
+ESIO_FIELD_WRITE_STREAM_GEN(int)
+
+/**
+ * Collectively read a scalar-valued <code>double</code> field
+ * slab-by-slab, handing each slab to \c callback after it is read.  At most
+ * \c cslab planes in "C" of this rank's block are held in memory at any
+ * one time.  The field must have been written using layout zero.
+ * When esio_readahead_get() is nonzero, the next slab is hinted to the page
+ * cache before \c callback consumes the current one.
+ *
+ * The parallel decomposition must have been set by a previous call to
+ * esio_field_establish().
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated field name.
+ * \param cslab Maximum number of "C" planes per slab.
+ * \param callback Invoked to consume each slab after it is read.
+ * \param user_data Passed unchanged to \c callback.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_FIELD_READ_STREAM_GEN(double)
+
+/**
+ * Collectively read a scalar-valued <code>float</code> field slab-by-slab.
+ * \copydetails esio_field_read_stream_double
+ */
+ESIO_FIELD_READ_STREAM_GEN(float)
+
+/**
+ * Collectively read a scalar-valued <code>int</code> field slab-by-slab.
+ * \copydetails esio_field_read_stream_double
+ */
+ESIO_FIELD_READ_STREAM_GEN(int)
+/*\@}*/
+
+/** \cond INTERNAL */
+#undef ESIO_FIELD_WRITE_STREAM_GEN
+#undef ESIO_FIELD_READ_STREAM_GEN
+/** \endcond */
+
+/** \cond INTERNAL */
+#define ESIO_FIELD_WRITE_BATCH_GEN(TYPE)                          \
+int                                                               \
+esio_field_write_batch_##TYPE(const esio_handle h,                \
+                              int nfields,                        \
+                              const char * const *names,          \
+                              const TYPE * const *fields,         \
+                              const char * const *comments)       \
+                              ESIO_API;
+
+#ifdef __cplusplus
+#define ESIO_FIELD_WRITE_BATCH_GEN_CXX(TYPE)                              \
+extern "C++" inline int                                                   \
+esio_field_write_batch(const esio_handle h,                               \
+                       int nfields,                                       \
+                       const char * const *names,                         \
+                       const TYPE * const *fields,                        \
+                       const char * const *comments = 0)                  \
+{ return esio_field_write_batch_##TYPE(h,nfields,names,fields,comments); }
+#endif
+/** \endcond */
+
+/**
+ * \name Writing several fields at once
+ * See \ref conceptsgrouped "grouped file concepts" for more details.
+ * Additionally, the C++-only function <tt>esio_field_write_batch()</tt>
+ * is overloaded on the field type.
+ */
+/*\@{*/
+
+/**
+ * Collectively write several scalar-valued <code>double</code> fields.
+ * Within a file created by esio_file_create_grouped(), new fields are
+ * redistributed so that each group of ranks writes a subset of them
+ * concurrently into its own subfile.  Otherwise, and for fields which
+ * already exist, this is equivalent to calling esio_field_write_double()
+ * for each field in turn with contiguous strides.
+ *
+ * The parallel decomposition must have been set by a previous call to
+ * esio_field_establish().
+ *
+ * \param h Handle to use.
+ * \param nfields Number of fields to write.
+ * \param names Null-terminated field names.
+ * \param fields Buffers holding each field's contiguous local block.
+ * \param comments Comments to associate with each field.  Providing NULL
+ *                 for the array, or NULL or the empty string for any entry,
+ *                 indicates that no comment should be written.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_FIELD_WRITE_BATCH_GEN(double)
+
+#ifdef __cplusplus
+/** \copydoc esio_field_write_batch_double */
+ESIO_FIELD_WRITE_BATCH_GEN_CXX(double)
+#endif
+
+/**
+ * Collectively write several scalar-valued <code>float</code> fields.
+ * \copydetails esio_field_write_batch_double
+ */
+ESIO_FIELD_WRITE_BATCH_GEN(float)
+
+#ifdef __cplusplus
+/** \copydoc esio_field_write_batch_float */
+ESIO_FIELD_WRITE_BATCH_GEN_CXX(float)
+#endif
+
+/**
+ * Collectively write several scalar-valued <code>int</code> fields.
+ * \copydetails esio_field_write_batch_double
+ */
+ESIO_FIELD_WRITE_BATCH_GEN(int)
+
+#ifdef __cplusplus
+/** \copydoc esio_field_write_batch_int */
+ESIO_FIELD_WRITE_BATCH_GEN_CXX(int)
+#endif
+/*\@}*/
+
+/** \cond INTERNAL */
+#undef ESIO_FIELD_WRITE_BATCH_GEN
+#ifdef __cplusplus
+#undef ESIO_FIELD_WRITE_BATCH_GEN_CXX
+#endif
+/** \endcond */
+
+/** \cond INTERNAL */
+#define ESIO_FIELD_MAP_READONLY_GEN(TYPE)              \
+int                                                    \
+esio_field_map_readonly_##TYPE(const esio_handle h,    \
+                               const char *name,       \
+                               const TYPE **field,     \
+                               int *cstride,           \
+                               int *bstride,           \
+                               int *astride) ESIO_API;
+
+#ifdef __cplusplus
+#define ESIO_FIELD_MAP_READONLY_GEN_CXX(TYPE)                               \
+extern "C++" inline int                                                     \
+esio_field_map_readonly(const esio_handle h,                                \
+                        const char *name,                                   \
+                        const TYPE **field,                                 \
+                        int *cstride,                                       \
+                        int *bstride,                                       \
+                        int *astride)                                       \
+{ return esio_field_map_readonly_##TYPE(h,name,field,cstride,bstride,astride); }
+#endif
+/** \endcond */
+
+/**
+ * \name Mapping fields for zero-copy reading
+ * Post-processing tools which only read files on a single node may walk
+ * fields in place rather than copying them through MPI-IO and HDF5.
+ * Additionally, the C++-only function <tt>esio_field_map_readonly()</tt>
+ * is overloaded on the field type.
+ */
+/*\@{*/
+
+/**
+ * Map an entire <code>double</code>-valued field read-only into memory.
+ * On success, \c field points into a <tt>mmap</tt> of the file holding the
+ * field so that repeated passes are served by the page cache.  Element
+ * (c, b, a) begins at <tt>field[c*cstride + b*bstride + a*astride]</tt>
+ * and any vector components are stored adjacently.  Global sizes are
+ * available from esio_field_sizev().
+ *
+ * Only fields whose values are stored verbatim and contiguously may be
+ * mapped.  Fields written using layout 3, in reduced precision, sparsely,
+ * chunked, or as deltas are rejected with ::ESIO_EINVAL.  Such fields may
+ * always be read using esio_field_read_double() and friends.
+ *
+ * This method does not communicate and no parallel decomposition is
+ * required.  The mapping remains valid after the file is closed until it is
+ * released using esio_field_unmap() or the handle is finalized.  Data
+ * written using the handle since the file was opened may not be visible.
+ *
+ * \param h       Handle to use.
+ * \param name    Null-terminated field name.
+ * \param field   On success, the field's first element.
+ * \param cstride On success, the stride between consecutive \c c indices
+ *                in units of <code>double</code>.  May be NULL.
+ * \param bstride On success, the stride between consecutive \c b indices
+ *                in units of <code>double</code>.  May be NULL.
+ * \param astride On success, the stride between consecutive \c a indices
+ *                in units of <code>double</code>, which is also the number
+ *                of components.  May be NULL.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_FIELD_MAP_READONLY_GEN(double)
+
+#ifdef __cplusplus
+/** \copydoc esio_field_map_readonly_double */
+ESIO_FIELD_MAP_READONLY_GEN_CXX(double)
+#endif
+
+/**
+ * Map an entire <code>float</code>-valued field read-only into memory.
+ * \copydetails esio_field_map_readonly_double
+ */
+ESIO_FIELD_MAP_READONLY_GEN(float)
+
+#ifdef __cplusplus
+/** \copydoc esio_field_map_readonly_float */
+ESIO_FIELD_MAP_READONLY_GEN_CXX(float)
+#endif
+
+/**
+ * Map an entire <code>int</code>-valued field read-only into memory.
+ * \copydetails esio_field_map_readonly_double
+ */
+ESIO_FIELD_MAP_READONLY_GEN(int)
+
+#ifdef __cplusplus
+/** \copydoc esio_field_map_readonly_int */
+ESIO_FIELD_MAP_READONLY_GEN_CXX(int)
+#endif
+
+/**
+ * Release a mapping obtained from esio_field_map_readonly_double() or
+ * its siblings.  The mapped field must no longer be accessed.
+ *
+ * \param h     Handle used to create the mapping.
+ * \param field Field pointer returned when the mapping was created.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_field_unmap(const esio_handle h, const void *field) ESIO_API;
+/*\@}*/
+
+/** \cond INTERNAL */
+#undef ESIO_FIELD_MAP_READONLY_GEN
+#ifdef __cplusplus
+#undef ESIO_FIELD_MAP_READONLY_GEN_CXX
+#endif
+/** \endcond */
+
+/** \cond INTERNAL */
+#define ESIO_LINE_WRITE_REDUCE_GEN(TYPE)           \
+int                                                \
+esio_line_write_reduce_##TYPE(const esio_handle h, \
+                              const char *name,    \
+                              const TYPE *line,    \
+                              int astride,         \
+                              int op,              \
+                              const char *comment) \
+                              ESIO_API;
+
+#ifdef __cplusplus
+#define ESIO_LINE_WRITE_REDUCE_GEN_CXX(TYPE)                               \
+extern "C++" inline int                                                    \
+esio_line_write_reduce(const esio_handle h,                                \
+                       const char *name,                                   \
+                       const TYPE *line,                                   \
+                       int astride,                                        \
+                       int op,                                             \
+                       const char *comment = 0)                            \
+{ return esio_line_write_reduce_##TYPE(h,name,line,astride,op,comment); }
+#endif
+
+#define ESIO_PLANE_WRITE_REDUCE_GEN(TYPE)                \
+int                                                      \
+esio_plane_write_reduce_##TYPE(const esio_handle h,      \
+                               const char *name,         \
+                               const TYPE *plane,        \
+                               int bstride, int astride, \
+                               int op,                   \
+                               const char *comment)      \
+                               ESIO_API;
+
+#ifdef __cplusplus
+#define ESIO_PLANE_WRITE_REDUCE_GEN_CXX(TYPE)                             \
+extern "C++" inline int                                                   \
+esio_plane_write_reduce(const esio_handle h,                              \
+                        const char *name,                                 \
+                        const TYPE *plane,                                \
+                        int bstride, int astride,                         \
+                        int op,                                           \
+                        const char *comment = 0)                          \
+{ return esio_plane_write_reduce_##TYPE(h,name,plane,bstride,astride,     \
+                                        op,comment);                    }
+#endif
+/** \endcond */
+
+/**
+ * \name Reducing per-rank partial results while writing
+ * See \ref conceptsreduce "reduction concepts" for more details.
+ * Additionally, the C++-only functions <tt>esio_line_write_reduce()</tt> and
+ * <tt>esio_plane_write_reduce()</tt> provide overloaded, type-safe versions
+ * of these methods.
+ */
+/*\@{*/
+
+/**
+ * Operations available for combining per-rank partial results.
+ */
+enum esio_reduction {
+    ESIO_REDUCE_SUM = 0, /**< Store the sum over all ranks */
+    ESIO_REDUCE_MAX = 1, /**< Store the maximum over all ranks */
+    ESIO_REDUCE_MIN = 2  /**< Store the minimum over all ranks */
+};
+
+/**
+ * Combine and write a scalar-valued <code>double</code> line.
+ * Every rank supplies a partial result spanning the entire global line.
+ * Each rank receives only the combined values within its portion of the
+ * decomposition before the line is written.  No rank ever holds the
+ * complete result.
+ *
+ * The parallel decomposition must have been set by a previous
+ * call to esio_line_establish().
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated line name.
+ * \param line Buffer containing this rank's partial result for all
+ *             <tt>aglobal</tt> scalars.
+ * \param astride Stride between adjacent values in buffer \c line
+ *                measured in <tt>sizeof(</tt><i>scalar</i><tt>)</tt>.
+ *                Supplying zero indicates contiguous data.
+ * \param op One of ::esio_reduction.
+ * \param comment Comment to associate with the line.  Providing NULL or the
+ *                empty string indicates that no comment should be written.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_LINE_WRITE_REDUCE_GEN(double)
+
+#ifdef __cplusplus
+/** \copydoc esio_line_write_reduce_double */
+ESIO_LINE_WRITE_REDUCE_GEN_CXX(double)
+#endif
+
+/**
+ * Combine and write a scalar-valued <code>float</code> line.
+ * \copydetails esio_line_write_reduce_double
+ */
+ESIO_LINE_WRITE_REDUCE_GEN(float)
+
+#ifdef __cplusplus
+/** \copydoc esio_line_write_reduce_float */
+ESIO_LINE_WRITE_REDUCE_GEN_CXX(float)
+#endif
+
+/**
+ * Combine and write a scalar-valued <code>int</code> line.
+ * \copydetails esio_line_write_reduce_double
+ */
+ESIO_LINE_WRITE_REDUCE_GEN(int)
+
+#ifdef __cplusplus
+/** \copydoc esio_line_write_reduce_int */
+ESIO_LINE_WRITE_REDUCE_GEN_CXX(int)
+#endif
+
+/**
+ * Combine and write a scalar-valued <code>double</code> plane.
+ * Every rank supplies a partial result spanning the entire global plane.
+ * Each rank receives only the combined values within its portion of the
+ * decomposition before the plane is written.
+ *
+ * The parallel decomposition must have been set by a previous call to
+ * esio_plane_establish().  All strides are measured in
+ * <tt>sizeof(</tt><i>scalar</i><tt>)</tt>.  Supplying zero for a stride
+ * indicates that direction is contiguous in memory.  Note that the
+ * contiguous default for \c bstride is <tt>astride * aglobal</tt>.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated plane name.
+ * \param plane Buffer containing this rank's partial result for all
+ *              <tt>bglobal * aglobal</tt> scalars.
+ * \param bstride Stride between adjacent scalars in "B"
+ *                within buffer \c plane.
+ * \param astride Stride between adjacent scalars in "A"
+ *                within buffer \c plane.
+ * \param op One of ::esio_reduction.
+ * \param comment Comment to associate with the plane.  Providing NULL or the
+ *                empty string indicates that no comment should be written.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_PLANE_WRITE_REDUCE_GEN(double)
+
+#ifdef __cplusplus
+/** \copydoc esio_plane_write_reduce_double */
+ESIO_PLANE_WRITE_REDUCE_GEN_CXX(double)
+#endif
+
+/**
+ * Combine and write a scalar-valued <code>float</code> plane.
+ * \copydetails esio_plane_write_reduce_double
+ */
+ESIO_PLANE_WRITE_REDUCE_GEN(float)
+
+#ifdef __cplusplus
+/** \copydoc esio_plane_write_reduce_float */
+ESIO_PLANE_WRITE_REDUCE_GEN_CXX(float)
+#endif
+
+/**
+ * Combine and write a scalar-valued <code>int</code> plane.
+ * \copydetails esio_plane_write_reduce_double
+ */
+ESIO_PLANE_WRITE_REDUCE_GEN(int)
+
+#ifdef __cplusplus
+/** \copydoc esio_plane_write_reduce_int */
+ESIO_PLANE_WRITE_REDUCE_GEN_CXX(int)
+#endif
+/*\@}*/
+
+/** \cond INTERNAL */
+#undef ESIO_LINE_WRITE_REDUCE_GEN
+#undef ESIO_PLANE_WRITE_REDUCE_GEN
+#ifdef __cplusplus
+#undef ESIO_LINE_WRITE_REDUCE_GEN_CXX
+#undef ESIO_PLANE_WRITE_REDUCE_GEN_CXX
+#endif
+/** \endcond */
+
+/** \cond INTERNAL */
+#define ESIO_LINE_READ_SHARED_GEN(TYPE)           \
+int                                               \
+esio_line_read_shared_##TYPE(const esio_handle h, \
+                             const char *name,    \
+                             const TYPE **line,   \
+                             MPI_Win *win)        \
+                             ESIO_API;
+
+#ifdef __cplusplus
+#define ESIO_LINE_READ_SHARED_GEN_CXX(TYPE)                            \
+extern "C++" inline int                                                \
+esio_line_read_shared(const esio_handle h,                             \
+                      const char *name,                                \
+                      const TYPE **line,                               \
+                      MPI_Win *win)                                    \
+{ return esio_line_read_shared_##TYPE(h,name,line,win); }
+#endif
+
+#define ESIO_PLANE_READ_SHARED_GEN(TYPE)           \
+int                                                \
+esio_plane_read_shared_##TYPE(const esio_handle h, \
+                              const char *name,    \
+                              const TYPE **plane,  \
+                              MPI_Win *win)        \
+                              ESIO_API;
+
+#ifdef __cplusplus
+#define ESIO_PLANE_READ_SHARED_GEN_CXX(TYPE)                           \
+extern "C++" inline int                                                \
+esio_plane_read_shared(const esio_handle h,                            \
+                       const char *name,                               \
+                       const TYPE **plane,                             \
+                       MPI_Win *win)                                   \
+{ return esio_plane_read_shared_##TYPE(h,name,plane,win); }
+#endif
+/** \endcond */
+
+/**
+ * \name Reading replicated lines and planes into node-shared memory
+ * See \ref conceptsshared "node-shared concepts" for more details.
+ * Additionally, the C++-only functions <tt>esio_line_read_shared()</tt> and
+ * <tt>esio_plane_read_shared()</tt> provide overloaded, type-safe versions
+ * of these methods.
+ */
+/*\@{*/
+
+/**
+ * Collectively read an entire scalar-valued <code>double</code> line into
+ * memory shared by all ranks on each node.  One rank per node reads the
+ * data.  No prior call to esio_line_establish() is required and any
+ * established decomposition is unchanged.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated line name.
+ * \param[out] line Receives the address of the <tt>aglobal</tt>
+ *             contiguous values, which must not be modified.
+ * \param[out] win Receives the window owning the shared memory.  All ranks
+ *             must release it with <tt>MPI_Win_free</tt> once finished.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_LINE_READ_SHARED_GEN(double)
+
+#ifdef __cplusplus
+/** \copydoc esio_line_read_shared_double */
+ESIO_LINE_READ_SHARED_GEN_CXX(double)
+#endif
+
+/**
+ * Collectively read an entire scalar-valued <code>float</code> line into
+ * node-shared memory.
+ * \copydetails esio_line_read_shared_double
+ */
+ESIO_LINE_READ_SHARED_GEN(float)
+
+#ifdef __cplusplus
+/** \copydoc esio_line_read_shared_float */
+ESIO_LINE_READ_SHARED_GEN_CXX(float)
+#endif
+
+/**
+ * Collectively read an entire scalar-valued <code>int</code> line into
+ * node-shared memory.
+ * \copydetails esio_line_read_shared_double
+ */
+ESIO_LINE_READ_SHARED_GEN(int)
+
+#ifdef __cplusplus
+/** \copydoc esio_line_read_shared_int */
+ESIO_LINE_READ_SHARED_GEN_CXX(int)
+#endif
+
+/**
+ * Collectively read an entire scalar-valued <code>double</code> plane into
+ * memory shared by all ranks on each node.  One rank per node reads the
+ * data.  No prior call to esio_plane_establish() is required and any
+ * established decomposition is unchanged.
+ *
+ * \param h Handle to use.
+ * \param name Null-terminated plane name.
+ * \param[out] plane Receives the address of the <tt>bglobal*aglobal</tt>
+ *             values, stored with "A" varying fastest, which must not be
+ *             modified.
+ * \param[out] win Receives the window owning the shared memory.  All ranks
+ *             must release it with <tt>MPI_Win_free</tt> once finished.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+ESIO_PLANE_READ_SHARED_GEN(double)
+
+#ifdef __cplusplus
+/** \copydoc esio_plane_read_shared_double */
+ESIO_PLANE_READ_SHARED_GEN_CXX(double)
+#endif
+
+/**
+ * Collectively read an entire scalar-valued <code>float</code> plane into
+ * node-shared memory.
+ * \copydetails esio_plane_read_shared_double
+ */
+ESIO_PLANE_READ_SHARED_GEN(float)
+
+#ifdef __cplusplus
+/** \copydoc esio_plane_read_shared_float */
+ESIO_PLANE_READ_SHARED_GEN_CXX(float)
+#endif
+
+/**
+ * Collectively read an entire scalar-valued <code>int</code> plane into
+ * node-shared memory.
+ * \copydetails esio_plane_read_shared_double
+ */
+ESIO_PLANE_READ_SHARED_GEN(int)
+
+#ifdef __cplusplus
+/** \copydoc esio_plane_read_shared_int */
+ESIO_PLANE_READ_SHARED_GEN_CXX(int)
+#endif
+/*\@}*/
+
+/** \cond INTERNAL */
+#undef ESIO_LINE_READ_SHARED_GEN
+#undef ESIO_PLANE_READ_SHARED_GEN
+#ifdef __cplusplus
+#undef ESIO_LINE_READ_SHARED_GEN_CXX
+#undef ESIO_PLANE_READ_SHARED_GEN_CXX
+#endif
+/** \endcond */
+
+/**
+ * \name Querying and controlling field layout
+ * See \ref conceptslayouts "layout concepts" for more details.
+ */
+/*\@{*/
+
+/**
+ * Query the number of layouts available within ESIO.
+ * This is the maximum <code>layout_index + 1</code>.
+ *
+ * @return The number of layouts available within ESIO.
+ */
+int esio_field_layout_count(void) ESIO_API;
+
+/**
+ * Get the default layout associated with the given handle.
+ * This layout will be used when writing any new fields.
+ *
+ * @param h Handle to use.
+ *
+ * \return A \c layout_index value suitable for use with
+ *         esio_field_layout_set().  On error, zero is
+ *         returned.
+ */
+int esio_field_layout_get(const esio_handle h) ESIO_API;
+
+/**
+ * Set the default layout associated with the given handle.
+ * The supplied layout will be used when writing any new fields.
+ *
+ * @param h Handle to use.
+ * @param layout_index Layout index to set in the range
+ *                     <tt>[0, </tt>esio_field_layout_count()<tt>)</tt>.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_field_layout_set(esio_handle h, int layout_index) ESIO_API;
+/*\@}*/
+
+/**
+ * \name Querying and controlling storage precision
+ * See \ref conceptsprecision "precision concepts" for more details.
+ */
+/*\@{*/
+
+/**
+ * Storage precisions available for new floating point fields and planes.
+ * Values are converted from and to the in-memory \c float or \c double type
+ * whenever data is written or read.
+ */
+enum esio_precision {
+    ESIO_PRECISION_NATIVE   = 0, /**< Store values using the in-memory type */
+    ESIO_PRECISION_HALF     = 1, /**< Store IEEE 754 binary16 values */
+    ESIO_PRECISION_BFLOAT16 = 2  /**< Store bfloat16 values */
+};
+
+/**
+ * Get the storage precision associated with the given handle.
+ * This precision will be used when writing any new fields or planes.
+ *
+ * @param h Handle to use.
+ *
+ * \return One of ::esio_precision.  On error,
+ *         ::ESIO_PRECISION_NATIVE is returned.
+ */
+int esio_precision_get(const esio_handle h) ESIO_API;
+
+/**
+ * Set the storage precision associated with the given handle.
+ * The supplied precision will be used when writing any new floating point
+ * fields or planes.  Integer data and lines are always stored using their
+ * in-memory type.  Existing datasets retain their stored precision.
+ *
+ * @param h Handle to use.
+ * @param precision One of ::esio_precision.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_precision_set(esio_handle h, int precision) ESIO_API;
+/*\@}*/
+
+/**
+ * \name Controlling page cache hints
+ * See \ref conceptsreadahead "readahead concepts" for more details.
+ */
+/*\@{*/
+
+/**
+ * Are page cache hints issued around reads and writes using the given handle?
+ *
+ * @param h Handle to use.
+ *
+ * \return One if hints are enabled and zero otherwise.
+ *         On error, zero is returned.
+ */
+int esio_readahead_get(const esio_handle h) ESIO_API;
+
+/**
+ * Enable or disable page cache hints for the given handle.  When enabled,
+ * one rank per node asks the operating system to prefetch the bytes every
+ * rank on that node is about to read and to drop bytes just written.
+ * Hints are disabled by default.  Enabling hints is collective the first
+ * time it occurs on a handle.
+ *
+ * @param h Handle to use.
+ * @param enable If nonzero, enable hints.  If zero, disable them.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_readahead_set(esio_handle h, int enable) ESIO_API;
+/*\@}*/
+
+/**
+ * \name Skipping constant regions of new fields
+ * See \ref conceptssparse "sparse field concepts" for more details.
+ */
+/*\@{*/
+
+/**
+ * Are new fields written sparsely using the given handle?
+ *
+ * @param h Handle to use.
+ * @param fill If not NULL, receives the fill value most recently supplied
+ *             to esio_field_sparse_set().
+ *
+ * \return One if sparse writes are enabled and zero otherwise.
+ *         On error, zero is returned.
+ */
+int esio_field_sparse_get(const esio_handle h, double *fill) ESIO_API;
+
+/**
+ * Enable or disable sparse writes of new fields for the given handle.
+ * When enabled, newly created scalar fields using layout zero are chunked
+ * and any chunk-aligned tile of a rank's block whose values all bitwise
+ * equal \c fill, after conversion to the in-memory type, is not written.
+ * Reading such regions returns \c fill.  Sparse writes are disabled by
+ * default.  Existing fields are always overwritten in their entirety.
+ *
+ * @param h Handle to use.
+ * @param enable If nonzero, enable sparse writes.  If zero, disable them.
+ * @param fill Fill value stored with and skipped within new fields.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_field_sparse_set(esio_handle h, int enable, double fill) ESIO_API;
+/*\@}*/
+
+/**
+ * \name Packing many small lines into tables
+ * See \ref conceptslinetable "line table concepts" for more details.
+ */
+/*\@{*/
+
+/**
+ * Are new lines packed into line tables using the given handle?
+ *
+ * @param h Handle to use.
+ *
+ * \return One if line tables are enabled and zero otherwise.
+ *         On error, zero is returned.
+ */
+int esio_line_table_get(const esio_handle h) ESIO_API;
+
+/**
+ * Enable or disable packing new lines into line tables for the given handle.
+ * When enabled, each newly written line is staged in memory.  Staged lines
+ * sharing a global extent, decomposition, and type are written as the rows of
+ * a single two-dimensional table by one collective transfer during the next
+ * esio_file_flush(), esio_file_close(), esio_line_establish(), or line read.
+ * Line tables are disabled by default.  Lines within tables remain accessible
+ * by name using esio_line_read_double(), esio_line_size(), and friends
+ * regardless of this setting, and rewriting them overwrites their rows in
+ * place.
+ *
+ * @param h Handle to use.
+ * @param enable If nonzero, enable line tables.  If zero, disable them.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_line_table_set(esio_handle h, int enable) ESIO_API;
+/*\@}*/
+
+/**
+ * \name Balancing and pipelining field writes
+ * See \ref conceptsbalance "balanced write concepts" for more details.
+ */
+/*\@{*/
+
+/**
+ * Are field writes rebalanced across ranks using the given handle?
+ *
+ * @param h Handle to use.
+ *
+ * \return One if balanced writes are enabled and zero otherwise.
+ *         On error, zero is returned.
+ */
+int esio_field_balance_get(const esio_handle h) ESIO_API;
+
+/**
+ * Enable or disable balanced field writes for the given handle.
+ * When enabled and the established field decomposition is markedly uneven,
+ * each field write first redistributes data so that every rank holds an
+ * equal share of whole planes and then writes those shares collectively.
+ * The schedule is computed during the first such write and reused until
+ * the decomposition changes.  Balanced writes are disabled by default.
+ * Reads are unaffected.
+ *
+ * @param h Handle to use.
+ * @param enable If nonzero, enable balanced writes.  If zero, disable them.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_field_balance_set(esio_handle h, int enable) ESIO_API;
+
+/**
+ * Into how many segments is each field write pipelined using the given
+ * handle?
+ *
+ * @param h Handle to use.
+ *
+ * \return The number of segments, where one indicates no pipelining.
+ *         On error, one is returned.
+ */
+int esio_field_pipeline_get(const esio_handle h) ESIO_API;
+
+/**
+ * Set into how many segments each field write is pipelined for the given
+ * handle.  When more than one, uneven decompositions are redistributed
+ * onto the evenly sized blocks used by esio_field_balance_set() even if
+ * balancing is disabled.  Each such block is split into \c nsegments pieces
+ * and each piece is exchanged while the previous piece is written.  No more
+ * segments are used than the largest block has planes.  Evenly decomposed
+ * layout 0 fields stored contiguously without type conversion in files
+ * opened with HDF5's MPI-IO driver are instead split into \c nsegments
+ * pieces, each packed while the previous one is written with nonblocking
+ * collective MPI-IO.  Other evenly decomposed fields are written directly.
+ * The default, one, disables pipelining.
+ *
+ * @param h Handle to use.
+ * @param nsegments Number of segments, which must be at least one.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_field_pipeline_set(esio_handle h, int nsegments) ESIO_API;
+/*\@}*/
+
+/**
+ * \name Recording comments
+ * See \ref conceptscomments "comment concepts" for more details.
+ */
+/*\@{*/
+
+/**
+ * Are comments passed to write routines recorded using the given handle?
+ *
+ * @param h Handle to use.
+ *
+ * \return One if comments are recorded and zero otherwise.
+ *         On error, one is returned.
+ */
+int esio_field_comments_get(const esio_handle h) ESIO_API;
+
+/**
+ * Enable or disable recording comments for the given handle.
+ * Comments passed to field, plane, and line write routines are recorded
+ * together by esio_file_flush() or esio_file_close() and only when they
+ * differ from an object's existing comment.  When disabled, comments are
+ * silently dropped and existing comments are left untouched.  Comments are
+ * recorded by default.
+ *
+ * @param h Handle to use.
+ * @param enable If nonzero, record comments.  If zero, drop them.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_field_comments_set(esio_handle h, int enable) ESIO_API;
+/*\@}*/
+
+/**
+ * \name Protecting node-local checkpoints with parity
+ * See \ref conceptsparity "parity concepts" for more details.
+ */
+/*\@{*/
+
+/**
+ * Collectively compute XOR parity protecting each rank's node-local file.
+ * Ranks on at least \c k distinct nodes form a parity group whenever that
+ * many nodes are available.  Each member stores a parity block about
+ * <tt>1/(g-1)</tt> the size of the largest file within its group of size
+ * \c g.  Files are commonly written using a handle initialized with \c
+ * MPI_COMM_SELF.
+ *
+ * @param h Handle to use.
+ * @param file This rank's node-local file.
+ * @param parity Path at which to store this rank's parity block.
+ *               It should reside on the same node as \c file.
+ * @param k Desired number of nodes per parity group.  Must be at least two.
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         ESIO_EINVAL is returned without writing any parity whenever some
+ *         group would span fewer than <tt>max(2,k)</tt> nodes, including
+ *         whenever fewer than \c k nodes are available.
+ */
+int esio_parity_encode(const esio_handle h,
+                       const char *file,
+                       const char *parity,
+                       int k) ESIO_API;
+
+/**
+ * Collectively recreate any node-local files lost since a previous call to
+ * esio_parity_encode() using the same arguments.  At most one member of each
+ * parity group may be missing its \c file.  Parity blocks are then
+ * recomputed within groups that recreated a file.  Groups must be formed
+ * identically, so ranks must be placed onto nodes as they were when parity
+ * was computed, though a replacement node may stand in for a lost one.
+ *
+ * @param h Handle to use.
+ * @param file This rank's node-local file, which may be missing.
+ * @param parity This rank's parity block, which may be missing only when
+ *               \c file is missing.
+ * @param k Value previously supplied to esio_parity_encode().
+ *
+ * \return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         ESIO_EINVAL is returned under the same conditions as
+ *         esio_parity_encode().
+ */
+int esio_parity_rebuild(const esio_handle h,
+                        const char *file,
+                        const char *parity,
+                        int k) ESIO_API;
 /*\@}*/
 
 #ifdef __cplusplus
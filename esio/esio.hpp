@@ -0,0 +1,586 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifndef ESIO_ESIO_HPP
+#define ESIO_ESIO_HPP
+
+/** \file
+ * Provides a header-only C++20 interface atop ESIO's \ref esio.h "C API".
+ * Handles and files are managed by move-only RAII classes.  Lines, planes,
+ * and fields are passed as any <tt>std::mdspan</tt>-like view whose element
+ * type, layout, and strides determine which typed C entry point is called
+ * and with what strides.  Contiguous, row-major data may instead be passed
+ * as a <tt>std::span</tt>.  Views whose layout is known at compile time to
+ * be row-major are passed without inspecting their strides.  Views whose
+ * strides ESIO cannot express directly, for example column-major or other
+ * permuted views, are staged through a temporary row-major buffer holding a
+ * full copy of the view, allocated anew on every call.  Only the choice of
+ * entry point and strides is made at compile time.  Every call still passes
+ * through the same public C function, and so pays the same argument checks
+ * and runtime type dispatch, as an equivalent call from C.
+ *
+ * Failures invoke ESIO's \ref error.h "error handler" as usual.  Whenever the
+ * handler returns, an esio::error is thrown.
+ */
+
+#if !defined(__cplusplus) || __cplusplus < 202002L
+#error "esio.hpp requires C++20 or newer"
+#endif
+
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if __has_include(<mdspan>)
+#include <mdspan>
+#endif
+
+namespace esio {
+
+/** Thrown whenever an ESIO C API call reports failure. */
+class error : public std::runtime_error
+{
+public:
+    error(const char *what, int status)
+        : std::runtime_error(what), status_(status) {}
+
+    /** One of ::esio_status describing the failure. */
+    int status() const noexcept { return status_; }
+
+private:
+    int status_;
+};
+
+/** Scalar types ESIO stores natively. */
+template <class T>
+concept element = std::same_as<T, double>
+               || std::same_as<T, float>
+               || std::same_as<T, int>;
+
+/**
+ * Is \c Layout known at compile time to be row-major and contiguous?
+ * Specialize to describe layouts other than <tt>std::layout_right</tt>.
+ */
+template <class Layout>
+struct is_row_major_layout : std::false_type {};
+
+/**
+ * Does \c Accessor dereference <tt>p[i]</tt> for data handle \c p?
+ * Specialize to describe accessors other than
+ * <tt>std::default_accessor</tt>.  Views using other accessors are staged.
+ */
+template <class Accessor>
+struct is_plain_accessor : std::false_type {};
+
+#if defined(__cpp_lib_mdspan)
+template <>
+struct is_row_major_layout<std::layout_right> : std::true_type {};
+
+template <class T>
+struct is_plain_accessor<std::default_accessor<T>> : std::true_type {};
+#endif
+
+/** Views providing the <tt>std::mdspan</tt> interface used by ESIO. */
+template <class V>
+concept strided_view = requires(const V &v, std::size_t r) {
+    typename V::element_type;
+    typename V::layout_type;
+    typename V::accessor_type;
+    { V::rank() } -> std::convertible_to<std::size_t>;
+    { v.extent(r) } -> std::convertible_to<std::size_t>;
+    { v.stride(r) } -> std::convertible_to<std::size_t>;
+    { v.data_handle() };
+    { v.mapping() };
+    { v.accessor() };
+} && element<std::remove_const_t<typename V::element_type>>;
+
+/** \cond INTERNAL */
+namespace detail {
+
+inline void check(int status, const char *what)
+{
+    if (status != ESIO_SUCCESS) throw error(what, status);
+}
+
+// Compile-time dispatch onto the typed C entry points
+template <class T> struct typed;
+
+#define ESIO_HPP_TYPED(TYPE)                                              \
+template <> struct typed<TYPE> {                                          \
+    static constexpr auto line_write      = &esio_line_write_##TYPE;      \
+    static constexpr auto line_read       = &esio_line_read_##TYPE;       \
+    static constexpr auto plane_write     = &esio_plane_write_##TYPE;     \
+    static constexpr auto plane_read      = &esio_plane_read_##TYPE;      \
+    static constexpr auto field_write     = &esio_field_write_##TYPE;     \
+    static constexpr auto field_read      = &esio_field_read_##TYPE;      \
+    static constexpr auto attribute_write = &esio_attribute_write_##TYPE; \
+    static constexpr auto attribute_read  = &esio_attribute_read_##TYPE;  \
+};
+ESIO_HPP_TYPED(double)
+ESIO_HPP_TYPED(float)
+ESIO_HPP_TYPED(int)
+#undef ESIO_HPP_TYPED
+
+// Local extents of the established decomposition ordered as { C, B, A }
+template <std::size_t R>
+std::array<int, R> established(esio_handle h)
+{
+    std::array<int, 3> n = { 1, 1, 1 };
+    int status;
+    if constexpr (R == 1) {
+        status = esio_line_established(h, 0, 0, &n[2]);
+    } else if constexpr (R == 2) {
+        status = esio_plane_established(h, 0, 0, &n[1], 0, 0, &n[2]);
+    } else {
+        status = esio_field_established(h, 0, 0, &n[0], 0, 0, &n[1],
+                                           0, 0, &n[2]);
+    }
+    check(status, "Unable to retrieve established decomposition");
+    std::array<int, R> retval;
+    for (std::size_t r = 0; r < R; ++r) retval[r] = n[3 - R + r];
+    return retval;
+}
+
+// Visit every index tuple in row-major order
+template <std::size_t R, class F>
+void for_each_index(const std::array<int, R> &n, F &&f)
+{
+    std::size_t k = 0;
+    if constexpr (R == 1) {
+        for (int a = 0; a < n[0]; ++a) f(k++, a);
+    } else if constexpr (R == 2) {
+        for (int b = 0; b < n[0]; ++b)
+            for (int a = 0; a < n[1]; ++a) f(k++, b, a);
+    } else {
+        for (int c = 0; c < n[0]; ++c)
+            for (int b = 0; b < n[1]; ++b)
+                for (int a = 0; a < n[2]; ++a) f(k++, c, b, a);
+    }
+}
+
+// Determine ESIO strides for v, returning false when v must be staged.
+// ESIO requires each stride to step past the full extent of the next.
+template <strided_view V>
+bool strides(const V &v, std::array<int, V::rank()> &s)
+{
+    constexpr std::size_t R = V::rank();
+    if constexpr (!is_plain_accessor<typename V::accessor_type>::value) {
+        return false;
+    } else if constexpr (is_row_major_layout<typename V::layout_type>::value) {
+        s.fill(0);
+        return true;
+    } else {
+        for (std::size_t r = 0; r < R; ++r) {
+            if (v.extent(r) == 0) { s.fill(0); return true; }
+            s[r] = static_cast<int>(v.stride(r));
+        }
+        if (v.extent(R-1) > 1 && s[R-1] < 1) return false;
+        for (std::size_t r = 0; r + 1 < R; ++r) {
+            const std::size_t span = (v.extent(r+1) - 1) * v.stride(r+1) + 1;
+            if (v.extent(r) > 1 && static_cast<std::size_t>(s[r]) < span) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// Invoke a typed C entry point taking strides in { C, B, A } order
+template <class Fn, class P, std::size_t R, class... Tail>
+int invoke(Fn fn, esio_handle h, const char *name, P p,
+           const std::array<int, R> &s, Tail... tail)
+{
+    if constexpr (R == 1) {
+        return fn(h, name, p, s[0], tail...);
+    } else if constexpr (R == 2) {
+        return fn(h, name, p, s[0], s[1], tail...);
+    } else {
+        return fn(h, name, p, s[0], s[1], s[2], tail...);
+    }
+}
+
+template <strided_view V>
+std::array<int, V::rank()> extents(const V &v)
+{
+    std::array<int, V::rank()> n;
+    for (std::size_t r = 0; r < V::rank(); ++r) {
+        n[r] = static_cast<int>(v.extent(r));
+    }
+    return n;
+}
+
+template <strided_view V, class Fn>
+void write(esio_handle h, Fn fn, const char *name, const V &v,
+           const char *comment)
+{
+    constexpr std::size_t R = V::rank();
+    using T = std::remove_const_t<typename V::element_type>;
+    const std::array<int, R> n = extents(v);
+    if (n != established<R>(h)) {
+        throw error("View extents differ from established decomposition",
+                    ESIO_EINVAL);
+    }
+
+    std::array<int, R> s;
+    if (strides(v, s)) {
+        check(invoke(fn, h, name, static_cast<const T *>(v.data_handle()),
+                     s, comment),
+              "Unable to write");
+        return;
+    }
+
+    // Stage into contiguous row-major storage
+    std::vector<T> tmp;
+    tmp.reserve(v.size());
+    for_each_index<R>(n, [&](std::size_t, auto... i) {
+        tmp.push_back(v.accessor().access(v.data_handle(), v.mapping()(i...)));
+    });
+    s.fill(0);
+    check(invoke(fn, h, name, static_cast<const T *>(tmp.data()), s, comment),
+          "Unable to write");
+}
+
+template <strided_view V, class Fn>
+void read(esio_handle h, Fn fn, const char *name, const V &v)
+{
+    constexpr std::size_t R = V::rank();
+    using T = typename V::element_type;
+    static_assert(!std::is_const_v<T>, "Cannot read into a const view");
+    const std::array<int, R> n = extents(v);
+    if (n != established<R>(h)) {
+        throw error("View extents differ from established decomposition",
+                    ESIO_EINVAL);
+    }
+
+    std::array<int, R> s;
+    if (strides(v, s)) {
+        check(invoke(fn, h, name, static_cast<T *>(v.data_handle()), s),
+              "Unable to read");
+        return;
+    }
+
+    // Stage through contiguous row-major storage
+    std::vector<T> tmp(v.size());
+    s.fill(0);
+    check(invoke(fn, h, name, tmp.data(), s), "Unable to read");
+    for_each_index<R>(n, [&](std::size_t k, auto... i) {
+        v.accessor().access(v.data_handle(), v.mapping()(i...)) = tmp[k];
+    });
+}
+
+// Contiguous spans hold the rank's entire established block row-major
+template <std::size_t R, class T, std::size_t N, class Fn>
+void write_span(esio_handle h, Fn fn, const char *name, std::span<T, N> v,
+                const char *comment)
+{
+    const std::array<int, R> n = established<R>(h);
+    std::size_t size = 1;
+    for (int e : n) size *= static_cast<std::size_t>(e);
+    if (size != v.size()) {
+        throw error("Span size differs from established decomposition",
+                    ESIO_EINVAL);
+    }
+    const std::array<int, R> s = {};
+    check(invoke(fn, h, name, static_cast<const std::remove_const_t<T> *>(
+                     v.data()), s, comment),
+          "Unable to write");
+}
+
+template <std::size_t R, class T, std::size_t N, class Fn>
+void read_span(esio_handle h, Fn fn, const char *name, std::span<T, N> v)
+{
+    const std::array<int, R> n = established<R>(h);
+    std::size_t size = 1;
+    for (int e : n) size *= static_cast<std::size_t>(e);
+    if (size != v.size()) {
+        throw error("Span size differs from established decomposition",
+                    ESIO_EINVAL);
+    }
+    const std::array<int, R> s = {};
+    check(invoke(fn, h, name, v.data(), s), "Unable to read");
+}
+
+} // namespace detail
+/** \endcond */
+
+/** Move-only owner of an ::esio_handle. */
+class handle
+{
+public:
+    /** Collectively initialize a handle.  See esio_handle_initialize(). */
+    explicit handle(MPI_Comm comm) : h_(esio_handle_initialize(comm))
+    {
+        if (!h_) throw error("Unable to initialize handle", ESIO_EFAILED);
+    }
+
+    /** Collectively finalize the handle.  See esio_handle_finalize(). */
+    ~handle() { if (h_) esio_handle_finalize(h_); }
+
+    handle(const handle &) = delete;
+    handle &operator=(const handle &) = delete;
+    handle(handle &&o) noexcept : h_(std::exchange(o.h_, nullptr)) {}
+    handle &operator=(handle &&o) noexcept
+    {
+        std::swap(h_, o.h_);
+        return *this;
+    }
+
+    /** Retrieve the underlying handle for use with the C API. */
+    esio_handle get() const noexcept { return h_; }
+
+    /** See esio_line_establish(). */
+    void line_establish(int aglobal, int astart, int alocal)
+    {
+        detail::check(esio_line_establish(h_, aglobal, astart, alocal),
+                      "Unable to establish line decomposition");
+    }
+
+    /** See esio_plane_establish(). */
+    void plane_establish(int bglobal, int bstart, int blocal,
+                         int aglobal, int astart, int alocal)
+    {
+        detail::check(esio_plane_establish(h_, bglobal, bstart, blocal,
+                                               aglobal, astart, alocal),
+                      "Unable to establish plane decomposition");
+    }
+
+    /** See esio_field_establish(). */
+    void field_establish(int cglobal, int cstart, int clocal,
+                         int bglobal, int bstart, int blocal,
+                         int aglobal, int astart, int alocal)
+    {
+        detail::check(esio_field_establish(h_, cglobal, cstart, clocal,
+                                               bglobal, bstart, blocal,
+                                               aglobal, astart, alocal),
+                      "Unable to establish field decomposition");
+    }
+
+private:
+    esio_handle h_;
+};
+
+/**
+ * Move-only owner of the file open on a handle.  Destruction collectively
+ * closes the file ignoring any error.  Call close() to observe errors.
+ * A handle must outlive any file created or opened using it.
+ */
+class file
+{
+public:
+    /** Collectively create a file.  See esio_file_create(). */
+    static file create(const handle &h, const char *path,
+                       bool overwrite = false)
+    {
+        detail::check(esio_file_create(h.get(), path, overwrite),
+                      "Unable to create file");
+        return file(h.get());
+    }
+
+    /** Collectively open a file.  See esio_file_open(). */
+    static file open(const handle &h, const char *path,
+                     bool readwrite = false)
+    {
+        detail::check(esio_file_open(h.get(), path, readwrite),
+                      "Unable to open file");
+        return file(h.get());
+    }
+
+    ~file() { if (h_) esio_file_close(h_); }
+
+    file(const file &) = delete;
+    file &operator=(const file &) = delete;
+    file(file &&o) noexcept : h_(std::exchange(o.h_, nullptr)) {}
+    file &operator=(file &&o) noexcept
+    {
+        std::swap(h_, o.h_);
+        return *this;
+    }
+
+    /** Collectively flush the file.  See esio_file_flush(). */
+    void flush()
+    {
+        detail::check(esio_file_flush(h_), "Unable to flush file");
+    }
+
+    /** Collectively close the file.  See esio_file_close(). */
+    void close()
+    {
+        detail::check(esio_file_close(std::exchange(h_, nullptr)),
+                      "Unable to close file");
+    }
+
+    /** Write a rank-one view as a line.  See esio_line_write_double().
+     *  Views which must be staged are first copied in full. */
+    template <strided_view V> requires (V::rank() == 1)
+    void write_line(const char *name, const V &line,
+                    const char *comment = nullptr)
+    {
+        using T = std::remove_const_t<typename V::element_type>;
+        detail::write(h_, detail::typed<T>::line_write, name, line, comment);
+    }
+
+    /** Write a contiguous line.  See esio_line_write_double(). */
+    template <class T, std::size_t N> requires element<std::remove_const_t<T>>
+    void write_line(const char *name, std::span<T, N> line,
+                    const char *comment = nullptr)
+    {
+        using U = std::remove_const_t<T>;
+        detail::write_span<1>(h_, detail::typed<U>::line_write,
+                              name, line, comment);
+    }
+
+    /** Read a rank-one view as a line.  See esio_line_read_double().
+     *  Views which must be staged are read into a full temporary copy. */
+    template <strided_view V> requires (V::rank() == 1)
+    void read_line(const char *name, const V &line)
+    {
+        using T = typename V::element_type;
+        detail::read(h_, detail::typed<T>::line_read, name, line);
+    }
+
+    /** Read a contiguous line.  See esio_line_read_double(). */
+    template <class T, std::size_t N> requires element<T>
+    void read_line(const char *name, std::span<T, N> line)
+    {
+        detail::read_span<1>(h_, detail::typed<T>::line_read, name, line);
+    }
+
+    /** Write a <tt>{B, A}</tt> view as a plane.
+     *  See esio_plane_write_double().
+     *  Views which must be staged are first copied in full. */
+    template <strided_view V> requires (V::rank() == 2)
+    void write_plane(const char *name, const V &plane,
+                     const char *comment = nullptr)
+    {
+        using T = std::remove_const_t<typename V::element_type>;
+        detail::write(h_, detail::typed<T>::plane_write, name, plane, comment);
+    }
+
+    /** Write a contiguous, row-major <tt>{B, A}</tt> plane.
+     *  See esio_plane_write_double(). */
+    template <class T, std::size_t N> requires element<std::remove_const_t<T>>
+    void write_plane(const char *name, std::span<T, N> plane,
+                     const char *comment = nullptr)
+    {
+        using U = std::remove_const_t<T>;
+        detail::write_span<2>(h_, detail::typed<U>::plane_write,
+                              name, plane, comment);
+    }
+
+    /** Read a <tt>{B, A}</tt> view as a plane.
+     *  See esio_plane_read_double().
+     *  Views which must be staged are read into a full temporary copy. */
+    template <strided_view V> requires (V::rank() == 2)
+    void read_plane(const char *name, const V &plane)
+    {
+        using T = typename V::element_type;
+        detail::read(h_, detail::typed<T>::plane_read, name, plane);
+    }
+
+    /** Read a contiguous, row-major <tt>{B, A}</tt> plane.
+     *  See esio_plane_read_double(). */
+    template <class T, std::size_t N> requires element<T>
+    void read_plane(const char *name, std::span<T, N> plane)
+    {
+        detail::read_span<2>(h_, detail::typed<T>::plane_read, name, plane);
+    }
+
+    /** Write a <tt>{C, B, A}</tt> view as a field.
+     *  See esio_field_write_double().
+     *  Views which must be staged are first copied in full. */
+    template <strided_view V> requires (V::rank() == 3)
+    void write_field(const char *name, const V &field,
+                     const char *comment = nullptr)
+    {
+        using T = std::remove_const_t<typename V::element_type>;
+        detail::write(h_, detail::typed<T>::field_write, name, field, comment);
+    }
+
+    /** Write a contiguous, row-major <tt>{C, B, A}</tt> field.
+     *  See esio_field_write_double(). */
+    template <class T, std::size_t N> requires element<std::remove_const_t<T>>
+    void write_field(const char *name, std::span<T, N> field,
+                     const char *comment = nullptr)
+    {
+        using U = std::remove_const_t<T>;
+        detail::write_span<3>(h_, detail::typed<U>::field_write,
+                              name, field, comment);
+    }
+
+    /** Read a <tt>{C, B, A}</tt> view as a field.
+     *  See esio_field_read_double().
+     *  Views which must be staged are read into a full temporary copy. */
+    template <strided_view V> requires (V::rank() == 3)
+    void read_field(const char *name, const V &field)
+    {
+        using T = typename V::element_type;
+        detail::read(h_, detail::typed<T>::field_read, name, field);
+    }
+
+    /** Read a contiguous, row-major <tt>{C, B, A}</tt> field.
+     *  See esio_field_read_double(). */
+    template <class T, std::size_t N> requires element<T>
+    void read_field(const char *name, std::span<T, N> field)
+    {
+        detail::read_span<3>(h_, detail::typed<T>::field_read, name, field);
+    }
+
+    /** Write a scalar attribute.  See esio_attribute_write_double(). */
+    template <element T>
+    void write_attribute(const char *location, const char *name, T value)
+    {
+        detail::check(detail::typed<T>::attribute_write(
+                          h_, location, name, &value),
+                      "Unable to write attribute");
+    }
+
+    /** Read a scalar attribute.  See esio_attribute_read_double(). */
+    template <element T>
+    T read_attribute(const char *location, const char *name)
+    {
+        T value;
+        detail::check(detail::typed<T>::attribute_read(
+                          h_, location, name, &value),
+                      "Unable to read attribute");
+        return value;
+    }
+
+private:
+    explicit file(esio_handle h) noexcept : h_(h) {}
+
+    esio_handle h_;
+};
+
+} // namespace esio
+
+#endif /* ESIO_ESIO_HPP */
@@ -0,0 +1,88 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "group.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+
+void esio_group_members(int comm_size, int ngroups, int rank,
+                        int *group, int *first, int *count)
+{
+    const long g = ((long) rank * ngroups) / comm_size;
+    const long lo = (g       * comm_size + ngroups - 1) / ngroups;
+    const long hi = ((g + 1) * comm_size + ngroups - 1) / ngroups;
+    *group = (int) g;
+    *first = (int) lo;
+    *count = (int) (hi - lo);
+}
+
+void esio_group_block(int comm_size, int ngroups, int rank,
+                      int cglobal, int bglobal, int aglobal,
+                      int *group, int *blk)
+{
+    int first, count;
+    esio_group_members(comm_size, ngroups, rank, group, &first, &count);
+    const long lo = ((long) (rank - first)     * cglobal) / count;
+    const long hi = ((long) (rank - first + 1) * cglobal) / count;
+    blk[0] = (int) lo; blk[1] = (int) (hi - lo);
+    blk[2] = 0;        blk[3] = bglobal;
+    blk[4] = 0;        blk[5] = aglobal;
+}
+
+int esio_group_field(int ngroups, int round, int group)
+{
+    return round * ngroups + group;
+}
+
+int esio_group_split(MPI_Comm comm, int ngroups, MPI_Comm *group_comm)
+{
+    int rank, size;
+    if (MPI_Comm_rank(comm, &rank) || MPI_Comm_size(comm, &size)) {
+        return ESIO_EFAILED;
+    }
+    if (ngroups < 1 || ngroups > size) return ESIO_EINVAL;
+
+    int group, first, count;
+    esio_group_members(size, ngroups, rank, &group, &first, &count);
+    if (MPI_Comm_split(comm, group, rank, group_comm)) return ESIO_EFAILED;
+
+    return ESIO_SUCCESS;
+}
+
+char* esio_group_path(const char *file, int group)
+{
+    const size_t len = strlen(file) + 16;
+    char *path = malloc(len);
+    if (path) snprintf(path, len, "%s.g%d", file, group);
+    return path;
+}
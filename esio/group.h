@@ -0,0 +1,98 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifndef ESIO_GROUP_H
+#define ESIO_GROUP_H
+
+//****************************************************************
+// INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL
+//****************************************************************
+
+#include <mpi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Find the group holding \c rank when \c comm_size ranks are split into
+ * \c ngroups contiguous, nearly equal runs as esio_file_create_grouped()
+ * does.  Every group holds at least one rank whenever
+ * <tt>ngroups <= comm_size</tt>.
+ *
+ * @param comm_size Number of ranks being split.
+ * @param ngroups   Number of groups.
+ * @param rank      Rank to locate.
+ * @param group     On return, the group holding \c rank.
+ * @param first     On return, the lowest rank within \c group.
+ * @param count     On return, the number of ranks within \c group.
+ */
+void esio_group_members(int comm_size, int ngroups, int rank,
+                        int *group, int *first, int *count);
+
+/**
+ * Find the block of a field that \c rank stores within its group's subfile.
+ * The ranks of each group split whole planes of C evenly amongst
+ * themselves, in rank order, so every group holds the entire field.
+ *
+ * @param group On return, the group holding \c rank.
+ * @param blk   On return, \c rank's block stored as
+ *              <tt>{cstart, clocal, bstart, blocal, astart, alocal}</tt>.
+ */
+void esio_group_block(int comm_size, int ngroups, int rank,
+                      int cglobal, int bglobal, int aglobal,
+                      int *group, int *blk);
+
+/**
+ * Find the index within a batch's new fields of the field written by
+ * \c group during \c round.  Fields are dealt to groups round-robin, so
+ * each field is owned by exactly one group.  Indices at or beyond the
+ * number of new fields mean that \c group idles during \c round.
+ */
+int esio_group_field(int ngroups, int round, int group);
+
+/**
+ * Collectively split \c comm into the groups found by esio_group_members()
+ * retaining rank order within each group.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         Failures are not reported through esio_error().
+ */
+int esio_group_split(MPI_Comm comm, int ngroups, MPI_Comm *group_comm);
+
+/**
+ * Allocate the path of \c group's subfile, which is named after \c file.
+ * The caller must free the result.
+ *
+ * @return The path or NULL when memory cannot be allocated.
+ */
+char* esio_group_path(const char *file, int group);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESIO_GROUP_H */
@@ -30,6 +30,9 @@
 #include "layout.h"
 
 #include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <hdf5.h>
 #include <hdf5_hl.h>
 #include "error.h"
@@ -105,6 +108,125 @@ herr_t esio_field_layout0_dataset_chunker(hid_t dcpl_id,
 #undef OPFUNC
 #undef QUALIFIER
 
+// Sparse writes transfer only those tiles of the local block, aligned with
+// the dataset's chunks, differing somewhere from a fill value.  Chunks no
+// rank transfers are never allocated when the dataset's allocation time is
+// incremental and reads of them return the fill value.
+
+// Find the end of the tile starting at x given chunk size and block end
+static int layout0_tile_end(int x, int chunk, int end)
+{
+    const int next = (x / chunk + 1) * chunk;
+    return next < end ? next : end;
+}
+
+// Is every element of the given tile bitwise identical to fill?
+static int layout0_tile_isfill(const char *field, size_t size,
+                               const void *fill,
+                               int ck, int nk, int cstride,
+                               int bj, int nj, int bstride,
+                               int ai, int ni, int astride)
+{
+    for (int k = ck; k < ck + nk; ++k) {
+        for (int j = bj; j < bj + nj; ++j) {
+            const char *p = field + (k*(size_t)cstride + j*(size_t)bstride
+                                     + ai*(size_t)astride) * size;
+            for (int i = 0; i < ni; ++i, p += astride*size) {
+                if (memcmp(p, fill, size)) return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+int esio_field_layout0_sparse_writer(
+        hid_t plist_id, hid_t dset_id, const void *field,
+        int cglobal, int cstart, int clocal, int cstride,
+        int bglobal, int bstart, int blocal, int bstride,
+        int aglobal, int astart, int alocal, int astride,
+        int cchunk, int bchunk, int achunk,
+        hid_t type_id, const void *fill)
+{
+    // Tiles are selected from memory as a regular 3D array.  Strides not
+    // expressible that way are written densely, which is merely slower.
+    if (   cchunk < 1 || bchunk < 1 || achunk < 1
+        || cstride % bstride || cstride / bstride < blocal
+        || bstride < (alocal - 1) * astride + 1) {
+        return esio_field_layout0_field_writer(
+                plist_id, dset_id, field,
+                cglobal, cstart, clocal, cstride,
+                bglobal, bstart, blocal, bstride,
+                aglobal, astart, alocal, astride,
+                type_id);
+    }
+
+    const size_t size = H5Tget_size(type_id);
+    const int nlocal = clocal * blocal * alocal;
+    const hsize_t mdims[3] = { nlocal ? clocal : 1,
+                               nlocal ? cstride / bstride : 1,
+                               nlocal ? bstride : 1 };
+    const hid_t memspace  = H5Screate_simple(3, mdims, NULL);
+    const hid_t filespace = H5Dget_space(dset_id);
+    if (memspace < 0 || filespace < 0) {
+        if (memspace  >= 0) H5Sclose(memspace);
+        if (filespace >= 0) H5Sclose(filespace);
+        ESIO_ERROR("Unable to create dataspaces", ESIO_EFAILED);
+    }
+    H5Sselect_none(memspace);
+    H5Sselect_none(filespace);
+
+    // Select every tile, aligned with the dataset's chunks, holding at least
+    // one element differing from fill.  Selections are traversed in
+    // row-major order, so memory and file elements correspond regardless of
+    // the order in which tiles are added.
+    for (int c0 = cstart; nlocal && c0 < cstart + clocal; ) {
+        const int c1 = layout0_tile_end(c0, cchunk, cstart + clocal);
+        for (int b0 = bstart; b0 < bstart + blocal; ) {
+            const int b1 = layout0_tile_end(b0, bchunk, bstart + blocal);
+            for (int a0 = astart; a0 < astart + alocal; ) {
+                const int a1 = layout0_tile_end(a0, achunk,
+                                                astart + alocal);
+
+                if (!layout0_tile_isfill(field, size, fill,
+                                         c0 - cstart, c1 - c0, cstride,
+                                         b0 - bstart, b1 - b0, bstride,
+                                         a0 - astart, a1 - a0, astride)) {
+                    const hsize_t fstart[3] = { c0, b0, a0 };
+                    const hsize_t count[3]  = { c1 - c0, b1 - b0, a1 - a0 };
+                    const hsize_t mstart[3] = { c0 - cstart, b0 - bstart,
+                                                (a0 - astart) * astride };
+                    const hsize_t mstride[3] = { 1, 1, astride };
+                    if (   H5Sselect_hyperslab(filespace, H5S_SELECT_OR,
+                                               fstart, NULL, count, NULL) < 0
+                        || H5Sselect_hyperslab(memspace, H5S_SELECT_OR,
+                                               mstart, mstride, count,
+                                               NULL) < 0) {
+                        H5Sclose(filespace);
+                        H5Sclose(memspace);
+                        ESIO_ERROR("Selecting tile hyperslab failed",
+                                   ESIO_EFAILED);
+                    }
+                }
+
+                a0 = a1;
+            }
+            b0 = b1;
+        }
+        c0 = c1;
+    }
+
+    // Transfer only the selected tiles; all ranks participate
+    const herr_t status = H5Dwrite(dset_id, type_id, memspace,
+                                   filespace, plist_id, field);
+    H5Sclose(filespace);
+    H5Sclose(memspace);
+    if (status < 0) {
+        ESIO_ERROR("Operation failed", ESIO_EFAILED);
+    }
+
+    return ESIO_SUCCESS;
+}
+
 // ***********************************************************************
 // LAYOUT 1 LAYOUT 1 LAYOUT 1 LAYOUT 1 LAYOUT 1 LAYOUT 1 LAYOUT 1 LAYOUT 1
 // ***********************************************************************
@@ -159,6 +281,38 @@ herr_t esio_field_layout2_dataset_chunker(hid_t dcpl_id,
     return H5Pset_chunk(dcpl_id, 2, chunksizes);
 }
 
+// Virtual mappers add mappings to dcpl_id presenting the field stored in
+// dataset name within the same file as the 3-D dataspace vspace_id.  Only
+// layout 2 has one as layouts 0 and 1 are already plain 3-D arrays and
+// layout 3's bricks would require one mapping apiece.
+herr_t esio_field_layout2_virtual_mapper(hid_t dcpl_id,
+                                         hid_t vspace_id,
+                                         const char *name,
+                                         int cglobal,
+                                         int bglobal,
+                                         int aglobal)
+{
+#if H5_VERSION_GE(1,10,0)
+    const hid_t srcspace = esio_field_layout2_filespace_creator(cglobal,
+                                                                bglobal,
+                                                                aglobal);
+    if (srcspace < 0) return -1;
+
+    // Both spaces share one row-major order so a single mapping suffices
+    herr_t status = H5Sselect_all(vspace_id);
+    if (status >= 0) status = H5Sselect_all(srcspace);
+    if (status >= 0) {
+        status = H5Pset_virtual(dcpl_id, vspace_id, ".", name, srcspace);
+    }
+    H5Sclose(srcspace);
+    return status;
+#else
+    (void) dcpl_id; (void) vspace_id; (void) name;
+    (void) cglobal; (void) bglobal; (void) aglobal;
+    return -1; // Virtual datasets require HDF5 1.10
+#endif
+}
+
 #define METHODNAME esio_field_layout2_field_writer
 #define OPFUNC     H5Dwrite
 #define QUALIFIER  const
@@ -174,3 +328,137 @@ herr_t esio_field_layout2_dataset_chunker(hid_t dcpl_id,
 #undef METHODNAME
 #undef OPFUNC
 #undef QUALIFIER
+
+// ***********************************************************************
+// LAYOUT 3 LAYOUT 3 LAYOUT 3 LAYOUT 3 LAYOUT 3 LAYOUT 3 LAYOUT 3 LAYOUT 3
+// ***********************************************************************
+
+// Layout 3 stores a field as fixed-size bricks, one brick per row of a
+// dataset with dimensions { nbricks, cedge, bedge, aedge }.  Bricks are
+// ordered along a Morton (Z-order) curve over their brick coordinates so
+// that bricks which are near one another in the field are near one another
+// on disk.  Subvolume reads consequently touch few, mostly contiguous
+// regions of the file.  Bricks overhanging the field's global extent are
+// padded and the padding is never transferred.
+
+/** Brick edge length along each direction, in elements */
+#define LAYOUT3_BRICK_EDGE (8)
+
+static int layout3_brick_edge(int global)
+{
+    return global < LAYOUT3_BRICK_EDGE ? global : LAYOUT3_BRICK_EDGE;
+}
+
+struct layout3_brick {
+    hsize_t row;
+    int c, b, a;
+};
+
+static int layout3_brick_compare(const void *x, const void *y)
+{
+    const hsize_t p = ((const struct layout3_brick *) x)->row;
+    const hsize_t q = ((const struct layout3_brick *) y)->row;
+    return (p > q) - (p < q);
+}
+
+// Compute the dataset row for brick (c, b, a) within a cn x bn x an grid.
+// The row is the brick's rank when all bricks in the grid are sorted by
+// Morton code.  The rank is found by counting, for each set bit in the
+// code, the grid bricks sharing the code's higher bits but having a zero
+// at that bit.  Each such set is an axis-aligned box so counting is
+// O(bits) rather than requiring a sort of the entire grid.
+static hsize_t layout3_brick_row(int c, int b, int a, int cn, int bn, int an)
+{
+    const uint64_t v[3] = { a, b, c };    /* Index 0 is least significant */
+    const uint64_t n[3] = { an, bn, cn };
+
+    uint64_t row = 0;
+    for (int t = 30; t >= 0; --t) {
+        for (int s = 2; s >= 0; --s) {
+            if (!((v[s] >> t) & 1)) continue;
+            uint64_t count = 1;
+            for (int x = 0; x < 3 && count; ++x) {
+                const int free = x < s ? t + 1 : t;
+                const uint64_t lo = x == s
+                                  ? (v[x] >> (t + 1)) << (t + 1)
+                                  : (v[x] >> free) << free;
+                const uint64_t hi = lo + ((uint64_t) 1 << free);
+                count *= lo < n[x] ? (hi < n[x] ? hi : n[x]) - lo : 0;
+            }
+            row += count;
+        }
+    }
+    return row;
+}
+
+// Compute the portion of a brick overlapping the local block as a
+// four dimensional { row, c, b, a } hyperslab relative to the brick.
+static void layout3_brick_overlap(const struct layout3_brick *brick,
+                                  int ce, int be, int ae,
+                                  int cstart, int clocal,
+                                  int bstart, int blocal,
+                                  int astart, int alocal,
+                                  hsize_t start[4], hsize_t count[4])
+{
+    const int c0 = brick->c * ce, b0 = brick->b * be, a0 = brick->a * ae;
+    const int clo = cstart > c0 ? cstart : c0;
+    const int blo = bstart > b0 ? bstart : b0;
+    const int alo = astart > a0 ? astart : a0;
+    const int chi = cstart + clocal < c0 + ce ? cstart + clocal : c0 + ce;
+    const int bhi = bstart + blocal < b0 + be ? bstart + blocal : b0 + be;
+    const int ahi = astart + alocal < a0 + ae ? astart + alocal : a0 + ae;
+
+    start[0] = brick->row;  count[0] = 1;
+    start[1] = clo - c0;    count[1] = chi - clo;
+    start[2] = blo - b0;    count[2] = bhi - blo;
+    start[3] = alo - a0;    count[3] = ahi - alo;
+}
+
+hid_t esio_field_layout3_filespace_creator(int cglobal,
+                                           int bglobal,
+                                           int aglobal)
+{
+    const int ce = layout3_brick_edge(cglobal);
+    const int be = layout3_brick_edge(bglobal);
+    const int ae = layout3_brick_edge(aglobal);
+    const hsize_t dims[4] = {
+        (hsize_t) ((cglobal + ce - 1) / ce)
+                * ((bglobal + be - 1) / be)
+                * ((aglobal + ae - 1) / ae),
+        ce, be, ae
+    };
+    return H5Screate_simple(4, dims, NULL);
+}
+
+herr_t esio_field_layout3_dataset_chunker(hid_t dcpl_id,
+                                          int cchunk, int bchunk, int achunk)
+{
+    /* One chunk per brick; clamped as chunk sizes may be below an edge */
+    const hsize_t chunksizes[4] = {
+        1,
+        layout3_brick_edge(cchunk),
+        layout3_brick_edge(bchunk),
+        layout3_brick_edge(achunk)
+    };
+    return H5Pset_chunk(dcpl_id, 4, chunksizes);
+}
+
+#define METHODNAME esio_field_layout3_field_writer
+#define OPFUNC     H5Dwrite
+#define QUALIFIER  const
+#define PACKING    1
+#include "x-layout3.c"
+#undef METHODNAME
+#undef OPFUNC
+#undef QUALIFIER
+#undef PACKING
+
+#define METHODNAME esio_field_layout3_field_reader
+#define OPFUNC     H5Dread
+#define QUALIFIER  /* mutable */
+#define PACKING    0
+#include "x-layout3.c"
+#undef METHODNAME
+#undef OPFUNC
+#undef QUALIFIER
+#undef PACKING
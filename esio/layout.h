@@ -53,6 +53,9 @@ typedef int    (*esio_field_reader_t)     (hid_t, hid_t, void *,
                                            int, int, int, int,
                                            hid_t);
 
+typedef herr_t (*esio_virtual_mapper_t)  (hid_t, hid_t, const char *,
+                                           int, int, int);
+
 //******************************************************************
 // INTERNAL DECLARATIONS INTERNAL DECLARATIONS INTERNAL DECLARATIONS
 //******************************************************************
@@ -82,6 +85,19 @@ int esio_field_layout ## NUM ##_field_reader(              \
 ESIO_LAYOUT_DECLARATIONS(0)
 ESIO_LAYOUT_DECLARATIONS(1)
 ESIO_LAYOUT_DECLARATIONS(2)
+ESIO_LAYOUT_DECLARATIONS(3)
+
+herr_t esio_field_layout2_virtual_mapper(
+        hid_t dcpl_id, hid_t vspace_id, const char *name,
+        int cglobal, int bglobal, int aglobal);
+
+int esio_field_layout0_sparse_writer(
+        hid_t plist_id, hid_t dset_id, const void *field,
+        int cglobal, int cstart, int clocal, int cstride,
+        int bglobal, int bstart, int blocal, int bstride,
+        int aglobal, int astart, int alocal, int astride,
+        int cchunk, int bchunk, int achunk,
+        hid_t type_id, const void *fill);
 
 int esio_plane_writer(
         hid_t plist_id, hid_t dset_id, const void *plane,
@@ -0,0 +1,541 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "linetable.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hdf5.h>
+
+#include "error.h"
+#include "esio.h"
+#include "h5utils.h"
+#include "layout.h"
+#include "metadata.h"
+
+// Each table's index is a dataset of fixed-length name and comment pairs
+#define LINETABLE_INDEX_SUFFIX ".index"
+
+// Form the path of a table's data or, if suffix is non-NULL, its index
+static void linetable_path(char *buf, size_t len, int table,
+                           const char *suffix)
+{
+    snprintf(buf, len, "%s/%d%s", ESIO_LINETABLE_GROUP, table,
+             suffix ? suffix : "");
+}
+
+// Open the dataset holding the given table's data
+static hid_t linetable_open(hid_t file_id, int table)
+{
+    char path[64];
+    linetable_path(path, sizeof(path), table, NULL);
+    return H5Dopen2(file_id, path, H5P_DEFAULT);
+}
+
+static int linetable_row_compare(const void *a, const void *b)
+{
+    const struct esio_linetable_row *x = a, *y = b;
+    return strcmp(x->name, y->name);
+}
+
+// Create the index's compound type of fixed-length, null-terminated strings.
+// Supplying commentlen zero omits the comment member, e.g. for reading.
+static hid_t linetable_index_type(size_t namelen, size_t commentlen)
+{
+    const hid_t name_id    = H5Tcopy(H5T_C_S1);
+    const hid_t comment_id = H5Tcopy(H5T_C_S1);
+    hid_t type_id = -1;
+    if (   name_id >= 0 && comment_id >= 0
+        && H5Tset_size(name_id, namelen) >= 0
+        && (commentlen == 0 || H5Tset_size(comment_id, commentlen) >= 0)) {
+        type_id = H5Tcreate(H5T_COMPOUND, namelen + commentlen);
+        if (   type_id >= 0
+            && (   H5Tinsert(type_id, "name", 0, name_id) < 0
+                || (commentlen && H5Tinsert(type_id, "comment", namelen,
+                                            comment_id) < 0))) {
+            H5Tclose(type_id);
+            type_id = -1;
+        }
+    }
+    if (comment_id >= 0) H5Tclose(comment_id);
+    if (name_id    >= 0) H5Tclose(name_id);
+    return type_id;
+}
+
+// Append every row of one table to lt->rows, leaving them unsorted
+static int linetable_load_table(struct esio_linetable *lt,
+                                hid_t file_id, int table)
+{
+    char path[64];
+    int status = ESIO_SUCCESS;
+
+    // The table's extents and type describe every line within it
+    const hid_t tset_id = linetable_open(file_id, table);
+    if (tset_id < 0) return ESIO_EFAILED;
+    const hid_t ttype_id  = H5Dget_type(tset_id);
+    const hid_t tspace_id = H5Dget_space(tset_id);
+    hsize_t dims[2] = { 0, 0 };
+    if (   ttype_id < 0 || tspace_id < 0
+        || H5Sget_simple_extent_ndims(tspace_id) != 2
+        || H5Sget_simple_extent_dims(tspace_id, dims, NULL) < 0
+        || dims[0] > INT_MAX || dims[1] > INT_MAX) {
+        status = ESIO_EFAILED;
+    }
+    const int ncomponents = (ttype_id < 0) ? 0
+                          : esio_type_ncomponents(ttype_id);
+    if (tspace_id >= 0) H5Sclose(tspace_id);
+    if (ttype_id  >= 0) H5Tclose(ttype_id);
+    H5Dclose(tset_id);
+    if (status != ESIO_SUCCESS) return status;
+
+    // Read only the names from the table's index
+    linetable_path(path, sizeof(path), table, LINETABLE_INDEX_SUFFIX);
+    const hid_t iset_id = H5Dopen2(file_id, path, H5P_DEFAULT);
+    if (iset_id < 0) return ESIO_EFAILED;
+    const hid_t itype_id = H5Dget_type(iset_id);
+    const int   idx      = (itype_id < 0) ? -1
+                         : H5Tget_member_index(itype_id, "name");
+    const hid_t str_id   = (idx < 0) ? -1 : H5Tget_member_type(itype_id, idx);
+    const size_t namelen = (str_id < 0) ? 0 : H5Tget_size(str_id);
+    const hid_t memtype_id = namelen ? linetable_index_type(namelen, 0) : -1;
+    const size_t n = (size_t) dims[0];
+    char *names = malloc(n * namelen + 1);
+    struct esio_linetable_row *rows
+        = realloc(lt->rows, (lt->nrows + n + 1) * sizeof(*rows));
+    if (rows) lt->rows = rows;
+    if (memtype_id < 0) {
+        status = ESIO_EFAILED;
+    } else if (names == NULL || rows == NULL) {
+        status = ESIO_ENOMEM;
+    } else if (n && H5Dread(iset_id, memtype_id, H5S_ALL, H5S_ALL,
+                            H5P_DEFAULT, names) < 0) {
+        status = ESIO_EFAILED;
+    }
+    for (size_t i = 0; i < n && status == ESIO_SUCCESS; ++i) {
+        char *name = names + i * namelen;
+        name[namelen - 1] = '\0';
+        struct esio_linetable_row *r = lt->rows + lt->nrows;
+        if ((r->name = strdup(name)) == NULL) {
+            status = ESIO_ENOMEM;
+            break;
+        }
+        r->table       = table;
+        r->row         = (int) i;
+        r->aglobal     = (int) dims[1];
+        r->ncomponents = ncomponents;
+        ++lt->nrows;
+    }
+    free(names);
+    if (memtype_id >= 0) H5Tclose(memtype_id);
+    if (str_id     >= 0) H5Tclose(str_id);
+    if (itype_id   >= 0) H5Tclose(itype_id);
+    H5Dclose(iset_id);
+
+    return status;
+}
+
+// Read the rows of every table within file_id once
+static int linetable_load(struct esio_linetable *lt, hid_t file_id)
+{
+    if (lt->loaded) return ESIO_SUCCESS;
+
+    DISABLE_HDF5_ERROR_HANDLER(one)
+    const htri_t exists = H5Lexists(file_id, ESIO_LINETABLE_GROUP,
+                                    H5P_DEFAULT);
+    ENABLE_HDF5_ERROR_HANDLER(one)
+
+    // Tables are numbered consecutively from zero
+    int status = ESIO_SUCCESS;
+    for (int k = 0; exists > 0 && status == ESIO_SUCCESS; ++k) {
+        char path[64];
+        linetable_path(path, sizeof(path), k, LINETABLE_INDEX_SUFFIX);
+        DISABLE_HDF5_ERROR_HANDLER(two)
+        const htri_t found = H5Lexists(file_id, path, H5P_DEFAULT);
+        ENABLE_HDF5_ERROR_HANDLER(two)
+        if (found <= 0) break;
+        status = linetable_load_table(lt, file_id, k);
+        lt->ntables = k + 1;
+    }
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to read line table index", status);
+    }
+
+    qsort(lt->rows, lt->nrows, sizeof(lt->rows[0]), &linetable_row_compare);
+    lt->loaded = 1;
+    return ESIO_SUCCESS;
+}
+
+// Allocate empty line tables whenever none exist
+static int linetable_ensure(struct esio_linetable **lt)
+{
+    if (*lt == NULL && (*lt = calloc(1, sizeof(**lt))) == NULL) {
+        ESIO_ERROR("Unable to allocate line tables", ESIO_ENOMEM);
+    }
+    return ESIO_SUCCESS;
+}
+
+int esio_linetable_stage(struct esio_linetable **lt,
+                         const char *name, const char *comment,
+                         int aglobal, int astart, int alocal,
+                         const void *line, int astride, hid_t type_id)
+{
+    const int estat = linetable_ensure(lt);
+    if (estat != ESIO_SUCCESS) return estat;
+    struct esio_linetable *t = *lt;
+
+    // Find a previously staged row or a compatible group of rows
+    struct esio_linetable_pending *p = NULL;
+    int row = -1;
+    for (int k = 0; k < t->npending && row < 0; ++k) {
+        struct esio_linetable_pending *q = t->pending + k;
+        for (int i = 0; i < q->nrows; ++i) {
+            if (strcmp(q->names[i], name) == 0) {
+                p   = q;
+                row = i;
+                break;
+            }
+        }
+        if (   p == NULL && q->aglobal == aglobal && q->astart == astart
+            && q->alocal == alocal && H5Tequal(q->type_id, type_id) > 0) {
+            p = q;
+        }
+    }
+    if (row >= 0 && (   p->aglobal != aglobal || p->astart != astart
+                     || p->alocal  != alocal
+                     || H5Tequal(p->type_id, type_id) <= 0)) {
+        ESIO_ERROR("request mismatch with previously staged line",
+                   ESIO_EINVAL);
+    }
+
+    // Start a new group of rows whenever none is compatible
+    if (p == NULL) {
+        p = realloc(t->pending, (t->npending + 1) * sizeof(*p));
+        if (p == NULL) {
+            ESIO_ERROR("Unable to allocate staged lines", ESIO_ENOMEM);
+        }
+        t->pending = p;
+        p += t->npending;
+        memset(p, 0, sizeof(*p));
+        if ((p->type_id = H5Tcopy(type_id)) < 0) {
+            ESIO_ERROR("Unable to copy line type", ESIO_EFAILED);
+        }
+        p->aglobal = aglobal;
+        p->astart  = astart;
+        p->alocal  = alocal;
+        p->size    = H5Tget_size(type_id);
+        ++t->npending;
+    }
+
+    // Append a new row, growing storage geometrically
+    if (row < 0) {
+        if (p->nrows == p->capacity) {
+            const int capacity = p->capacity ? 2 * p->capacity : 16;
+            char **names    = realloc(p->names,    capacity * sizeof(char *));
+            if (names) p->names = names;
+            char **comments = realloc(p->comments, capacity * sizeof(char *));
+            if (comments) p->comments = comments;
+            char *data = realloc(p->data,
+                                 (capacity * alocal + 1) * p->size);
+            if (data) p->data = data;
+            if (names == NULL || comments == NULL || data == NULL) {
+                ESIO_ERROR("Unable to allocate staged lines", ESIO_ENOMEM);
+            }
+            p->capacity = capacity;
+        }
+        if ((p->names[p->nrows] = strdup(name)) == NULL) {
+            ESIO_ERROR("Unable to allocate staged line name", ESIO_ENOMEM);
+        }
+        p->comments[p->nrows] = NULL;
+        row = p->nrows++;
+    }
+
+    // Record the (possibly replaced) comment and copy the elements
+    free(p->comments[row]);
+    p->comments[row] = (comment && *comment) ? strdup(comment) : NULL;
+    char *dst = p->data + (size_t) row * alocal * p->size;
+    for (int i = 0; i < alocal; ++i) {
+        memcpy(dst + i * p->size,
+               (const char *) line + (size_t) i * astride * p->size,
+               p->size);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+int esio_linetable_find(struct esio_linetable **lt, hid_t file_id,
+                        const char *name, int *aglobal, int *ncomponents,
+                        int *table, int *row)
+{
+    const int estat = linetable_ensure(lt);
+    if (estat != ESIO_SUCCESS) return estat;
+    struct esio_linetable *t = *lt;
+
+    // Staged lines shadow nothing as existing rows are never staged
+    for (int k = 0; k < t->npending; ++k) {
+        const struct esio_linetable_pending *p = t->pending + k;
+        for (int i = 0; i < p->nrows; ++i) {
+            if (strcmp(p->names[i], name) == 0) {
+                if (aglobal)     *aglobal     = p->aglobal;
+                if (ncomponents) *ncomponents = esio_type_ncomponents(
+                                                        p->type_id);
+                if (table)       *table       = -1;
+                if (row)         *row         = i;
+                return ESIO_SUCCESS;
+            }
+        }
+    }
+
+    const int lstat = linetable_load(t, file_id);
+    if (lstat != ESIO_SUCCESS) return lstat;
+
+    const struct esio_linetable_row key = { (char *) name, 0, 0, 0, 0 };
+    const struct esio_linetable_row *r = t->nrows == 0 ? NULL
+        : bsearch(&key, t->rows, t->nrows, sizeof(key),
+                  &linetable_row_compare);
+    if (r == NULL) return ESIO_NOTFOUND;
+    if (aglobal)     *aglobal     = r->aglobal;
+    if (ncomponents) *ncomponents = r->ncomponents;
+    if (table)       *table       = r->table;
+    if (row)         *row         = r->row;
+    return ESIO_SUCCESS;
+}
+
+// Transfer this rank's portion of one row treating the table as a plane
+static int linetable_row_transfer(hid_t file_id, int table, int row,
+                                  hid_t plist_id, void *line,
+                                  int aglobal, int astart, int alocal,
+                                  int astride, hid_t type_id, int writing)
+{
+    const hid_t dset_id = linetable_open(file_id, table);
+    if (dset_id < 0) {
+        ESIO_ERROR("Unable to open line table", ESIO_EFAILED);
+    }
+    hsize_t dims[2] = { 0, 0 };
+    const hid_t space_id = H5Dget_space(dset_id);
+    if (space_id >= 0) {
+        H5Sget_simple_extent_dims(space_id, dims, NULL);
+        H5Sclose(space_id);
+    }
+    const int status = writing
+        ? esio_plane_writer(plist_id, dset_id, line,
+                            (int) dims[0], row, 1, astride * alocal,
+                            aglobal, astart, alocal, astride, type_id)
+        : esio_plane_reader(plist_id, dset_id, line,
+                            (int) dims[0], row, 1, astride * alocal,
+                            aglobal, astart, alocal, astride, type_id);
+    H5Dclose(dset_id);
+    return status;
+}
+
+int esio_linetable_write_row(hid_t file_id, int table, int row,
+                             hid_t plist_id, const void *line,
+                             int aglobal, int astart, int alocal,
+                             int astride, hid_t type_id)
+{
+    return linetable_row_transfer(file_id, table, row, plist_id,
+                                  (void *) line, aglobal, astart, alocal,
+                                  astride, type_id, 1);
+}
+
+int esio_linetable_read_row(hid_t file_id, int table, int row,
+                            hid_t plist_id, void *line,
+                            int aglobal, int astart, int alocal,
+                            int astride, hid_t type_id)
+{
+    return linetable_row_transfer(file_id, table, row, plist_id,
+                                  line, aglobal, astart, alocal,
+                                  astride, type_id, 0);
+}
+
+// Collectively create and write one table from a group of staged rows
+static int linetable_write(const struct esio_linetable_pending *p,
+                           hid_t file_id, hid_t plist_id, int comm_rank,
+                           int table)
+{
+    char path[64];
+    int status = ESIO_SUCCESS;
+
+    // All rows are written by a single collective transfer
+    const hsize_t dims[2] = { p->nrows, p->aglobal };
+    const hid_t space_id = H5Screate_simple(2, dims, NULL);
+    linetable_path(path, sizeof(path), table, NULL);
+    const hid_t dset_id = (space_id < 0) ? -1
+                        : H5Dcreate2(file_id, path, p->type_id, space_id,
+                                     H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (space_id >= 0) H5Sclose(space_id);
+    if (dset_id < 0) {
+        ESIO_ERROR("Unable to create line table", ESIO_EFAILED);
+    }
+    status = esio_plane_writer(plist_id, dset_id, p->data,
+                               p->nrows, 0, p->nrows, p->alocal,
+                               p->aglobal, p->astart, p->alocal, 1,
+                               p->type_id);
+    H5Dclose(dset_id);
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to write line table", status);
+    }
+
+    // Every rank holds identical names and comments
+    size_t namelen = 1, commentlen = 1;
+    for (int i = 0; i < p->nrows; ++i) {
+        const size_t n = strlen(p->names[i]) + 1;
+        const size_t c = p->comments[i] ? strlen(p->comments[i]) + 1 : 1;
+        if (n > namelen)    namelen    = n;
+        if (c > commentlen) commentlen = c;
+    }
+    const hsize_t nrows[1] = { p->nrows };
+    const hid_t type_id  = linetable_index_type(namelen, commentlen);
+    const hid_t ispace_id = H5Screate_simple(1, nrows, NULL);
+    linetable_path(path, sizeof(path), table, LINETABLE_INDEX_SUFFIX);
+    const hid_t iset_id = (type_id < 0 || ispace_id < 0) ? -1
+                        : H5Dcreate2(file_id, path, type_id, ispace_id,
+                                     H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (iset_id < 0) status = ESIO_EFAILED;
+
+    // Rank zero independently writes the index in one operation
+    if (status == ESIO_SUCCESS && comm_rank == 0) {
+        char *buf = calloc(p->nrows, namelen + commentlen);
+        if (buf == NULL) {
+            status = ESIO_ENOMEM;
+        } else {
+            for (int i = 0; i < p->nrows; ++i) {
+                char *dst = buf + i * (namelen + commentlen);
+                strcpy(dst, p->names[i]);
+                if (p->comments[i]) strcpy(dst + namelen, p->comments[i]);
+            }
+            if (H5Dwrite(iset_id, type_id, H5S_ALL, H5S_ALL,
+                         H5P_DEFAULT, buf) < 0) {
+                status = ESIO_EFAILED;
+            }
+            free(buf);
+        }
+    }
+    if (iset_id   >= 0) H5Dclose(iset_id);
+    if (ispace_id >= 0) H5Sclose(ispace_id);
+    if (type_id   >= 0) H5Tclose(type_id);
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to write line table index", status);
+    }
+
+    return ESIO_SUCCESS;
+}
+
+// Release one group of staged rows, optionally keeping the row names
+static void linetable_pending_free(struct esio_linetable_pending *p,
+                                   int keep_names)
+{
+    for (int i = 0; i < p->nrows; ++i) {
+        if (!keep_names) free(p->names[i]);
+        free(p->comments[i]);
+    }
+    free(p->names);
+    free(p->comments);
+    free(p->data);
+    if (p->type_id >= 0) H5Tclose(p->type_id);
+}
+
+int esio_linetable_flush(struct esio_linetable *lt, hid_t file_id,
+                         hid_t plist_id, int comm_rank)
+{
+    if (lt == NULL || lt->npending == 0) return ESIO_SUCCESS;
+
+    // New tables are numbered after any already in the file
+    int status = linetable_load(lt, file_id);
+    if (status != ESIO_SUCCESS) return status;
+
+    DISABLE_HDF5_ERROR_HANDLER(one)
+    const htri_t exists = H5Lexists(file_id, ESIO_LINETABLE_GROUP,
+                                    H5P_DEFAULT);
+    ENABLE_HDF5_ERROR_HANDLER(one)
+    if (exists <= 0) {
+        const hid_t group_id = H5Gcreate2(file_id, ESIO_LINETABLE_GROUP,
+                                          H5P_DEFAULT, H5P_DEFAULT,
+                                          H5P_DEFAULT);
+        if (group_id < 0) {
+            ESIO_ERROR("Unable to create line table group", ESIO_EFAILED);
+        }
+        H5Gclose(group_id);
+    }
+
+    // Written rows become findable by name
+    for (int k = 0; k < lt->npending && status == ESIO_SUCCESS; ++k) {
+        struct esio_linetable_pending *p = lt->pending + k;
+        struct esio_linetable_row *rows
+            = realloc(lt->rows, (lt->nrows + p->nrows + 1) * sizeof(*rows));
+        if (rows == NULL) {
+            status = ESIO_ENOMEM;
+            break;
+        }
+        lt->rows = rows;
+        status = linetable_write(p, file_id, plist_id, comm_rank,
+                                 lt->ntables);
+        if (status != ESIO_SUCCESS) break;
+        const int ncomponents = esio_type_ncomponents(p->type_id);
+        for (int i = 0; i < p->nrows; ++i) {
+            struct esio_linetable_row *r = lt->rows + lt->nrows++;
+            r->name        = p->names[i];
+            r->table       = lt->ntables;
+            r->row         = i;
+            r->aglobal     = p->aglobal;
+            r->ncomponents = ncomponents;
+        }
+        ++lt->ntables;
+        linetable_pending_free(p, 1);
+        p->nrows = 0;
+    }
+    qsort(lt->rows, lt->nrows, sizeof(lt->rows[0]), &linetable_row_compare);
+
+    // Discard all staged rows, whether written or not
+    for (int k = 0; k < lt->npending; ++k) {
+        if (lt->pending[k].nrows) linetable_pending_free(lt->pending + k, 0);
+    }
+    free(lt->pending);
+    lt->pending  = NULL;
+    lt->npending = 0;
+
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to write staged lines", status);
+    }
+    return ESIO_SUCCESS;
+}
+
+void esio_linetable_free(struct esio_linetable *lt)
+{
+    if (lt) {
+        for (int k = 0; k < lt->npending; ++k) {
+            linetable_pending_free(lt->pending + k, 0);
+        }
+        free(lt->pending);
+        for (size_t i = 0; i < lt->nrows; ++i) free(lt->rows[i].name);
+        free(lt->rows);
+        free(lt);
+    }
+}
@@ -0,0 +1,160 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifndef ESIO_LINETABLE_H
+#define ESIO_LINETABLE_H
+
+//****************************************************************
+// INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL
+//****************************************************************
+
+#include <stddef.h>
+#include <hdf5.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Name of the group holding every line table within the root group. */
+#define ESIO_LINETABLE_GROUP "esio_line_tables"
+
+/** Location of one line stored as a row within a line table. */
+struct esio_linetable_row {
+    char *name;         //< Line name
+    int   table;        //< Index of the table within ESIO_LINETABLE_GROUP
+    int   row;          //< Row within the table
+    int   aglobal;      //< Global extent in the A direction
+    int   ncomponents;  //< Number of scalar components per point
+};
+
+/** Staged lines sharing one decomposition and memory type. */
+struct esio_linetable_pending {
+    int     aglobal;    //< Global extent in the A direction
+    int     astart;     //< This rank's starting offset
+    int     alocal;     //< This rank's number of elements
+    hid_t   type_id;    //< Copy of the staged lines' memory type
+    size_t  size;       //< Size in bytes of type_id
+    int     nrows;      //< Number of rows staged
+    int     capacity;   //< Number of rows allocated
+    char  **names;      //< Each row's name
+    char  **comments;   //< Each row's comment or NULL
+    char   *data;       //< Each row's alocal elements stored contiguously
+};
+
+/** The line tables within one file along with any staged lines. */
+struct esio_linetable {
+    int     loaded;                         //< Were rows read from the file?
+    int     ntables;                        //< Number of tables in the file
+    size_t  nrows;                          //< Number of entries in rows
+    struct esio_linetable_row *rows;        //< Written rows sorted by name
+    int     npending;                       //< Number of entries in pending
+    struct esio_linetable_pending *pending; //< Staged, unwritten tables
+};
+
+/**
+ * Stage this rank's portion of a line for writing by esio_linetable_flush().
+ * Staging a name again replaces the previously staged contents.
+ * Every rank must stage the same names in the same order.
+ *
+ * @param lt      Line tables, allocated whenever <tt>*lt == NULL</tt>.
+ * @param name    Line name.
+ * @param comment Comment to record alongside the line or \c NULL.
+ * @param aglobal Global extent in the A direction.
+ * @param astart  This rank's starting offset.
+ * @param alocal  This rank's number of elements.
+ * @param line    This rank's elements of type \c type_id.
+ * @param astride Stride between elements in units of \c type_id.
+ * @param type_id Memory type of each element.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_linetable_stage(struct esio_linetable **lt,
+                         const char *name, const char *comment,
+                         int aglobal, int astart, int alocal,
+                         const void *line, int astride, hid_t type_id);
+
+/**
+ * Find a line stored within a table of \c file_id or staged for one.
+ * Table rows are read from the file on first use.
+ *
+ * @param lt          Line tables, allocated whenever <tt>*lt == NULL</tt>.
+ * @param file_id     File containing any line tables.
+ * @param name        Line name.
+ * @param aglobal     If non-NULL, set to the line's global extent.
+ * @param ncomponents If non-NULL, set to the line's component count.
+ * @param table       If non-NULL, set to the table holding the line
+ *                    or to \c -1 whenever the line is only staged.
+ * @param row         If non-NULL, set to the row holding the line.
+ *
+ * @return ESIO_SUCCESS \c (0) when found, ESIO_NOTFOUND when absent,
+ *         or one of ::esio_status on failure.
+ */
+int esio_linetable_find(struct esio_linetable **lt, hid_t file_id,
+                        const char *name, int *aglobal, int *ncomponents,
+                        int *table, int *row);
+
+/**
+ * Collectively write this rank's portion of one existing table row.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_linetable_write_row(hid_t file_id, int table, int row,
+                             hid_t plist_id, const void *line,
+                             int aglobal, int astart, int alocal,
+                             int astride, hid_t type_id);
+
+/**
+ * Collectively read this rank's portion of one existing table row.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_linetable_read_row(hid_t file_id, int table, int row,
+                            hid_t plist_id, void *line,
+                            int aglobal, int astart, int alocal,
+                            int astride, hid_t type_id);
+
+/**
+ * Collectively write every staged group of lines as one new table using
+ * a single transfer.  Rank zero alone writes each table's name index.
+ *
+ * @param lt        Line tables, which may be \c NULL.
+ * @param file_id   File to contain the tables.
+ * @param plist_id  Dataset transfer properties for writing table data.
+ * @param comm_rank Rank within the communicator used to open \c file_id.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_linetable_flush(struct esio_linetable *lt, hid_t file_id,
+                         hid_t plist_id, int comm_rank);
+
+/** Release all resources held by \c lt, which may be \c NULL. */
+void esio_linetable_free(struct esio_linetable *lt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESIO_LINETABLE_H */
@@ -0,0 +1,609 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "manifest.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hdf5.h>
+
+#include "error.h"
+#include "esio.h"
+#include "h5utils.h"
+#include "metadata.h"
+
+// Rows are stored as the fixed-size members below followed by a fixed-length,
+// null-terminated name.  All names in one manifest share the same length.
+struct manifest_row {
+    uint64_t hash;
+    uint64_t offset;
+    int      kind;
+    int      layout_index;
+    int      cglobal;
+    int      bglobal;
+    int      aglobal;
+    int      ncomponents;
+    int      type_class;
+    int      type_size;
+};
+
+// Bytes occupied by one in-memory row given a fixed name length
+static size_t manifest_stride(size_t namelen)
+{
+    const size_t align = sizeof(uint64_t);
+    return sizeof(struct manifest_row) + (namelen + align - 1) / align * align;
+}
+
+// In-memory compound type for rows of the given stride and name length
+static hid_t manifest_memtype(size_t namelen)
+{
+    const hid_t str_id = H5Tcopy(H5T_C_S1);
+    if (str_id < 0) return -1;
+    H5Tset_size(str_id, namelen);
+    H5Tset_strpad(str_id, H5T_STR_NULLTERM);
+
+    const hid_t type_id = H5Tcreate(H5T_COMPOUND, manifest_stride(namelen));
+    if (type_id < 0) {
+        H5Tclose(str_id);
+        return -1;
+    }
+
+#define MEMBER(member, native)                                        \
+    H5Tinsert(type_id, #member, HOFFSET(struct manifest_row, member), \
+              H5T_NATIVE_##native)
+    herr_t err = 0;
+    err |= H5Tinsert(type_id, "name", sizeof(struct manifest_row), str_id);
+    err |= MEMBER(kind,         INT);
+    err |= MEMBER(layout_index, INT);
+    err |= MEMBER(cglobal,      INT);
+    err |= MEMBER(bglobal,      INT);
+    err |= MEMBER(aglobal,      INT);
+    err |= MEMBER(ncomponents,  INT);
+    err |= MEMBER(type_class,   INT);
+    err |= MEMBER(type_size,    INT);
+    err |= MEMBER(offset,       UINT64);
+    err |= MEMBER(hash,         UINT64);
+#undef MEMBER
+
+    H5Tclose(str_id);
+    if (err < 0) {
+        H5Tclose(type_id);
+        return -1;
+    }
+    return type_id;
+}
+
+uint64_t esio_manifest_hash(const char *name)
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (const unsigned char *p = (const unsigned char *) name; *p; ++p) {
+        hash ^= *p;
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+static int manifest_entry_compare(const void *a, const void *b)
+{
+    const struct esio_manifest_entry *x = a;
+    const struct esio_manifest_entry *y = b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+// Populate an entry from an open dataset returning 1 when the dataset is an
+// ESIO field, plane, or line, 0 when it is something else, and -1 on error.
+static int manifest_classify(hid_t loc_id, const char *name, hid_t dset_id,
+                             struct esio_manifest_entry *e)
+{
+    memset(e, 0, sizeof(*e));
+
+    // Find the scalar component type and number of components
+    const hid_t type_id = H5Dget_type(dset_id);
+    if (type_id < 0) return -1;
+    hid_t base_id = -1;
+    if (H5Tget_class(type_id) == H5T_ARRAY) {
+        hsize_t ncomponents = 0;
+        if (   H5Tget_array_ndims(type_id) == 1
+            && H5Tget_array_dims2(type_id, &ncomponents) == 1
+            && ncomponents <= INT_MAX) {
+            e->ncomponents = (int) ncomponents;
+            base_id = H5Tget_super(type_id);
+        }
+    } else {
+        e->ncomponents = 1;
+        base_id = H5Tcopy(type_id);
+    }
+    H5Tclose(type_id);
+    if (base_id < 0) return 0;
+    e->type_class = H5Tget_class(base_id);
+    e->type_size  = (int) H5Tget_size(base_id);
+    H5Tclose(base_id);
+    switch (e->type_class) {
+        case H5T_COMPOUND:
+        case H5T_ENUM:
+        case H5T_FLOAT:
+        case H5T_INTEGER:
+        case H5T_OPAQUE:
+            break;
+        default:
+            return 0; // Not a type ESIO would have written
+    }
+
+    // Obtain the dataspace's extents
+    const hid_t space_id = H5Dget_space(dset_id);
+    if (space_id < 0) return -1;
+    hsize_t dims[H5S_MAX_RANK];
+    const int rank = H5Sget_simple_extent_dims(space_id, dims, NULL);
+    H5Sclose(space_id);
+    if (rank < 0) return -1;
+    for (int i = 0; i < rank; ++i) {
+        if (dims[i] > INT_MAX) return 0;
+    }
+
+    // Fields carrying esio_field_metadata may use any layout_index.
+    // Otherwise classify per esio_XXX_metadata_read's rank conventions.
+    const htri_t has_metadata = H5Aexists(dset_id, "esio_field_metadata");
+    if (has_metadata < 0) return -1;
+    if (has_metadata) {
+        e->kind = ESIO_MANIFEST_FIELD;
+        if (esio_field_metadata_read(loc_id, name, &e->layout_index,
+                                     &e->cglobal, &e->bglobal, &e->aglobal,
+                                     &e->ncomponents) != ESIO_SUCCESS) {
+            return 0;
+        }
+    } else if (rank == 3) {
+        e->kind    = ESIO_MANIFEST_FIELD;
+        e->cglobal = (int) dims[0];
+        e->bglobal = (int) dims[1];
+        e->aglobal = (int) dims[2];
+    } else if (rank == 2) {
+        e->kind    = ESIO_MANIFEST_PLANE;
+        e->bglobal = (int) dims[0];
+        e->aglobal = (int) dims[1];
+    } else if (rank == 1) {
+        e->kind    = ESIO_MANIFEST_LINE;
+        e->aglobal = (int) dims[0];
+    } else {
+        return 0;
+    }
+
+    // Contiguous datasets report where their raw data begins
+    const haddr_t offset = H5Dget_offset(dset_id);
+    e->offset = (offset == HADDR_UNDEF) ? UINT64_MAX : (uint64_t) offset;
+    e->hash   = esio_manifest_hash(name);
+
+    return 1;
+}
+
+// Walk the root group of file_id accumulating entries with strdup-ed names
+static int manifest_build(hid_t file_id,
+                          struct esio_manifest_entry **entries,
+                          size_t *n)
+{
+    *entries = NULL;
+    *n       = 0;
+
+    H5G_info_t ginfo;
+    if (H5Gget_info(file_id, &ginfo) < 0) {
+        ESIO_ERROR("Unable to query root group", ESIO_EFAILED);
+    }
+    if (ginfo.nlinks == 0) return ESIO_SUCCESS;
+
+    struct esio_manifest_entry *e = calloc(ginfo.nlinks, sizeof(*e));
+    if (e == NULL) {
+        ESIO_ERROR("Unable to allocate manifest entries", ESIO_ENOMEM);
+    }
+
+    int status = ESIO_SUCCESS;
+    size_t count = 0;
+    for (hsize_t i = 0; i < ginfo.nlinks && status == ESIO_SUCCESS; ++i) {
+
+        // Retrieve the i-th link name
+        const ssize_t len = H5Lget_name_by_idx(file_id, ".", H5_INDEX_NAME,
+                H5_ITER_INC, i, NULL, 0, H5P_DEFAULT);
+        char *name = (len < 0) ? NULL : malloc(len + 1);
+        if (name == NULL) {
+            status = (len < 0) ? ESIO_EFAILED : ESIO_ENOMEM;
+            break;
+        }
+        H5Lget_name_by_idx(file_id, ".", H5_INDEX_NAME, H5_ITER_INC, i,
+                           name, len + 1, H5P_DEFAULT);
+        if (strcmp(name, ESIO_MANIFEST_NAME) == 0) {
+            free(name);
+            continue;
+        }
+
+        // Only hard links are followed.  External links lead to subfiles
+        // whose opening is collective, so rank zero alone must not open
+        // them.  Such datasets take the per-object path when looked up.
+        H5L_info_t info;
+        if (H5Lget_info(file_id, name, &info, H5P_DEFAULT) < 0) {
+            status = ESIO_EFAILED;
+            free(name);
+            break;
+        }
+        if (info.type != H5L_TYPE_HARD) {
+            free(name);
+            continue;
+        }
+
+        // Non-datasets are silently skipped
+        DISABLE_HDF5_ERROR_HANDLER(one)
+        const hid_t obj_id = H5Oopen(file_id, name, H5P_DEFAULT);
+        ENABLE_HDF5_ERROR_HANDLER(one)
+        int found = 0;
+        if (obj_id >= 0) {
+            if (H5Iget_type(obj_id) == H5I_DATASET) {
+                found = manifest_classify(file_id, name, obj_id, e + count);
+            }
+            H5Oclose(obj_id);
+        }
+
+        if (found > 0) {
+            e[count++].name = name;
+        } else {
+            if (found < 0) status = ESIO_EFAILED;
+            free(name);
+        }
+    }
+
+    if (status != ESIO_SUCCESS) {
+        for (size_t j = 0; j < count; ++j) free((void *) e[j].name);
+        free(e);
+        ESIO_ERROR("Unable to enumerate datasets for manifest", status);
+    }
+
+    qsort(e, count, sizeof(*e), &manifest_entry_compare);
+    *entries = e;
+    *n       = count;
+    return ESIO_SUCCESS;
+}
+
+// Manifests are chunked along their single dimension by this many rows
+#define ESIO_MANIFEST_CHUNK 64
+
+// Return the name length of an existing manifest which may be resized and
+// rewritten in place, or zero if it must be replaced.  Only chunked manifests
+// with an unlimited extent qualify.
+static size_t manifest_reusable(hid_t dset_id)
+{
+    size_t namelen = 0;
+    const hid_t dcpl_id  = H5Dget_create_plist(dset_id);
+    const hid_t space_id = H5Dget_space(dset_id);
+    const hid_t type_id  = H5Dget_type(dset_id);
+    hsize_t maxdims[1] = { 0 };
+    if (   dcpl_id >= 0 && space_id >= 0 && type_id >= 0
+        && H5Pget_layout(dcpl_id) == H5D_CHUNKED
+        && H5Sget_simple_extent_ndims(space_id) == 1
+        && H5Sget_simple_extent_dims(space_id, NULL, maxdims) == 1
+        && maxdims[0] == H5S_UNLIMITED) {
+        const int idx = H5Tget_member_index(type_id, "name");
+        const hid_t str_id = (idx < 0) ? -1 : H5Tget_member_type(type_id, idx);
+        if (str_id >= 0) {
+            namelen = H5Tget_size(str_id);
+            H5Tclose(str_id);
+        }
+    }
+    if (type_id  >= 0) H5Tclose(type_id);
+    if (space_id >= 0) H5Sclose(space_id);
+    if (dcpl_id  >= 0) H5Pclose(dcpl_id);
+    return namelen;
+}
+
+// Build the lookup table for entries already held within a manifest
+static int manifest_index(struct esio_manifest *m)
+{
+    size_t nslots = 1;
+    while (nslots < 2 * m->n) nslots *= 2;
+    m->mask  = nslots - 1;
+    m->slots = malloc(nslots * sizeof(m->slots[0]));
+    if (m->slots == NULL) {
+        ESIO_ERROR("Unable to allocate manifest slots", ESIO_ENOMEM);
+    }
+    for (size_t i = 0; i < nslots; ++i) m->slots[i] = -1;
+
+    for (size_t i = 0; i < m->n; ++i) {
+        size_t j = (size_t) m->entries[i].hash & m->mask;
+        while (m->slots[j] >= 0) j = (j + 1) & m->mask;
+        m->slots[j] = (int) i;
+    }
+
+    return ESIO_SUCCESS;
+}
+
+int esio_manifest_write(hid_t file_id, MPI_Comm comm)
+{
+    int comm_rank;
+    ESIO_MPICHKQ(MPI_Comm_rank(comm, &comm_rank));
+
+    // All ranks open any previous manifest so it may be rewritten in place.
+    // Deleting and recreating it would leak its file space on every close.
+    DISABLE_HDF5_ERROR_HANDLER(one)
+    const htri_t exists = H5Lexists(file_id, ESIO_MANIFEST_NAME, H5P_DEFAULT);
+    ENABLE_HDF5_ERROR_HANDLER(one)
+    hid_t dset_id = -1;
+    size_t oldlen = 0;
+    if (exists > 0) {
+        dset_id = H5Dopen2(file_id, ESIO_MANIFEST_NAME, H5P_DEFAULT);
+        if (dset_id < 0) {
+            ESIO_ERROR("Unable to open previous manifest", ESIO_EFAILED);
+        }
+        oldlen = manifest_reusable(dset_id);
+    }
+
+    // Rank zero alone walks the file and shares what it must create
+    struct esio_manifest_entry *entries = NULL;
+    size_t n = 0;
+    long buf[3] = { /*status*/ ESIO_SUCCESS, /*n*/ 0, /*namelen*/ 1 };
+    if (comm_rank == 0) {
+        buf[0] = manifest_build(file_id, &entries, &n);
+        buf[1] = (long) n;
+        for (size_t i = 0; i < n; ++i) {
+            const long len = (long) strlen(entries[i].name) + 1;
+            if (len > buf[2]) buf[2] = len;
+        }
+        if (n > INT_MAX / manifest_stride(buf[2])) buf[0] = ESIO_EINVAL;
+    }
+    const int bstat = MPI_Bcast(buf, 3, MPI_LONG, 0, comm);
+    if (bstat != MPI_SUCCESS) {
+        if (dset_id >= 0) H5Dclose(dset_id);
+        for (size_t i = 0; i < n; ++i) free((void *) entries[i].name);
+        free(entries);
+        ESIO_MPICHKQ(bstat);
+    }
+    int status = (int) buf[0];
+    const int reuse = (oldlen >= (size_t) buf[2]);
+    const size_t namelen = reuse ? oldlen : (size_t) buf[2];
+    if (   status == ESIO_SUCCESS
+        && (size_t) buf[1] > INT_MAX / manifest_stride(namelen)) {
+        status = ESIO_EINVAL;
+    }
+
+    // Collectively resize a reusable manifest or replace any other one with
+    // a chunked, extendible dataset in a compact on-disk form
+    hid_t memtype_id = -1, filetype_id = -1, space_id = -1, dcpl_id = -1;
+    if (status == ESIO_SUCCESS) {
+        const hsize_t dims[1]    = { (hsize_t) buf[1] };
+        const hsize_t maxdims[1] = { H5S_UNLIMITED };
+        const hsize_t chunk[1]   = { ESIO_MANIFEST_CHUNK };
+        memtype_id = manifest_memtype(namelen);
+        if (memtype_id < 0) {
+            status = ESIO_EFAILED;
+        } else if (reuse) {
+            if (H5Dset_extent(dset_id, dims) < 0) status = ESIO_EFAILED;
+        } else {
+            if (dset_id >= 0) {
+                H5Dclose(dset_id);
+                dset_id = -1;
+            }
+            filetype_id = H5Tcopy(memtype_id);
+            if (exists > 0 && H5Ldelete(file_id, ESIO_MANIFEST_NAME,
+                                        H5P_DEFAULT) < 0) {
+                status = ESIO_EFAILED;
+            } else if (filetype_id < 0 || H5Tpack(filetype_id) < 0) {
+                status = ESIO_EFAILED;
+            } else if ((space_id = H5Screate_simple(1, dims, maxdims)) < 0) {
+                status = ESIO_EFAILED;
+            } else if ((dcpl_id = H5Pcreate(H5P_DATASET_CREATE)) < 0
+                    || H5Pset_chunk(dcpl_id, 1, chunk) < 0) {
+                status = ESIO_EFAILED;
+            } else if ((dset_id = H5Dcreate2(file_id, ESIO_MANIFEST_NAME,
+                            filetype_id, space_id, H5P_DEFAULT, dcpl_id,
+                            H5P_DEFAULT)) < 0) {
+                status = ESIO_EFAILED;
+            }
+        }
+    }
+
+    // Rank zero independently writes every row in one operation
+    if (status == ESIO_SUCCESS && comm_rank == 0 && n > 0) {
+        const size_t stride = manifest_stride(namelen);
+        char *rows = calloc(n, stride);
+        if (rows == NULL) {
+            status = ESIO_ENOMEM;
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                struct manifest_row r;
+                r.hash         = entries[i].hash;
+                r.offset       = entries[i].offset;
+                r.kind         = entries[i].kind;
+                r.layout_index = entries[i].layout_index;
+                r.cglobal      = entries[i].cglobal;
+                r.bglobal      = entries[i].bglobal;
+                r.aglobal      = entries[i].aglobal;
+                r.ncomponents  = entries[i].ncomponents;
+                r.type_class   = entries[i].type_class;
+                r.type_size    = entries[i].type_size;
+                memcpy(rows + i * stride, &r, sizeof(r));
+                strcpy(rows + i * stride + sizeof(r), entries[i].name);
+            }
+            if (H5Dwrite(dset_id, memtype_id, H5S_ALL, H5S_ALL,
+                         H5P_DEFAULT, rows) < 0) {
+                status = ESIO_EFAILED;
+            }
+            free(rows);
+        }
+    }
+
+    // Release resources
+    if (dset_id     >= 0) H5Dclose(dset_id);
+    if (dcpl_id     >= 0) H5Pclose(dcpl_id);
+    if (space_id    >= 0) H5Sclose(space_id);
+    if (filetype_id >= 0) H5Tclose(filetype_id);
+    if (memtype_id  >= 0) H5Tclose(memtype_id);
+    for (size_t i = 0; i < n; ++i) free((void *) entries[i].name);
+    free(entries);
+
+    if (status != ESIO_SUCCESS) {
+        ESIO_ERROR("Unable to write manifest", status);
+    }
+    return ESIO_SUCCESS;
+}
+
+int esio_manifest_read(hid_t file_id, MPI_Comm comm,
+                       struct esio_manifest **manifest)
+{
+    if (manifest == NULL) {
+        ESIO_ERROR("manifest == NULL", ESIO_EFAULT);
+    }
+    *manifest = NULL;
+
+    int comm_rank;
+    ESIO_MPICHKQ(MPI_Comm_rank(comm, &comm_rank));
+
+    // Rank zero reads the entire manifest, if any, in a single operation.
+    // A negative name length indicates that no manifest is present.
+    long buf[3] = { /*status*/ ESIO_SUCCESS, /*n*/ 0, /*namelen*/ -1 };
+    char *rows = NULL;
+    if (comm_rank == 0) {
+        DISABLE_HDF5_ERROR_HANDLER(one)
+        const htri_t exists = H5Lexists(file_id, ESIO_MANIFEST_NAME,
+                                        H5P_DEFAULT);
+        ENABLE_HDF5_ERROR_HANDLER(one)
+        const hid_t dset_id = (exists > 0)
+                            ? H5Dopen2(file_id, ESIO_MANIFEST_NAME, H5P_DEFAULT)
+                            : -1;
+        if (exists > 0 && dset_id < 0) {
+            buf[0] = ESIO_EFAILED;
+        } else if (dset_id >= 0) {
+            const hid_t type_id  = H5Dget_type(dset_id);
+            const hid_t space_id = H5Dget_space(dset_id);
+            const int   idx      = H5Tget_member_index(type_id, "name");
+            const hid_t str_id   = (idx < 0) ? -1
+                                 : H5Tget_member_type(type_id, idx);
+            const hssize_t npoints = H5Sget_simple_extent_npoints(space_id);
+            const size_t   namelen = (str_id < 0) ? 0 : H5Tget_size(str_id);
+            if (str_id < 0 || npoints < 0 || namelen < 1) {
+                buf[0] = ESIO_EFAILED;
+            } else if ((size_t) npoints
+                    > INT_MAX / manifest_stride(namelen)) {
+                buf[0] = ESIO_EINVAL;
+            } else {
+                buf[1] = (long) npoints;
+                buf[2] = (long) namelen;
+                rows = malloc(npoints * manifest_stride(namelen) + 1);
+                const hid_t memtype_id = manifest_memtype(namelen);
+                if (rows == NULL) {
+                    buf[0] = ESIO_ENOMEM;
+                } else if (memtype_id < 0 || H5Dread(dset_id, memtype_id,
+                            H5S_ALL, H5S_ALL, H5P_DEFAULT, rows) < 0) {
+                    buf[0] = ESIO_EFAILED;
+                }
+                if (memtype_id >= 0) H5Tclose(memtype_id);
+            }
+            if (str_id   >= 0) H5Tclose(str_id);
+            if (space_id >= 0) H5Sclose(space_id);
+            if (type_id  >= 0) H5Tclose(type_id);
+            H5Dclose(dset_id);
+        }
+        if (buf[0] != ESIO_SUCCESS) {
+            ESIO_ERROR_REPORT("Unable to read manifest", (int) buf[0]);
+        }
+    }
+    ESIO_MPICHKQ(MPI_Bcast(buf, 3, MPI_LONG, 0, comm));
+    if (buf[0] != ESIO_SUCCESS || buf[2] < 0) {
+        free(rows);
+        return (int) buf[0];
+    }
+
+    // Share the rows with all other ranks
+    const size_t n       = (size_t) buf[1];
+    const size_t namelen = (size_t) buf[2];
+    const size_t stride  = manifest_stride(namelen);
+    int ok = (comm_rank == 0) || (rows = malloc(n * stride + 1)) != NULL;
+    ESIO_MPICHKQ(MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm));
+    if (!ok) {
+        free(rows);
+        ESIO_ERROR("Unable to allocate space for manifest", ESIO_ENOMEM);
+    }
+    ESIO_MPICHKQ(MPI_Bcast(rows, (int) (n * stride), MPI_BYTE, 0, comm));
+
+    // Unpack the rows into entries whose names reference the row storage
+    struct esio_manifest *m = calloc(1, sizeof(*m));
+    if (m == NULL || (m->entries = calloc(n + 1, sizeof(m->entries[0])))
+                     == NULL) {
+        free(m);
+        free(rows);
+        ESIO_ERROR("Unable to allocate space for manifest", ESIO_ENOMEM);
+    }
+    m->n      = n;
+    m->buffer = rows;
+    for (size_t i = 0; i < n; ++i) {
+        struct manifest_row r;
+        memcpy(&r, rows + i * stride, sizeof(r));
+        char *name = rows + i * stride + sizeof(r);
+        name[namelen - 1] = '\0';
+        m->entries[i].name         = name;
+        m->entries[i].hash         = r.hash;
+        m->entries[i].offset       = r.offset;
+        m->entries[i].kind         = r.kind;
+        m->entries[i].layout_index = r.layout_index;
+        m->entries[i].cglobal      = r.cglobal;
+        m->entries[i].bglobal      = r.bglobal;
+        m->entries[i].aglobal      = r.aglobal;
+        m->entries[i].ncomponents  = r.ncomponents;
+        m->entries[i].type_class   = r.type_class;
+        m->entries[i].type_size    = r.type_size;
+    }
+
+    const int status = manifest_index(m);
+    if (status != ESIO_SUCCESS) {
+        esio_manifest_free(m);
+        return status;
+    }
+
+    *manifest = m;
+    return ESIO_SUCCESS;
+}
+
+const struct esio_manifest_entry*
+esio_manifest_find(const struct esio_manifest *manifest, const char *name)
+{
+    if (manifest == NULL || name == NULL) return NULL;
+
+    const uint64_t hash = esio_manifest_hash(name);
+    size_t j = (size_t) hash & manifest->mask;
+    for (int i; (i = manifest->slots[j]) >= 0; j = (j + 1) & manifest->mask) {
+        const struct esio_manifest_entry * const e = manifest->entries + i;
+        if (e->hash == hash && strcmp(e->name, name) == 0) return e;
+    }
+    return NULL;
+}
+
+void esio_manifest_free(struct esio_manifest *manifest)
+{
+    if (manifest) {
+        free(manifest->slots);
+        free(manifest->entries);
+        free(manifest->buffer);
+        free(manifest);
+    }
+}
@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifndef ESIO_MANIFEST_H
+#define ESIO_MANIFEST_H
+
+//****************************************************************
+// INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL
+//****************************************************************
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mpi.h>
+#include <hdf5.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Name of the dataset holding a file's manifest within the root group. */
+#define ESIO_MANIFEST_NAME "esio_manifest"
+
+/** Kinds of objects recorded within a manifest. */
+enum esio_manifest_kind {
+    ESIO_MANIFEST_FIELD = 1,
+    ESIO_MANIFEST_PLANE = 2,
+    ESIO_MANIFEST_LINE  = 3
+};
+
+/**
+ * One manifest row describing a single dataset in the root group.  Unused
+ * extents are zero, e.g. \c cglobal and \c bglobal for lines.  The type
+ * details describe the scalar component type as stored within the file.
+ */
+struct esio_manifest_entry {
+    const char *name;         //< Dataset name within the root group
+    uint64_t    hash;         //< esio_manifest_hash(name)
+    uint64_t    offset;       //< Contiguous raw data offset or UINT64_MAX
+    int         kind;         //< One of ::esio_manifest_kind
+    int         layout_index; //< Field layout_index or zero otherwise
+    int         cglobal;      //< Global extent in the C direction
+    int         bglobal;      //< Global extent in the B direction
+    int         aglobal;      //< Global extent in the A direction
+    int         ncomponents;  //< Number of scalar components per point
+    int         type_class;   //< H5T_class_t of the stored component type
+    int         type_size;    //< Size in bytes of the stored component type
+};
+
+/** An in-memory manifest supporting constant time lookup by name. */
+struct esio_manifest {
+    size_t                      n;       //< Number of entries
+    struct esio_manifest_entry *entries; //< Entries sorted by hash
+    size_t                      mask;    //< One less than number of slots
+    int                        *slots;   //< Open addressing table into entries
+    char                       *buffer;  //< Storage backing all names
+};
+
+/** Compute the 64-bit FNV-1a hash of \c name used to key manifests. */
+uint64_t esio_manifest_hash(const char *name);
+
+/**
+ * Collectively (re)write the manifest dataset describing every field, plane,
+ * and line hard linked from the root group of \c file_id.  Rank zero walks
+ * the group and writes the manifest while all ranks participate in its
+ * creation.  External links are never followed as doing so would open the
+ * linked file on rank zero alone.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_manifest_write(hid_t file_id, MPI_Comm comm);
+
+/**
+ * Collectively read the manifest stored within \c file_id.  Rank zero reads
+ * the manifest dataset in a single operation and broadcasts it.
+ *
+ * @param file_id  File containing the manifest.
+ * @param comm     Communicator with which the file was opened.
+ * @param manifest On success, set to a new manifest which must be released
+ *                 using esio_manifest_free() or to \c NULL whenever the file
+ *                 contains no manifest.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_manifest_read(hid_t file_id, MPI_Comm comm,
+                       struct esio_manifest **manifest);
+
+/**
+ * Find the entry for \c name within \c manifest in constant expected time.
+ *
+ * @return The matching entry or \c NULL if \c manifest is \c NULL or the
+ *         name is not present.
+ */
+const struct esio_manifest_entry*
+esio_manifest_find(const struct esio_manifest *manifest, const char *name);
+
+/** Release all resources held by \c manifest, which may be \c NULL. */
+void esio_manifest_free(struct esio_manifest *manifest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESIO_MANIFEST_H */
@@ -56,11 +56,13 @@ int esio_type_ncomponents(hid_t type_id)
 
     // Look up number of scalar components contained in the given type
     switch (H5Tget_class(type_id)) {
+        case H5T_COMPOUND:
         case H5T_ENUM:
         case H5T_FLOAT:
         case H5T_INTEGER:
         case H5T_OPAQUE:
-            // Scalar types contain a single component for metadata purposes
+            // Scalar types and compound records contain a single component
+            // for metadata purposes
             ncomponents = 1;
             break;
         case H5T_ARRAY:
@@ -68,8 +70,6 @@ int esio_type_ncomponents(hid_t type_id)
             assert(H5Tget_array_ndims(type_id) == 1);
             H5Tget_array_dims2(type_id, &ncomponents);
             break;
-        case H5T_COMPOUND:
-            ESIO_ERROR_VAL("H5T_COMPOUND not supported", ESIO_ESANITY, -1);
         case H5T_REFERENCE:
             ESIO_ERROR_VAL("H5T_REFERENCE not supported", ESIO_ESANITY, -1);
         case H5T_STRING:
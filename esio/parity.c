@@ -0,0 +1,369 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "parity.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <hdf5.h>
+#include <hdf5_hl.h>
+
+#include "error.h"
+
+// Combine status values so that every member of comm sees the same result
+static int agree(MPI_Comm comm, int status)
+{
+    if (MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm)) {
+        return ESIO_EFAILED;
+    }
+    return status;
+}
+
+// Bytes per chunk when the longest of g files is split into g-1 chunks
+static long long chunk_size(const long long *lengths, int g)
+{
+    long long longest = 0;
+    for (int j = 0; j < g; ++j) {
+        if (lengths[j] > longest) longest = lengths[j];
+    }
+    return (g > 1) ? (longest + g - 2) / (g - 1) : 0;
+}
+
+// Index of the chunk of member i folded into the parity block of member j.
+// For fixed i the mapping is a bijection from j != i onto [0, g-1).
+static int chunk_index(int i, int j, int g)
+{
+    return (j - i - 1 + g) % g;
+}
+
+// Copy chunk idx of data, zero-padded, into dst
+static void chunk_copy(unsigned char *dst, const unsigned char *data,
+                       long long len, int idx, long long chunk)
+{
+    const long long offset = idx * chunk;
+    if (offset < len) {
+        const long long n = (len - offset < chunk) ? len - offset : chunk;
+        memcpy(dst, data + offset, n);
+    }
+}
+
+// Read an entire file into a freshly allocated buffer
+static int slurp(const char *path, unsigned char **data, long long *len)
+{
+    *data = NULL;
+    *len  = 0;
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return ESIO_EFAILED;
+
+    int status = ESIO_SUCCESS;
+    if (fseeko(f, 0, SEEK_END) || (*len = ftello(f)) < 0
+                               || fseeko(f, 0, SEEK_SET)) {
+        status = ESIO_EFAILED;
+    } else if ((*data = malloc(*len ? *len : 1)) == NULL) {
+        status = ESIO_ENOMEM;
+    } else if (fread(*data, 1, *len, f) != (size_t) *len) {
+        status = ESIO_EFAILED;
+    }
+    fclose(f);
+
+    if (status != ESIO_SUCCESS) {
+        free(*data);
+        *data = NULL;
+        *len  = 0;
+    }
+    return status;
+}
+
+// Write len bytes to path replacing any existing file
+static int spill(const char *path, const unsigned char *data, long long len)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return ESIO_EFAILED;
+    int status = (fwrite(data, 1, len, f) == (size_t) len)
+               ? ESIO_SUCCESS : ESIO_EFAILED;
+    if (fclose(f)) status = ESIO_EFAILED;
+    return status;
+}
+
+// Store member i's parity block and every member's length as HDF5
+static int parity_write(const char *parity, int i, int g,
+                        const long long *lengths,
+                        const unsigned char *block, long long chunk)
+{
+    const hid_t file_id = H5Fcreate(parity, H5F_ACC_TRUNC,
+                                    H5P_DEFAULT, H5P_DEFAULT);
+    if (file_id < 0) return ESIO_EFAILED;
+
+    const hsize_t dims[1]     = { chunk };
+    const int     position[2] = { i, g };
+    int status = ESIO_SUCCESS;
+    if (   H5LTmake_dataset(file_id, ESIO_PARITY_NAME, 1, dims,
+                            H5T_NATIVE_UCHAR, block) < 0
+        || H5LTset_attribute_long_long(file_id, ESIO_PARITY_NAME,
+                                       "lengths", lengths, g) < 0
+        || H5LTset_attribute_int(file_id, ESIO_PARITY_NAME,
+                                 "position", position, 2) < 0) {
+        status = ESIO_EFAILED;
+    }
+    if (H5Fclose(file_id) < 0) status = ESIO_EFAILED;
+    return status;
+}
+
+// Load member i's parity block and every member's length from HDF5
+static int parity_read(const char *parity, int i, int g,
+                       long long *lengths,
+                       unsigned char **block, long long *chunk)
+{
+    *block = NULL;
+    *chunk = 0;
+
+    hid_t file_id;
+    H5E_BEGIN_TRY {
+        file_id = H5Fopen(parity, H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if (file_id < 0) return ESIO_EFAILED;
+
+    int status = ESIO_SUCCESS;
+    int position[2] = { -1, -1 };
+    hsize_t dims[1] = { 0 };
+    if (   H5LTget_attribute_int(file_id, ESIO_PARITY_NAME,
+                                 "position", position) < 0
+        || position[0] != i || position[1] != g
+        || H5LTget_attribute_long_long(file_id, ESIO_PARITY_NAME,
+                                       "lengths", lengths) < 0
+        || H5LTget_dataset_info(file_id, ESIO_PARITY_NAME,
+                                dims, NULL, NULL) < 0) {
+        status = ESIO_EFAILED;
+    } else if ((*block = malloc(dims[0] ? dims[0] : 1)) == NULL) {
+        status = ESIO_ENOMEM;
+    } else if (H5LTread_dataset(file_id, ESIO_PARITY_NAME,
+                                H5T_NATIVE_UCHAR, *block) < 0) {
+        status = ESIO_EFAILED;
+    }
+    H5Fclose(file_id);
+
+    if (status != ESIO_SUCCESS) {
+        free(*block);
+        *block = NULL;
+    } else {
+        *chunk = (long long) dims[0];
+    }
+    return status;
+}
+
+int esio_parity_group(MPI_Comm comm, MPI_Comm node_comm, int k,
+                      MPI_Comm *group)
+{
+    if (k < 1) return ESIO_EINVAL;
+
+    int rank, node_rank;
+    if (   MPI_Comm_rank(comm, &rank)
+        || MPI_Comm_rank(node_comm, &node_rank)) {
+        return ESIO_EFAILED;
+    }
+
+    // Number nodes by their lowest rank using a communicator of leaders
+    MPI_Comm leaders;
+    if (MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, rank,
+                       &leaders)) {
+        return ESIO_EFAILED;
+    }
+    int node[2] = { 0, 0 }; // { index, count }
+    if (leaders != MPI_COMM_NULL) {
+        MPI_Comm_rank(leaders, &node[0]);
+        MPI_Comm_size(leaders, &node[1]);
+        MPI_Comm_free(&leaders);
+    }
+    if (MPI_Bcast(node, 2, MPI_INT, 0, node_comm)) return ESIO_EFAILED;
+
+    // Deal nodes round-robin into sets then split by rank within node
+    const int nsets = (node[1] / k > 1) ? node[1] / k : 1;
+    const int color = node_rank * nsets + node[0] % nsets;
+    if (MPI_Comm_split(comm, color, rank, group)) return ESIO_EFAILED;
+
+    return ESIO_SUCCESS;
+}
+
+int esio_parity_encode_group(MPI_Comm group,
+                             const char *file,
+                             const char *parity)
+{
+    int g, i;
+    if (MPI_Comm_size(group, &g) || MPI_Comm_rank(group, &i)) {
+        return ESIO_EFAILED;
+    }
+
+    unsigned char *data = NULL, *send = NULL, *block = NULL;
+    long long len = 0;
+    long long *lengths = malloc(g * sizeof(long long));
+    int status = lengths ? slurp(file, &data, &len) : ESIO_ENOMEM;
+    if ((status = agree(group, status)) != ESIO_SUCCESS) goto done;
+
+    // Learn every member's length to size the chunks consistently
+    if (MPI_Allgather(&len, 1, MPI_LONG_LONG,
+                      lengths, 1, MPI_LONG_LONG, group)) {
+        status = ESIO_EFAILED;
+        goto done;
+    }
+    const long long chunk = chunk_size(lengths, g);
+    if (chunk * g > INT_MAX) {
+        status = ESIO_EINVAL; // Identical on all members
+        goto done;
+    }
+
+    // Fold each of this member's chunks into a different member's block
+    const size_t nbytes = (size_t) (chunk * g);
+    send  = calloc(nbytes ? nbytes : 1, 1);
+    block = malloc(chunk ? chunk : 1);
+    status = agree(group, (send && block) ? ESIO_SUCCESS : ESIO_ENOMEM);
+    if (status != ESIO_SUCCESS) goto done;
+    for (int j = 0; j < g; ++j) {
+        if (j != i) {
+            chunk_copy(send + j*chunk, data, len, chunk_index(i, j, g), chunk);
+        }
+    }
+    if (MPI_Reduce_scatter_block(send, block, (int) chunk,
+                                 MPI_BYTE, MPI_BXOR, group)) {
+        status = ESIO_EFAILED;
+        goto done;
+    }
+
+    status = agree(group, parity_write(parity, i, g, lengths, block, chunk));
+
+done:
+    free(block);
+    free(send);
+    free(data);
+    free(lengths);
+    return status;
+}
+
+int esio_parity_rebuild_group(MPI_Comm group,
+                              const char *file,
+                              const char *parity,
+                              int *rebuilt)
+{
+    *rebuilt = 0;
+
+    int g, i;
+    if (MPI_Comm_size(group, &g) || MPI_Comm_rank(group, &i)) {
+        return ESIO_EFAILED;
+    }
+
+    // Determine which member, if any, lost its file
+    const int lost = (access(file, F_OK) != 0);
+    int census[2] = { lost, lost ? i : -1 }; // { count, member }
+    if (   MPI_Allreduce(MPI_IN_PLACE, &census[0], 1, MPI_INT, MPI_SUM, group)
+        || MPI_Allreduce(MPI_IN_PLACE, &census[1], 1, MPI_INT, MPI_MAX, group)) {
+        return ESIO_EFAILED;
+    }
+    if (census[0] == 0) return ESIO_SUCCESS;
+    if (census[0] > 1 || g < 2) return ESIO_EFAILED;
+    const int m = census[1];
+
+    // Survivors load their files and parity blocks
+    unsigned char *data = NULL, *block = NULL, *send = NULL, *recv = NULL;
+    long long len = 0, nblock = 0;
+    long long *lengths = calloc(g, sizeof(long long));
+    int status = lengths ? ESIO_SUCCESS : ESIO_ENOMEM;
+    if (!lost && status == ESIO_SUCCESS) {
+        status = slurp(file, &data, &len);
+    }
+    if (!lost && status == ESIO_SUCCESS) {
+        status = parity_read(parity, i, g, lengths, &block, &nblock);
+    }
+    if ((status = agree(group, status)) != ESIO_SUCCESS) goto done;
+
+    // The lost member learns every length from a survivor
+    if (MPI_Bcast(lengths, g, MPI_LONG_LONG, (m == 0) ? 1 : 0, group)) {
+        status = ESIO_EFAILED;
+        goto done;
+    }
+    const long long chunk = chunk_size(lengths, g);
+    status = (!lost && (nblock != chunk || len != lengths[i]))
+           ? ESIO_ESANITY : ESIO_SUCCESS;
+    if ((status = agree(group, status)) != ESIO_SUCCESS) goto done;
+
+    // Block j XORed with every other survivor's chunk for j yields the lost
+    // member's chunk for j.  The lost member's own block is not needed.
+    const size_t nbytes = (size_t) (chunk * g);
+    send = calloc(nbytes ? nbytes : 1, 1);
+    recv = (i == m) ? malloc(nbytes ? nbytes : 1) : NULL;
+    status = (send && (i != m || recv)) ? ESIO_SUCCESS : ESIO_ENOMEM;
+    if ((status = agree(group, status)) != ESIO_SUCCESS) goto done;
+    if (!lost) {
+        for (int j = 0; j < g; ++j) {
+            if (j == m) continue;
+            if (j == i) {
+                memcpy(send + j*chunk, block, chunk);
+            } else {
+                chunk_copy(send + j*chunk, data, len,
+                           chunk_index(i, j, g), chunk);
+            }
+        }
+    }
+    if (MPI_Reduce(send, recv, (int) nbytes, MPI_BYTE, MPI_BXOR,
+                   m, group)) {
+        status = ESIO_EFAILED;
+        goto done;
+    }
+
+    // Reassemble the lost file in chunk order
+    if (lost) {
+        free(data);
+        data = malloc(lengths[m] ? lengths[m] : 1);
+        if (data == NULL) {
+            status = ESIO_ENOMEM;
+        } else {
+            for (int j = 0; j < g; ++j) {
+                if (j == m) continue;
+                const long long offset = chunk_index(m, j, g) * chunk;
+                if (offset < lengths[m]) {
+                    const long long n = (lengths[m] - offset < chunk)
+                                      ? lengths[m] - offset : chunk;
+                    memcpy(data + offset, recv + j*chunk, n);
+                }
+            }
+            status = spill(file, data, lengths[m]);
+            *rebuilt = (status == ESIO_SUCCESS);
+        }
+    }
+    status = agree(group, status);
+
+done:
+    free(recv);
+    free(send);
+    free(block);
+    free(data);
+    free(lengths);
+    return status;
+}
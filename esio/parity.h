@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifndef ESIO_PARITY_H
+#define ESIO_PARITY_H
+
+//****************************************************************
+// INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL
+//****************************************************************
+
+#include <mpi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Name of the dataset holding a parity block within a parity file. */
+#define ESIO_PARITY_NAME "esio_parity"
+
+/**
+ * Collectively split \c comm into parity groups.  Nodes are numbered by the
+ * lowest rank they contain and dealt round-robin into <tt>max(1,
+ * nnodes/k)</tt> sets, so each set contains at least \c k nodes whenever
+ * that many exist.  Ranks sharing a set and a rank within their node form a
+ * group.  No group ever contains two ranks from the same node.
+ *
+ * @param comm      Communicator to split.
+ * @param node_comm Communicator containing the ranks sharing this node.
+ * @param k         Desired number of nodes per group.
+ * @param group     On success, the group containing this rank.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         Failures are not reported through esio_error().
+ */
+int esio_parity_group(MPI_Comm comm, MPI_Comm node_comm, int k,
+                      MPI_Comm *group);
+
+/**
+ * Collectively compute and store XOR parity for the files \c file named by
+ * each member of \c group.  Every member's file is treated as bytes, split
+ * into <tt>g-1</tt> equal chunks for a group of size \c g, and each chunk is
+ * folded into the parity block of a different member.  Member \c i stores
+ * its block within \c parity together with every member's file length.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         The same value is returned on every member of \c group.
+ *         Failures are not reported through esio_error().
+ */
+int esio_parity_encode_group(MPI_Comm group,
+                             const char *file,
+                             const char *parity);
+
+/**
+ * Collectively recreate at most one missing \c file within \c group from the
+ * survivors' files and parity blocks.  Parity is not recomputed.
+ *
+ * @param group   Communicator previously passed to
+ *                esio_parity_encode_group().
+ * @param file    This member's file, possibly missing.
+ * @param parity  This member's parity file, possibly missing when \c file
+ *                is missing.
+ * @param rebuilt On success, set nonzero on the member whose file was
+ *                recreated and zero elsewhere.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         The same value is returned on every member of \c group.
+ *         Failures are not reported through esio_error().
+ */
+int esio_parity_rebuild_group(MPI_Comm group,
+                              const char *file,
+                              const char *parity,
+                              int *rebuilt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESIO_PARITY_H */
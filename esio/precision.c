@@ -0,0 +1,400 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "precision.h"
+
+#include <assert.h>
+#include <string.h>
+#include <hdf5.h>
+
+#if defined(__F16C__) || defined(HAVE_F16C_DISPATCH)
+#include <immintrin.h>
+#endif
+
+#include "error.h"
+#include "esio.h"
+
+// *******************************************************************
+// SCALAR CONVERSIONS SCALAR CONVERSIONS SCALAR CONVERSIONS SCALAR CONV
+// *******************************************************************
+
+// Branch-light binary16 conversions rounding to nearest even after
+// F. Giesen's public domain float_to_half_fast3_rtne and half_to_float.
+
+static inline uint16_t float_to_half(float f)
+{
+    const uint32_t f32infty       = UINT32_C(255) << 23;
+    const uint32_t f16max         = (uint32_t) (127 + 16) << 23;
+    const uint32_t denorm_magic_u = (uint32_t) (127 - 15 + 23 - 10 + 1) << 23;
+
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    const uint32_t sign = u & UINT32_C(0x80000000);
+    u ^= sign;
+
+    uint16_t o;
+    if (u >= f16max) {                      // Overflow, Inf, or NaN
+        o = (u > f32infty) ? 0x7e00 : 0x7c00;
+    } else if (u < (UINT32_C(113) << 23)) { // Subnormal or zero result
+        float g, magic;
+        memcpy(&g,     &u,              sizeof(g));
+        memcpy(&magic, &denorm_magic_u, sizeof(magic));
+        g += magic;                         // Hardware rounds the mantissa
+        memcpy(&u, &g, sizeof(u));
+        o = (uint16_t) (u - denorm_magic_u);
+    } else {                                // Normal result
+        const uint32_t mant_odd = (u >> 13) & 1;
+        u += ((uint32_t) (15 - 127) << 23) + 0xfff;
+        u += mant_odd;
+        o = (uint16_t) (u >> 13);
+    }
+    return o | (uint16_t) (sign >> 16);
+}
+
+static inline float half_to_float(uint16_t h)
+{
+    const uint32_t shifted_exp = UINT32_C(0x7c00) << 13;
+    const uint32_t magic_u     = UINT32_C(113) << 23;
+
+    uint32_t o = (uint32_t) (h & 0x7fff) << 13;
+    const uint32_t exp = shifted_exp & o;
+    o += (uint32_t) (127 - 15) << 23;
+    if (exp == shifted_exp) {               // Inf or NaN
+        o += (uint32_t) (128 - 16) << 23;
+    } else if (exp == 0) {                  // Zero or subnormal
+        float f, magic;
+        o += UINT32_C(1) << 23;
+        memcpy(&f,     &o,       sizeof(f));
+        memcpy(&magic, &magic_u, sizeof(magic));
+        f -= magic;                         // Renormalize
+        memcpy(&o, &f, sizeof(o));
+    }
+    o |= (uint32_t) (h & 0x8000) << 16;
+
+    float f;
+    memcpy(&f, &o, sizeof(f));
+    return f;
+}
+
+static inline uint16_t float_to_bfloat16(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    if ((u & UINT32_C(0x7fffffff)) > UINT32_C(0x7f800000)) {
+        return (uint16_t) ((u >> 16) | 0x40); // Quiet any NaN
+    }
+    u += UINT32_C(0x7fff) + ((u >> 16) & 1);
+    return (uint16_t) (u >> 16);
+}
+
+static inline float bfloat16_to_float(uint16_t b)
+{
+    const uint32_t u = (uint32_t) b << 16;
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// *******************************************************************
+// BULK CONVERSIONS BULK CONVERSIONS BULK CONVERSIONS BULK CONVERSIONS
+// *******************************************************************
+
+// Bulk conversions permit src and dst to start at the same address so that
+// HDF5 may convert its type conversion buffer in place.  Narrowing proceeds
+// forward and widening proceeds backward so no unread input is clobbered.
+
+// F16C kernels are used unconditionally when the compiler targets F16C.
+// Otherwise, when configure found the compiler able to target F16C per
+// function, they are compiled for it and selected only on CPUs having it.
+#if defined(__F16C__)
+#define ESIO_F16C 1
+#define F16C_TARGET
+#define f16c_supported() 1
+#elif defined(HAVE_F16C_DISPATCH)
+#define ESIO_F16C 1
+#define F16C_TARGET __attribute__((target("avx,f16c")))
+#define f16c_supported() (   __builtin_cpu_supports("avx") \
+                          && __builtin_cpu_supports("f16c"))
+#endif
+
+#ifdef ESIO_F16C
+// Narrow leading blocks of eight returning how many values were converted
+F16C_TARGET
+static size_t f16c_float_half(const float *src, uint16_t *dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256  x = _mm256_loadu_ps(src + i);
+        const __m128i y = _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i *) (dst + i), y);
+    }
+    return i;
+}
+
+// Widen trailing blocks of eight returning how many values remain
+F16C_TARGET
+static size_t f16c_half_float(const uint16_t *src, float *dst, size_t n)
+{
+    size_t i = n;
+    for (; i >= 8; i -= 8) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (src + i - 8));
+        _mm256_storeu_ps(dst + i - 8, _mm256_cvtph_ps(x));
+    }
+    return i;
+}
+#endif
+
+void esio_convert_float_half(const float *src, uint16_t *dst, size_t n)
+{
+    size_t i = 0;
+#ifdef ESIO_F16C
+    if (f16c_supported()) i = f16c_float_half(src, dst, n);
+#endif
+    for (; i < n; ++i) dst[i] = float_to_half(src[i]);
+}
+
+void esio_convert_half_float(const uint16_t *src, float *dst, size_t n)
+{
+    size_t i = n;
+#ifdef ESIO_F16C
+    if (f16c_supported()) i = f16c_half_float(src, dst, n);
+#endif
+    while (i-- > 0) dst[i] = half_to_float(src[i]);
+}
+
+void esio_convert_float_bfloat16(const float *src, uint16_t *dst, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) dst[i] = float_to_bfloat16(src[i]);
+}
+
+void esio_convert_bfloat16_float(const uint16_t *src, float *dst, size_t n)
+{
+    for (size_t i = n; i-- > 0;) dst[i] = bfloat16_to_float(src[i]);
+}
+
+// Double precision data is rounded to float before narrowing.  This double
+// rounding may differ from a correctly rounded result in the last place.
+
+static void convert_double_half(const double *src, uint16_t *dst, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) dst[i] = float_to_half((float) src[i]);
+}
+
+static void convert_half_double(const uint16_t *src, double *dst, size_t n)
+{
+    for (size_t i = n; i-- > 0;) dst[i] = half_to_float(src[i]);
+}
+
+static void convert_double_bfloat16(const double *src, uint16_t *dst, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) dst[i] = float_to_bfloat16((float) src[i]);
+}
+
+static void convert_bfloat16_double(const uint16_t *src, double *dst, size_t n)
+{
+    for (size_t i = n; i-- > 0;) dst[i] = bfloat16_to_float(src[i]);
+}
+
+// *******************************************************************
+// HDF5 CONVERSION PATHS HDF5 CONVERSION PATHS HDF5 CONVERSION PATHS
+// *******************************************************************
+
+// Generate an H5T_conv_t conversion function using bulk kernel BULK for
+// packed buffers and per-element conversion ONE for strided buffers.
+#define GEN_CONV(NAME, STYPE, DTYPE, BULK, ONE)                           \
+static herr_t NAME(hid_t src_id, hid_t dst_id, H5T_cdata_t *cdata,        \
+                   size_t nelmts, size_t buf_stride, size_t bkg_stride,   \
+                   void *buf, void *bkg, hid_t dxpl_id)                   \
+{                                                                         \
+    (void) src_id; (void) dst_id; (void) bkg_stride;                      \
+    (void) bkg;    (void) dxpl_id;                                        \
+    switch (cdata->command) {                                             \
+        case H5T_CONV_INIT: cdata->need_bkg = H5T_BKG_NO; return 0;       \
+        case H5T_CONV_FREE: return 0;                                     \
+        case H5T_CONV_CONV: break;                                        \
+        default:            return -1;                                    \
+    }                                                                     \
+    if (buf_stride) {                                                     \
+        char *p = buf;                                                    \
+        for (size_t i = 0; i < nelmts; ++i, p += buf_stride) {            \
+            STYPE s;                                                      \
+            memcpy(&s, p, sizeof(s));                                     \
+            const DTYPE d = ONE(s);                                       \
+            memcpy(p, &d, sizeof(d));                                     \
+        }                                                                 \
+    } else {                                                              \
+        BULK((const STYPE *) buf, (DTYPE *) buf, nelmts);                 \
+    }                                                                     \
+    return 0;                                                             \
+}
+
+#define TO_HALF(x)     float_to_half((float) (x))
+#define TO_BFLOAT16(x) float_to_bfloat16((float) (x))
+
+GEN_CONV(conv_float_half,     float,    uint16_t, esio_convert_float_half,
+         TO_HALF)
+GEN_CONV(conv_half_float,     uint16_t, float,    esio_convert_half_float,
+         half_to_float)
+GEN_CONV(conv_double_half,    double,   uint16_t, convert_double_half,
+         TO_HALF)
+GEN_CONV(conv_half_double,    uint16_t, double,   convert_half_double,
+         half_to_float)
+GEN_CONV(conv_float_bfloat16, float,    uint16_t, esio_convert_float_bfloat16,
+         TO_BFLOAT16)
+GEN_CONV(conv_bfloat16_float, uint16_t, float,    esio_convert_bfloat16_float,
+         bfloat16_to_float)
+GEN_CONV(conv_double_bfloat16, double,  uint16_t, convert_double_bfloat16,
+         TO_BFLOAT16)
+GEN_CONV(conv_bfloat16_double, uint16_t, double,  convert_bfloat16_double,
+         bfloat16_to_float)
+
+// Derive a 16-bit floating point type from the native float.  Byte order
+// stays native so the conversion kernels above operate on raw words.
+static hid_t esio_type_float16(size_t epos, size_t esize, size_t msize,
+                               size_t ebias)
+{
+    const hid_t type_id = H5Tcopy(H5T_NATIVE_FLOAT);
+    if (type_id < 0) return type_id;
+    if (   H5Tset_fields(type_id, 15, epos, esize, 0, msize) < 0
+        || H5Tset_precision(type_id, 16) < 0
+        || H5Tset_size(type_id, 2) < 0
+        || H5Tset_ebias(type_id, ebias) < 0) {
+        H5Tclose(type_id);
+        return -1;
+    }
+    return type_id;
+}
+
+static hid_t esio_type_half(void)
+{
+    return esio_type_float16(10, 5, 10, 15);
+}
+
+static hid_t esio_type_bfloat16(void)
+{
+    return esio_type_float16(7, 8, 7, 127);
+}
+
+int esio_precision_initialize(void)
+{
+    static int initialized = 0;
+    if (initialized) return ESIO_SUCCESS;
+
+    const hid_t half_id     = esio_type_half();
+    const hid_t bfloat16_id = esio_type_bfloat16();
+    if (half_id < 0 || bfloat16_id < 0) {
+        if (half_id >= 0)     H5Tclose(half_id);
+        if (bfloat16_id >= 0) H5Tclose(bfloat16_id);
+        ESIO_ERROR("Unable to create reduced precision types", ESIO_EFAILED);
+    }
+
+    const struct {
+        const char *name;
+        hid_t src_id, dst_id;
+        H5T_conv_t func;
+    } paths[] = {
+        { "esio_float_half", H5T_NATIVE_FLOAT, half_id,
+          &conv_float_half },
+        { "esio_half_float", half_id, H5T_NATIVE_FLOAT,
+          &conv_half_float },
+        { "esio_double_half", H5T_NATIVE_DOUBLE, half_id,
+          &conv_double_half },
+        { "esio_half_double", half_id, H5T_NATIVE_DOUBLE,
+          &conv_half_double },
+        { "esio_float_bfloat16", H5T_NATIVE_FLOAT, bfloat16_id,
+          &conv_float_bfloat16 },
+        { "esio_bfloat16_float", bfloat16_id, H5T_NATIVE_FLOAT,
+          &conv_bfloat16_float },
+        { "esio_double_bfloat16", H5T_NATIVE_DOUBLE, bfloat16_id,
+          &conv_double_bfloat16 },
+        { "esio_bfloat16_double", bfloat16_id, H5T_NATIVE_DOUBLE,
+          &conv_bfloat16_double },
+    };
+    herr_t status = 0;
+    const size_t npaths = sizeof(paths)/sizeof(paths[0]);
+    for (size_t i = 0; i < npaths && status >= 0; ++i) {
+        status = H5Tregister(H5T_PERS_HARD, paths[i].name,
+                             paths[i].src_id, paths[i].dst_id, paths[i].func);
+    }
+    H5Tclose(half_id);
+    H5Tclose(bfloat16_id);
+    if (status < 0) {
+        ESIO_ERROR("Unable to register reduced precision conversions",
+                   ESIO_EFAILED);
+    }
+
+    initialized = 1;
+    return ESIO_SUCCESS;
+}
+
+hid_t esio_type_storage(hid_t type_id, int precision)
+{
+    // Compound records are stored without padding at native precision
+    if (H5Tget_class(type_id) == H5T_COMPOUND) {
+        const hid_t retval = H5Tcopy(type_id);
+        if (retval >= 0 && H5Tpack(retval) < 0) {
+            H5Tclose(retval);
+            ESIO_ERROR_VAL("Unable to pack compound type", ESIO_EFAILED, -1);
+        }
+        return retval;
+    }
+
+    switch (precision) {
+        case ESIO_PRECISION_NATIVE:
+            return H5Tcopy(type_id);
+        case ESIO_PRECISION_HALF:
+        case ESIO_PRECISION_BFLOAT16:
+            break;
+        default:
+            ESIO_ERROR_VAL("Unknown storage precision", ESIO_EINVAL, -1);
+    }
+
+    switch (H5Tget_class(type_id)) {
+        case H5T_FLOAT:
+            return precision == ESIO_PRECISION_HALF ? esio_type_half()
+                                                    : esio_type_bfloat16();
+        case H5T_ARRAY: {
+            // Reduce the array's base type retaining its dimensions
+            const int ndims = H5Tget_array_ndims(type_id);
+            assert(ndims > 0 && ndims <= H5S_MAX_RANK);
+            hsize_t dims[H5S_MAX_RANK];
+            H5Tget_array_dims2(type_id, dims);
+            const hid_t super_id   = H5Tget_super(type_id);
+            const hid_t storage_id = esio_type_storage(super_id, precision);
+            H5Tclose(super_id);
+            if (storage_id < 0) return storage_id;
+            const hid_t retval = H5Tarray_create2(storage_id, ndims, dims);
+            H5Tclose(storage_id);
+            return retval;
+        }
+        default:
+            // Reduced precision applies only to floating point data
+            return H5Tcopy(type_id);
+    }
+}
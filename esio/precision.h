@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifndef ESIO_PRECISION_H
+#define ESIO_PRECISION_H
+
+//****************************************************************
+// INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL
+//****************************************************************
+
+#include <stddef.h>
+#include <stdint.h>
+#include <hdf5.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Register ESIO's hard conversion paths between native \c float or \c double
+ * and the reduced precision storage types.  HDF5's soft floating point
+ * conversions handle these types correctly but slowly.  Registration happens
+ * at most once per process and may be invoked repeatedly.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ */
+int esio_precision_initialize(void);
+
+/**
+ * Create the HDF5 type used to store data held in memory as \c type_id when
+ * writing new datasets with storage precision \c precision.  Only floating
+ * point types (and arrays thereof) are affected.  Compound types are packed
+ * to remove padding and other types are copied.
+ *
+ * @param type_id   In-memory type of the data to be stored.
+ * @param precision One of ::esio_precision.
+ *
+ * @return A new type which the caller must <tt>H5Tclose</tt> on success.
+ *         A negative value on failure.
+ */
+hid_t esio_type_storage(hid_t type_id, int precision);
+
+/**
+ * Convert \c n floats to IEEE 754 binary16 values rounding to nearest even.
+ * Buffers \c src and \c dst may coincide exactly but must not otherwise
+ * overlap.
+ */
+void esio_convert_float_half(const float *src, uint16_t *dst, size_t n);
+
+/** Convert \c n IEEE 754 binary16 values to floats exactly. */
+void esio_convert_half_float(const uint16_t *src, float *dst, size_t n);
+
+/** Convert \c n floats to bfloat16 values rounding to nearest even. */
+void esio_convert_float_bfloat16(const float *src, uint16_t *dst, size_t n);
+
+/** Convert \c n bfloat16 values to floats exactly. */
+void esio_convert_bfloat16_float(const uint16_t *src, float *dst, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESIO_PRECISION_H */
@@ -0,0 +1,187 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "readahead.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "error.h"
+
+size_t esio_readahead_ranges(uint64_t base, size_t size,
+                             int cglobal, int cstart, int clocal,
+                             int bglobal, int bstart, int blocal,
+                             int aglobal, int astart, int alocal,
+                             uint64_t *ranges)
+{
+    (void) cglobal; // Unused but present for API consistency
+    if (clocal <= 0 || blocal <= 0 || alocal <= 0) return 0;
+
+    // Elements are addressed as ((c*bglobal + b)*aglobal + a)
+    const uint64_t plane = (uint64_t) bglobal * aglobal;
+    const uint64_t first = (uint64_t) bstart * aglobal + astart;
+    const uint64_t span  = (uint64_t) (blocal - 1) * aglobal + alocal;
+
+    // Whole planes coalesce into one range
+    if (blocal == bglobal && alocal == aglobal) {
+        ranges[0] = base + (uint64_t) cstart * plane * size;
+        ranges[1] = (uint64_t) clocal * plane * size;
+        return 1;
+    }
+
+    // Otherwise emit one range per plane covering any b and a gaps
+    for (int c = 0; c < clocal; ++c) {
+        ranges[2*c  ] = base + ((cstart + c) * plane + first) * size;
+        ranges[2*c+1] = span * size;
+    }
+    return (size_t) clocal;
+}
+
+// Order {offset, length} pairs by offset
+static int pair_compare(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *) a;
+    const uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+int esio_readahead_advise(MPI_Comm node_comm, const char *path,
+                          const uint64_t *ranges, size_t nranges,
+                          int advice)
+{
+    int node_rank, node_size;
+    if (   MPI_Comm_rank(node_comm, &node_rank) != MPI_SUCCESS
+        || MPI_Comm_size(node_comm, &node_size) != MPI_SUCCESS) {
+        return ESIO_EFAILED;
+    }
+
+    // Node leader allocates space for gathering and shares its success
+    int *counts = NULL, *displs = NULL;
+    int ok = 1;
+    if (node_rank == 0) {
+        counts = malloc(2 * node_size * sizeof(int));
+        displs = counts + node_size;
+        ok     = (counts != NULL);
+    }
+    if (MPI_Bcast(&ok, 1, MPI_INT, 0, node_comm) != MPI_SUCCESS || !ok) {
+        free(counts);
+        return ok ? ESIO_EFAILED : ESIO_ENOMEM;
+    }
+
+    // Gather the number of values each rank contributes to the node leader
+    const int count = (int) (2 * nranges);
+    if (MPI_Gather((void *) &count, 1, MPI_INT, counts, 1, MPI_INT,
+                   0, node_comm) != MPI_SUCCESS) {
+        free(counts);
+        return ESIO_EFAILED;
+    }
+    int total = 0;
+    uint64_t *all = NULL;
+    if (node_rank == 0) {
+        for (int i = 0; i < node_size; ++i) {
+            displs[i] = total;
+            total    += counts[i];
+        }
+        all = malloc((total > 0 ? total : 1) * sizeof(uint64_t));
+        ok  = (all != NULL);
+    }
+    if (MPI_Bcast(&ok, 1, MPI_INT, 0, node_comm) != MPI_SUCCESS || !ok) {
+        free(counts);
+        return ok ? ESIO_EFAILED : ESIO_ENOMEM;
+    }
+
+    // Gather every range onto the node leader
+    int status = ESIO_SUCCESS;
+    if (MPI_Gatherv((void *) ranges, count, MPI_UINT64_T, all,
+                    counts, displs, MPI_UINT64_T, 0, node_comm)
+            != MPI_SUCCESS) {
+        status = ESIO_EFAILED;
+    }
+    free(counts);
+    if (node_rank != 0 || status != ESIO_SUCCESS) {
+        free(all);
+        return status;
+    }
+
+#if defined(POSIX_FADV_WILLNEED) && defined(POSIX_FADV_DONTNEED)
+    // Merge overlapping or adjacent ranges and advise the kernel about each
+    const size_t npairs = (size_t) total / 2;
+    qsort(all, npairs, 2 * sizeof(uint64_t), &pair_compare);
+    const int fd = (npairs > 0) ? open(path, O_RDONLY) : -1;
+    if (fd >= 0) {
+        const int flag = (advice == ESIO_READAHEAD_WILLNEED)
+                       ? POSIX_FADV_WILLNEED : POSIX_FADV_DONTNEED;
+        uint64_t lo = all[0], hi = all[0] + all[1];
+        for (size_t i = 1; i <= npairs; ++i) {
+            if (i < npairs && all[2*i] <= hi) {
+                const uint64_t end = all[2*i] + all[2*i+1];
+                if (end > hi) hi = end;
+                continue;
+            }
+            if (posix_fadvise(fd, (off_t) lo, (off_t) (hi - lo), flag)) {
+                status = ESIO_EFAILED;
+            }
+            if (i < npairs) {
+                lo = all[2*i];
+                hi = all[2*i] + all[2*i+1];
+            }
+        }
+        close(fd);
+    } else if (npairs > 0) {
+        status = ESIO_EFAILED;
+    }
+#else
+    (void) path;
+    (void) advice;
+    (void) pair_compare;
+#endif
+
+    free(all);
+    return status;
+}
+
+int esio_readahead_evict(const char *path)
+{
+#if defined(POSIX_FADV_DONTNEED)
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return ESIO_EFAILED;
+
+    // Dirty pages cannot be dropped so first write them back
+    int status = ESIO_SUCCESS;
+    if (fdatasync(fd) || posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED)) {
+        status = ESIO_EFAILED;
+    }
+    close(fd);
+    return status;
+#else
+    (void) path;
+    return ESIO_SUCCESS;
+#endif
+}
@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifndef ESIO_READAHEAD_H
+#define ESIO_READAHEAD_H
+
+//****************************************************************
+// INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL INTERNAL
+//****************************************************************
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mpi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Page cache advice understood by esio_readahead_advise(). */
+enum esio_readahead_advice {
+    ESIO_READAHEAD_WILLNEED = 1, //< Data will be read soon
+    ESIO_READAHEAD_DONTNEED = 2  //< Data will not be accessed again soon
+};
+
+/**
+ * Compute the byte ranges covering a local block within a dataset stored
+ * contiguously in row-major order starting at file offset \c base.  Ranges
+ * are stored as <tt>{offset, length}</tt> pairs with one pair per local
+ * \c c index or a single pair whenever the block spans whole \c c planes.
+ * Block extents less than or equal to zero produce no ranges.
+ *
+ * @param base     File offset of the first element of the dataset.
+ * @param size     Size in bytes of one dataset element.
+ * @param ranges   Storage for at least <tt>2*max(clocal,1)</tt> values.
+ *
+ * @return The number of pairs stored within \c ranges.
+ */
+size_t esio_readahead_ranges(uint64_t base, size_t size,
+                             int cglobal, int cstart, int clocal,
+                             int bglobal, int bstart, int blocal,
+                             int aglobal, int astart, int alocal,
+                             uint64_t *ranges);
+
+/**
+ * Collectively gather byte ranges from every rank in \c node_comm onto its
+ * rank zero which merges them and advises the operating system about the
+ * ranges within \c path using <tt>posix_fadvise</tt>.  Advice is only a
+ * hint so platforms lacking <tt>posix_fadvise</tt> silently ignore it.
+ *
+ * @param node_comm Communicator containing ranks sharing one page cache.
+ * @param path      Path to the file being accessed.
+ * @param ranges    Local <tt>{offset, length}</tt> pairs.
+ * @param nranges   Number of local pairs.
+ * @param advice    One of ::esio_readahead_advice.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         Failures are not reported through esio_error().
+ */
+int esio_readahead_advise(MPI_Comm node_comm, const char *path,
+                          const uint64_t *ranges, size_t nranges,
+                          int advice);
+
+/**
+ * Synchronize any data for \c path cached by this node to storage and then
+ * advise the operating system that none of it will be needed soon.  Only
+ * one rank per node should invoke this routine.
+ *
+ * @return Either ESIO_SUCCESS \c (0) or one of ::esio_status on failure.
+ *         Failures are not reported through esio_error().
+ */
+int esio_readahead_evict(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESIO_READAHEAD_H */
@@ -30,6 +30,11 @@
 #include "uri.h"
 
 #include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char stage_prefix[] = "stage:";
 
 int scheme_prefix_len(const char *s)
 {
@@ -51,3 +56,30 @@ int scheme_prefix_len(const char *s)
 
     return 0;
 }
+
+int stage_scheme(const char *s)
+{
+    return s && 0 == strncmp(s, stage_prefix, sizeof(stage_prefix) - 1);
+}
+
+int stage_name_valid(const char *s)
+{
+    if (!stage_scheme(s)) return 0;
+    const char *name = s + sizeof(stage_prefix) - 1;
+    return *name && !strchr(name, '/') && !strstr(name, "..");
+}
+
+char* stage_resolve(const char *s, const char *suffix)
+{
+    if (!stage_name_valid(s)) return NULL;
+
+    const char *dir  = getenv("ESIO_STAGE_DIR");
+    if (!dir || !*dir) dir = "/dev/shm";
+    const char *name = s + sizeof(stage_prefix) - 1;
+    if (!suffix) suffix = "";
+
+    const size_t len = strlen(dir) + 1 + strlen(name) + strlen(suffix) + 1;
+    char *path = malloc(len);
+    if (path) snprintf(path, len, "%s/%s%s", dir, name, suffix);
+    return path;
+}
@@ -56,6 +56,42 @@ extern "C" {
  */
 int scheme_prefix_len(const char *s);
 
+/**
+ * Does \c s name a staged file using the <tt>stage:</tt> URI scheme?
+ * Staged files reside beneath the directory given by the environment
+ * variable <tt>ESIO_STAGE_DIR</tt>, by default <tt>/dev/shm</tt>.
+ *
+ * @param s String which may optionally have a leading URI scheme.
+ *
+ * @return Nonzero if \c s begins with <tt>stage:</tt>.  Zero otherwise.
+ */
+int stage_scheme(const char *s);
+
+/**
+ * Does \c s name a staged file which stays within the staging directory?
+ * The name following <tt>stage:</tt> must be nonempty and may contain
+ * neither <tt>/</tt> nor <tt>..</tt>.
+ *
+ * @param s String which may optionally have a leading URI scheme.
+ *
+ * @return Nonzero if \c s is a valid <tt>stage:</tt> URI.  Zero otherwise.
+ */
+int stage_name_valid(const char *s);
+
+/**
+ * Resolve a <tt>stage:</tt> URI into a path beneath the staging directory.
+ * For example, <tt>stage:snap.h5</tt> with suffix <tt>.partial</tt> becomes
+ * <tt>/dev/shm/snap.h5.partial</tt> when <tt>ESIO_STAGE_DIR</tt> is unset.
+ *
+ * @param s      String beginning with <tt>stage:</tt>.
+ * @param suffix Optional suffix appended to the result.  May be NULL.
+ *
+ * @return A path which the caller must <tt>free</tt> on success.
+ *         NULL when \c s is not a valid staged name per stage_name_valid()
+ *         or on allocation failure.
+ */
+char* stage_resolve(const char *s, const char *suffix);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,198 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+// Designed to be #included from layout.c
+#if !defined(METHODNAME) || !defined(OPFUNC) || !defined(QUALIFIER) \
+ || !defined(PACKING)
+#error "One of METHODNAME, OPFUNC, QUALIFIER, or PACKING not defined"
+#endif
+
+int METHODNAME(hid_t plist_id, hid_t dset_id, QUALIFIER void *field,
+               int cglobal, int cstart, int clocal, int cstride,
+               int bglobal, int bstart, int blocal, int bstride,
+               int aglobal, int astart, int alocal, int astride,
+               hid_t type_id)
+{
+    /* Determine in-memory size of type_id */
+    const size_t type_size = H5Tget_size(type_id);
+    assert(type_size > 0);
+
+    /* Determine brick geometry shared by every rank */
+    const int ce = layout3_brick_edge(cglobal);
+    const int be = layout3_brick_edge(bglobal);
+    const int ae = layout3_brick_edge(aglobal);
+    const int cn = (cglobal + ce - 1) / ce;
+    const int bn = (bglobal + be - 1) / be;
+    const int an = (aglobal + ae - 1) / ae;
+
+    /* Establish filespace and reset the selection */
+    const hid_t filespace = H5Dget_space(dset_id);
+    assert(filespace >= 0);
+    H5Sselect_none(filespace);
+
+    /* Degenerate local block: participate in collective with no data */
+    const size_t nelems = (size_t) clocal * blocal * alocal;
+    if (nelems == 0) {
+        const hsize_t lies = 1;
+        const hid_t memspace = H5Screate_simple(1, &lies, NULL);
+        assert(memspace > 0);
+        H5Sselect_none(memspace);
+        const herr_t status = OPFUNC(dset_id, type_id, memspace,
+                                     filespace, plist_id, field);
+        H5Sclose(memspace);
+        H5Sclose(filespace);
+        if (status < 0) ESIO_ERROR("Operation failed", ESIO_EFAILED);
+        return ESIO_SUCCESS;
+    }
+
+    /* Enumerate bricks overlapping the local block and sort them by row */
+    /* so buffer order matches the file selection's iteration order.     */
+    const int cb0 = cstart / ce, cb1 = (cstart + clocal - 1) / ce;
+    const int bb0 = bstart / be, bb1 = (bstart + blocal - 1) / be;
+    const int ab0 = astart / ae, ab1 = (astart + alocal - 1) / ae;
+    const size_t nbricks = (size_t) (cb1 - cb0 + 1)
+                         * (bb1 - bb0 + 1)
+                         * (ab1 - ab0 + 1);
+    struct layout3_brick *bricks = malloc(nbricks * sizeof(*bricks));
+    char *buffer = malloc(nelems * type_size);
+    if (!bricks || !buffer) {
+        free(bricks);
+        free(buffer);
+        H5Sclose(filespace);
+        ESIO_ERROR("Unable to allocate brick buffers", ESIO_ENOMEM);
+    }
+    {
+        size_t n = 0;
+        for (int k = cb0; k <= cb1; ++k) {
+            for (int j = bb0; j <= bb1; ++j) {
+                for (int i = ab0; i <= ab1; ++i) {
+                    bricks[n].row = layout3_brick_row(k, j, i, cn, bn, an);
+                    bricks[n].c   = k;
+                    bricks[n].b   = j;
+                    bricks[n].a   = i;
+                    ++n;
+                }
+            }
+        }
+    }
+    qsort(bricks, nbricks, sizeof(*bricks), &layout3_brick_compare);
+
+#if !PACKING
+    /* Read everything into the buffer before unpacking it below */
+    for (size_t n = 0; n < nbricks; ++n) {
+        hsize_t start[4], count[4];
+        layout3_brick_overlap(&bricks[n], ce, be, ae,
+                              cstart, clocal, bstart, blocal, astart, alocal,
+                              start, count);
+        H5Sselect_hyperslab(filespace, H5S_SELECT_OR,
+                            start, NULL, count, NULL);
+    }
+    {
+        const hsize_t dims = nelems;
+        const hid_t memspace = H5Screate_simple(1, &dims, NULL);
+        assert(memspace > 0);
+        const herr_t status = OPFUNC(dset_id, type_id, memspace,
+                                     filespace, plist_id, buffer);
+        H5Sclose(memspace);
+        if (status < 0) {
+            free(buffer);
+            free(bricks);
+            H5Sclose(filespace);
+            ESIO_ERROR("Operation failed", ESIO_EFAILED);
+        }
+    }
+#endif
+
+    /* Walk bricks in row order moving data between field and buffer */
+    {
+        QUALIFIER char *base = (QUALIFIER char *) field;
+        char *p_buffer = buffer;
+        for (size_t n = 0; n < nbricks; ++n) {
+            hsize_t start[4], count[4];
+            layout3_brick_overlap(&bricks[n], ce, be, ae,
+                                  cstart, clocal, bstart, blocal,
+                                  astart, alocal, start, count);
+#if PACKING
+            H5Sselect_hyperslab(filespace, H5S_SELECT_OR,
+                                start, NULL, count, NULL);
+#endif
+            const int k0 = bricks[n].c * ce + (int) start[1] - cstart;
+            const int j0 = bricks[n].b * be + (int) start[2] - bstart;
+            const int i0 = bricks[n].a * ae + (int) start[3] - astart;
+            for (int k = k0; k < k0 + (int) count[1]; ++k) {
+                for (int j = j0; j < j0 + (int) count[2]; ++j) {
+                    QUALIFIER char *p_field = base + type_size
+                        * ((size_t) k*cstride + (size_t) j*bstride
+                                              + (size_t) i0*astride);
+                    if (astride == 1) {
+                        const size_t nbytes = count[3] * type_size;
+#if PACKING
+                        memcpy(p_buffer, p_field, nbytes);
+#else
+                        memcpy(p_field, p_buffer, nbytes);
+#endif
+                        p_buffer += nbytes;
+                    } else {
+                        for (hsize_t i = 0; i < count[3]; ++i) {
+#if PACKING
+                            memcpy(p_buffer, p_field, type_size);
+#else
+                            memcpy(p_field, p_buffer, type_size);
+#endif
+                            p_buffer += type_size;
+                            p_field  += type_size * astride;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+#if PACKING
+    /* Write the packed buffer in a single transfer */
+    {
+        const hsize_t dims = nelems;
+        const hid_t memspace = H5Screate_simple(1, &dims, NULL);
+        assert(memspace > 0);
+        const herr_t status = OPFUNC(dset_id, type_id, memspace,
+                                     filespace, plist_id, buffer);
+        H5Sclose(memspace);
+        if (status < 0) {
+            free(buffer);
+            free(bricks);
+            H5Sclose(filespace);
+            ESIO_ERROR("Operation failed", ESIO_EFAILED);
+        }
+    }
+#endif
+
+    /* Release temporary resources */
+    free(buffer);
+    free(bricks);
+    H5Sclose(filespace);
+
+    return ESIO_SUCCESS;
+}
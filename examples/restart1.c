@@ -14,6 +14,7 @@ int main(int argc, char *argv[])
     // Create restart file template filled with metadata on a subset of ranks
     if (world_rank == 0) {
         esio_handle s = esio_handle_initialize(MPI_COMM_SELF);
+        esio_file_small_set(s, 1);  // Build the tiny template in memory
         esio_file_create(s, "template.h5", 1 /* overwrite */);
         esio_string_set(s, "/", "program", argv[0]);
         esio_string_set(s, "/", "built",   __DATE__ " " __TIME__);
@@ -0,0 +1,329 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(balance)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // A decomposition where one rank owns everything is written evenly
+        FCT_TEST_BGN(uneven)
+        {
+            enum { C = 4, B = 3, A = 5, N = C*B*A };
+            double x[2*N], y[N], back[N];
+            for (int i = 0; i < 2*N; ++i) x[i] = (i % 2) ? -1 : i / 2;
+            for (int i = 0; i < N; ++i) y[i] = 2*i + 1;
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int before = esio_field_balance_get(state);
+            fct_chk_eq_int(before, 0);
+            fct_req(0 == esio_field_balance_set(state, 1));
+            const int after = esio_field_balance_get(state);
+            fct_chk_eq_int(after, 1);
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+
+            // Strided input is gathered directly from the user buffer
+            fct_req(0 == esio_field_write_double(state, "x", x,
+                                                 0, 0, 2, "strided"));
+            fct_req(0 == esio_field_write_double(state, "x", x,
+                                                 0, 0, 2, "again"));
+            fct_req(0 == esio_field_write_double(state, "y", y,
+                                                 0, 0, 0, 0));
+
+            // Any new decomposition invalidates the cached schedule
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_field_write_double(state, "z", y,
+                                                 0, 0, 0, 0));
+
+            for (int i = 0; i < N; ++i) back[i] = 0;
+            fct_req(0 == esio_field_read_double(state, "x", back, 0, 0, 0));
+            if (own) {
+                for (int i = 0; i < N; ++i) fct_chk_eq_dbl(back[i], i);
+            }
+            fct_req(0 == esio_field_read_double(state, "z", back, 0, 0, 0));
+            if (own) {
+                for (int i = 0; i < N; ++i) fct_chk_eq_dbl(back[i], y[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+
+        // Pipelined writes exchange one segment while writing another
+        // whenever the decomposition is redistributed
+        FCT_TEST_BGN(pipelined)
+        {
+            enum { C = 7, B = 3, A = 5, N = C*B*A };
+            double x[2*N], back[N];
+            for (int i = 0; i < 2*N; ++i) x[i] = (i % 2) ? -1 : i / 2;
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int before = esio_field_pipeline_get(state);
+            fct_chk_eq_int(before, 1);
+            fct_req(0 == esio_field_pipeline_set(state, 3));
+            const int after = esio_field_pipeline_get(state);
+            fct_chk_eq_int(after, 3);
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            static const char * const names[] = { "l0", "l1", "l2", "l3" };
+            for (int k = 0; k < 4; ++k) {
+                fct_req(0 == esio_field_layout_set(state, k));
+                fct_req(0 == esio_field_write_double(state, names[k], x,
+                                                     0, 0, 2, "pipelined"));
+                for (int i = 0; i < N; ++i) back[i] = 0;
+                fct_req(0 == esio_field_read_double(state, names[k], back,
+                                                    0, 0, 0));
+                if (own) {
+                    for (int i = 0; i < N; ++i) fct_chk_eq_dbl(back[i], i);
+                }
+            }
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+
+        // Evenly decomposed writes are also pipelined, whether creating a
+        // field or overwriting one, with more segments than some ranks have
+        FCT_TEST_BGN(even)
+        {
+            enum { C = 7, B = 3, A = 5, N = C*B*A };
+            double x[2*N], back[N];
+            for (int i = 0; i < 2*N; ++i) x[i] = (i % 2) ? -1 : i / 2;
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_pipeline_set(state, 16));
+            const int cstart = ( world_rank      * C) / world_size;
+            const int clocal = ((world_rank + 1) * C) / world_size - cstart;
+            fct_req(0 == esio_field_establish(state, C, cstart, clocal,
+                                                     B, 0,      B,
+                                                     A, 0,      A));
+            const double *mine = x + 2*cstart*B*A;
+            fct_req(0 == esio_field_write_double(state, "even", mine,
+                                                 0, 0, 2, "even"));
+            for (int i = 0; i < N; ++i) back[i] = 0;
+            fct_req(0 == esio_field_read_double(state, "even", back, 0, 0, 0));
+            for (int i = 0; i < clocal*B*A; ++i) {
+                fct_chk_eq_dbl(back[i], cstart*B*A + i);
+            }
+            for (int i = 0; i < 2*N; ++i) x[i] = -x[i];
+            fct_req(0 == esio_field_write_double(state, "even", mine,
+                                                 0, 0, 2, "even"));
+            fct_req(0 == esio_field_read_double(state, "even", back, 0, 0, 0));
+            for (int i = 0; i < clocal*B*A; ++i) {
+                fct_chk_eq_dbl(back[i], -(cstart*B*A + i));
+            }
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+
+        // Pipelined segments are chunked as the whole field would be
+        FCT_TEST_BGN(chunked)
+        {
+            enum { C = 7, B = 3, A = 5, N = C*B*A };
+            double x[N], back[N];
+            for (int i = 0; i < N; ++i) x[i] = (i % 3) ? i : 0;
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_sparse_set(state, 1, 0));
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_field_write_double(state, "direct", x,
+                                                 0, 0, 0, 0));
+            fct_req(0 == esio_field_pipeline_set(state, 3));
+            fct_req(0 == esio_field_write_double(state, "piped", x,
+                                                 0, 0, 0, 0));
+            for (int i = 0; i < N; ++i) back[i] = -1;
+            fct_req(0 == esio_field_read_double(state, "piped", back,
+                                                0, 0, 0));
+            if (own) {
+                for (int i = 0; i < N; ++i) fct_chk_eq_dbl(back[i], x[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                hsize_t dims[2][3] = { { 0, 0, 0 }, { 0, 0, 0 } };
+                static const char * const names[2] = { "direct", "piped" };
+                for (int k = 0; k < 2; ++k) {
+                    const hid_t dset_id = H5Dopen2(file_id, names[k],
+                                                   H5P_DEFAULT);
+                    fct_req(dset_id >= 0);
+                    const hid_t plist_id = H5Dget_create_plist(dset_id);
+                    const int rank = H5Pget_chunk(plist_id, 3, dims[k]);
+                    fct_chk_eq_int(rank, 3);
+                    H5Pclose(plist_id);
+                    H5Dclose(dset_id);
+                }
+                for (int d = 0; d < 3; ++d) {
+                    fct_chk_eq_int((int) dims[1][d], (int) dims[0][d]);
+                }
+                H5Fclose(file_id);
+            }
+        }
+        FCT_TEST_END();
+
+        // Bad handles are reported
+        FCT_TEST_BGN(invalid)
+        {
+            const int status = esio_field_balance_get(NULL);
+            fct_chk_eq_int(status, 0);
+            esio_set_error_handler_off();
+            const int failed = esio_field_balance_set(NULL, 1);
+            fct_chk_eq_int(failed, ESIO_EFAULT);
+            const int nsegments = esio_field_pipeline_get(NULL);
+            fct_chk_eq_int(nsegments, 1);
+            const int invalid = esio_field_pipeline_set(state, 0);
+            fct_chk_eq_int(invalid, ESIO_EINVAL);
+            esio_set_error_handler(esio_handler);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
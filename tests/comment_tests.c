@@ -0,0 +1,316 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(comment)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Comments are recorded at close along with the file's provenance
+        FCT_TEST_BGN(deferred)
+        {
+            enum { C = 2, B = 3, A = 4, N = C*B*A };
+            double x[N];
+            for (int i = 0; i < N; ++i) x[i] = i;
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_plane_establish(state, B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_line_establish(state, A, 0, own ? A : 0));
+            fct_req(0 == esio_field_write_double(state, "x", x,
+                                                 0, 0, 0, "first"));
+            fct_req(0 == esio_field_write_double(state, "y", x,
+                                                 0, 0, 0, 0));
+            fct_req(0 == esio_field_write_double(state, "x", x,
+                                                 0, 0, 0, "second"));
+            fct_req(0 == esio_plane_write_double(state, "p", x,
+                                                 0, 0, "plane"));
+            fct_req(0 == esio_line_write_double(state, "l", x, 0, "line"));
+            fct_req(0 == esio_file_close(state));
+
+            // Rewriting with unchanged or changed comments
+            fct_req(0 == esio_file_open(state, filename, 1));
+            fct_req(0 == esio_field_write_double(state, "x", x,
+                                                 0, 0, 0, "second"));
+            fct_req(0 == esio_plane_write_double(state, "p", x,
+                                                 0, 0, "changed"));
+            fct_req(0 == esio_file_flush(state));
+            fct_req(0 == esio_file_close(state));
+
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                char buf[128];
+                ssize_t len;
+                len = H5Oget_comment_by_name(file_id, "x", buf,
+                                             sizeof(buf), H5P_DEFAULT);
+                fct_chk(len > 0);
+                fct_chk_eq_str(buf, "second");
+                len = H5Oget_comment_by_name(file_id, "y", NULL, 0,
+                                             H5P_DEFAULT);
+                fct_chk_eq_int((int) len, 0);
+                len = H5Oget_comment_by_name(file_id, "p", buf,
+                                             sizeof(buf), H5P_DEFAULT);
+                fct_chk(len > 0);
+                fct_chk_eq_str(buf, "changed");
+                len = H5Oget_comment_by_name(file_id, "l", buf,
+                                             sizeof(buf), H5P_DEFAULT);
+                fct_chk(len > 0);
+                fct_chk_eq_str(buf, "line");
+
+                fct_req(0 <= H5LTget_attribute_string(file_id, "/",
+                                                      "esio_provenance",
+                                                      buf));
+                fct_chk(0 == strncmp(buf, "ESIO ", 5));
+                fct_chk(strstr(buf, "; ranks "));
+                fct_chk(strstr(buf, "; field 2x3x4 blocks "));
+                fct_chk(strstr(buf, "; written "));
+                H5Fclose(file_id);
+            }
+        }
+        FCT_TEST_END();
+
+        // Comments may be dropped entirely
+        FCT_TEST_BGN(disabled)
+        {
+            enum { C = 2, B = 2, A = 2, N = C*B*A };
+            double x[N] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+            const int before = esio_field_comments_get(state);
+            fct_chk_eq_int(before, 1);
+            fct_req(0 == esio_field_comments_set(state, 0));
+            const int after = esio_field_comments_get(state);
+            fct_chk_eq_int(after, 0);
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_field_write_double(state, "x", x,
+                                                 0, 0, 0, "dropped"));
+            fct_req(0 == esio_file_close(state));
+
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                const ssize_t len = H5Oget_comment_by_name(
+                        file_id, "x", NULL, 0, H5P_DEFAULT);
+                fct_chk_eq_int((int) len, 0);
+                H5Fclose(file_id);
+            }
+
+            esio_set_error_handler_off();
+            const int failed = esio_field_comments_set(NULL, 1);
+            fct_chk_eq_int(failed, ESIO_EFAULT);
+            esio_set_error_handler(esio_handler);
+        }
+        FCT_TEST_END();
+
+        // Provenance is rewritten only when the file was written
+        FCT_TEST_BGN(provenance)
+        {
+            enum { C = 2, B = 2, A = 2, N = C*B*A };
+            double x[N] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_write_double(state, "x", x, 0, 0, 0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            // Replace the recorded provenance with a sentinel
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDWR,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                fct_req(0 <= H5LTset_attribute_string(file_id, "/",
+                                                      "esio_provenance",
+                                                      "sentinel"));
+                H5Fclose(file_id);
+            }
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+
+            // Opening writable, reading, and closing leaves it untouched
+            double back[N];
+            fct_req(0 == esio_file_open(state, filename, 1));
+            fct_req(0 == esio_field_read_double(state, "x", back, 0, 0, 0));
+            fct_req(0 == esio_file_close(state));
+            char buf[160] = "";
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                fct_req(0 <= H5LTget_attribute_string(file_id, "/",
+                                                      "esio_provenance",
+                                                      buf));
+                fct_chk_eq_str(buf, "sentinel");
+                H5Fclose(file_id);
+            }
+
+            // Any write records the writer again
+            fct_req(0 == esio_file_open(state, filename, 1));
+            fct_req(0 == esio_string_set(state, "/", "note", "changed"));
+            fct_req(0 == esio_file_close(state));
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                fct_req(0 <= H5LTget_attribute_string(file_id, "/",
+                                                      "esio_provenance",
+                                                      buf));
+                fct_chk(0 == strncmp(buf, "ESIO ", 5));
+                fct_chk(strstr(buf, "; field 2x2x2 blocks "));
+                H5Fclose(file_id);
+            }
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
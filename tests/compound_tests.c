@@ -0,0 +1,346 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+// A per-point record mixing member types
+struct point {
+    double uvw[3];
+    float  T;
+    int    flag;
+};
+
+static void point_fill(struct point *p, int i)
+{
+    p->uvw[0] = i; p->uvw[1] = 2*i; p->uvw[2] = 3*i;
+    p->T      = (float) i / 2;
+    p->flag   = i % 3;
+}
+
+static int point_equal(const struct point *p, const struct point *q)
+{
+    return p->uvw[0] == q->uvw[0] && p->uvw[1] == q->uvw[1]
+        && p->uvw[2] == q->uvw[2] && p->T    == q->T
+        && p->flag   == q->flag;
+}
+
+static esio_compound point_compound(void)
+{
+    esio_compound c = esio_compound_create(sizeof(struct point));
+    if (   c == NULL
+        || esio_compound_insert_double(c, "uvw",
+                                       offsetof(struct point, uvw), 3)
+        || esio_compound_insert_float(c, "T", offsetof(struct point, T), 1)
+        || esio_compound_insert_int(c, "flag",
+                                    offsetof(struct point, flag), 1)) {
+        esio_compound_free(c);
+        return NULL;
+    }
+    return c;
+}
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(compound)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Records round trip through fields, planes, and lines
+        FCT_TEST_BGN(roundtrip)
+        {
+            enum { C = 3, B = 4, A = 5, N = C*B*A };
+            struct point x[N], back[N];
+            for (int i = 0; i < N; ++i) {
+                point_fill(&x[i], i);
+                memset(&back[i], 0, sizeof(back[i]));
+            }
+
+            esio_compound c = point_compound();
+            fct_req(c);
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_plane_establish(state, B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_line_establish(state, A, 0, own ? A : 0));
+            for (int k = 0; k < 4; ++k) {
+                static const char * const names[] = { "f0", "f1", "f2", "f3" };
+                fct_req(0 == esio_field_layout_set(state, k));
+                fct_req(0 == esio_field_write_compound(state, names[k], x,
+                                                       0, 0, 0, c, "field"));
+                fct_req(0 == esio_field_read_compound(state, names[k], back,
+                                                      0, 0, 0, c));
+                if (own) {
+                    for (int i = 0; i < N; ++i) {
+                        fct_chk(point_equal(&back[i], &x[i]));
+                    }
+                }
+            }
+            fct_req(0 == esio_plane_write_compound(state, "p", x,
+                                                   0, 0, c, "plane"));
+            fct_req(0 == esio_line_write_compound(state, "l", x,
+                                                  0, c, "line"));
+            memset(back, 0, sizeof(back));
+            fct_req(0 == esio_plane_read_compound(state, "p", back, 0, 0, c));
+            if (own) {
+                for (int i = 0; i < B*A; ++i) {
+                    fct_chk(point_equal(&back[i], &x[i]));
+                }
+            }
+            memset(back, 0, sizeof(back));
+            fct_req(0 == esio_line_read_compound(state, "l", back, 0, c));
+            if (own) {
+                for (int i = 0; i < A; ++i) {
+                    fct_chk(point_equal(&back[i], &x[i]));
+                }
+            }
+
+            // Records count as a single component and are stored packed
+            int cglobal, bglobal, aglobal, ncomponents;
+            fct_req(0 == esio_field_sizev(state, "f0", &cglobal, &bglobal,
+                                          &aglobal, &ncomponents));
+            fct_chk_eq_int(ncomponents, 1);
+            fct_req(0 == esio_file_close(state));
+            esio_compound_free(c);
+
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                const hid_t dset_id = H5Dopen2(file_id, "f0", H5P_DEFAULT);
+                fct_req(dset_id >= 0);
+                const hid_t type_id = H5Dget_type(dset_id);
+                const size_t size = H5Tget_size(type_id);
+                fct_chk_eq_int((int) size, 3*8 + 4 + 4);
+                const int nmembers = H5Tget_nmembers(type_id);
+                fct_chk_eq_int(nmembers, 3);
+                H5Tclose(type_id);
+                H5Dclose(dset_id);
+                H5Fclose(file_id);
+            }
+        }
+        FCT_TEST_END();
+
+        // Single members are read selectively
+        FCT_TEST_BGN(members)
+        {
+            enum { C = 2, B = 3, A = 4, N = C*B*A };
+            struct point x[N], back[N];
+            float T[N];
+            for (int i = 0; i < N; ++i) {
+                point_fill(&x[i], i);
+                point_fill(&back[i], -1);
+                T[i] = 0;
+            }
+
+            esio_compound c = point_compound();
+            fct_req(c);
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_field_write_compound(state, "x", x,
+                                                   0, 0, 0, c, 0));
+            esio_compound_free(c);
+
+            // Into a plain array
+            esio_compound t = esio_compound_create(sizeof(float));
+            fct_req(t);
+            fct_req(0 == esio_compound_insert_float(t, "T", 0, 1));
+            fct_req(0 == esio_field_read_compound(state, "x", T, 0, 0, 0, t));
+            esio_compound_free(t);
+
+            // Into existing records leaving other members untouched
+            esio_compound f = esio_compound_create(sizeof(struct point));
+            fct_req(f);
+            fct_req(0 == esio_compound_insert_int(
+                        f, "flag", offsetof(struct point, flag), 1));
+            fct_req(0 == esio_field_read_compound(state, "x", back,
+                                                  0, 0, 0, f));
+            esio_compound_free(f);
+            fct_req(0 == esio_file_close(state));
+
+            if (own) {
+                for (int i = 0; i < N; ++i) {
+                    fct_chk_eq_dbl(T[i], x[i].T);
+                    fct_chk_eq_int(back[i].flag, x[i].flag);
+                    fct_chk_eq_dbl(back[i].uvw[0], -1);
+                    fct_chk_eq_dbl(back[i].T, -0.5);
+                }
+            }
+        }
+        FCT_TEST_END();
+
+        // Malformed descriptions are rejected
+        FCT_TEST_BGN(invalid)
+        {
+            esio_set_error_handler_off();
+            esio_compound c = esio_compound_create(sizeof(struct point));
+            fct_req(c);
+            int status;
+            status = esio_compound_insert_double(c, "u", 0, 3);
+            fct_chk_eq_int(status, ESIO_SUCCESS);
+            status = esio_compound_insert_double(c, "u", 24, 1);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            status = esio_compound_insert_float(c, "T", 8, 1);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            status = esio_compound_insert_int(c, "x", sizeof(struct point), 1);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            status = esio_compound_insert_int(c, "y", 28, 0);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            esio_compound_free(c);
+
+            esio_compound empty = esio_compound_create(8);
+            fct_req(empty);
+            double x = 0;
+            fct_req(0 == esio_line_establish(state, 1, 0, 1));
+            status = esio_line_write_compound(state, "l", &x, 0, empty, 0);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            status = esio_line_write_compound(state, "l", &x, 0, NULL, 0);
+            fct_chk_eq_int(status, ESIO_EFAULT);
+            esio_compound_free(empty);
+            esio_set_error_handler(esio_handler);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
@@ -0,0 +1,319 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+#include <mpi.h>
+#include <esio/esio.hpp>
+
+extern "C" {
+#include "testutils.h"
+}
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+// Minimal stand-in for std::mdspan providing only what esio.hpp requires.
+// Mappings compute offsets from explicit strides regardless of layout tag.
+namespace standin {
+
+struct layout_right {};   // Row-major and contiguous by contract
+struct layout_stride {};  // Anything else
+
+template <class T>
+struct plain_accessor {
+    T &access(T *p, std::size_t i) const { return p[i]; }
+};
+
+template <class T>
+struct other_accessor {
+    T &access(T *p, std::size_t i) const { return p[i]; }
+};
+
+template <class T, std::size_t R, class L, class A = plain_accessor<T>>
+struct mdspan {
+    using element_type  = T;
+    using layout_type   = L;
+    using accessor_type = A;
+
+    struct mapping_type {
+        std::array<std::size_t, R> s;
+        template <class... I>
+        std::size_t operator()(I... i) const
+        {
+            std::size_t k = 0, r = 0;
+            ((k += s[r++] * static_cast<std::size_t>(i)), ...);
+            return k;
+        }
+    };
+
+    T *p;
+    std::array<std::size_t, R> n, s;
+
+    static constexpr std::size_t rank() { return R; }
+    std::size_t extent(std::size_t r) const { return n[r]; }
+    std::size_t stride(std::size_t r) const { return s[r]; }
+    std::size_t size() const
+    {
+        std::size_t z = 1;
+        for (std::size_t e : n) z *= e;
+        return z;
+    }
+    T *data_handle() const { return p; }
+    mapping_type mapping() const { return { s }; }
+    A accessor() const { return {}; }
+};
+
+} // namespace standin
+
+template <>
+struct esio::is_row_major_layout<standin::layout_right> : std::true_type {};
+
+template <class T>
+struct esio::is_plain_accessor<standin::plain_accessor<T>>
+    : std::true_type {};
+
+static_assert(esio::strided_view<
+        standin::mdspan<double, 3, standin::layout_right>>);
+static_assert(esio::strided_view<
+        standin::mdspan<const float, 2, standin::layout_stride>>);
+static_assert(!esio::strided_view<
+        standin::mdspan<long, 1, standin::layout_right>>);
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    char * filename = NULL;
+
+    // Each rank owns contiguous planes of C for a field { C, B, A }
+    const int C = 2 * world_size, B = 3, A = 4;
+    const int cstart = 2 * world_rank, clocal = 2;
+    const std::size_t N = clocal * B * A;
+
+    FCT_FIXTURE_SUITE_BGN(cxx)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = (char *) calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+            filename = NULL;
+        }
+        FCT_TEARDOWN_END();
+
+        // Row-major, padded, permuted, and opaque views all round trip
+        FCT_TEST_BGN(views)
+        {
+            using standin::mdspan;
+            using standin::layout_right;
+            using standin::layout_stride;
+            using standin::other_accessor;
+
+            std::vector<double> f(N), g(N);
+            for (std::size_t i = 0; i < N; ++i) f[i] = cstart * B * A + i;
+            for (int c = 0; c < clocal; ++c)       // Column-major copy
+                for (int b = 0; b < B; ++b)
+                    for (int a = 0; a < A; ++a)
+                        g[c + clocal*(b + B*a)] = f[(c*B + b)*A + a];
+            std::vector<float> p(B * 2 * A);       // Padded rows
+            for (int b = 0; b < B; ++b)
+                for (int a = 0; a < A; ++a)
+                    p[b*2*A + 2*a] = 10*b + a;
+            std::vector<int> l = { 1, 2, 3, 4 };
+
+            {
+                esio::handle h(MPI_COMM_WORLD);
+                h.field_establish(C, cstart, clocal, B, 0, B, A, 0, A);
+                h.plane_establish(B, 0, B, A, 0, A);
+                h.line_establish(A, 0, A);
+
+                esio::file w = esio::file::create(h, filename, true);
+                w.write_field("right", mdspan<const double, 3, layout_right>{
+                        f.data(), { 2, 3, 4 }, { B*A, A, 1 } });
+                w.write_field("left", mdspan<double, 3, layout_stride>{
+                        g.data(), { 2, 3, 4 }, { 1, 2, 2*B } });
+                w.write_field("other", mdspan<double, 3, layout_stride,
+                                              other_accessor<double>>{
+                        f.data(), { 2, 3, 4 }, { B*A, A, 1 } });
+                w.write_plane("padded", mdspan<float, 2, layout_stride>{
+                        p.data(), { 3, 4 }, { 2*A, 2 } });
+                w.write_line("span", std::span<const int>(l));
+                w.write_field("spanned", std::span<const double>(f));
+                std::vector<float> q(B * A, 2.5f);
+                w.write_plane("spanplane", std::span<float>(q));
+                w.write_attribute("/", "step", 7);
+                w.close();
+
+                esio::file r = esio::file::open(h, filename);
+                std::vector<double> back(N), backl(N);
+                for (const char *name : { "right", "left", "other" }) {
+                    r.read_field(name, mdspan<double, 3, layout_right>{
+                            back.data(), { 2, 3, 4 }, { B*A, A, 1 } });
+                    r.read_field(name, mdspan<double, 3, layout_stride>{
+                            backl.data(), { 2, 3, 4 }, { 1, 2, 2*B } });
+                    const bool ok = back == f && backl == g;
+                    fct_chk(ok);
+                }
+                std::vector<float> pb(B * A);
+                r.read_plane("padded", mdspan<float, 2, layout_stride>{
+                        pb.data(), { 3, 4 }, { A, 1 } });
+                int mismatches = 0;
+                for (int b = 0; b < B; ++b)
+                    for (int a = 0; a < A; ++a)
+                        mismatches += pb[b*A + a] != 10*b + a;
+                fct_chk_eq_int(mismatches, 0);
+                std::vector<int> lb(A);
+                r.read_line("span", std::span<int>(lb));
+                const bool same = lb == l;
+                fct_chk(same);
+                r.read_field("spanned", std::span<double>(back));
+                const bool spanned = back == f;
+                fct_chk(spanned);
+                r.read_plane("spanplane", std::span<float>(pb));
+                const bool planed = pb == std::vector<float>(B * A, 2.5f);
+                fct_chk(planed);
+                const int step = r.read_attribute<int>("/", "step");
+                fct_chk_eq_int(step, 7);
+            }
+        }
+        FCT_TEST_END();
+
+        // Failures surface as esio::error carrying the status
+        FCT_TEST_BGN(errors)
+        {
+            esio::handle h(MPI_COMM_WORLD);
+            h.line_establish(4, 0, 4);
+            esio::file w = esio::file::create(h, filename, true);
+            std::vector<int> l(3);
+
+            int status = 0;
+            try {
+                w.write_line("short", std::span<int>(l));
+            } catch (const esio::error &e) {
+                status = e.status();
+            }
+            fct_chk_eq_int(status, ESIO_EINVAL);
+
+            status = 0;
+            esio_set_error_handler_off();
+            try {
+                w.read_attribute<int>("/", "missing");
+            } catch (const esio::error &e) {
+                status = e.status();
+            }
+            esio_set_error_handler(esio_handler);
+            fct_chk_neq_int(status, 0);
+
+            // Moved-from owners release nothing
+            esio::handle g = std::move(h);
+            esio::file v = std::move(w);
+            fct_chk(h.get() == NULL);
+            fct_chk(g.get() != NULL);
+            v.close();
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
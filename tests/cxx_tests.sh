@@ -0,0 +1,24 @@
+#!/bin/bash
+# Must use mpiexec to run serial-but-MPI-enabled tests on some MPI stacks.  In
+# particular, mvapich seems to exhibit this problem.  Moreover, we cannot
+# always use mpiexec on some login nodes.  Better to warn the user that a test
+# was skipped then worry them when make check fails as a result.
+
+if ! [ -x cxx_tests ]; then
+    echo "cxx_tests binary not found or not executable"
+    exit 1
+fi
+
+if ! which mpiexec > /dev/null ; then
+    echo "WARNING: Unable to find mpiexec; skipping cxx_tests"
+    exit 0
+fi
+
+set -e # Fail on first error
+for cmd in "mpiexec -np 1 ./cxx_tests" \
+           "mpiexec -np 2 ./cxx_tests" \
+           "mpiexec -np 3 ./cxx_tests"
+do
+    echo $cmd
+    $cmd
+done
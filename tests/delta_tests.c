@@ -0,0 +1,282 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(delta)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Chains of deltas reconstruct every snapshot bit-for-bit
+        FCT_TEST_BGN(chain)
+        {
+            // Each rank owns two C planes of a 7x9 field
+            const int cglobal = 2 * world_size, cstart = 2 * world_rank;
+            const int clocal = 2, bglobal = 7, aglobal = 9;
+            const int nelem = clocal * bglobal * aglobal;
+            double *s[3], *back = malloc(2 * nelem * sizeof(double));
+            float  *f[2];
+            fct_req(back);
+            for (int t = 0; t < 3; ++t) {
+                fct_req(s[t] = malloc(nelem * sizeof(double)));
+                for (int i = 0; i < nelem; ++i) {
+                    s[t][i] = sin(0.01 * (i + nelem * world_rank))
+                            + 1e-7 * t * cos(0.02 * i);
+                }
+            }
+            for (int t = 0; t < 2; ++t) {
+                fct_req(f[t] = malloc(nelem * sizeof(float)));
+                for (int i = 0; i < nelem; ++i) f[t][i] = (float) s[t][i];
+            }
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal, bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_write_double(
+                        state, "s0", s[0], 0, 0, 0, "key frame"));
+            fct_req(0 == esio_field_write_delta_double(
+                        state, "s1", s[1], 0, 0, 0, "s0", s[0], "delta"));
+            fct_req(0 == esio_field_write_delta_double(
+                        state, "s2", s[2], 0, 0, 0, "s1", NULL, 0));
+            fct_req(0 == esio_field_write_float(
+                        state, "f0", f[0], 0, 0, 0, 0));
+            fct_req(0 == esio_field_write_delta_float(
+                        state, "f1", f[1], 0, 0, 0, "f0", NULL, 0));
+
+            // Deltas report the size of the fields they encode
+            int c, b, a, n;
+            fct_req(0 == esio_field_sizev(state, "s2", &c, &b, &a, &n));
+            fct_chk_eq_int(c, cglobal);
+            fct_chk_eq_int(b, bglobal);
+            fct_chk_eq_int(a, aglobal);
+            fct_chk_eq_int(n, 1);
+
+            // Cycles, missing references, and unsupported reads are errors
+            esio_set_error_handler_off();
+            fct_chk(0 != esio_field_write_delta_double(
+                        state, "s0", s[0], 0, 0, 0, "s2", NULL, 0));
+            fct_chk(0 != esio_field_write_delta_double(
+                        state, "s3", s[0], 0, 0, 0, "missing", NULL, 0));
+            fct_chk(0 != esio_field_write_delta_double(
+                        state, "s0", s[0], 0, 0, 0, "s1", NULL, 0));
+            fct_chk(0 != esio_field_read_float(
+                        state, "s1", (float *) back, 0, 0, 0));
+            fct_chk(0 != esio_field_write_double(
+                        state, "s2", s[2], 0, 0, 0, 0));
+            esio_set_error_handler(esio_handler);
+            fct_req(0 == esio_file_close(state));
+
+            // Reads reconstruct exactly, including with strided buffers
+            fct_req(0 == esio_file_open(state, filename, 0));
+            for (int t = 0; t < 3; ++t) {
+                const char *names[] = { "s0", "s1", "s2" };
+                fct_req(0 == esio_field_read_double(
+                            state, names[t], back, 0, 0, 2));
+                for (int i = 0; i < nelem; ++i) {
+                    fct_chk(!memcmp(back + 2*i, s[t] + i, sizeof(double)));
+                }
+            }
+            fct_req(0 == esio_field_read_float(
+                        state, "f1", (float *) back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) {
+                fct_chk(!memcmp((float *) back + i, f[1] + i, sizeof(float)));
+            }
+            fct_req(0 == esio_file_close(state));
+
+            // Slowly evolving deltas occupy less space than the key frame
+            if (world_rank == 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                const hid_t s0_id = H5Dopen2(file_id, "s0", H5P_DEFAULT);
+                const hid_t s2_id = H5Dopen2(file_id, "s2", H5P_DEFAULT);
+                fct_req(s0_id >= 0 && s2_id >= 0);
+                fct_chk(H5Dget_storage_size(s2_id)
+                        < H5Dget_storage_size(s0_id));
+                H5Dclose(s2_id);
+                H5Dclose(s0_id);
+                H5Fclose(file_id);
+            }
+
+            for (int t = 0; t < 2; ++t) free(f[t]);
+            for (int t = 0; t < 3; ++t) free(s[t]);
+            free(back);
+        }
+        FCT_TEST_END();
+
+        // References stored at reduced precision are reread so that
+        // supplied previous values cannot disagree with what readers use
+        FCT_TEST_BGN(reduced)
+        {
+            const int cglobal = world_size, cstart = world_rank;
+            const int clocal = 1, bglobal = 5, aglobal = 6;
+            const int nelem = clocal * bglobal * aglobal;
+            double s0[30], s1[30], back[30];
+            for (int i = 0; i < nelem; ++i) {
+                s0[i] = 1 + 0.001 * (i + nelem * world_rank);
+                s1[i] = s0[i] + 1e-9 * i;
+            }
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal, bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_precision_set(state, ESIO_PRECISION_HALF));
+            fct_req(0 == esio_field_write_double(
+                        state, "k", s0, 0, 0, 0, 0));
+            fct_req(0 == esio_precision_set(state, ESIO_PRECISION_NATIVE));
+            fct_req(0 == esio_field_write_delta_double(
+                        state, "d", s1, 0, 0, 0, "k", s0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_field_read_double(state, "d", back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) {
+                fct_chk(!memcmp(back + i, s1 + i, sizeof(double)));
+            }
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
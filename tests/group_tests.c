@@ -0,0 +1,181 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include <esio/error.h>
+#include <esio/group.h>
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Count violations of esio_group_members' contract for one split
+static int members_violations(int comm_size, int ngroups)
+{
+    int violations = 0, expected_first = 0, previous = -1;
+    for (int rank = 0; rank < comm_size; ++rank) {
+        int group, first, count;
+        esio_group_members(comm_size, ngroups, rank, &group, &first, &count);
+        if (group != previous) {        // Groups are contiguous and ordered
+            violations += group != previous + 1;
+            violations += first != expected_first;
+            expected_first = first + count;
+            previous = group;
+        }
+        violations += rank < first || rank >= first + count;
+        violations += count < comm_size / ngroups;     // Nearly equal
+        violations += count > (comm_size + ngroups - 1) / ngroups;
+    }
+    violations += previous != ngroups - 1;             // None empty
+    violations += expected_first != comm_size;         // All covered
+    return violations;
+}
+
+// Count planes of C stored by no rank, or by two ranks, within each group
+static int block_violations(int comm_size, int ngroups, int cglobal)
+{
+    int violations = 0;
+    int *owners = calloc((size_t) ngroups * cglobal, sizeof(int));
+    if (owners == NULL) return -1;
+    for (int rank = 0; rank < comm_size; ++rank) {
+        int group, blk[6];
+        esio_group_block(comm_size, ngroups, rank, cglobal, 5, 7,
+                         &group, blk);
+        violations += blk[2] != 0 || blk[3] != 5;      // Whole planes
+        violations += blk[4] != 0 || blk[5] != 7;
+        for (int c = blk[0]; c < blk[0] + blk[1]; ++c) {
+            ++owners[group * cglobal + c];
+        }
+    }
+    for (int i = 0; i < ngroups * cglobal; ++i) violations += owners[i] != 1;
+    free(owners);
+    return violations;
+}
+
+FCT_BGN()
+{
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    FCT_SUITE_BGN(group)
+    {
+        // Splits of many communicator sizes into G > 1 groups
+        FCT_TEST_BGN(members)
+        {
+            for (int n = 1; n <= 17; ++n) {
+                for (int g = 1; g <= n; ++g) {
+                    const int violations = members_violations(n, g);
+                    fct_chk_eq_int(violations, 0);
+                }
+            }
+        }
+        FCT_TEST_END();
+
+        // Every group holds every plane exactly once amongst its ranks
+        FCT_TEST_BGN(blocks)
+        {
+            for (int n = 1; n <= 9; ++n) {
+                for (int g = 1; g <= n; ++g) {
+                    for (int c = 1; c <= 11; ++c) {
+                        const int violations = block_violations(n, g, c);
+                        fct_chk_eq_int(violations, 0);
+                    }
+                }
+            }
+        }
+        FCT_TEST_END();
+
+        // Each field of a batch is owned by one group during one round
+        FCT_TEST_BGN(fields)
+        {
+            const int ngroups = 3, nfields = 8;
+            int owned[8] = { 0 };
+            for (int round = 0; round < (nfields + ngroups - 1) / ngroups;
+                 ++round) {
+                for (int group = 0; group < ngroups; ++group) {
+                    const int i = esio_group_field(ngroups, round, group);
+                    if (i < nfields) ++owned[i];
+                }
+            }
+            for (int i = 0; i < nfields; ++i) fct_chk_eq_int(owned[i], 1);
+
+            char *path = esio_group_path("dir/file.h5", 12);
+            fct_req(path);
+            fct_chk_eq_str(path, "dir/file.h5.g12");
+            free(path);
+        }
+        FCT_TEST_END();
+
+        // Live communicators match the computed membership
+        FCT_TEST_BGN(split)
+        {
+            for (int g = 1; g <= world_size; ++g) {
+                MPI_Comm group_comm;
+                fct_req(0 == esio_group_split(MPI_COMM_WORLD, g,
+                                              &group_comm));
+                int group, first, count, size, rank;
+                esio_group_members(world_size, g, world_rank,
+                                   &group, &first, &count);
+                MPI_Comm_size(group_comm, &size);
+                MPI_Comm_rank(group_comm, &rank);
+                fct_chk_eq_int(size, count);
+                fct_chk_eq_int(rank, world_rank - first);
+
+                // Only members of this group share its communicator
+                int lowest = world_rank;
+                MPI_Allreduce(MPI_IN_PLACE, &lowest, 1, MPI_INT,
+                              MPI_MIN, group_comm);
+                fct_chk_eq_int(lowest, first);
+                MPI_Comm_free(&group_comm);
+            }
+
+            MPI_Comm unused;
+            fct_chk_eq_int(ESIO_EINVAL,
+                           esio_group_split(MPI_COMM_WORLD, 0, &unused));
+            fct_chk_eq_int(ESIO_EINVAL,
+                           esio_group_split(MPI_COMM_WORLD, world_size + 1,
+                                            &unused));
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
+}
+FCT_END()
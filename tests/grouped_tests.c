@@ -0,0 +1,480 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(grouped)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // New fields are dealt to groups and read back transparently
+        FCT_TEST_BGN(roundtrip)
+        {
+            const int ngroups = world_size > 1 ? 2 : 1;
+            const size_t len = strlen(filename) + 16;
+            char *subs[2];
+            for (int g = 0; g < 2; ++g) {
+                fct_req(subs[g] = malloc(len));
+                snprintf(subs[g], len, "%s.g%d", filename, g);
+            }
+
+            // Each rank owns one C plane of three 3x4 fields
+            const int bglobal = 3, aglobal = 4, nelem = bglobal * aglobal;
+            double *u = malloc(3 * nelem * sizeof(double));
+            double *back = malloc(nelem * sizeof(double));
+            fct_req(u && back);
+            for (int i = 0; i < 3 * nelem; ++i) {
+                u[i] = 3 * world_rank * nelem + i;
+            }
+            fct_req(0 == esio_field_establish(state,
+                        world_size, world_rank, 1,
+                        bglobal, 0, bglobal, aglobal, 0, aglobal));
+            fct_req(0 == esio_line_establish(state,
+                        aglobal, 0, world_rank ? 0 : aglobal));
+
+            const char * const names[3]    = { "u", "v", "w" };
+            const char * const comments[3] = { "first", NULL, "" };
+            const double * const fields[3] = { u, u + nelem, u + 2*nelem };
+            fct_req(0 == esio_file_create_grouped(state, filename, 1,
+                                                  ngroups));
+            const int bstat = esio_field_write_batch_double(
+                    state, 3, names, fields, comments);
+            fct_req(0 == bstat);
+            fct_req(0 == esio_line_write_double(state, "l", u, 0, 0));
+            fct_req(0 == esio_file_flush(state));
+
+            // Grouped files cannot be renamed as restarts
+            esio_set_error_handler_off();
+            fct_chk(ESIO_EINVAL == esio_file_close_restart(state, "r#.h5", 1));
+            esio_set_error_handler(esio_handler);
+            fct_req(0 == esio_file_close(state));
+
+            // The file links to fields held round-robin within subfiles
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                H5L_info_t info;
+                for (int i = 0; i < 3; ++i) {
+                    fct_req(0 <= H5Lget_info(file_id, names[i],
+                                             &info, H5P_DEFAULT));
+                    fct_chk(info.type == H5L_TYPE_EXTERNAL);
+                }
+                fct_req(0 <= H5Lget_info(file_id, "l", &info, H5P_DEFAULT));
+                fct_chk(info.type == H5L_TYPE_HARD);
+                H5Fclose(file_id);
+
+                const hid_t sub_id = H5Fopen(subs[0], H5F_ACC_RDONLY,
+                                             H5P_DEFAULT);
+                fct_req(sub_id >= 0);
+                const htri_t has_v = H5Lexists(sub_id, "v", H5P_DEFAULT);
+                const htri_t has_w = H5Lexists(sub_id, "w", H5P_DEFAULT);
+                fct_chk_eq_int(has_v, ngroups == 1);
+                fct_chk_eq_int(has_w, 1);
+                H5Fclose(sub_id);
+            }
+
+            // Reads and metadata queries follow the links transparently
+            fct_req(0 == esio_file_open(state, filename, 0));
+            int c, b, a;
+            fct_req(0 == esio_field_size(state, "w", &c, &b, &a));
+            fct_chk_eq_int(c, world_size);
+            fct_chk_eq_int(b, bglobal);
+            fct_chk_eq_int(a, aglobal);
+            for (int k = 0; k < 3; ++k) {
+                fct_req(0 == esio_field_read_double(state, names[k], back,
+                                                    0, 0, 0));
+                for (int i = 0; i < nelem; ++i) {
+                    fct_chk_eq_dbl(back[i], fields[k][i]);
+                }
+            }
+            fct_req(0 == esio_file_close(state));
+
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+            for (int g = 0; g < 2; ++g) {
+                if (world_rank == 0 && !preserve) unlink(subs[g]);
+                free(subs[g]);
+            }
+            free(back);
+            free(u);
+        }
+        FCT_TEST_END();
+
+        // Existing fields and ungrouped files are written field-by-field
+        FCT_TEST_BGN(rewrite)
+        {
+            const size_t len = strlen(filename) + 16;
+            char *sub = malloc(len);
+            fct_req(sub);
+            snprintf(sub, len, "%s.g0", filename);
+
+            const int nelem = 2 * 5;
+            int *u = malloc(2 * nelem * sizeof(int));
+            int *back = malloc(nelem * sizeof(int));
+            fct_req(u && back);
+            for (int i = 0; i < 2 * nelem; ++i) u[i] = world_rank * nelem + i;
+            fct_req(0 == esio_field_establish(state,
+                        world_size, world_rank, 1, 2, 0, 2, 5, 0, 5));
+            const char * const names[2] = { "u", "v" };
+            const int * const fields[2] = { u, u + nelem };
+            const int * const swapped[2] = { u + nelem, u };
+
+            // Without groups every field is stored directly
+            fct_req(0 == esio_file_create(state, filename, 1));
+            int bstat = esio_field_write_batch_int(state, 2, names,
+                                                   fields, NULL);
+            fct_req(0 == bstat);
+            fct_req(0 == esio_file_close(state));
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                H5L_info_t info;
+                fct_req(0 <= H5Lget_info(file_id, "v", &info, H5P_DEFAULT));
+                fct_chk(info.type == H5L_TYPE_HARD);
+                H5Fclose(file_id);
+            }
+
+            // Fields written earlier are overwritten in place
+            fct_req(0 == esio_file_create_grouped(state, filename, 1, 1));
+            bstat = esio_field_write_batch_int(state, 1, names, fields, NULL);
+            fct_req(0 == bstat);
+            bstat = esio_field_write_batch_int(state, 2, names, swapped, NULL);
+            fct_req(0 == bstat);
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            for (int k = 0; k < 2; ++k) {
+                fct_req(0 == esio_field_read_int(state, names[k], back,
+                                                 0, 0, 0));
+                for (int i = 0; i < nelem; ++i) {
+                    fct_chk_eq_int(back[i], swapped[k][i]);
+                }
+            }
+            fct_req(0 == esio_file_close(state));
+
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+            if (world_rank == 0 && !preserve) unlink(sub);
+            free(sub);
+            free(back);
+            free(u);
+        }
+        FCT_TEST_END();
+
+        // Subfiles are open only within batched writes so that linked
+        // accesses under the handle's communicator never reopen them
+        FCT_TEST_BGN(linked)
+        {
+            const int ngroups = world_size > 1 ? 2 : 1;
+            const int nelem = 2 * 3;
+            int u[6], back[6];
+            for (int i = 0; i < nelem; ++i) u[i] = world_rank * nelem + i;
+            fct_req(0 == esio_field_establish(state,
+                        world_size, world_rank, 1, 2, 0, 2, 3, 0, 3));
+
+            const char * const names[1]    = { "u" };
+            const char * const comments[1] = { "grouped" };
+            const int * const fields[1]    = { u };
+            fct_req(0 == esio_file_create_grouped(state, filename, 1,
+                                                  ngroups));
+            ssize_t nfiles = H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_FILE);
+            fct_chk_eq_int(nfiles, 1);
+            const int bstat = esio_field_write_batch_int(state, 1, names,
+                                                         fields, comments);
+            fct_req(0 == bstat);
+            nfiles = H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_FILE);
+            fct_chk_eq_int(nfiles, 1);
+
+            // Reads and ordinary writes before close go through the link
+            fct_req(0 == esio_field_read_int(state, "u", back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) fct_chk_eq_int(back[i], u[i]);
+            for (int i = 0; i < nelem; ++i) u[i] = -u[i];
+            fct_req(0 == esio_field_write_int(state, "u", u, 0, 0, 0, 0));
+            nfiles = H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_FILE);
+            fct_chk_eq_int(nfiles, 1);
+            fct_req(0 == esio_file_close(state));
+
+            // Comments deferred through the link reach the subfile
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_field_read_int(state, "u", back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) fct_chk_eq_int(back[i], u[i]);
+            fct_req(0 == esio_file_close(state));
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                char text[16] = "";
+                H5Oget_comment_by_name(file_id, "u", text, sizeof(text),
+                                       H5P_DEFAULT);
+                fct_chk_eq_str(text, "grouped");
+                H5Fclose(file_id);
+            }
+
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+            const size_t len = strlen(filename) + 16;
+            char *sub = malloc(len);
+            fct_req(sub);
+            for (int g = 0; g < ngroups; ++g) {
+                snprintf(sub, len, "%s.g%d", filename, g);
+                if (world_rank == 0 && !preserve) unlink(sub);
+            }
+            free(sub);
+        }
+        FCT_TEST_END();
+
+        // Closing after a batch writes the manifest without opening any
+        // subfile on one rank alone, which would hang with several ranks
+        FCT_TEST_BGN(reopen)
+        {
+            const int ngroups = world_size > 1 ? 2 : 1;
+            const int nelem = 2 * 3;
+            int u[6], v[6], back[6];
+            for (int i = 0; i < nelem; ++i) {
+                u[i] = world_rank * nelem + i;
+                v[i] = -u[i];
+            }
+            fct_req(0 == esio_field_establish(state,
+                        world_size, world_rank, 1, 2, 0, 2, 3, 0, 3));
+
+            const char * const names[2] = { "u", "v" };
+            const int * const fields[2] = { u, v };
+            fct_req(0 == esio_file_create_grouped(state, filename, 1,
+                                                  ngroups));
+            const int bstat = esio_field_write_batch_int(state, 2, names,
+                                                         fields, NULL);
+            fct_req(0 == bstat);
+            fct_req(0 == esio_file_close(state));
+            ssize_t nfiles = H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_FILE);
+            fct_chk_eq_int(nfiles, 0);
+
+            // Writable reopening and closing rewrites the manifest again
+            fct_req(0 == esio_file_open(state, filename, 1));
+            fct_req(0 == esio_file_close(state));
+            nfiles = H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_FILE);
+            fct_chk_eq_int(nfiles, 0);
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            for (int k = 0; k < 2; ++k) {
+                fct_req(0 == esio_field_read_int(state, names[k], back,
+                                                 0, 0, 0));
+                for (int i = 0; i < nelem; ++i) {
+                    fct_chk_eq_int(back[i], fields[k][i]);
+                }
+            }
+            fct_req(0 == esio_file_close(state));
+
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+            const size_t len = strlen(filename) + 16;
+            char *sub = malloc(len);
+            fct_req(sub);
+            for (int g = 0; g < ngroups; ++g) {
+                snprintf(sub, len, "%s.g%d", filename, g);
+                if (world_rank == 0 && !preserve) unlink(sub);
+            }
+            free(sub);
+        }
+        FCT_TEST_END();
+
+        // Balanced handles still write grouped batches correctly as group
+        // views must not reuse a schedule built for the whole communicator
+        FCT_TEST_BGN(balanced)
+        {
+            const int ngroups = world_size > 1 ? 2 : 1;
+            enum { C = 4, B = 3, A = 5, N = C*B*A };
+            double u[2*N], back[N];
+            for (int i = 0; i < 2*N; ++i) u[i] = i;
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+
+            // An ordinary balanced write caches the handle's schedule
+            fct_req(0 == esio_file_create_grouped(state, filename, 1,
+                                                  ngroups));
+            fct_req(0 == esio_field_balance_set(state, 1));
+            fct_req(0 == esio_field_write_double(state, "s", u, 0, 0, 0, 0));
+
+            const char * const names[2]    = { "u", "v" };
+            const double * const fields[2] = { u, u + N };
+            const int bstat = esio_field_write_batch_double(
+                    state, 2, names, fields, NULL);
+            fct_req(0 == bstat);
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            for (int k = 0; k < 2; ++k) {
+                for (int i = 0; i < N; ++i) back[i] = 0;
+                fct_req(0 == esio_field_read_double(state, names[k], back,
+                                                    0, 0, 0));
+                if (own) {
+                    for (int i = 0; i < N; ++i) {
+                        fct_chk_eq_dbl(back[i], fields[k][i]);
+                    }
+                }
+            }
+            fct_req(0 == esio_file_close(state));
+
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+            const size_t len = strlen(filename) + 16;
+            char *sub = malloc(len);
+            fct_req(sub);
+            for (int g = 0; g < ngroups; ++g) {
+                snprintf(sub, len, "%s.g%d", filename, g);
+                if (world_rank == 0 && !preserve) unlink(sub);
+            }
+            free(sub);
+        }
+        FCT_TEST_END();
+
+        // Group counts must be usable with the handle's communicator
+        FCT_TEST_BGN(invalid)
+        {
+            esio_set_error_handler_off();
+            int status = esio_file_create_grouped(state, filename, 1, 0);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            status = esio_file_create_grouped(state, filename, 1,
+                                              world_size + 1);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            esio_set_error_handler(esio_handler);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
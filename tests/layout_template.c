@@ -109,6 +109,95 @@ static const fctcl_init_t my_cl_options[] = {
     FCTCL_INIT_NULL /* Sentinel */
 };
 
+#if LAYOUT_TAG == 3
+
+// Layout 3 stores a field as bricks of edge min(global, 8) with one brick
+// per dataset row.  Rows are ordered by each brick's Morton code formed by
+// interleaving its c, b, and a brick coordinates' bits with c most
+// significant.  Bricks are ranked here by sorting codes, independently of
+// the library's counting approach.
+#define BRICK_EDGE(global) ((global) < 8 ? (global) : 8)
+
+struct brick_key {
+    unsigned long long code;
+    int k, j, i;
+};
+
+static int brick_key_compare(const void *x, const void *y)
+{
+    const unsigned long long p = ((const struct brick_key *) x)->code;
+    const unsigned long long q = ((const struct brick_key *) y)->code;
+    return (p > q) - (p < q);
+}
+
+// Compare every brick's padded contents within dataset name against the
+// field 2*(i+3)+5*(j+7)+11*(k+13)-h, where h is the component, with zero
+// padding.  Returns the number of mismatched values or -1 on error.
+static int brick_mismatches(hid_t file_id, const char *name, hid_t type_id,
+                            int cglobal, int bglobal, int aglobal,
+                            int ncomponents)
+{
+    const int ce = BRICK_EDGE(cglobal);
+    const int be = BRICK_EDGE(bglobal);
+    const int ae = BRICK_EDGE(aglobal);
+    const int cn = (cglobal + ce - 1) / ce;
+    const int bn = (bglobal + be - 1) / be;
+    const int an = (aglobal + ae - 1) / ae;
+    const size_t nbricks = (size_t) cn * bn * an;
+    const size_t brick   = (size_t) ce * be * ae * ncomponents;
+
+    struct brick_key *keys = malloc(nbricks * sizeof(struct brick_key));
+    REAL *data = malloc(nbricks * brick * sizeof(REAL));
+    if (!keys || !data || H5LTread_dataset(file_id, name, type_id, data) < 0) {
+        free(keys);
+        free(data);
+        return -1;
+    }
+
+    size_t n = 0;
+    for (int k = 0; k < cn; ++k) {
+        for (int j = 0; j < bn; ++j) {
+            for (int i = 0; i < an; ++i, ++n) {
+                keys[n].k = k; keys[n].j = j; keys[n].i = i;
+                keys[n].code = 0;
+                for (int t = 20; t >= 0; --t) {
+                    keys[n].code = (keys[n].code << 3)
+                                 | (unsigned long long) ((k >> t) & 1) << 2
+                                 | (unsigned long long) ((j >> t) & 1) << 1
+                                 | (unsigned long long) ((i >> t) & 1);
+                }
+            }
+        }
+    }
+    qsort(keys, nbricks, sizeof(struct brick_key), &brick_key_compare);
+
+    int mismatches = 0;
+    for (size_t row = 0; row < nbricks; ++row) {
+        const REAL *p = data + row * brick;
+        for (int z = 0; z < ce; ++z) {
+            for (int y = 0; y < be; ++y) {
+                for (int x = 0; x < ae; ++x) {
+                    const int k = keys[row].k * ce + z;
+                    const int j = keys[row].j * be + y;
+                    const int i = keys[row].i * ae + x;
+                    const int inside = k < cglobal && j < bglobal
+                                    && i < aglobal;
+                    for (int h = 0; h < ncomponents; ++h) {
+                        const REAL expected = inside
+                            ? (REAL) 2*(i+3)+5*(j+7)+11*(k+13)-h : 0;
+                        if (*p++ != expected) ++mismatches;
+                    }
+                }
+            }
+        }
+    }
+
+    free(keys);
+    free(data);
+    return mismatches;
+}
+
+#endif /* LAYOUT_TAG == 3 */
 
 FCT_BGN()
 {
@@ -380,20 +469,30 @@ FCT_BGN()
             if (world_rank == 0) {
                 const hid_t file_id
                     = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
-                fct_req(0 <= H5LTread_dataset(file_id, "field",
-                                              REAL_H5T, field));
-
-                REAL *p_field = field;
-                for (int k = 0; k < cglobal; ++k) {
-                    for (int j = 0; j < bglobal; ++j) {
-                        for (int i = 0; i < aglobal; ++i) {
-                            const REAL expected
-                                = (REAL) 2*(i+3)+5*(j+7)+11*(k+13);
-                            const REAL value    = *p_field++;
-                            fct_chk_eq_dbl(value, expected);
+#if LAYOUT_TAG == 3
+                // Layout 3 stores padded bricks in Morton order
+                const int mismatches = brick_mismatches(
+                        file_id, "field", REAL_H5T,
+                        cglobal, bglobal, aglobal, 1);
+                fct_chk_eq_int(mismatches, 0);
+#else
+                {
+                    fct_req(0 <= H5LTread_dataset(file_id, "field",
+                                                  REAL_H5T, field));
+
+                    REAL *p_field = field;
+                    for (int k = 0; k < cglobal; ++k) {
+                        for (int j = 0; j < bglobal; ++j) {
+                            for (int i = 0; i < aglobal; ++i) {
+                                const REAL expected
+                                    = (REAL) 2*(i+3)+5*(j+7)+11*(k+13);
+                                const REAL value    = *p_field++;
+                                fct_chk_eq_dbl(value, expected);
+                            }
                         }
                     }
                 }
+#endif
 
                 char buf[64];
                 const int bufsize = sizeof(buf)/sizeof(buf[0]);
@@ -562,23 +661,33 @@ FCT_BGN()
                     type_id = H5Tarray_create2(REAL_H5T, 1, dims);
                     fct_req(type_id >= 0);
                 }
-                fct_req(0 <= H5LTread_dataset(file_id, "vfield",
-                                              type_id, vfield));
-                if (ncomponents > 1) H5Tclose(type_id);
-
-                REAL *p_field = vfield;
-                for (int k = 0; k < cglobal; ++k) {
-                    for (int j = 0; j < bglobal; ++j) {
-                        for (int i = 0; i < aglobal; ++i) {
-                            for (int h = 0; h < ncomponents; ++h) {
-                                const REAL value = *p_field++;
-                                fct_chk_eq_dbl(
-                                    value,
-                                    (REAL) 2*(i+3)+5*(j+7)+11*(k+13)-h);
+#if LAYOUT_TAG == 3
+                // Layout 3 stores padded bricks in Morton order
+                const int mismatches = brick_mismatches(
+                        file_id, "vfield", type_id,
+                        cglobal, bglobal, aglobal, ncomponents);
+                fct_chk_eq_int(mismatches, 0);
+#else
+                {
+                    fct_req(0 <= H5LTread_dataset(file_id, "vfield",
+                                                  type_id, vfield));
+
+                    REAL *p_field = vfield;
+                    for (int k = 0; k < cglobal; ++k) {
+                        for (int j = 0; j < bglobal; ++j) {
+                            for (int i = 0; i < aglobal; ++i) {
+                                for (int h = 0; h < ncomponents; ++h) {
+                                    const REAL value = *p_field++;
+                                    fct_chk_eq_dbl(
+                                        value,
+                                        (REAL) 2*(i+3)+5*(j+7)+11*(k+13)-h);
+                                }
                             }
                         }
                     }
                 }
+#endif
+                if (ncomponents > 1) H5Tclose(type_id);
 
                 char buf[64];
                 const int bufsize = sizeof(buf)/sizeof(buf[0]);
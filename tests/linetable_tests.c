@@ -0,0 +1,312 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(linetable)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Many lines coalesce into one table per extent and type
+        FCT_TEST_BGN(roundtrip)
+        {
+            // Rank 0 owns every element of each line
+            const int n = 5, m = 7;
+            double x[3][7], back[7];
+            int k[5], kback[5];
+            for (int j = 0; j < 3; ++j) {
+                for (int i = 0; i < m; ++i) x[j][i] = 10*j + i;
+            }
+            for (int i = 0; i < n; ++i) k[i] = -i;
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_chk_eq_int(esio_line_table_get(state), 0);
+            fct_req(0 == esio_line_table_set(state, 1));
+            fct_chk_eq_int(esio_line_table_get(state), 1);
+
+            fct_req(0 == esio_line_establish(state, n, 0,
+                                             world_rank ? 0 : n));
+            fct_req(0 == esio_line_write_double(state, "a", x[0], 0, "a"));
+            fct_req(0 == esio_line_write_double(state, "b", x[2], 0, 0));
+            fct_req(0 == esio_line_write_int(state, "k", k, 0, 0));
+
+            // Staging a name again replaces its contents
+            fct_req(0 == esio_line_write_double(state, "b", x[1], 0, 0));
+
+            fct_req(0 == esio_line_establish(state, m, 0,
+                                             world_rank ? 0 : m));
+            fct_req(0 == esio_line_write_double(state, "c", x[2], 0, 0));
+
+            // Staged lines are visible by name before being written
+            int aglobal;
+            fct_req(0 == esio_line_size(state, "c", &aglobal));
+            fct_chk_eq_int(aglobal, m);
+            fct_req(0 == esio_file_close(state));
+
+            // Lines are rows of three tables rather than datasets
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                const htri_t has_a = H5Lexists(file_id, "a", H5P_DEFAULT);
+                fct_chk_eq_int(has_a, 0);
+                H5G_info_t info;
+                fct_req(0 <= H5Gget_info_by_name(file_id, "esio_line_tables",
+                                                 &info, H5P_DEFAULT));
+                fct_chk_eq_int((int) info.nlinks, 6);
+                H5Fclose(file_id);
+            }
+
+            // Reads and size queries find lines by name
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_line_size(state, "a", &aglobal));
+            fct_chk_eq_int(aglobal, n);
+            fct_req(0 == esio_line_establish(state, n, 0,
+                                             world_rank ? 0 : n));
+            fct_req(0 == esio_line_read_double(state, "a", back, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], x[0][i]);
+            }
+            fct_req(0 == esio_line_read_double(state, "b", back, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], x[1][i]);
+            }
+            fct_req(0 == esio_line_read_int(state, "k", kback, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_int(kback[i], k[i]);
+            }
+            fct_req(0 == esio_line_establish(state, m, 0,
+                                             world_rank ? 0 : m));
+            fct_req(0 == esio_line_read_double(state, "c", back, 0));
+            for (int i = 0; i < m && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], x[2][i]);
+            }
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+
+        // Rows are overwritten in place and may be read once staged
+        FCT_TEST_BGN(rewrite)
+        {
+            const int n = 4;
+            double x[4] = { 1, 2, 3, 4 }, y[8], back[8];
+            for (int i = 0; i < 2*n; ++i) y[i] = -i;
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_line_table_set(state, 1));
+            fct_req(0 == esio_line_establish(state, n, 0,
+                                             world_rank ? 0 : n));
+            fct_req(0 == esio_line_write_double(state, "x", x, 0, 0));
+            fct_req(0 == esio_line_write_double(state, "y", x, 0, 0));
+
+            // Reading writes staged lines beforehand
+            fct_req(0 == esio_line_read_double(state, "x", back, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], x[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+
+            // Existing rows are overwritten with a strided source even
+            // once new lines again become ordinary datasets
+            fct_req(0 == esio_file_open(state, filename, 1));
+            fct_req(0 == esio_line_table_set(state, 0));
+            fct_req(0 == esio_line_establish(state, n, 0,
+                                             world_rank ? 0 : n));
+            fct_req(0 == esio_line_write_double(state, "y", y, 2, 0));
+            fct_req(0 == esio_line_write_double(state, "z", x, 0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_line_read_double(state, "y", back, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], y[2*i]);
+            }
+            fct_req(0 == esio_line_read_double(state, "x", back, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], x[i]);
+            }
+            fct_req(0 == esio_line_read_double(state, "z", back, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], x[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                const htri_t has_z = H5Lexists(file_id, "z", H5P_DEFAULT);
+                fct_chk_eq_int(has_z, 1);
+                H5Fclose(file_id);
+            }
+        }
+        FCT_TEST_END();
+
+        // Changing only some ranks' decompositions writes staged lines first
+        FCT_TEST_BGN(redecompose)
+        {
+            const int n = 6;
+            double x[6] = { 1, 2, 3, 4, 5, 6 }, back[6];
+            const int last = (world_rank == world_size - 1);
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_line_table_set(state, 1));
+            fct_req(0 == esio_line_establish(state, n, 0,
+                                             world_rank ? 0 : n));
+            fct_req(0 == esio_line_write_double(state, "a", x, 0, 0));
+            fct_req(0 == esio_line_establish(state, n, 0, last ? n : 0));
+            fct_req(0 == esio_line_write_double(state, "b", x, 0, 0));
+            fct_req(0 == esio_file_flush(state));
+
+            // Both lines are read back under the latter decomposition
+            static const char * const names[] = { "a", "b" };
+            for (int k = 0; k < 2; ++k) {
+                for (int i = 0; i < n; ++i) back[i] = 0;
+                fct_req(0 == esio_line_read_double(state, names[k], back, 0));
+                for (int i = 0; i < n && last; ++i) {
+                    fct_chk_eq_dbl(back[i], x[i]);
+                }
+            }
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
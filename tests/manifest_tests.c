@@ -0,0 +1,388 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+#include <esio/manifest.h>
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(manifest)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Manifests describe every field, plane, and line written
+        FCT_TEST_BGN(contents)
+        {
+            // Each rank owns two C planes of a 5x6 field
+            const int cglobal = 2 * world_size, cstart = 2 * world_rank;
+            const int clocal = 2, bglobal = 5, aglobal = 6;
+            const int nelem = clocal * bglobal * aglobal;
+            double *field = malloc(2 * nelem * sizeof(double));
+            double *back  = malloc(2 * nelem * sizeof(double));
+            fct_req(field && back);
+            for (int i = 0; i < 2 * nelem; ++i) field[i] = i + world_rank;
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal, bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_plane_establish(state,
+                        bglobal, 0, bglobal, aglobal, 0, aglobal));
+            fct_req(0 == esio_line_establish(state, aglobal, 0, aglobal));
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_write_double(
+                        state, "field0", field, 0, 0, 0, 0));
+            fct_req(0 == esio_field_layout_set(state, 2));
+            fct_req(0 == esio_field_writev_double(
+                        state, "field2", field, 0, 0, 0, 2, 0));
+            fct_req(0 == esio_field_layout_set(state, 0));
+            fct_req(0 == esio_plane_write_float(
+                        state, "plane", (float *) field, 0, 0, 0));
+            fct_req(0 == esio_line_write_int(
+                        state, "line", (int *) field, 0, 0));
+            fct_req(0 == esio_attribute_write_int(
+                        state, "/", "attribute", (int *) field));
+            fct_req(0 == esio_file_close(state));
+
+            // Inspect the manifest directly
+            {
+                const hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+                fct_req(fapl_id >= 0);
+                fct_req(0 <= H5Pset_fapl_mpio(fapl_id, MPI_COMM_WORLD,
+                                              MPI_INFO_NULL));
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              fapl_id);
+                fct_req(file_id >= 0);
+                H5Pclose(fapl_id);
+
+                struct esio_manifest *m = NULL;
+                fct_req(0 == esio_manifest_read(file_id, MPI_COMM_WORLD, &m));
+                fct_req(m);
+                fct_chk_eq_int(m->n, 4);
+                for (size_t i = 1; i < m->n; ++i) {
+                    fct_chk(m->entries[i-1].hash <= m->entries[i].hash);
+                }
+
+                const struct esio_manifest_entry *e;
+                fct_req(e = esio_manifest_find(m, "field0"));
+                fct_chk_eq_int(e->kind,         ESIO_MANIFEST_FIELD);
+                fct_chk_eq_int(e->layout_index, 0);
+                fct_chk_eq_int(e->cglobal,      cglobal);
+                fct_chk_eq_int(e->bglobal,      bglobal);
+                fct_chk_eq_int(e->aglobal,      aglobal);
+                fct_chk_eq_int(e->ncomponents,  1);
+                fct_chk_eq_int(e->type_class,   H5T_FLOAT);
+                fct_chk_eq_int(e->type_size,    sizeof(double));
+                fct_chk(e->offset != UINT64_MAX);
+                fct_chk(e->hash == esio_manifest_hash("field0"));
+
+                fct_req(e = esio_manifest_find(m, "field2"));
+                fct_chk_eq_int(e->kind,         ESIO_MANIFEST_FIELD);
+                fct_chk_eq_int(e->layout_index, 2);
+                fct_chk_eq_int(e->cglobal,      cglobal);
+                fct_chk_eq_int(e->bglobal,      bglobal);
+                fct_chk_eq_int(e->aglobal,      aglobal);
+                fct_chk_eq_int(e->ncomponents,  2);
+
+                fct_req(e = esio_manifest_find(m, "plane"));
+                fct_chk_eq_int(e->kind,         ESIO_MANIFEST_PLANE);
+                fct_chk_eq_int(e->bglobal,      bglobal);
+                fct_chk_eq_int(e->aglobal,      aglobal);
+                fct_chk_eq_int(e->type_size,    sizeof(float));
+
+                fct_req(e = esio_manifest_find(m, "line"));
+                fct_chk_eq_int(e->kind,         ESIO_MANIFEST_LINE);
+                fct_chk_eq_int(e->aglobal,      aglobal);
+                fct_chk_eq_int(e->type_class,   H5T_INTEGER);
+
+                fct_chk(!esio_manifest_find(m, "attribute"));
+                fct_chk(!esio_manifest_find(m, "missing"));
+                fct_chk(!esio_manifest_find(m, ESIO_MANIFEST_NAME));
+                esio_manifest_free(m);
+
+                H5Fclose(file_id);
+            }
+
+            // Reading via the manifest agrees with what was written
+            int c, b, a, n;
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_field_sizev(state, "field2", &c, &b, &a, &n));
+            fct_chk_eq_int(c, cglobal);
+            fct_chk_eq_int(b, bglobal);
+            fct_chk_eq_int(a, aglobal);
+            fct_chk_eq_int(n, 2);
+            fct_req(0 == esio_plane_size(state, "plane", &b, &a));
+            fct_chk_eq_int(b, bglobal);
+            fct_chk_eq_int(a, aglobal);
+            fct_req(0 == esio_line_size(state, "line", &a));
+            fct_chk_eq_int(a, aglobal);
+            fct_chk_eq_int(ESIO_NOTFOUND,
+                           esio_field_size(state, "missing", &c, &b, &a));
+            fct_req(0 == esio_field_readv_double(
+                        state, "field2", back, 0, 0, 0, 2));
+            for (int i = 0; i < 2 * nelem; ++i) {
+                fct_chk_eq_dbl(back[i], field[i]);
+            }
+            fct_req(0 == esio_field_read_double(
+                        state, "field0", back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) {
+                fct_chk_eq_dbl(back[i], field[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+
+            free(back);
+            free(field);
+        }
+        FCT_TEST_END();
+
+        // Files lacking a manifest fall back to per-object metadata and
+        // gain a manifest when next closed after being opened for writing
+        FCT_TEST_BGN(fallback)
+        {
+            const int aglobal = 7;
+            int line[7] = { 1, 2, 3, 4, 5, 6, 7 }, back[7];
+            fct_req(0 == esio_line_establish(state, aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_line_write_int(state, "old", line, 0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            // Remove the manifest using plain HDF5
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDWR,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                fct_req(0 <= H5Ldelete(file_id, ESIO_MANIFEST_NAME,
+                                       H5P_DEFAULT));
+                H5Fclose(file_id);
+            }
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD));
+
+            int a;
+            fct_req(0 == esio_file_open(state, filename, 1));
+            fct_req(0 == esio_line_size(state, "old", &a));
+            fct_chk_eq_int(a, aglobal);
+            fct_req(0 == esio_line_write_int(state, "new", line, 0, 0));
+            fct_req(0 == esio_line_size(state, "new", &a));
+            fct_chk_eq_int(a, aglobal);
+            fct_req(0 == esio_file_close(state));
+
+            // Names added after opening appear in the rewritten manifest
+            fct_req(0 == esio_file_open(state, filename, 1));
+            fct_req(0 == esio_line_write_int(state, "newer", line, 0, 0));
+            fct_req(0 == esio_file_close(state));
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_line_read_int(state, "newer", back, 0));
+            for (int i = 0; i < aglobal; ++i) fct_chk_eq_int(back[i], line[i]);
+            fct_req(0 == esio_file_close(state));
+
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                hsize_t dims[1];
+                fct_req(0 <= H5LTget_dataset_info(file_id, ESIO_MANIFEST_NAME,
+                                                  dims, NULL, NULL));
+                fct_chk_eq_int(dims[0], 3);
+                H5Fclose(file_id);
+            }
+        }
+        FCT_TEST_END();
+
+        // Repeatedly closing a writable file rewrites the manifest in place
+        // rather than leaking the space held by the previous one
+        FCT_TEST_BGN(inplace)
+        {
+            const int aglobal = 5;
+            int line[5] = { 1, 2, 3, 4, 5 };
+            fct_req(0 == esio_line_establish(state, aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_line_write_int(state, "a_longer_name", line,
+                                             0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            // Shorter names and fewer rows reuse the existing dataset
+            off_t sizes[4] = { 0, 0, 0, 0 };
+            for (int k = 0; k < 4; ++k) {
+                fct_req(0 == esio_file_open(state, filename, 1));
+                if (k == 0) {
+                    fct_req(0 == esio_line_write_int(state, "b", line, 0, 0));
+                }
+                fct_req(0 == esio_file_close(state));
+                struct stat st;
+                if (world_rank == 0 && 0 == stat(filename, &st)) {
+                    sizes[k] = st.st_size;
+                }
+            }
+            if (world_rank == 0) {
+                fct_chk(sizes[0] > 0);
+                for (int k = 1; k < 4; ++k) {
+                    fct_chk_eq_int((int) sizes[k], (int) sizes[0]);
+                }
+
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                const hid_t dset_id = H5Dopen2(file_id, ESIO_MANIFEST_NAME,
+                                               H5P_DEFAULT);
+                fct_req(dset_id >= 0);
+                const hid_t dcpl_id  = H5Dget_create_plist(dset_id);
+                const hid_t space_id = H5Dget_space(dset_id);
+                const H5D_layout_t layout = H5Pget_layout(dcpl_id);
+                fct_chk(layout == H5D_CHUNKED);
+                hsize_t dims[1], maxdims[1];
+                fct_req(1 == H5Sget_simple_extent_dims(space_id,
+                                                       dims, maxdims));
+                fct_chk_eq_int(dims[0], 2);
+                fct_chk(maxdims[0] == H5S_UNLIMITED);
+                H5Sclose(space_id);
+                H5Pclose(dcpl_id);
+                H5Dclose(dset_id);
+                H5Fclose(file_id);
+            }
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            int a;
+            fct_req(0 == esio_line_size(state, "b", &a));
+            fct_chk_eq_int(a, aglobal);
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
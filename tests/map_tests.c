@@ -0,0 +1,254 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(map)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Contiguous fields are walked in place by a single-rank reader
+        FCT_TEST_BGN(readonly)
+        {
+            enum { C = 2, B = 3, A = 4, N = C*B*A };
+            double x[N], v[2*N];
+            for (int i = 0; i < N; ++i) {
+                x[i]       = i;
+                v[2*i]     = -i;
+                v[2*i + 1] = 100 + i;
+            }
+
+            // Rank 0 owns the entire field
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_field_write_double(state, "x", x, 0, 0, 0, 0));
+            fct_req(0 == esio_field_writev_double(state, "v", v,
+                                                  0, 0, 0, 2, 0));
+            fct_req(0 == esio_file_close(state));
+
+            if (world_rank == 0) {
+                esio_handle s = esio_handle_initialize(MPI_COMM_SELF);
+                fct_req(s);
+                fct_req(0 == esio_file_open(s, filename, 0));
+
+                const double *px = NULL;
+                int cstride, bstride, astride;
+                fct_req(0 == esio_field_map_readonly_double(s, "x", &px,
+                                                            &cstride,
+                                                            &bstride,
+                                                            &astride));
+                fct_chk_eq_int(cstride, B*A);
+                fct_chk_eq_int(bstride, A);
+                fct_chk_eq_int(astride, 1);
+                for (int c = 0; c < C; ++c)
+                    for (int b = 0; b < B; ++b)
+                        for (int a = 0; a < A; ++a)
+                            fct_chk_eq_dbl(
+                                px[c*cstride + b*bstride + a*astride],
+                                x[(c*B + b)*A + a]);
+
+                // Vector components are adjacent
+                const double *pv = NULL;
+                fct_req(0 == esio_field_map_readonly_double(s, "v", &pv,
+                                                            &cstride,
+                                                            &bstride,
+                                                            &astride));
+                fct_chk_eq_int(astride, 2);
+                for (int i = 0; i < 2*N; ++i) fct_chk_eq_dbl(pv[i], v[i]);
+
+                // Mappings outlive the file
+                fct_req(0 == esio_file_close(s));
+                fct_chk_eq_dbl(px[N - 1], x[N - 1]);
+                fct_req(0 == esio_field_unmap(s, px));
+
+                // Remaining mappings are released by finalization
+                esio_handle_finalize(s);
+            }
+        }
+        FCT_TEST_END();
+
+        // Fields not stored verbatim and contiguously are rejected
+        FCT_TEST_BGN(invalid)
+        {
+            enum { C = 2, B = 2, A = 2, N = C*B*A };
+            double x[N] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            fct_req(0 == esio_field_write_double(state, "x", x, 0, 0, 0, 0));
+            fct_req(0 == esio_field_layout_set(state, 3));
+            fct_req(0 == esio_field_write_double(state, "m", x, 0, 0, 0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            if (world_rank == 0) {
+                esio_handle s = esio_handle_initialize(MPI_COMM_SELF);
+                fct_req(s);
+                fct_req(0 == esio_file_open(s, filename, 0));
+
+                H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+                esio_set_error_handler_off();
+                const double *pd = NULL;
+                const float  *pf = NULL;
+                const int morton = esio_field_map_readonly_double(
+                        s, "m", &pd, NULL, NULL, NULL);
+                fct_chk_eq_int(morton, ESIO_EINVAL);
+                const int mismatch = esio_field_map_readonly_float(
+                        s, "x", &pf, NULL, NULL, NULL);
+                fct_chk_eq_int(mismatch, ESIO_EINVAL);
+                const int missing = esio_field_map_readonly_double(
+                        s, "y", &pd, NULL, NULL, NULL);
+                fct_chk_eq_int(missing, ESIO_NOTFOUND);
+                const int unmapped = esio_field_unmap(s, x);
+                fct_chk_eq_int(unmapped, ESIO_EINVAL);
+
+                fct_req(0 == esio_file_close(s));
+                esio_handle_finalize(s);
+            }
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
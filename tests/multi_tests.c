@@ -0,0 +1,257 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(multi)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Datasets spread across targets and read back transparently
+        FCT_TEST_BGN(roundtrip)
+        {
+            // Rank 0 creates two target directories beside the file
+            const size_t len = strlen(filename) + 8;
+            char *dirs[2], *subs[2];
+            const char *base = strrchr(filename, '/');
+            base = base ? base + 1 : filename;
+            for (int k = 0; k < 2; ++k) {
+                fct_req(dirs[k] = malloc(len));
+                fct_req(subs[k] = malloc(2 * len));
+                snprintf(dirs[k], len, "%s.t%d", filename, k);
+                snprintf(subs[k], 2 * len, "%s/%s.%d", dirs[k], base, k);
+                if (world_rank == 0) {
+                    fct_req(0 == mkdir(dirs[k], 0700));
+                }
+            }
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+
+            // Each rank owns one C plane of a pair of 3x4 fields
+            const int bglobal = 3, aglobal = 4, nelem = bglobal * aglobal;
+            double *u = malloc(nelem * sizeof(double));
+            double *v = malloc(nelem * sizeof(double));
+            double *back = malloc(nelem * sizeof(double));
+            fct_req(u && v && back);
+            for (int i = 0; i < nelem; ++i) {
+                u[i] = world_rank * nelem + i;
+                v[i] = -u[i];
+            }
+            fct_req(0 == esio_field_establish(state,
+                        world_size, world_rank, 1,
+                        bglobal, 0, bglobal, aglobal, 0, aglobal));
+            fct_req(0 == esio_line_establish(state,
+                        aglobal, 0, world_rank ? 0 : aglobal));
+
+            const char * const targets[2] = { dirs[0], dirs[1] };
+            fct_req(0 == esio_file_create_multi(state, filename, 1,
+                                                2, targets));
+            fct_req(0 == esio_field_write_double(state, "u", u, 0, 0, 0, 0));
+            fct_req(0 == esio_field_write_double(state, "v", v, 0, 0, 0, 0));
+            fct_req(0 == esio_line_write_double(state, "l", u, 0, 0));
+            const int fortytwo = 42;
+            fct_req(0 == esio_attribute_write_int(state, "u", "step",
+                                                  &fortytwo));
+            fct_req(0 == esio_file_flush(state));
+
+            // Multi-target files cannot be renamed as restarts
+            esio_set_error_handler_off();
+            fct_chk(ESIO_EINVAL == esio_file_close_restart(state, "r#.h5", 1));
+            esio_set_error_handler(esio_handler);
+            fct_req(0 == esio_file_close(state));
+
+            // The file holds only links while subfiles hold the data
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                const char *names[] = { "u", "v", "l" };
+                for (int i = 0; i < 3; ++i) {
+                    H5L_info_t info;
+                    fct_req(0 <= H5Lget_info(file_id, names[i],
+                                             &info, H5P_DEFAULT));
+                    fct_chk(info.type == H5L_TYPE_EXTERNAL);
+                }
+                H5Fclose(file_id);
+
+                // Equally sized fields landed on different targets
+                for (int k = 0; k < 2; ++k) {
+                    const hid_t sub_id = H5Fopen(subs[k], H5F_ACC_RDONLY,
+                                                 H5P_DEFAULT);
+                    fct_req(sub_id >= 0);
+                    fct_chk_eq_int(H5Lexists(sub_id, k ? "v" : "u",
+                                             H5P_DEFAULT), 1);
+                    fct_chk_eq_int(H5Lexists(sub_id, k ? "u" : "v",
+                                             H5P_DEFAULT), 0);
+                    H5Fclose(sub_id);
+                }
+            }
+
+            // Reads and metadata queries follow the links transparently
+            fct_req(0 == esio_file_open(state, filename, 0));
+            int c, b, a, step;
+            fct_req(0 == esio_field_size(state, "v", &c, &b, &a));
+            fct_chk_eq_int(c, world_size);
+            fct_chk_eq_int(b, bglobal);
+            fct_chk_eq_int(a, aglobal);
+            fct_req(0 == esio_attribute_read_int(state, "u", "step", &step));
+            fct_chk_eq_int(step, 42);
+            fct_req(0 == esio_field_read_double(state, "u", back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) fct_chk_eq_dbl(back[i], u[i]);
+            fct_req(0 == esio_field_read_double(state, "v", back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) fct_chk_eq_dbl(back[i], v[i]);
+            fct_req(0 == esio_file_close(state));
+
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+            for (int k = 0; k < 2; ++k) {
+                if (world_rank == 0 && !preserve) {
+                    unlink(subs[k]);
+                    rmdir(dirs[k]);
+                }
+                free(subs[k]);
+                free(dirs[k]);
+            }
+            free(back);
+            free(v);
+            free(u);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
@@ -0,0 +1,298 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+#include "../esio/parity.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(parity)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Treating every rank as its own node, groups span all ranks
+        FCT_TEST_BGN(group)
+        {
+            MPI_Comm group;
+            int size, rank;
+            fct_req(0 == esio_parity_group(MPI_COMM_WORLD, MPI_COMM_SELF,
+                                           world_size, &group));
+            MPI_Comm_size(group, &size);
+            MPI_Comm_rank(group, &rank);
+            fct_chk_eq_int(size, world_size);
+            fct_chk_eq_int(rank, world_rank);
+            MPI_Comm_free(&group);
+
+            // Ranks sharing one node never share a group
+            fct_req(0 == esio_parity_group(MPI_COMM_WORLD, MPI_COMM_WORLD,
+                                           2, &group));
+            MPI_Comm_size(group, &size);
+            fct_chk_eq_int(size, 1);
+            MPI_Comm_free(&group);
+        }
+        FCT_TEST_END();
+
+        // A lost file is recreated bit-for-bit from the survivors
+        FCT_TEST_BGN(rebuild)
+        {
+            const size_t len = strlen(filename) + 16;
+            char *local  = malloc(len);
+            char *parity = malloc(len);
+            fct_req(local && parity);
+            snprintf(local,  len, "%s.r%d", filename, world_rank);
+            snprintf(parity, len, "%s.p%d", filename, world_rank);
+
+            // Each rank writes an ESIO file of a different size
+            const int aglobal = 100 + 37 * world_rank;
+            double *line = malloc(aglobal * sizeof(double));
+            fct_req(line);
+            for (int i = 0; i < aglobal; ++i) line[i] = world_rank + 0.5 * i;
+            esio_handle self = esio_handle_initialize(MPI_COMM_SELF);
+            fct_req(self);
+            fct_req(0 == esio_line_establish(self, aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(self, local, 1));
+            fct_req(0 == esio_line_write_double(self, "l", line, 0, 0));
+            fct_req(0 == esio_file_close(self));
+
+            FILE *f = fopen(local, "rb");
+            fct_req(f);
+            fseek(f, 0, SEEK_END);
+            const long nbytes = ftell(f);
+            fseek(f, 0, SEEK_SET);
+            char *expected = malloc(nbytes), *actual = malloc(nbytes);
+            fct_req(expected && actual);
+            fct_req(fread(expected, 1, nbytes, f) == (size_t) nbytes);
+            fclose(f);
+
+            MPI_Comm group;
+            fct_req(0 == esio_parity_group(MPI_COMM_WORLD, MPI_COMM_SELF,
+                                           world_size, &group));
+            fct_req(0 == esio_parity_encode_group(group, local, parity));
+
+            // Nothing lost means nothing to do
+            int rebuilt = -1;
+            fct_req(0 == esio_parity_rebuild_group(group, local, parity,
+                                                   &rebuilt));
+            fct_chk_eq_int(rebuilt, 0);
+
+            // The last rank loses its node
+            const int victim = world_size - 1;
+            if (world_rank == victim) {
+                unlink(local);
+                unlink(parity);
+            }
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+            const int status = esio_parity_rebuild_group(group, local, parity,
+                                                         &rebuilt);
+            if (world_size == 1) {
+                // A lone member has no survivors to rebuild from
+                fct_chk_neq_int(status, 0);
+            } else {
+                fct_req(0 == status);
+                fct_chk_eq_int(rebuilt, world_rank == victim);
+                f = fopen(local, "rb");
+                fct_req(f);
+                fct_req(fread(actual, 1, nbytes, f) == (size_t) nbytes);
+                fct_chk(fgetc(f) == EOF);
+                fclose(f);
+                fct_chk(!memcmp(expected, actual, nbytes));
+
+                // The recreated file is a readable ESIO file
+                fct_req(0 == esio_file_open(self, local, 0));
+                fct_req(0 == esio_line_read_double(self, "l", line, 0));
+                fct_chk_eq_dbl(line[aglobal - 1],
+                               world_rank + 0.5 * (aglobal - 1));
+                fct_req(0 == esio_file_close(self));
+
+                // Losing two members of one group is unrecoverable
+                if (world_rank == victim || world_rank == 0) unlink(local);
+                ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+                fct_chk_neq_int(0, esio_parity_rebuild_group(
+                            group, local, parity, &rebuilt));
+            }
+            MPI_Comm_free(&group);
+
+            esio_handle_finalize(self);
+            if (!preserve) {
+                unlink(local);
+                unlink(parity);
+            }
+            free(actual);
+            free(expected);
+            free(line);
+            free(parity);
+            free(local);
+        }
+        FCT_TEST_END();
+
+        // The public interface groups ranks by node and refuses groups
+        // which could not survive losing one
+        FCT_TEST_BGN(public)
+        {
+            const size_t len = strlen(filename) + 16;
+            char *local  = malloc(len);
+            char *parity = malloc(len);
+            fct_req(local && parity);
+            snprintf(local,  len, "%s.r%d", filename, world_rank);
+            snprintf(parity, len, "%s.p%d", filename, world_rank);
+            FILE *f = fopen(local, "wb");
+            fct_req(f);
+            fprintf(f, "rank %d", world_rank);
+            fclose(f);
+
+            // Every test rank shares one node so no group spans two
+            esio_set_error_handler_off();
+            const int encoded = esio_parity_encode(state, local, parity, 2);
+            const int rebuilt = esio_parity_rebuild(state, local, parity, 2);
+            fct_chk_eq_int(ESIO_EINVAL, encoded);
+            fct_chk_eq_int(ESIO_EINVAL, rebuilt);
+            fct_chk(0 != access(parity, F_OK));
+            fct_chk_eq_int(ESIO_EINVAL,
+                           esio_parity_encode(state, local, parity, 1));
+            esio_set_error_handler(esio_handler);
+
+            if (!preserve) {
+                unlink(local);
+                unlink(parity);
+            }
+            free(parity);
+            free(local);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
@@ -0,0 +1,307 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+#include <esio/precision.h>
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(precision)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Check conversion kernels against hand-computed rounding cases
+        FCT_TEST_BGN(kernels)
+        {
+            const float in[] = {
+                1.0f, -2.0f, 65504.0f, 65520.0f, ldexpf(1, -24),
+                ldexpf(1, -25), 3*ldexpf(1, -25), 1 + ldexpf(1, -11),
+                1 + 3*ldexpf(1, -11), INFINITY
+            };
+            const uint16_t half[] = {
+                0x3c00, 0xc000, 0x7bff, 0x7c00, 0x0001,
+                0x0000, 0x0002, 0x3c00,
+                0x3c02, 0x7c00
+            };
+            const size_t n = sizeof(in)/sizeof(in[0]);
+            uint16_t out[sizeof(in)/sizeof(in[0])];
+            esio_convert_float_half(in, out, n);
+            for (size_t i = 0; i < n; ++i) fct_chk_eq_int(out[i], half[i]);
+
+            // Every binary16 value survives a round trip through float
+            // and the widening kernel works in place
+            static float buf[65536];
+            uint16_t *h = (uint16_t *) buf;
+            for (int i = 0; i < 65536; ++i) h[i] = (uint16_t) i;
+            esio_convert_half_float(h, buf, 65536);
+            uint16_t back;
+            int mismatches = 0;
+            for (int i = 0; i < 65536; ++i) {
+                if (isnan(buf[i])) continue;
+                esio_convert_float_half(buf + i, &back, 1);
+                mismatches += back != i;
+            }
+            fct_chk_eq_int(mismatches, 0);
+
+            const float bin[] = {
+                1.0f, 1 + ldexpf(1, -8), 1 + 3*ldexpf(1, -8), -0.5f
+            };
+            const uint16_t bf16[] = { 0x3f80, 0x3f80, 0x3f82, 0xbf00 };
+            esio_convert_float_bfloat16(bin, out, 4);
+            for (size_t i = 0; i < 4; ++i) fct_chk_eq_int(out[i], bf16[i]);
+            float bout[4];
+            esio_convert_bfloat16_float(out, bout, 4);
+            fct_chk_eq_dbl(bout[0], 1.0);
+            fct_chk_eq_dbl(bout[2], 1 + 4*ldexpf(1, -8));
+            fct_chk_eq_dbl(bout[3], -0.5);
+        }
+        FCT_TEST_END();
+
+        // Round trip fields and planes through each reduced precision
+        FCT_TEST_BGN(roundtrip)
+        {
+            const int precisions[] = {
+                ESIO_PRECISION_HALF, ESIO_PRECISION_BFLOAT16
+            };
+            const double tolerance[] = { ldexp(1, -11), ldexp(1, -8) };
+
+            // Each rank owns two C planes of a 5x6 field
+            const int cglobal = 2 * world_size, cstart = 2 * world_rank;
+            const int clocal = 2, bglobal = 5, aglobal = 6;
+            const int nelem = clocal * bglobal * aglobal;
+            double *field = malloc(3 * nelem * sizeof(double));
+            double *back  = malloc(3 * nelem * sizeof(double));
+            float  *fback = malloc(nelem * sizeof(float));
+            int    *ints  = malloc(nelem * sizeof(int));
+            fct_req(field && back && fback && ints);
+            for (int i = 0; i < 3 * nelem; ++i) {
+                field[i] = (1 + i % 7) * M_PI * pow(-10, i % 3 - 1)
+                         + world_rank;
+            }
+            for (int i = 0; i < nelem; ++i) ints[i] = 100000 + i;
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal, bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_plane_establish(state,
+                        bglobal, 0, bglobal, aglobal, 0, aglobal));
+
+            for (int p = 0; p < 2; ++p) {
+                fct_req(0 == esio_file_create(state, filename, 1));
+                fct_chk_eq_int(esio_precision_get(state),
+                               ESIO_PRECISION_NATIVE);
+                fct_req(0 == esio_precision_set(state, precisions[p]));
+                fct_chk_eq_int(esio_precision_get(state), precisions[p]);
+
+                fct_req(0 == esio_field_write_double(
+                            state, "field", field, 0, 0, 0, "comment"));
+                fct_req(0 == esio_field_writev_double(
+                            state, "vfield", field, 0, 0, 0, 3, 0));
+                fct_req(0 == esio_plane_write_double(
+                            state, "plane", field, 0, 0, 0));
+                fct_req(0 == esio_field_write_int(
+                            state, "ints", ints, 0, 0, 0, 0));
+                fct_req(0 == esio_precision_set(state,
+                                                ESIO_PRECISION_NATIVE));
+                fct_req(0 == esio_file_close(state));
+
+                // Check stored type sizes using normal HDF5 APIs
+                if (world_rank == 0) {
+                    const hid_t file_id
+                        = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+                    fct_req(file_id >= 0);
+                    const char *names[] = { "field", "plane", "ints" };
+                    const size_t sizes[] = { 2, 2, sizeof(int) };
+                    for (int i = 0; i < 3; ++i) {
+                        const hid_t dset_id = H5Dopen2(file_id, names[i],
+                                                       H5P_DEFAULT);
+                        const hid_t type_id = H5Dget_type(dset_id);
+                        fct_chk_eq_int(H5Tget_size(type_id), sizes[i]);
+                        H5Tclose(type_id);
+                        H5Dclose(dset_id);
+                    }
+                    fct_req(0 <= H5Fclose(file_id));
+                }
+
+                // Read back using ESIO as double and float
+                fct_req(0 == esio_file_open(state, filename, 0));
+                fct_req(0 == esio_field_read_double(
+                            state, "field", back, 0, 0, 0));
+                fct_req(0 == esio_field_read_float(
+                            state, "field", fback, 0, 0, 0));
+                for (int i = 0; i < nelem; ++i) {
+                    fct_chk(fabs(back[i] - field[i])
+                            <= tolerance[p] * fabs(field[i]));
+                    fct_chk_eq_dbl(fback[i], back[i]);
+                }
+                fct_req(0 == esio_field_readv_double(
+                            state, "vfield", back, 0, 0, 0, 3));
+                for (int i = 0; i < 3 * nelem; ++i) {
+                    fct_chk(fabs(back[i] - field[i])
+                            <= tolerance[p] * fabs(field[i]));
+                }
+                fct_req(0 == esio_plane_read_double(
+                            state, "plane", back, 0, 0));
+                for (int i = 0; i < bglobal * aglobal; ++i) {
+                    fct_chk(fabs(back[i] - field[i])
+                            <= tolerance[p] * fabs(field[i]));
+                }
+                fct_req(0 == esio_field_read_int(
+                            state, "ints", (int *) back, 0, 0, 0));
+                for (int i = 0; i < nelem; ++i) {
+                    fct_chk_eq_int(((int *) back)[i], ints[i]);
+                }
+                fct_req(0 == esio_file_close(state));
+            }
+
+            // Unknown precisions are rejected
+            esio_set_error_handler_off();
+            fct_chk(0 != esio_precision_set(state, 3));
+            esio_set_error_handler(esio_handler);
+
+            free(ints);
+            free(fback);
+            free(back);
+            free(field);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
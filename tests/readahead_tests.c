@@ -0,0 +1,238 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <hdf5_hl.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+#include <esio/readahead.h>
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(readahead)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Byte ranges cover exactly the local block in row-major order
+        FCT_TEST_BGN(ranges)
+        {
+            uint64_t r[8];
+
+            // Whole planes coalesce
+            fct_chk_eq_int(1, esio_readahead_ranges(100, 8,
+                        4, 1, 2, 3, 0, 3, 5, 0, 5, r));
+            fct_chk(r[0] == 100 + 1*15*8);
+            fct_chk(r[1] == 2*15*8);
+
+            // Partial planes produce one range per plane
+            fct_chk_eq_int(2, esio_readahead_ranges(0, 4,
+                        4, 2, 2, 3, 1, 2, 5, 1, 3, r));
+            fct_chk(r[0] == (2*15 + 1*5 + 1)*4);
+            fct_chk(r[1] == (1*5 + 3)*4);
+            fct_chk(r[2] == (3*15 + 1*5 + 1)*4);
+            fct_chk(r[3] == (1*5 + 3)*4);
+
+            // Empty blocks produce nothing
+            fct_chk_eq_int(0, esio_readahead_ranges(0, 4,
+                        4, 0, 0, 3, 0, 3, 5, 0, 5, r));
+            fct_chk_eq_int(0, esio_readahead_ranges(0, 4,
+                        4, 0, 4, 3, 0, 3, 5, 0, 0, r));
+        }
+        FCT_TEST_END();
+
+        // Enabling hints does not change what is written or read
+        FCT_TEST_BGN(roundtrip)
+        {
+            fct_chk_eq_int(esio_readahead_get(state), 0);
+            fct_req(0 == esio_readahead_set(state, 1));
+            fct_chk_eq_int(esio_readahead_get(state), 1);
+
+            // Each rank owns two C planes of a 5x6 field
+            const int cglobal = 2 * world_size, cstart = 2 * world_rank;
+            const int clocal = 2, bglobal = 5, aglobal = 6;
+            const int nelem = clocal * bglobal * aglobal;
+            double *field = malloc(nelem * sizeof(double));
+            double *back  = malloc(nelem * sizeof(double));
+            fct_req(field && back);
+            for (int i = 0; i < nelem; ++i) field[i] = i + 1000 * world_rank;
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal, bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_plane_establish(state,
+                        bglobal, 0, bglobal, aglobal, 0, aglobal));
+            fct_req(0 == esio_line_establish(state, aglobal, 0, aglobal));
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_write_double(
+                        state, "field0", field, 0, 0, 0, 0));
+            fct_req(0 == esio_field_layout_set(state, 3));
+            fct_req(0 == esio_field_write_double(
+                        state, "field3", field, 0, 0, 0, 0));
+            fct_req(0 == esio_field_layout_set(state, 0));
+            fct_req(0 == esio_plane_write_double(
+                        state, "plane", field, 0, 0, 0));
+            fct_req(0 == esio_line_write_double(
+                        state, "line", field, 0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_field_read_double(
+                        state, "field0", back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) fct_chk_eq_dbl(back[i], field[i]);
+            fct_req(0 == esio_field_read_double(
+                        state, "field3", back, 0, 0, 0));
+            for (int i = 0; i < nelem; ++i) fct_chk_eq_dbl(back[i], field[i]);
+            fct_req(0 == esio_plane_read_double(
+                        state, "plane", back, 0, 0));
+            for (int i = 0; i < bglobal * aglobal; ++i) {
+                fct_chk_eq_dbl(back[i], field[i]);
+            }
+            fct_req(0 == esio_line_read_double(state, "line", back, 0));
+            for (int i = 0; i < aglobal; ++i) {
+                fct_chk_eq_dbl(back[i], field[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_readahead_set(state, 0));
+            fct_chk_eq_int(esio_readahead_get(state), 0);
+
+            free(back);
+            free(field);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
@@ -0,0 +1,260 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(reduce)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Lines combine every rank's partial using each operation
+        FCT_TEST_BGN(line)
+        {
+            const int aglobal = 5 * world_size + 2;
+            const int astart  = 5 * world_rank;
+            const int alocal  = (world_rank == world_size - 1) ? 7 : 5;
+            const int stride  = 3;
+            const int n = world_size;
+            int    *partial = calloc(stride * aglobal, sizeof(int));
+            double *dpart   = calloc(aglobal, sizeof(double));
+            int    *back    = calloc(aglobal, sizeof(int));
+            double *dback   = calloc(aglobal, sizeof(double));
+            fct_req(partial && dpart && back && dback);
+            for (int i = 0; i < aglobal; ++i) {
+                partial[stride*i] = (world_rank + 1) * (i + 1);
+                dpart[i]          = 0.5 * (world_rank + 1) * i;
+            }
+
+            fct_req(0 == esio_line_establish(state, aglobal, astart, alocal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_line_write_reduce_int(
+                        state, "sum", partial, stride, ESIO_REDUCE_SUM, 0));
+            fct_req(0 == esio_line_write_reduce_int(
+                        state, "max", partial, stride, ESIO_REDUCE_MAX, 0));
+            fct_req(0 == esio_line_write_reduce_int(
+                        state, "min", partial, stride, ESIO_REDUCE_MIN, 0));
+            fct_req(0 == esio_line_write_reduce_double(
+                        state, "dsum", dpart, 0, ESIO_REDUCE_SUM, "sum"));
+
+            // Unknown operations are rejected
+            esio_set_error_handler_off();
+            fct_chk(ESIO_EINVAL == esio_line_write_reduce_int(
+                        state, "bad", partial, stride, 3, 0));
+            esio_set_error_handler(esio_handler);
+            fct_req(0 == esio_file_close(state));
+
+            // Every rank checks the entire line
+            fct_req(0 == esio_line_establish(state, aglobal, 0, aglobal));
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_line_read_int(state, "sum", back, 0));
+            for (int i = 0; i < aglobal; ++i) {
+                fct_chk_eq_int(back[i], (i + 1) * n * (n + 1) / 2);
+            }
+            fct_req(0 == esio_line_read_int(state, "max", back, 0));
+            for (int i = 0; i < aglobal; ++i) {
+                fct_chk_eq_int(back[i], (i + 1) * n);
+            }
+            fct_req(0 == esio_line_read_int(state, "min", back, 0));
+            for (int i = 0; i < aglobal; ++i) {
+                fct_chk_eq_int(back[i], i + 1);
+            }
+            fct_req(0 == esio_line_read_double(state, "dsum", dback, 0));
+            for (int i = 0; i < aglobal; ++i) {
+                fct_chk_eq_dbl(dback[i], 0.25 * i * n * (n + 1));
+            }
+            fct_req(0 == esio_file_close(state));
+
+            free(dback);
+            free(back);
+            free(dpart);
+            free(partial);
+        }
+        FCT_TEST_END();
+
+        // Planes combine partials under decompositions in both directions
+        FCT_TEST_BGN(plane)
+        {
+            const int bglobal = 3, aglobal = 4 * world_size;
+            const int n = world_size;
+            const int bstride = 2 * aglobal + 1, astride = 2;
+            float *partial = calloc(bglobal * bstride, sizeof(float));
+            float *back    = calloc(bglobal * aglobal, sizeof(float));
+            fct_req(partial && back);
+            for (int j = 0; j < bglobal; ++j) {
+                for (int i = 0; i < aglobal; ++i) {
+                    partial[j*bstride + i*astride]
+                        = (world_rank + 1) * (j * aglobal + i);
+                }
+            }
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_plane_establish(state,
+                        bglobal, 0, bglobal, aglobal, 4*world_rank, 4));
+            fct_req(0 == esio_plane_write_reduce_float(
+                        state, "asplit", partial, bstride, astride,
+                        ESIO_REDUCE_MAX, 0));
+            fct_req(0 == esio_plane_establish(state,
+                        bglobal, (world_rank == 0) ? 0 : bglobal,
+                                 (world_rank == 0) ? bglobal : 0,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_plane_write_reduce_float(
+                        state, "bsplit", partial, bstride, astride,
+                        ESIO_REDUCE_SUM, 0));
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_plane_establish(state,
+                        bglobal, 0, bglobal, aglobal, 0, aglobal));
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_plane_read_float(state, "asplit", back, 0, 0));
+            for (int k = 0; k < bglobal * aglobal; ++k) {
+                fct_chk_eq_dbl(back[k], (float) (n * k));
+            }
+            fct_req(0 == esio_plane_read_float(state, "bsplit", back, 0, 0));
+            for (int k = 0; k < bglobal * aglobal; ++k) {
+                fct_chk_eq_dbl(back[k], (float) (k * n * (n + 1) / 2));
+            }
+            fct_req(0 == esio_file_close(state));
+
+            free(back);
+            free(partial);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
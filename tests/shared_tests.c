@@ -0,0 +1,233 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(shared)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(line_read_shared)
+        {
+            const int alocal = 7, aglobal = alocal * world_size;
+            const int astart = alocal * world_rank;
+
+            double *line = malloc(alocal * sizeof(double));
+            fct_req(line);
+            for (int i = 0; i < alocal; ++i) line[i] = 0.5 * (astart + i);
+
+            fct_req(0 == esio_line_establish(state, aglobal, astart, alocal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_line_write_double(state, "x", line, 0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            // Every rank sees the entire line
+            fct_req(0 == esio_file_open(state, filename, 0));
+            const double *shared = NULL;
+            MPI_Win win = MPI_WIN_NULL;
+            fct_req(0 == esio_line_read_shared_double(state, "x",
+                                                      &shared, &win));
+            fct_req(shared);
+            fct_req(win != MPI_WIN_NULL);
+            for (int i = 0; i < aglobal; ++i) {
+                fct_chk_eq_dbl(shared[i], 0.5 * i);
+            }
+            MPI_Win_free(&win);
+
+            // The established decomposition is untouched
+            int g, s, l;
+            fct_req(0 == esio_line_established(state, &g, &s, &l));
+            fct_chk_eq_int(g, aglobal);
+            fct_chk_eq_int(s, astart);
+            fct_chk_eq_int(l, alocal);
+
+            // Missing data is reported consistently on all ranks
+            esio_set_error_handler_off();
+            const int status = esio_line_read_shared_double(
+                    state, "missing", &shared, &win);
+            fct_chk(status != ESIO_SUCCESS);
+            esio_set_error_handler(esio_handler);
+
+            fct_req(0 == esio_file_close(state));
+            free(line);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(plane_read_shared)
+        {
+            const int bglobal = 3, blocal = 3;
+            const int alocal = 4, aglobal = alocal * world_size;
+            const int astart = alocal * world_rank;
+
+            int *plane = malloc(blocal * alocal * sizeof(int));
+            fct_req(plane);
+            for (int j = 0; j < blocal; ++j) {
+                for (int i = 0; i < alocal; ++i) {
+                    plane[j*alocal + i] = 100*j + astart + i;
+                }
+            }
+
+            fct_req(0 == esio_plane_establish(state,
+                        bglobal, 0, blocal, aglobal, astart, alocal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_plane_write_int(state, "y", plane, 0, 0, 0));
+            fct_req(0 == esio_file_close(state));
+
+            // A fresh handle need not establish any decomposition
+            esio_handle_finalize(state);
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+            fct_req(0 == esio_file_open(state, filename, 0));
+            const int *shared = NULL;
+            MPI_Win win = MPI_WIN_NULL;
+            fct_req(0 == esio_plane_read_shared_int(state, "y",
+                                                    &shared, &win));
+            for (int j = 0; j < bglobal; ++j) {
+                for (int i = 0; i < aglobal; ++i) {
+                    fct_chk_eq_int(shared[j*aglobal + i], 100*j + i);
+                }
+            }
+            MPI_Win_free(&win);
+            fct_req(0 == esio_file_close(state));
+            free(plane);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
@@ -0,0 +1,210 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(small)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Small files are written only when closed and read back either way
+        FCT_TEST_BGN(roundtrip)
+        {
+            const int n = 3;
+            double x[3] = { 1, 2, 3 }, back[3];
+            int answer = 0;
+            char *program = NULL;
+
+            // Only single-rank handles may build files in memory
+            esio_set_error_handler_off();
+            const int world_status = esio_file_small_set(state, 1);
+            fct_chk_eq_int(world_status, world_size == 1 ? 0 : ESIO_EINVAL);
+            esio_set_error_handler(esio_handler);
+            fct_req(0 == esio_file_small_set(state, 0));
+
+            if (world_rank == 0) {
+                esio_handle s = esio_handle_initialize(MPI_COMM_SELF);
+                fct_req(s);
+                const int before = esio_file_small_get(s);
+                fct_chk_eq_int(before, 0);
+                fct_req(0 == esio_file_small_set(s, 1));
+                const int after = esio_file_small_get(s);
+                fct_chk_eq_int(after, 1);
+
+                fct_req(0 == esio_file_create(s, filename, 1));
+                fct_req(0 == esio_string_set(s, "/", "program", "small"));
+                fct_req(0 == esio_attribute_write_int(s, "/", "answer",
+                                                      &(int){42}));
+                fct_req(0 == esio_line_establish(s, n, 0, n));
+                fct_req(0 == esio_line_write_double(s, "x", x, 0, "x"));
+
+                fct_req(0 == esio_file_close(s));
+
+                // Reading in memory sees the same contents
+                fct_req(0 == esio_file_open(s, filename, 0));
+                program = esio_string_get(s, "/", "program");
+                fct_req(program);
+                fct_chk_eq_str(program, "small");
+                free(program);
+                fct_req(0 == esio_line_read_double(s, "x", back, 0));
+                for (int i = 0; i < n; ++i) fct_chk_eq_dbl(back[i], x[i]);
+                fct_req(0 == esio_file_close(s));
+
+                esio_handle_finalize(s);
+            }
+            ESIO_MPICHKR(MPI_Barrier(MPI_COMM_WORLD));
+
+            // The result is an ordinary file readable in parallel
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_attribute_read_int(state, "/", "answer",
+                                                 &answer));
+            fct_chk_eq_int(answer, 42);
+            fct_req(0 == esio_line_establish(state, n, 0,
+                                             world_rank ? 0 : n));
+            fct_req(0 == esio_line_read_double(state, "x", back, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], x[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
@@ -0,0 +1,277 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Storage bytes allocated for a dataset or -1 on error
+static long long storage_size(const char *filename, const char *name,
+                              int *incremental)
+{
+    const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file_id < 0) return -1;
+    const hid_t dset_id = H5Dopen2(file_id, name, H5P_DEFAULT);
+    if (dset_id < 0) { H5Fclose(file_id); return -1; }
+    const hid_t dcpl_id = H5Dget_create_plist(dset_id);
+    H5D_alloc_time_t alloc_time = H5D_ALLOC_TIME_DEFAULT;
+    H5Pget_alloc_time(dcpl_id, &alloc_time);
+    *incremental = (alloc_time == H5D_ALLOC_TIME_INCR);
+    const long long retval = H5Dget_storage_size(dset_id);
+    H5Pclose(dcpl_id);
+    H5Dclose(dset_id);
+    H5Fclose(file_id);
+    return retval;
+}
+
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(sparse)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(skips_tiles_equal_to_fill)
+        {
+            // Each rank's block is twice ESIO's sparse chunk size so that
+            // it is split into one all-fill and one nontrivial tile
+            const int clocal = 64, cglobal = clocal * world_size;
+            const int cstart = clocal * world_rank;
+            const int bglobal = 32, aglobal = 32;
+            const int plane = bglobal * aglobal;
+            const double fill = 1.5;
+
+            double *field = malloc(clocal * plane * sizeof(double));
+            double *back  = calloc(clocal * plane, sizeof(double));
+            fct_req(field);
+            fct_req(back);
+            for (int i = 0; i < clocal * plane; ++i) {
+                field[i] = (i < clocal * plane / 2) ? fill : cstart + i;
+            }
+
+            double query = 0;
+            fct_chk_eq_int(esio_field_sparse_get(state, &query), 0);
+            fct_req(0 == esio_field_sparse_set(state, 1, fill));
+            fct_chk_eq_int(esio_field_sparse_get(state, &query), 1);
+            fct_chk_eq_dbl(query, fill);
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal,
+                        bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_write_double(state, "u", field, 0, 0, 0,
+                                                 "sparse"));
+            fct_req(0 == esio_file_close(state));
+
+            // Only nontrivial tiles occupy storage when allocation is
+            // incremental.  Parallel HDF5 forces early allocation of
+            // datasets accessed through MPI-IO, in which case every chunk
+            // occupies storage and skipping saves only bandwidth.
+            if (world_rank == 0) {
+                int incremental = 0;
+                const long long bytes = storage_size(filename, "u",
+                                                     &incremental);
+                const long long dense = (long long) world_size * clocal
+                                      * plane * (long long) sizeof(double);
+                fct_req(bytes >= 0);
+                fct_chk(bytes == (incremental ? dense / 2 : dense));
+            }
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_field_read_double(state, "u", back, 0, 0, 0));
+            for (int i = 0; i < clocal * plane; ++i) {
+                fct_chk_eq_dbl(back[i], field[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+
+            free(back);
+            free(field);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(strided_and_transposed_fields_remain_correct)
+        {
+            const int clocal = 3, cglobal = clocal * world_size;
+            const int cstart = clocal * world_rank;
+            const int bglobal = 4, aglobal = 5;
+            const int nlocal = clocal * bglobal * aglobal;
+
+            // Strided input where only one element differs from fill
+            int *field = malloc(2 * nlocal * sizeof(int));
+            int *back  = calloc(nlocal, sizeof(int));
+            fct_req(field);
+            fct_req(back);
+            for (int i = 0; i < 2 * nlocal; ++i) field[i] = -1;
+            field[2 * (nlocal - 1)] = world_rank;
+
+            fct_req(0 == esio_field_sparse_set(state, 1, -1));
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal,
+                        bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_write_int(state, "strided", field,
+                                              0, 0, 2, 0));
+
+            // Layout 1 is written densely despite sparse writes being enabled
+            fct_req(0 == esio_field_layout_set(state, 1));
+            fct_req(0 == esio_field_write_int(state, "transposed", field,
+                                              0, 0, 2, 0));
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_file_open(state, filename, 0));
+            fct_req(0 == esio_field_read_int(state, "strided", back, 0, 0, 0));
+            for (int i = 0; i < nlocal; ++i) {
+                fct_chk_eq_int(back[i], i == nlocal - 1 ? world_rank : -1);
+            }
+            memset(back, 0, nlocal * sizeof(int));
+            fct_req(0 == esio_field_read_int(state, "transposed",
+                                             back, 0, 0, 0));
+            for (int i = 0; i < nlocal; ++i) {
+                fct_chk_eq_int(back[i], i == nlocal - 1 ? world_rank : -1);
+            }
+            fct_req(0 == esio_file_close(state));
+
+            fct_req(0 == esio_field_sparse_set(state, 0, 0));
+            fct_chk_eq_int(esio_field_sparse_get(state, NULL), 0);
+
+            free(back);
+            free(field);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
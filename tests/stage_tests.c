@@ -0,0 +1,242 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+// Point ESIO_STAGE_DIR at path's directory and return the corresponding
+// stage: URI, which the caller must free
+static char * stage_uri(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    char *dir = slash ? strndup(path, slash - path) : strdup(".");
+    setenv("ESIO_STAGE_DIR", dir, 1);
+    free(dir);
+    const char *base = slash ? slash + 1 : path;
+    char *uri = malloc(strlen("stage:") + strlen(base) + 1);
+    if (uri) sprintf(uri, "stage:%s", base);
+    return uri;
+}
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(stage)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Staged files appear under their final name only once closed
+        FCT_TEST_BGN(publish)
+        {
+            const int n = 6;
+            double x[6] = { 1, 2, 3, 4, 5, 6 }, back[6];
+            char *uri = stage_uri(filename);
+            fct_req(uri);
+            char *partial = malloc(strlen(filename) + sizeof(".partial"));
+            fct_req(partial);
+            sprintf(partial, "%s.partial", filename);
+
+            fct_req(0 == esio_file_create(state, uri, 1));
+            fct_req(0 == esio_line_establish(state, n, 0,
+                                             world_rank ? 0 : n));
+            fct_req(0 == esio_line_write_double(state, "x", x, 0, 0));
+            const int has_partial = access(partial, F_OK);
+            fct_chk_eq_int(has_partial, 0);
+            const int has_final = access(filename, F_OK);
+            fct_chk_neq_int(has_final, 0);
+
+            // The handle reports the final name even while writing aside
+            char *path = esio_file_path(state);
+            fct_req(path);
+            const size_t len = strlen(path);
+            const char *base = strrchr(filename, '/');
+            base = base ? base + 1 : filename;
+            fct_chk(len >= strlen(base));
+            fct_chk_eq_str(path + len - strlen(base), base);
+            free(path);
+            fct_req(0 == esio_file_close(state));
+
+            const int had_partial = access(partial, F_OK);
+            fct_chk_neq_int(had_partial, 0);
+            const int had_final = access(filename, F_OK);
+            fct_chk_eq_int(had_final, 0);
+
+            // Consumers read through the same URI
+            fct_req(0 == esio_file_open(state, uri, 0));
+            fct_req(0 == esio_line_establish(state, n, 0,
+                                             world_rank ? 0 : n));
+            fct_req(0 == esio_line_read_double(state, "x", back, 0));
+            for (int i = 0; i < n && world_rank == 0; ++i) {
+                fct_chk_eq_dbl(back[i], x[i]);
+            }
+            fct_req(0 == esio_file_close(state));
+
+            free(partial);
+            free(uri);
+        }
+        FCT_TEST_END();
+
+        // Published files are not clobbered and absent files are reported
+        FCT_TEST_BGN(exclusive)
+        {
+            char *uri = stage_uri(filename);
+            fct_req(uri);
+
+            fct_req(0 == esio_file_create(state, uri, 1));
+            fct_req(0 == esio_file_close(state));
+
+            H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+            esio_set_error_handler_off();
+            const int create_status = esio_file_create(state, uri, 0);
+            fct_chk_eq_int(create_status, ESIO_EFAILED);
+            unlink(filename);
+            setenv("ESIO_STAGE_WAIT", "0.05", 1);
+            const int open_status = esio_file_open(state, uri, 0);
+            fct_chk_eq_int(open_status, ESIO_EFAILED);
+            unsetenv("ESIO_STAGE_WAIT");
+
+            // Names escaping the staging directory are refused
+            const int slash_status = esio_file_create(state, "stage:a/b", 1);
+            fct_chk_eq_int(slash_status, ESIO_EINVAL);
+            const int dots_status = esio_file_open(state, "stage:../b", 0);
+            fct_chk_eq_int(dots_status, ESIO_EINVAL);
+
+            free(uri);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
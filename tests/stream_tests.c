@@ -0,0 +1,340 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+// Callback state shared by the stream tests below
+struct stream_state {
+    int bglobal, aglobal;   // Extents of each plane
+    int planes;             // Number of planes seen so far
+    int maxclocal;          // Largest slab seen so far
+    int fail_at;            // Fail when reaching this global c, if nonneg
+    int mismatches;         // Number of unexpected values seen
+};
+
+static double stream_value(int c, int b, int a)
+{
+    return 10000.0 * c + 100.0 * b + a;
+}
+
+static int stream_generate(void *slab, int cstart, int clocal, void *data)
+{
+    struct stream_state *s = data;
+    double *p = slab;
+    if (s->fail_at >= 0 && cstart <= s->fail_at
+            && s->fail_at < cstart + clocal) {
+        return 1;
+    }
+    for (int k = 0; k < clocal; ++k)
+        for (int j = 0; j < s->bglobal; ++j)
+            for (int i = 0; i < s->aglobal; ++i)
+                *p++ = stream_value(cstart + k, j, i);
+    s->planes += clocal;
+    if (clocal > s->maxclocal) s->maxclocal = clocal;
+    return 0;
+}
+
+static int stream_verify(void *slab, int cstart, int clocal, void *data)
+{
+    struct stream_state *s = data;
+    const double *p = slab;
+    for (int k = 0; k < clocal; ++k)
+        for (int j = 0; j < s->bglobal; ++j)
+            for (int i = 0; i < s->aglobal; ++i)
+                if (*p++ != stream_value(cstart + k, j, i)) ++s->mismatches;
+    s->planes += clocal;
+    if (clocal > s->maxclocal) s->maxclocal = clocal;
+    return 0;
+}
+
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(stream)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        FCT_TEST_BGN(write_stream_matches_whole_read)
+        {
+            // Odd local extent in C exercises a short final slab
+            const int clocal = 5, cglobal = clocal * world_size;
+            const int cstart = clocal * world_rank;
+            const int bglobal = 3, aglobal = 4;
+            const int nlocal = clocal * bglobal * aglobal;
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal,
+                        bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+
+            struct stream_state s = { bglobal, aglobal, 0, 0, -1, 0 };
+            fct_req(0 == esio_field_write_stream_double(state, "u", 2,
+                        &stream_generate, &s, "streamed"));
+            fct_chk_eq_int(s.planes, clocal);
+            fct_chk_eq_int(s.maxclocal, 2);
+            fct_req(0 == esio_file_close(state));
+
+            double *back = calloc(nlocal, sizeof(double));
+            fct_req(back);
+            fct_req(0 == esio_file_open(state, filename, 0));
+            int c, b, a;
+            fct_req(0 == esio_field_size(state, "u", &c, &b, &a));
+            fct_chk_eq_int(c, cglobal);
+            fct_chk_eq_int(b, bglobal);
+            fct_chk_eq_int(a, aglobal);
+            fct_req(0 == esio_field_read_double(state, "u", back, 0, 0, 0));
+            for (int k = 0; k < clocal; ++k)
+                for (int j = 0; j < bglobal; ++j)
+                    for (int i = 0; i < aglobal; ++i)
+                        fct_chk_eq_dbl(back[(k*bglobal + j)*aglobal + i],
+                                       stream_value(cstart + k, j, i));
+            fct_req(0 == esio_file_close(state));
+            free(back);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(read_stream_of_whole_write)
+        {
+            const int clocal = 4, cglobal = clocal * world_size;
+            const int cstart = clocal * world_rank;
+            const int bglobal = 2, aglobal = 3;
+            const int nlocal = clocal * bglobal * aglobal;
+
+            double *field = calloc(nlocal, sizeof(double));
+            fct_req(field);
+            double *p = field;
+            for (int k = 0; k < clocal; ++k)
+                for (int j = 0; j < bglobal; ++j)
+                    for (int i = 0; i < aglobal; ++i)
+                        *p++ = stream_value(cstart + k, j, i);
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal,
+                        bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+            fct_req(0 == esio_field_write_double(state, "u", field, 0, 0, 0,
+                                                 0));
+            fct_req(0 == esio_file_close(state));
+
+            // Slabs larger than the local block collapse to one transfer
+            fct_req(0 == esio_file_open(state, filename, 0));
+            struct stream_state s = { bglobal, aglobal, 0, 0, -1, 0 };
+            fct_req(0 == esio_field_read_stream_double(state, "u", 3,
+                        &stream_verify, &s));
+            fct_chk_eq_int(s.planes, clocal);
+            fct_chk_eq_int(s.maxclocal, 3);
+            fct_chk_eq_int(s.mismatches, 0);
+
+            struct stream_state t = { bglobal, aglobal, 0, 0, -1, 0 };
+            fct_req(0 == esio_field_read_stream_double(state, "u", 100,
+                        &stream_verify, &t));
+            fct_chk_eq_int(t.planes, clocal);
+            fct_chk_eq_int(t.maxclocal, clocal);
+            fct_chk_eq_int(t.mismatches, 0);
+
+            // Page cache hints prefetch each next slab during the callback
+            fct_req(0 == esio_readahead_set(state, 1));
+            struct stream_state r = { bglobal, aglobal, 0, 0, -1, 0 };
+            fct_req(0 == esio_field_read_stream_double(state, "u", 1,
+                        &stream_verify, &r));
+            fct_chk_eq_int(r.planes, clocal);
+            fct_chk_eq_int(r.maxclocal, 1);
+            fct_chk_eq_int(r.mismatches, 0);
+            fct_req(0 == esio_readahead_set(state, 0));
+            fct_req(0 == esio_file_close(state));
+            free(field);
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(callback_failure_aborts)
+        {
+            const int clocal = 4, cglobal = clocal * world_size;
+            const int cstart = clocal * world_rank;
+            const int bglobal = 2, aglobal = 2;
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal,
+                        bglobal, 0, bglobal,
+                        aglobal, 0, aglobal));
+            fct_req(0 == esio_file_create(state, filename, 1));
+
+            // Only rank 0 fails yet every rank observes the failure once
+            // all slabs are transferred.  Rank 0 is not called again.
+            esio_set_error_handler_off();
+            struct stream_state s = { bglobal, aglobal, 0, 0,
+                                      world_rank == 0 ? 2 : -1, 0 };
+            const int status = esio_field_write_stream_double(
+                        state, "u", 1, &stream_generate, &s, 0);
+            fct_chk_eq_int(status, ESIO_EFAILED);
+            fct_chk_eq_int(s.planes, world_rank == 0 ? 2 : clocal);
+            esio_set_error_handler(esio_handler);
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+
+        FCT_TEST_BGN(rejects_transposed_layout_and_bad_arguments)
+        {
+            const int clocal = 2, cglobal = clocal * world_size;
+            const int cstart = clocal * world_rank;
+
+            fct_req(0 == esio_field_establish(state,
+                        cglobal, cstart, clocal, 2, 0, 2, 2, 0, 2));
+            fct_req(0 == esio_file_create(state, filename, 1));
+
+            esio_set_error_handler_off();
+            struct stream_state s = { 2, 2, 0, 0, -1, 0 };
+            int status;
+            status = esio_field_write_stream_double(
+                        state, "u", 0, &stream_generate, &s, 0);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            status = esio_field_write_stream_double(
+                        state, "u", 1, NULL, &s, 0);
+            fct_chk_eq_int(status, ESIO_EFAULT);
+            fct_req(0 == esio_field_layout_set(state, 1));
+            status = esio_field_write_stream_double(
+                        state, "u", 1, &stream_generate, &s, 0);
+            fct_chk_eq_int(status, ESIO_EINVAL);
+            fct_chk_eq_int(s.planes, 0);
+            esio_set_error_handler(esio_handler);
+
+            fct_req(0 == esio_file_close(state));
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()
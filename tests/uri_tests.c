@@ -128,5 +128,23 @@ FCT_BGN()
         FCT_TEST_END();
     }
     FCT_SUITE_END();
+
+    FCT_SUITE_BGN(stage_name_valid)
+    {
+        FCT_TEST_BGN(names)
+        {
+            fct_chk(stage_name_valid("stage:snap.h5"));
+            fct_chk(stage_name_valid("stage:snap.00042.h5"));
+            fct_chk(!stage_name_valid("snap.h5"));
+            fct_chk(!stage_name_valid("stage:"));
+            fct_chk(!stage_name_valid("stage:dir/snap.h5"));
+            fct_chk(!stage_name_valid("stage:/etc/passwd"));
+            fct_chk(!stage_name_valid("stage:..snap.h5"));
+            fct_chk(!stage_name_valid("stage:snap.h5.."));
+            fct_chk(!stage_resolve("stage:../snap.h5", NULL));
+        }
+        FCT_TEST_END();
+    }
+    FCT_SUITE_END();
 }
 FCT_END()
@@ -0,0 +1,252 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// ESIO 0.2.0: ExaScale IO library for turbulence simulation restart files
+// http://github.com/RhysU/ESIO
+//
+// Copyright (C) 2010-2017 The PECOS Development Team
+//
+// This file is part of ESIO.
+//
+// ESIO is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published
+// by the Free Software Foundation, either version 3.0 of the License, or
+// (at your option) any later version.
+//
+// ESIO is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with ESIO.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------el-
+// $Id$
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <mpi.h>
+#include <hdf5.h>
+#include <esio/esio.h>
+#include <esio/error.h>
+
+#include "testutils.h"
+
+// Include FCTX and silence useless warnings
+#ifdef __INTEL_COMPILER
+#pragma warning(push,disable:981)
+#endif
+#include "fct.h"
+#ifdef __INTEL_COMPILER
+#pragma warning(pop)
+#endif
+
+// Add command line options
+static const fctcl_init_t my_cl_options[] = {
+    {
+        "--preserve",
+        "-t",
+        FCTCL_STORE_TRUE,
+        "Are temporary filenames displayed and files preserved?"
+    },
+    FCTCL_INIT_NULL /* Sentinel */
+};
+
+FCT_BGN()
+{
+    int preserve = 0;
+
+    // MPI setup: MPI_Init and atexit(MPI_Finalize)
+    int world_size, world_rank;
+    MPI_Init(&argc, &argv);
+    atexit((void (*) ()) MPI_Finalize);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    // Install the command line options defined above.
+    fctcl_install(my_cl_options);
+
+    // Retrieve and sanity check problem size options
+    preserve = fctcl_is("--preserve");
+
+    // Obtain default HDF5 error handler
+    H5E_auto2_t hdf5_handler;
+    void *hdf5_client_data;
+    H5Eget_auto2(H5E_DEFAULT, &hdf5_handler, &hdf5_client_data);
+
+    // Obtain default ESIO error handler
+    esio_error_handler_t * const esio_handler = esio_set_error_handler_off();
+    esio_set_error_handler(esio_handler);
+
+    // Fixture-related details
+    const char * const input_dir  = getenv("ESIO_TEST_INPUT_DIR");
+    const char * const output_dir = getenv("ESIO_TEST_OUTPUT_DIR");
+    char * filetemplate = create_testfiletemplate(output_dir, __FILE__);
+    (void) input_dir;  // Possibly unused
+    char * filename = NULL;
+    esio_handle state;
+
+    FCT_FIXTURE_SUITE_BGN(views)
+    {
+        FCT_SETUP_BGN()
+        {
+            ESIO_MPICHKQ(MPI_Barrier(MPI_COMM_WORLD)); // Synchronize
+
+            // Restore HDF5/ESIO default error handling
+            H5Eset_auto2(H5E_DEFAULT, hdf5_handler, hdf5_client_data);
+            esio_set_error_handler(esio_handler);
+
+            // Rank 0 generates a unique filename and broadcasts it
+            int filenamelen;
+            if (world_rank == 0) {
+                filename = create_testfilename(filetemplate);
+                if (preserve) {
+                    printf("\nfilename: %s\n", filename);
+                }
+                filenamelen = strlen(filename);
+            }
+            ESIO_MPICHKR(MPI_Bcast(&filenamelen, 1, MPI_INT,
+                                   0, MPI_COMM_WORLD));
+            if (world_rank > 0) {
+                filename = calloc(filenamelen + 1, sizeof(char));
+            }
+            ESIO_MPICHKR(MPI_Bcast(filename, filenamelen, MPI_CHAR,
+                                    0, MPI_COMM_WORLD));
+            fct_req(filename);
+
+            // Initialize ESIO state
+            state = esio_handle_initialize(MPI_COMM_WORLD);
+            fct_req(state);
+        }
+        FCT_SETUP_END();
+
+        FCT_TEARDOWN_BGN()
+        {
+            // Finalize ESIO state
+            esio_handle_finalize(state);
+
+            // Clean up the unique file and filename
+            if (world_rank == 0) {
+                if (!preserve) unlink(filename);
+            }
+            free(filename);
+        }
+        FCT_TEARDOWN_END();
+
+        // Every layout is presented as a plain 3-D array
+        FCT_TEST_BGN(layouts)
+        {
+            enum { C = 3, B = 5, A = 9, N = C*B*A };
+            double x[N], v[3*N], back[3*N];
+            for (int i = 0; i < N; ++i) x[i] = i;
+            for (int i = 0; i < 3*N; ++i) v[i] = -i;
+
+            fct_req(0 == esio_file_create(state, filename, 1));
+            const int before = esio_file_views_get(state);
+            fct_chk_eq_int(before, 0);
+            fct_req(0 == esio_file_views_set(state, 1));
+            const int after = esio_file_views_get(state);
+            fct_chk_eq_int(after, 1);
+            const int own = (world_rank == 0);
+            fct_req(0 == esio_field_establish(state, C, 0, own ? C : 0,
+                                                     B, 0, own ? B : 0,
+                                                     A, 0, own ? A : 0));
+            static const char * const names[] = { "l0", "l1", "l2", "l3" };
+            for (int k = 0; k < 4; ++k) {
+                fct_req(0 == esio_field_layout_set(state, k));
+                fct_req(0 == esio_field_write_double(state, names[k], x,
+                                                     0, 0, 0, 0));
+            }
+            fct_req(0 == esio_field_layout_set(state, 2));
+            fct_req(0 == esio_field_writev_double(state, "v", v,
+                                                  0, 0, 0, 3, 0));
+            fct_req(0 == esio_file_close(state));
+
+            char *xmf = malloc(strlen(filename) + sizeof(".xmf"));
+            fct_req(xmf);
+            sprintf(xmf, "%s.xmf", filename);
+            if (world_rank == 0) {
+                const hid_t file_id = H5Fopen(filename, H5F_ACC_RDONLY,
+                                              H5P_DEFAULT);
+                fct_req(file_id >= 0);
+                for (int k = 0; k < 4; ++k) {
+                    // Layouts 0 and 1 are already plain and need no view
+                    char view[64];
+                    snprintf(view, sizeof(view), "esio_views/%s", names[k]);
+                    const int exists = H5Lexists(file_id, view, H5P_DEFAULT);
+                    fct_chk_eq_int(exists, k >= 2);
+                    const hid_t dset_id = H5Dopen2(file_id,
+                                                   exists ? view : names[k],
+                                                   H5P_DEFAULT);
+                    fct_req(dset_id >= 0);
+                    if (k == 3) {
+                        // Bricks are copied rather than mapped one by one
+                        const hid_t dcpl_id = H5Dget_create_plist(dset_id);
+                        const H5D_layout_t layout = H5Pget_layout(dcpl_id);
+                        fct_chk(layout == H5D_CONTIGUOUS);
+                        H5Pclose(dcpl_id);
+                    }
+                    const hid_t space_id = H5Dget_space(dset_id);
+                    hsize_t dims[3];
+                    const int rank = H5Sget_simple_extent_dims(space_id,
+                                                               dims, NULL);
+                    fct_chk_eq_int(rank, 3);
+                    fct_chk_eq_int((int) dims[0], C);
+                    fct_chk_eq_int((int) dims[1], B);
+                    fct_chk_eq_int((int) dims[2], A);
+                    fct_req(0 <= H5Dread(dset_id, H5T_NATIVE_DOUBLE,
+                                         H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                                         back));
+                    for (int i = 0; i < N; ++i) {
+                        fct_chk_eq_dbl(back[i], x[i]);
+                    }
+                    H5Sclose(space_id);
+                    H5Dclose(dset_id);
+                }
+
+                // Vector components remain within each element
+                const hsize_t ncomponents = 3;
+                const hid_t type_id = H5Tarray_create2(H5T_NATIVE_DOUBLE,
+                                                       1, &ncomponents);
+                const hid_t dset_id = H5Dopen2(file_id, "esio_views/v",
+                                               H5P_DEFAULT);
+                fct_req(dset_id >= 0);
+                fct_req(0 <= H5Dread(dset_id, type_id, H5S_ALL, H5S_ALL,
+                                     H5P_DEFAULT, back));
+                for (int i = 0; i < 3*N; ++i) fct_chk_eq_dbl(back[i], v[i]);
+                H5Dclose(dset_id);
+                H5Tclose(type_id);
+                H5Fclose(file_id);
+
+                // The descriptor references each view
+                FILE *stream = fopen(xmf, "r");
+                fct_req(stream);
+                char text[8192];
+                const size_t len = fread(text, 1, sizeof(text) - 1, stream);
+                text[len] = '\0';
+                fclose(stream);
+                fct_chk(strstr(text, "Dimensions=\"3 5 9\""));
+                fct_chk(strstr(text, ":/l0<"));
+                fct_chk(strstr(text, ":/esio_views/l2<"));
+                fct_chk(strstr(text, ":/esio_views/l3<"));
+                fct_chk(strstr(text, "AttributeType=\"Vector\""));
+                fct_chk(strstr(text, "Dimensions=\"3 5 9 3\""));
+                if (!preserve) unlink(xmf);
+            }
+            free(xmf);
+        }
+        FCT_TEST_END();
+    }
+    FCT_FIXTURE_SUITE_END();
+
+    free(filetemplate);
+}
+FCT_END()